@@ -15,20 +15,39 @@ namespace custom
     {
         Tensor resnet50_impl(const Tensor &in, const Tensor &weights)
         {
-            Tensor out = at::zeros({1, 1000});
+            Tensor out = at::zeros({in.size(0), 1000});
             resnet50_out_impl(in, weights, out);
             return out;
         }
 
+        Tensor resnet50_int8_impl(const Tensor &in, const Tensor &weights, const Tensor &scales)
+        {
+            Tensor out = at::zeros({in.size(0), 1000});
+            resnet50_int8_out_impl(in, weights, scales, out);
+            return out;
+        }
+
+        Tensor resnet50_invalidate_impl(const Tensor &weights)
+        {
+            // Returns a tensor like the out variant, so the op can be lowered to baremetal_ops::resnet50_invalidate.out.
+            Tensor out = at::zeros({0});
+            resnet50_invalidate_out_impl(weights, out);
+            return out;
+        }
+
         // standard API to register ops into PyTorch
         TORCH_LIBRARY_FRAGMENT(baremetal_ops, m)
         {
             m.def("baremetal_ops::resnet50(Tensor input, Tensor weights) -> Tensor");
+            m.def("baremetal_ops::resnet50_int8(Tensor input, Tensor weights, Tensor scales) -> Tensor");
+            m.def("baremetal_ops::resnet50_invalidate(Tensor weights) -> Tensor");
         }
 
         TORCH_LIBRARY_IMPL(baremetal_ops, CompositeExplicitAutograd, m)
         {
             m.impl("resnet50", TORCH_FN(resnet50_impl));
+            m.impl("resnet50_int8", TORCH_FN(resnet50_int8_impl));
+            m.impl("resnet50_invalidate", TORCH_FN(resnet50_invalidate_impl));
         }
     } // namespace native
 } // namespace custom
@@ -4,8 +4,15 @@
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 #include "execu_resnet50_out.h"
+#include "model/ResNet50Weights.h"
 #include <sstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <stdint.h>
 
 namespace custom
 {
@@ -305,6 +312,10 @@ namespace custom
                     in.dim() == 4,
                     "Exepcted input tensor to have 4 dimensions (Batch, Channels, Height, Width), but got %d instead",
                     in.dim());
+                ET_CHECK_MSG(
+                    in.size(0) >= 1,
+                    "Expected input tensor to have at least 1 image in the batch, but got %d instead",
+                    in.size(0));
                 ET_CHECK_MSG(
                     in.size(1) == 3,
                     "Expected input tensor to have 3 channels for Red, Green, Blue, but got %d instead",
@@ -323,61 +334,328 @@ namespace custom
                     "Expected weights tensor to have 1 dimension (CompressedWeights), but got %d instead",
                     weights.dim());
                 ET_CHECK_MSG(
-                    weights.size(0) == 25610152,
-                    "Expected weights tensor to have 25610152 elements, but got %d instead",
+                    weights.size(0) == 25610152 || weights.size(0) == 25610152 + RESNET50_BLOCKED_WEIGHTS_HEADER_SIZE,
+                    "Expected weights tensor to have 25610152 elements (+%d for blocked weights), but got %d instead",
+                    RESNET50_BLOCKED_WEIGHTS_HEADER_SIZE,
                     weights.size(0));
 
 
                 // Check Output Shape
                 ET_CHECK_MSG(
                     out.dim() == 2,
-                    "Expected out tensor to have 1 dimension (Batch, Classes), but got %d instead",
+                    "Expected out tensor to have 2 dimensions (Batch, Classes), but got %d instead",
                     out.dim());
+                ET_CHECK_MSG(
+                    out.size(0) == in.size(0),
+                    "Expected out tensor to have the batch %d of the input, but got %d instead",
+                    in.size(0),
+                    out.size(0));
                 ET_CHECK_MSG(
                     out.size(1) == 1000,
                     "Expected out tensor to have 1000 classes, but got %d instead",
                     out.size(1));
             }
 
+            void check_scales(const Tensor &scales)
+            {
+                ET_CHECK_MSG(
+                    scales.scalar_type() == exec_aten::ScalarType::Float,
+                    "Expected scales tensor to have dtype Float, but got %hhd instead",
+                    scales.scalar_type());
+                ET_CHECK_MSG(
+                    scales.dim() == 1,
+                    "Expected scales tensor to have 1 dimension (Scales), but got %d instead",
+                    scales.dim());
+                ET_CHECK_MSG(
+                    static_cast<size_t>(scales.size(0)) == ImageInference::model::ResNet50Calibration::size,
+                    "Expected scales tensor to have %d elements, but got %d instead",
+                    static_cast<int>(ImageInference::model::ResNet50Calibration::size),
+                    scales.size(0));
+            }
+
+            /// @brief Checks if the weights were exported in the blocked kernel layout, see export_utils.compressParameters.
+            /// Blocked weights start with a header that stores the layout version and the block size.
+            template <typename T>
+            static ImageInference::types::KernelLayout getLayout(const Tensor &tensor)
+            {
+                if (tensor.numel() != 25610152 + RESNET50_BLOCKED_WEIGHTS_HEADER_SIZE)
+                {
+                    return ImageInference::types::KernelLayout::OIHW;
+                }
+
+                const T *header = tensor.const_data_ptr<T>();
+                ET_CHECK_MSG(
+                    static_cast<size_t>(header[0]) == RESNET50_BLOCKED_WEIGHTS_MAGIC,
+                    "Expected blocked weights to start with the magic %d, but got %d instead",
+                    RESNET50_BLOCKED_WEIGHTS_MAGIC,
+                    static_cast<int>(header[0]));
+                ET_CHECK_MSG(
+                    static_cast<size_t>(header[1]) == RESNET50_BLOCKED_WEIGHTS_LAYOUT_VERSION,
+                    "Expected blocked weights with layout version %d, but got %d instead",
+                    RESNET50_BLOCKED_WEIGHTS_LAYOUT_VERSION,
+                    static_cast<int>(header[1]));
+                ET_CHECK_MSG(
+                    static_cast<size_t>(header[2]) == RESNET50_BLOCK_SIZE,
+                    "Expected blocked weights with block size %d, but got %d instead. Export the model with the block size of the runtime.",
+                    RESNET50_BLOCK_SIZE,
+                    static_cast<int>(header[2]));
+                return ImageInference::types::KernelLayout::Blocked;
+            }
+
+            /// @brief Returns the scalar type the model computes in, which is stored in the header of blocked weights.
+            /// Weights in the plain layout and older exports without the entry compute in the type of the weights.
+            template <typename T>
+            static ImageInference::types::ScalarType getComputeType(const Tensor &tensor, ImageInference::types::KernelLayout layout, ImageInference::types::ScalarType weightsType)
+            {
+                if (layout != ImageInference::types::KernelLayout::Blocked)
+                {
+                    return weightsType;
+                }
+
+                const T *header = tensor.const_data_ptr<T>();
+                const int computeType = static_cast<int>(header[3]);
+                if (computeType == 0)
+                {
+                    return weightsType;
+                }
+
+                ET_CHECK_MSG(
+                    computeType == static_cast<int>(ImageInference::types::ScalarType::Float) ||
+                        computeType == static_cast<int>(ImageInference::types::ScalarType::BFloat16) ||
+                        computeType == static_cast<int>(ImageInference::types::ScalarType::Int8),
+                    "Expected blocked weights to compute in Float, BFloat16 or Int8, but got %d instead",
+                    computeType);
+                return static_cast<ImageInference::types::ScalarType>(computeType);
+            }
+
+            /// @param data The elements of the weights tensor or a copy of them.
             template <typename T>
-            static void expandToTensorList(const Tensor &tensor, std::vector<void *> &out)
+            static void expandToTensorList(T *data, std::vector<void *> &out, ImageInference::types::KernelLayout layout)
             {
-                auto ptr = tensor.mutable_data_ptr<T>();
+                T *ptr = data;
+                if (layout == ImageInference::types::KernelLayout::Blocked)
+                {
+                    ptr += RESNET50_BLOCKED_WEIGHTS_HEADER_SIZE;
+                }
                 for (size_t i = 0; i < weightsCount; i++)
                 {
                     out[i] = ptr;
                     ptr += sizes[i];
                 }
             }
+
+            /// @brief Continues the FNV-1a hash with the bytes.
+            static uint64_t hashBytes(uint64_t hash, const void *bytes, size_t count)
+            {
+                const auto *data = static_cast<const unsigned char *>(bytes);
+                for (size_t i = 0; i < count; i++)
+                {
+                    hash ^= data[i];
+                    hash *= 1099511628211ULL;
+                }
+                return hash;
+            }
+
+            /// @brief Hashes all the elements of the tensor.
+            template <typename T>
+            static uint64_t fingerprint(const Tensor &tensor)
+            {
+                return hashBytes(14695981039346656037ULL, tensor.const_data_ptr<T>(), tensor.numel() * sizeof(T));
+            }
+
+            /// @brief Hashes windows of RESNET50_BLOCKED_WEIGHTS_HEADER_SIZE elements at fixed offsets spread over the tensor,
+            /// the first of which is the header of blocked weights.
+            /// It is cheap enough for every invocation and tells apart other weights that are allocated at the address of freed ones.
+            /// It does not detect every update in place, see resnet50_invalidate.
+            template <typename T>
+            static uint64_t sampledFingerprint(const Tensor &tensor)
+            {
+                constexpr const size_t samples = 64;
+                constexpr const size_t window = RESNET50_BLOCKED_WEIGHTS_HEADER_SIZE;
+                const T *data = tensor.const_data_ptr<T>();
+                const size_t numel = tensor.numel();
+                if (numel <= samples * window)
+                {
+                    return fingerprint<T>(tensor);
+                }
+
+                uint64_t hash = 14695981039346656037ULL;
+                for (size_t iSample = 0; iSample < samples; iSample++)
+                {
+                    const size_t offset = iSample * ((numel - window) / (samples - 1));
+                    hash = hashBytes(hash, data + offset, window * sizeof(T));
+                }
+                return hash;
+            }
+
+            /// @brief Identifies the prepared model of the weights and the scales of its activations.
+            /// The scales are small and identified by their content, the weights by their data pointer and a sampled fingerprint.
+            struct CacheKey
+            {
+                const void *weightsData;
+                exec_aten::ScalarType scalarType;
+                size_t numel;
+                uint64_t weightsFingerprint;
+                bool int8;
+                uint64_t scalesFingerprint;
+
+                bool operator<(const CacheKey &other) const
+                {
+                    return std::tie(weightsData, scalarType, numel, weightsFingerprint, int8, scalesFingerprint) <
+                           std::tie(other.weightsData, other.scalarType, other.numel, other.weightsFingerprint, other.int8, other.scalesFingerprint);
+                }
+            };
+
+            /// @brief A prepared model that is shared between op invocations with the same weights.
+            struct CachedModel
+            {
+                std::shared_ptr<ResNet50> model;
+                /// @brief The last invocation that used the model, the least recently used model is evicted first.
+                size_t lastUse = 0;
+            };
+
+            static std::mutex cacheMutex;
+            static std::map<CacheKey, CachedModel> cache;
+            static size_t cacheUses = 0;
+
+            /// @brief Returns the prepared model for the weights, building it if the weights are not cached yet.
+            /// The returned model stays alive until the caller is done, even if another thread evicts the cache entry.
+            ///
+            /// Up to RESNET50_CACHED_MODELS models are cached, so e.g. alternating the float and the int8 op or two programs
+            /// with different weights do not prepare their models again on every invocation.
+            /// The weights are identified by their data pointer and a fingerprint of samples of them, see sampledFingerprint.
+            /// The fingerprint catches other weights at the address of freed ones, but not every update in place.
+            /// Therefore weights that are updated in place or freed need to be dropped with resnet50_invalidate.
+            /// @param scales The scales of the activations of the int8 model or nullptr for the other models.
+            static std::shared_ptr<ResNet50> getModel(const Tensor &weights, const Tensor *scales = nullptr)
+            {
+                uint64_t weightsFingerprint = 0;
+                ImageInference::types::ScalarType type = ImageInference::types::ScalarType::Undefined;
+                ImageInference::types::KernelLayout layout = ImageInference::types::KernelLayout::OIHW;
+                switch (weights.scalar_type())
+                {
+                case exec_aten::ScalarType::Float:
+                    layout = getLayout<float>(weights);
+                    type = getComputeType<float>(weights, layout, ImageInference::types::ScalarType::Float);
+                    weightsFingerprint = sampledFingerprint<float>(weights);
+                    break;
+                default:
+                    ET_CHECK_MSG(false, "Unsupported scalar type");
+                    break;
+                }
+
+                // The int8 model always quantizes the weights, which are given as float.
+                uint64_t scalesFingerprint = 0;
+                if (scales != nullptr)
+                {
+                    type = ImageInference::types::ScalarType::Int8;
+                    scalesFingerprint = fingerprint<float>(*scales);
+                }
+                ET_CHECK_MSG(
+                    type != ImageInference::types::ScalarType::Int8 || scales != nullptr,
+                    "Expected the scales of the activations for weights exported for Int8, use baremetal_ops::resnet50_int8 instead");
+
+                const CacheKey key{weights.const_data_ptr(), weights.scalar_type(), static_cast<size_t>(weights.numel()), weightsFingerprint,
+                                   scales != nullptr, scalesFingerprint};
+
+                std::lock_guard<std::mutex> lock(cacheMutex);
+                cacheUses++;
+                auto cached = cache.find(key);
+                if (cached != cache.end())
+                {
+                    cached->second.lastUse = cacheUses;
+                    return cached->second.model;
+                }
+
+                // Models of the address with another fingerprint were prepared for weights that are no longer there.
+                for (auto stale = cache.begin(); stale != cache.end();)
+                {
+                    if (stale->first.weightsData == key.weightsData && stale->first.weightsFingerprint != key.weightsFingerprint)
+                    {
+                        stale = cache.erase(stale);
+                    }
+                    else
+                    {
+                        stale++;
+                    }
+                }
+
+                if (cache.size() >= RESNET50_CACHED_MODELS)
+                {
+                    cache.erase(std::min_element(cache.begin(), cache.end(),
+                                                 [](const auto &a, const auto &b)
+                                                 { return a.second.lastUse < b.second.lastUse; }));
+                }
+
+                // Blocked kernels are used in place and therefore point into the weights tensor of the program,
+                // which resnet50_invalidate drops the model of before the weights are freed. Only the derived buffers e.g.
+                // the folded biases and the kernels converted into the compute type are owned by the model.
+                std::vector<void *> raw_weights = std::vector<void *>(weightsCount);
+                if (weights.scalar_type() == exec_aten::ScalarType::Float)
+                {
+                    expandToTensorList<float>(weights.mutable_data_ptr<float>(), raw_weights, layout);
+                }
+
+                std::shared_ptr<ResNet50> model;
+                if (scales != nullptr)
+                {
+                    model = std::make_shared<ResNet50>(raw_weights, ImageInference::model::ResNet50Calibration(scales->const_data_ptr<float>()), layout);
+                }
+                else
+                {
+                    model = std::make_shared<ResNet50>(raw_weights, type, layout);
+                }
+                cache[key] = CachedModel{model, cacheUses};
+                return model;
+            }
         } // namespace
 
-        Tensor &resnet50_out_impl(const Tensor &in, const Tensor &weights, Tensor &out)
+        void resnet50_invalidate(const Tensor &weights)
         {
-            std::vector<void *> raw_weights = std::vector<void *>(weightsCount);
+            const void *weightsData = weights.const_data_ptr();
 
-            ImageInference::types::ScalarType type = ImageInference::types::ScalarType::Undefined;
-            switch (weights.scalar_type())
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            for (auto cached = cache.begin(); cached != cache.end();)
             {
-            case exec_aten::ScalarType::Float:
-                type = ImageInference::types::ScalarType::Float;
-                expandToTensorList<float>(weights, raw_weights);
-                break;
-            default:
-                ET_CHECK_MSG(false, "Unsupported scalar type");
-                break;
+                if (cached->first.weightsData == weightsData)
+                {
+                    // Invocations that still run keep their model alive until they are done.
+                    cached = cache.erase(cached);
+                }
+                else
+                {
+                    cached++;
+                }
             }
+        }
+
+        Tensor &resnet50_invalidate_out_impl(const Tensor &weights, Tensor &out)
+        {
+            resnet50_invalidate(weights);
+            return out;
+        }
 
+        Tensor &resnet50_invalidate_out_impl(RuntimeContext &ctx, const Tensor &weights, Tensor &out)
+        {
+            (void)ctx;
+            resnet50_invalidate_out_impl(weights, out);
+            return out;
+        }
+
+        Tensor &resnet50_out_impl(const Tensor &in, const Tensor &weights, Tensor &out)
+        {
             check_preconditions(in, weights, out);
 
-            ResNet50 resnet50 = ResNet50(raw_weights, type);
+            std::shared_ptr<ResNet50> resnet50 = getModel(weights);
 
-            if (resnet50.getType() == ImageInference::types::ScalarType::Float)
+            if (resnet50->getType() == ImageInference::types::ScalarType::Float ||
+                resnet50->getType() == ImageInference::types::ScalarType::BFloat16)
             {
-                // Float
+                // Float, BFloat16 keeps the stem and the classifier in float
                 float *out_data = out.mutable_data_ptr<float>();
                 const float *in_data = in.const_data_ptr<float>();
 
-                resnet50.inference(in_data, out_data);
+                resnet50->inference(in_data, out_data, in.size(0));
             }
 
             return out;
@@ -389,5 +667,28 @@ namespace custom
             resnet50_out_impl(in, weights, out);
             return out;
         }
+
+        Tensor &resnet50_int8_out_impl(const Tensor &in, const Tensor &weights, const Tensor &scales, Tensor &out)
+        {
+            check_preconditions(in, weights, out);
+            check_scales(scales);
+
+            std::shared_ptr<ResNet50> resnet50 = getModel(weights, &scales);
+
+            // Int8 keeps the stem and the classifier in float as well
+            float *out_data = out.mutable_data_ptr<float>();
+            const float *in_data = in.const_data_ptr<float>();
+
+            resnet50->inference(in_data, out_data, in.size(0));
+
+            return out;
+        }
+
+        Tensor &resnet50_int8_out_impl(RuntimeContext &ctx, const Tensor &in, const Tensor &weights, const Tensor &scales, Tensor &out)
+        {
+            (void)ctx;
+            resnet50_int8_out_impl(in, weights, scales, out);
+            return out;
+        }
     } // namespace native
 } // namespace custom
\ No newline at end of file
@@ -19,6 +19,8 @@
 #include "model/ResNet50.h"
 #include <string>
 
+#define RESNET50_CACHED_MODELS 4 // Upper bound of the prepared models that are shared between op invocations
+
 namespace custom
 {
     namespace native
@@ -30,9 +32,26 @@ namespace custom
         using ImageInference::model::ResNet50;
         using torch::executor::RuntimeContext;
 
+        /// @brief Runs the model prepared for the weights. The prepared models are cached by the data pointer of the weights
+        /// and are reused by the next invocations with the same weights, see resnet50_invalidate.
         Tensor &resnet50_out_impl(const Tensor &in, const Tensor &weights, Tensor &out);
 
         Tensor &resnet50_out_impl(RuntimeContext &ctx, const Tensor &in, const Tensor &weights, Tensor &out);
+
+        /// @brief The int8 model, which quantizes the float weights while it is prepared.
+        /// @param scales The ImageInference::model::ResNet50Calibration::size scales of the activations as float.
+        Tensor &resnet50_int8_out_impl(const Tensor &in, const Tensor &weights, const Tensor &scales, Tensor &out);
+
+        Tensor &resnet50_int8_out_impl(RuntimeContext &ctx, const Tensor &in, const Tensor &weights, const Tensor &scales, Tensor &out);
+
+        /// @brief Drops the cached models prepared for the weights. The cache does not read the weights again once it prepared
+        /// their model, so this needs to be called after the weights are updated in place or before they are freed.
+        void resnet50_invalidate(const Tensor &weights);
+
+        /// @brief The op of resnet50_invalidate for programs, which returns out unchanged.
+        Tensor &resnet50_invalidate_out_impl(const Tensor &weights, Tensor &out);
+
+        Tensor &resnet50_invalidate_out_impl(RuntimeContext &ctx, const Tensor &weights, Tensor &out);
     } // namespace native
 } // namespace custom
 
@@ -5,9 +5,22 @@
 import torch
 from torchvision import models
 from torchvision.models._api import WeightsEnum
-from typing import Dict, Optional
+from typing import Dict, Iterable, List, Optional
 from torch.nn.parameter import Parameter
 
+# Must match the defines in model/ResNet50Weights.h
+BLOCKED_WEIGHTS_MAGIC = 7225050
+BLOCKED_WEIGHTS_LAYOUT_VERSION = 2
+BLOCKED_WEIGHTS_HEADER_SIZE = 16
+
+# Must match ImageInference::types::ScalarType in types/ScalarTypes.h
+SCALAR_TYPE_FLOAT = 1
+SCALAR_TYPE_BFLOAT16 = 2
+SCALAR_TYPE_INT8 = 3
+
+# Must match the layers of ImageInference::model::ResNet50Calibration in model/ResNet50Calibration.h
+CALIBRATION_LAYER_BOTTLENECKS = [3, 4, 6, 3]
+
 
 def getResnet50Weights(weights: WeightsEnum) -> Dict[str, Optional[Parameter]]:
     def getMeanAndVar(bn, name) -> dict[str, Optional[Parameter]]:
@@ -51,25 +64,207 @@ def getResnet50Weights(weights: WeightsEnum) -> Dict[str, Optional[Parameter]]:
     return parameters
 
 
-def compressParameters(parameters: Dict[str, Optional[Parameter]]) -> Dict[str, Optional[Parameter]]:
+def blockKernel(weight: torch.Tensor, blockSize: int) -> torch.Tensor:
+    """
+    Converts a convolution weight from Count x Channel x Height x Width into the blocked format
+    CountBlocks x ChannelBlocks x Height x Width x ChannelElements x CountElements used by types::Kernel.
+    A dimension that is not a multiple of the block size is used as a single block e.g. the 3 input channels of conv1.
+
+    Args:
+        weight (torch.Tensor): The convolution weight to convert.
+        blockSize (int): The block size i.e. RESNET50_BLOCK_SIZE of the runtime.
+
+    Returns:
+        torch.Tensor: The blocked weight.
+    """
+
+    count, channels, height, width = weight.shape
+    blockSizeCount = blockSize if count % blockSize == 0 else count
+    blockSizeChannel = blockSize if channels % blockSize == 0 else channels
+    return (weight.view(count // blockSizeCount, blockSizeCount, channels // blockSizeChannel, blockSizeChannel, height, width)
+            .permute(0, 2, 4, 5, 3, 1)
+            .contiguous())
+
+
+def batchNormName(convName: str) -> str:
+    """
+    Returns the name of the batch norm that follows the convolution e.g. layer1.0.conv2.weight -> layer1.0.bn2.
+
+    Args:
+        convName (str): The name of the convolution weight.
+
+    Returns:
+        str: The name of the batch norm.
+    """
+
+    base = convName[:-len(".weight")]
+    if base.endswith("downsample.0"):
+        return base[:-1] + "1"
+    prefix, _, conv = base.rpartition(".")
+    bn = conv.replace("conv", "bn")
+    return f"{prefix}.{bn}" if prefix else bn
+
+
+def foldBatchNorm(weight: torch.Tensor, parameters: Dict[str, Optional[Parameter]], bnName: str) -> torch.Tensor:
+    """
+    Multiplies the scale gamma / sqrt(variance + eps) of the batch norm into the convolution weight.
+    The runtime computes the remaining bias from the unchanged batch norm parameters.
+
+    Args:
+        weight (torch.Tensor): The convolution weight in Count x Channel x Height x Width.
+        parameters (Dict[str, Optional[Parameter]]): All parameters of the model.
+        bnName (str): The name of the batch norm that follows the convolution.
+
+    Returns:
+        torch.Tensor: The folded weight.
+    """
+
+    gamma = parameters[f"{bnName}.weight"].data
+    variance = parameters[f"{bnName}.running_var"].data
+    scale = gamma / torch.sqrt(variance + 1e-5)
+    return weight * scale.view(-1, 1, 1, 1)
+
+
+def compressParameters(parameters: Dict[str, Optional[Parameter]], blockSize: Optional[int] = None, scalarType: int = SCALAR_TYPE_FLOAT) -> Dict[str, Optional[Parameter]]:
     """
     Compress all parameters into a single parameter with the key 'weight'
 
     Args:
         parameters (Dict[str, Optional[Parameter]]): The parameters to compress.
+        blockSize (Optional[int]): If set, the convolution weights are folded with their batch norm and stored in the blocked kernel
+            layout for this block size. A header with the layout version and block size is put in front, so the runtime can use them without copying.
+        scalarType (int): The scalar type the runtime computes in, stored in the header of blocked weights. The weights themselves stay float32
+            and are converted by the runtime, e.g. to BFloat16 with SCALAR_TYPE_BFLOAT16.
 
     Returns:
         Dict[str, Optional[Parameter]]: The compressed parameters with key 'weight'.
     """
 
-    total_length = sum(param.numel() for param in parameters.values())
-    weightCompressed = torch.empty(total_length, dtype=torch.float32)
-    offset = 0
-    for param in parameters.values():
+    headerSize = BLOCKED_WEIGHTS_HEADER_SIZE if blockSize is not None else 0
+    total_length = headerSize + sum(param.numel() for param in parameters.values())
+    weightCompressed = torch.zeros(total_length, dtype=torch.float32)
+    if blockSize is not None:
+        weightCompressed[0] = BLOCKED_WEIGHTS_MAGIC
+        weightCompressed[1] = BLOCKED_WEIGHTS_LAYOUT_VERSION
+        weightCompressed[2] = blockSize
+        weightCompressed[3] = scalarType
+    elif scalarType != SCALAR_TYPE_FLOAT:
+        raise ValueError("Only blocked weights can store a scalar type other than float")
+
+    offset = headerSize
+    for name, param in parameters.items():
         numel = param.numel()
-        weightCompressed[offset: offset + numel] = param.data.view([param.numel()])
+        data = param.data
+        if blockSize is not None and data.dim() == 4:
+            data = blockKernel(foldBatchNorm(data, parameters, batchNormName(name)), blockSize)
+        weightCompressed[offset: offset + numel] = data.reshape([numel])
         offset += numel
 
     weightCompressed = weightCompressed.contiguous().clone().detach()
 
     return {"weight": Parameter(weightCompressed)}
+
+
+def calibrationNames() -> List[str]:
+    """
+    Returns the names of the activations of the int8 model in the order of ImageInference::model::ResNet50Calibration:
+    maxpool for the output of the stem, then layerL.I.conv1, layerL.I.conv2 and layerL.I for every bottleneck.
+
+    Returns:
+        List[str]: The names of the activations.
+    """
+
+    names = ["maxpool"]
+    for layer, bottlenecks in enumerate(CALIBRATION_LAYER_BOTTLENECKS):
+        for bottleneck in range(bottlenecks):
+            module = f"layer{layer + 1}.{bottleneck}"
+            names += [f"{module}.conv1", f"{module}.conv2", module]
+    return names
+
+
+def calibrateActivations(resnet50: torch.nn.Module, images: Iterable[torch.Tensor]) -> torch.Tensor:
+    """
+    Runs the images through the float model and returns the scale of every activation of the int8 model,
+    which is the largest value seen divided by 255. All activations follow a relu, so they are quantized without a zero point.
+
+    Args:
+        resnet50 (torch.nn.Module): The float model of torchvision in eval mode.
+        images (Iterable[torch.Tensor]): The batches of calibration images in N x 3 x 224 x 224.
+
+    Returns:
+        torch.Tensor: The scales in the order of calibrationNames.
+    """
+
+    maxima: Dict[str, float] = {name: 0.0 for name in calibrationNames()}
+
+    def record(name: str, relu: bool):
+        def hook(module, inputs, output):
+            value = torch.relu(output) if relu else output
+            maxima[name] = max(maxima[name], value.max().item())
+        return hook
+
+    # The relu of the first two convolutions of a bottleneck is applied in place after bn1 and bn2.
+    handles = [resnet50.maxpool.register_forward_hook(record("maxpool", False))]
+    for layer, bottlenecks in enumerate(CALIBRATION_LAYER_BOTTLENECKS):
+        for bottleneck in range(bottlenecks):
+            module = f"layer{layer + 1}.{bottleneck}"
+            block = getattr(resnet50, f"layer{layer + 1}")[bottleneck]
+            handles.append(block.bn1.register_forward_hook(record(f"{module}.conv1", True)))
+            handles.append(block.bn2.register_forward_hook(record(f"{module}.conv2", True)))
+            handles.append(block.register_forward_hook(record(module, False)))
+
+    try:
+        with torch.no_grad():
+            for image in images:
+                resnet50(image)
+    finally:
+        for handle in handles:
+            handle.remove()
+
+    # An activation that stayed zero keeps a scale of 1, the runtime needs positive scales.
+    return torch.tensor([maxima[name] / 255 if maxima[name] > 0 else 1.0 for name in calibrationNames()], dtype=torch.float32)
+
+
+def writeCalibration(path: str, scales: torch.Tensor):
+    """
+    Writes the scales into a calibration file, which ImageInference::model::ResNet50Calibration::load reads.
+    Every line is the name of an activation followed by its scale.
+
+    Args:
+        path (str): The path of the calibration file.
+        scales (torch.Tensor): The scales in the order of calibrationNames.
+    """
+
+    with open(path, "w") as file:
+        file.write("# activation scale\n")
+        for name, scale in zip(calibrationNames(), scales.tolist()):
+            file.write(f"{name} {scale:.9g}\n")
+
+
+def readCalibration(path: str) -> torch.Tensor:
+    """
+    Reads the scales of a calibration file, see writeCalibration.
+
+    Args:
+        path (str): The path of the calibration file.
+
+    Returns:
+        torch.Tensor: The scales in the order of calibrationNames.
+    """
+
+    names = calibrationNames()
+    scales: Dict[str, float] = {}
+    with open(path) as file:
+        for line in file:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            name, scale = line.split()
+            if name not in names:
+                raise ValueError(f"The calibration file {path} names the unknown activation {name}")
+            scales[name] = float(scale)
+
+    missing = [name for name in names if name not in scales]
+    if missing:
+        raise ValueError(f"The calibration file {path} misses the activations {', '.join(missing)}")
+    return torch.tensor([scales[name] for name in names], dtype=torch.float32)
@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#include "ActivationArena.h"
+#include <algorithm>
+#include <iostream>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+
+ImageInference::model::ActivationArena::~ActivationArena()
+{
+    if (data != nullptr)
+    {
+        operator delete[](data, std::align_val_t(alignment));
+    }
+}
+
+size_t ImageInference::model::ActivationArena::add(size_t size, size_t firstStep, size_t lastStep)
+{
+    if (data != nullptr)
+    {
+        std::cerr << "ActivationArena (" << this << "): Can not add an activation after planning." << std::endl;
+        throw std::runtime_error("ActivationArena: Can not add an activation after planning!");
+    }
+
+    if (firstStep > lastStep)
+    {
+        std::cerr << "ActivationArena (" << this << "): The activation ends before it starts. First: " << firstStep
+                  << " Last: " << lastStep << std::endl;
+        throw std::runtime_error("ActivationArena: The activation ends before it starts!");
+    }
+
+    allocations.push_back(Allocation{size, firstStep, lastStep, 0});
+    return allocations.size() - 1;
+}
+
+void ImageInference::model::ActivationArena::plan()
+{
+    if (data != nullptr)
+    {
+        return;
+    }
+
+    // Greedy by size: the largest activations are placed first,
+    // each at the lowest offset that does not collide with an already placed activation that is alive at the same time.
+    std::vector<size_t> order(allocations.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b)
+                     { return allocations[a].size > allocations[b].size; });
+
+    std::vector<size_t> placed;
+    for (size_t id : order)
+    {
+        auto &allocation = allocations[id];
+
+        std::vector<size_t> alive;
+        for (size_t other : placed)
+        {
+            if (allocations[other].firstStep <= allocation.lastStep && allocation.firstStep <= allocations[other].lastStep)
+            {
+                alive.push_back(other);
+            }
+        }
+        std::sort(alive.begin(), alive.end(), [this](size_t a, size_t b)
+                  { return allocations[a].offset < allocations[b].offset; });
+
+        size_t offset = 0;
+        for (size_t other : alive)
+        {
+            if (offset + allocation.size <= allocations[other].offset)
+            {
+                break;
+            }
+            offset = std::max(offset, (allocations[other].offset + allocations[other].size + alignment - 1) / alignment * alignment);
+        }
+
+        allocation.offset = offset;
+        dataSize = std::max(dataSize, offset + allocation.size);
+        placed.push_back(id);
+    }
+
+    dataSize = (dataSize + alignment - 1) / alignment * alignment;
+    data = new (std::align_val_t(alignment)) unsigned char[std::max(dataSize, alignment)];
+}
+
+void *ImageInference::model::ActivationArena::get(size_t id) const
+{
+    if (data == nullptr || id >= allocations.size())
+    {
+        std::cerr << "ActivationArena (" << this << "): The activation " << id << " is not planned." << std::endl;
+        throw std::runtime_error("ActivationArena: The activation is not planned!");
+    }
+
+    return data + allocations[id].offset;
+}
+
+size_t ImageInference::model::ActivationArena::getSize(size_t id) const
+{
+    return allocations.at(id).size;
+}
+
+size_t ImageInference::model::ActivationArena::getArenaSize() const
+{
+    return dataSize;
+}
+
+size_t ImageInference::model::ActivationArena::getTotalSize() const
+{
+    size_t total = 0;
+    for (const auto &allocation : allocations)
+    {
+        total += allocation.size;
+    }
+    return total;
+}
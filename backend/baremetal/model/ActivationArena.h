@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef IMAGEINFERENCE_ACTIVATIONARENA_H
+#define IMAGEINFERENCE_ACTIVATIONARENA_H
+
+#include <stddef.h>
+#include <vector>
+
+namespace ImageInference
+{
+    namespace model
+    {
+        /// @brief Places the activations of a fixed graph into one preallocated buffer.
+        ///
+        /// Every activation is added with the steps of the graph in which it is alive.
+        /// Activations whose lifetimes do not overlap share the same memory,
+        /// so a forward pass does not allocate and the peak memory is the largest set of activations alive at once.
+        class ActivationArena
+        {
+        private:
+            struct Allocation
+            {
+                size_t size;
+                size_t firstStep;
+                size_t lastStep;
+                size_t offset;
+            };
+
+            std::vector<Allocation> allocations;
+            unsigned char *data = nullptr;
+            size_t dataSize = 0;
+
+        public:
+            /// @brief Every allocation starts at a page so the images keep the alignment of their own allocation.
+            static constexpr const size_t alignment = 4096;
+
+            ActivationArena() = default;
+            ~ActivationArena();
+
+            ActivationArena(const ActivationArena &) = delete;
+            ActivationArena &operator=(const ActivationArena &) = delete;
+
+            /// @brief Adds an activation which is alive from firstStep to lastStep, both inclusive.
+            /// @param size The size in bytes.
+            /// @return The id of the activation, used with get.
+            size_t add(size_t size, size_t firstStep, size_t lastStep);
+
+            /// @brief Assigns the offsets and allocates the buffer, no activation can be added afterwards.
+            void plan();
+
+            /// @brief Gets the memory of the activation, only valid after plan.
+            void *get(size_t id) const;
+
+            /// @brief The size in bytes of the activation.
+            size_t getSize(size_t id) const;
+
+            /// @brief The size in bytes of the buffer, which is the peak activation memory.
+            size_t getArenaSize() const;
+
+            /// @brief The size in bytes of all activations if none would share memory.
+            size_t getTotalSize() const;
+        };
+    } // namespace model
+} // namespace ImageInference
+
+#endif // IMAGEINFERENCE_ACTIVATIONARENA_H
@@ -0,0 +1,167 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#include "GemmKernels.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+bool ImageInference::model::GemmShape::operator==(const GemmShape &other) const
+{
+    return m == other.m && n == other.n && k == other.k &&
+           lda == other.lda && ldb == other.ldb && ldc == other.ldc &&
+           datatype == other.datatype && betaZero == other.betaZero &&
+           batchReduce == other.batchReduce;
+}
+
+std::ostream &ImageInference::model::operator<<(std::ostream &stream, const GemmShape &shape)
+{
+    return stream << "m:= " << shape.m << " n:= " << shape.n << " k:= " << shape.k
+                  << " lda:= " << shape.lda << " ldb:= " << shape.ldb << " ldc:= " << shape.ldc
+                  << " beta:= " << (shape.betaZero ? 0 : 1)
+                  << " batchReduce:= " << static_cast<int>(shape.batchReduce);
+}
+
+bool ImageInference::model::GemmKernels::add(const GemmShape &shape)
+{
+    if (find(shape) != NULL)
+    {
+        return true;
+    }
+
+    for (const auto &failure : failures)
+    {
+        if (failure == shape)
+        {
+            return false;
+        }
+    }
+
+    libxsmm_gemmfunction kernel = dispatch(shape, (libxsmm_bitfield)(LIBXSMM_PREFETCH)); // Default from libxsmm_sgemm
+    if (kernel == NULL)
+    {
+        kernel = dispatch(shape, (libxsmm_bitfield)(LIBXSMM_GEMM_PREFETCH_NONE));
+        if (kernel == NULL)
+        {
+            failures.push_back(shape);
+            return false;
+        }
+
+        fallbacks.push_back(shape);
+    }
+
+    shapes.push_back(shape);
+    kernels.push_back(kernel);
+    return true;
+}
+
+libxsmm_gemmfunction ImageInference::model::GemmKernels::find(const GemmShape &shape) const
+{
+    for (size_t i = 0; i < shapes.size(); i++)
+    {
+        if (shapes[i] == shape)
+        {
+            return kernels[i];
+        }
+    }
+
+    return NULL;
+}
+
+const std::vector<ImageInference::model::GemmShape> &ImageInference::model::GemmKernels::getFallbacks() const
+{
+    return fallbacks;
+}
+
+const std::vector<ImageInference::model::GemmShape> &ImageInference::model::GemmKernels::getFailures() const
+{
+    return failures;
+}
+
+size_t ImageInference::model::GemmKernels::size() const
+{
+    return shapes.size();
+}
+
+void ImageInference::model::GemmKernels::report(std::ostream &stream) const
+{
+    for (const auto &shape : fallbacks)
+    {
+        stream << "GemmKernels: using a kernel without prefetching for " << shape << std::endl;
+    }
+
+    for (const auto &shape : failures)
+    {
+        stream << "GemmKernels: no kernel could be generated for " << shape << std::endl;
+    }
+}
+
+libxsmm_gemmfunction ImageInference::model::GemmKernels::get(const GemmKernels *gemmKernels, const GemmShape &shape, const char *caller)
+{
+    libxsmm_gemmfunction kernel = NULL;
+    if (gemmKernels != nullptr)
+    {
+        kernel = gemmKernels->find(shape);
+    }
+
+    if (kernel == NULL)
+    {
+        kernel = dispatch(shape, (libxsmm_bitfield)(LIBXSMM_PREFETCH)); // Default from libxsmm_sgemm
+    }
+
+    if (kernel == NULL)
+    {
+        std::cerr << caller << ": libxsmm_dispatch_gemm failed! " << shape << std::endl;
+        throw std::runtime_error(std::string(caller) + ": libxsmm_dispatch_gemm failed!");
+    }
+
+    return kernel;
+}
+
+libxsmm_gemmfunction ImageInference::model::GemmKernels::dispatch(const GemmShape &shape, libxsmm_bitfield prefetch)
+{
+    // BFloat16 is only used for the inputs, the products are summed and stored in float.
+    // Int8 multiplies the signed weights with the unsigned activations that follow a relu, the products are summed and stored in int32.
+    // Both are stored in the VNNI layout of the weights, see ImageInference::types::Kernel::vnni.
+    const bool bfloat16 = shape.datatype == LIBXSMM_DATATYPE_BF16;
+    const bool int8 = shape.datatype == LIBXSMM_DATATYPE_I8;
+    const libxsmm_datatype accumulator = bfloat16 ? LIBXSMM_DATATYPE_F32 : (int8 ? LIBXSMM_DATATYPE_I32 : shape.datatype);
+    const libxsmm_gemm_shape gemmShape = libxsmm_create_gemm_shape(
+        shape.m /*required*/,
+        shape.n /*required*/,
+        shape.k /*required*/,
+        shape.lda /*lda*/,
+        shape.ldb /*ldb*/,
+        shape.ldc /*ldc*/,
+        shape.datatype, // input type
+        shape.datatype, // input type
+        accumulator,    // output type
+        accumulator     // compute type
+    );
+    libxsmm_bitfield flags = LIBXSMM_GEMM_FLAGS('N', 'N');
+    if (bfloat16 || int8)
+    {
+        flags |= LIBXSMM_GEMM_FLAG_VNNI_A;
+    }
+    if (int8)
+    {
+        flags |= LIBXSMM_GEMM_FLAG_B_UNSIGNED;
+    }
+    if (shape.betaZero)
+    {
+        flags |= LIBXSMM_GEMM_FLAG_BETA_0;
+    }
+
+    if (shape.batchReduce != LIBXSMM_GEMM_BATCH_REDUCE_NONE)
+    {
+        libxsmm_gemm_batch_reduce_config batchReduceConfig;
+        batchReduceConfig.br_type = shape.batchReduce;
+        batchReduceConfig.br_stride_a_hint = 0;
+        batchReduceConfig.br_stride_b_hint = 0;
+        batchReduceConfig.br_unroll_hint = 0;
+        return libxsmm_dispatch_brgemm(gemmShape, flags, prefetch, batchReduceConfig);
+    }
+
+    return libxsmm_dispatch_gemm(gemmShape, flags, prefetch);
+}
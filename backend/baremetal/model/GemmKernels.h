@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef IMAGEINFERENCE_GEMMKERNELS_H
+#define IMAGEINFERENCE_GEMMKERNELS_H
+
+#include <vector>
+#include <ostream>
+#ifdef LIBXSMM_AS_HEADER_ONLY
+#include <libxsmm_source.h>
+#else
+#include <libxsmm.h>
+#include <libxsmm_gemm.h>
+#include <libxsmm_typedefs.h>
+#endif // LIBXSMM_AS_HEADER_ONLY
+
+namespace ImageInference
+{
+    namespace model
+    {
+        /// @brief The shape of a column major gemm C[m x n] += A[m x k] * B[k x n] without transposition.
+        struct GemmShape
+        {
+            int m;
+            int n;
+            int k;
+            int lda;
+            int ldb;
+            int ldc;
+            /// @brief The type of A and B. BFloat16 gemms read A in the VNNI layout of types::Kernel and accumulate into C of float.
+            libxsmm_datatype datatype;
+            /// @brief Overwrite C with C[m x n] = A[m x k] * B[k x n] instead of accumulating into it.
+            bool betaZero = false;
+            /// @brief Sum a batch of gemms into C in a single call, with A and B addressed by the byte offsets passed at call time.
+            libxsmm_gemm_batch_reduce_type batchReduce = LIBXSMM_GEMM_BATCH_REDUCE_NONE;
+
+            bool operator==(const GemmShape &other) const;
+        };
+
+        std::ostream &operator<<(std::ostream &stream, const GemmShape &shape);
+
+        /// @brief A table of gemm kernels that are dispatched once up front,
+        /// so the layers only need to look up a ready kernel instead of dispatching it on every call.
+        class GemmKernels
+        {
+        private:
+            std::vector<GemmShape> shapes;
+            std::vector<libxsmm_gemmfunction> kernels;
+            std::vector<GemmShape> fallbacks;
+            std::vector<GemmShape> failures;
+
+        public:
+            /// @brief Dispatches the kernel for the shape if it is not in the table yet.
+            /// If the kernel can not be generated with prefetching it falls back to a kernel without prefetching.
+            /// @param shape The shape of the gemm.
+            /// @return True if a kernel is available for the shape.
+            bool add(const GemmShape &shape);
+
+            /// @brief Looks up the kernel for the shape.
+            /// @return The kernel or NULL if the shape was not added or failed.
+            libxsmm_gemmfunction find(const GemmShape &shape) const;
+
+            /// @brief The shapes that needed a kernel without prefetching.
+            const std::vector<GemmShape> &getFallbacks() const;
+
+            /// @brief The shapes for which no kernel could be generated.
+            const std::vector<GemmShape> &getFailures() const;
+
+            size_t size() const;
+
+            /// @brief Writes the fallbacks and failures of the table.
+            void report(std::ostream &stream) const;
+
+            /// @brief Gets the kernel for the shape from the table or dispatches it if the table is not given or misses the shape.
+            /// @param gemmKernels The table to look up, can be nullptr.
+            /// @param shape The shape of the gemm.
+            /// @param caller The name used in the error message.
+            /// @return The kernel, throws if no kernel could be generated.
+            static libxsmm_gemmfunction get(const GemmKernels *gemmKernels, const GemmShape &shape, const char *caller);
+
+            /// @brief Dispatches the kernel for the shape from libxsmm.
+            /// @return The kernel or NULL if it could not be generated.
+            static libxsmm_gemmfunction dispatch(const GemmShape &shape, libxsmm_bitfield prefetch);
+        };
+    } // namespace model
+} // namespace ImageInference
+
+#endif // IMAGEINFERENCE_GEMMKERNELS_H
@@ -27,6 +27,12 @@ namespace ImageInference
             /// @param input The input data to the model.
             /// @return The output data from the model.
             virtual void inference(const T *input, T* output) = 0;
+
+            /// @brief Do a forward pass through the model for a batch of inputs.
+            /// @param input The inputs of the batch, one after another.
+            /// @param output The outputs of the batch, one after another.
+            /// @param batch The number of inputs.
+            virtual void inference(const T *input, T *output, size_t batch) = 0;
         };
     } // namespace model
 } // namespace ImageInference
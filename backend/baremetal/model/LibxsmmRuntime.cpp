@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#include "LibxsmmRuntime.h"
+
+std::mutex ImageInference::model::LibxsmmRuntime::mutex;
+std::weak_ptr<ImageInference::model::LibxsmmRuntime> ImageInference::model::LibxsmmRuntime::instance;
+size_t ImageInference::model::LibxsmmRuntime::alive = 0;
+
+ImageInference::model::LibxsmmRuntime::LibxsmmRuntime()
+{
+    if (alive++ == 0)
+    {
+        libxsmm_init();
+    }
+    targetArchId = libxsmm_get_target_archid();
+}
+
+ImageInference::model::LibxsmmRuntime::~LibxsmmRuntime()
+{
+    // A concurrent acquire may already have created the next runtime after the weak reference expired.
+    // Only the last alive runtime finalizes libxsmm, in the same critical section that counts it.
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--alive == 0)
+    {
+        libxsmm_finalize();
+    }
+}
+
+std::shared_ptr<ImageInference::model::LibxsmmRuntime> ImageInference::model::LibxsmmRuntime::acquire()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::shared_ptr<LibxsmmRuntime> runtime = instance.lock();
+    if (runtime == nullptr)
+    {
+        // The constructor is private, therefore std::make_shared can not be used.
+        runtime = std::shared_ptr<LibxsmmRuntime>(new LibxsmmRuntime());
+        instance = runtime;
+    }
+
+    return runtime;
+}
+
+int ImageInference::model::LibxsmmRuntime::getTargetArchId() const
+{
+    return targetArchId;
+}
+
+const char *ImageInference::model::LibxsmmRuntime::getTargetArchName() const
+{
+    return libxsmm_cpuid_name(targetArchId);
+}
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef IMAGEINFERENCE_LIBXSMMRUNTIME_H
+#define IMAGEINFERENCE_LIBXSMMRUNTIME_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#ifdef LIBXSMM_AS_HEADER_ONLY
+#include <libxsmm_source.h>
+#else
+#include <libxsmm.h>
+#endif // LIBXSMM_AS_HEADER_ONLY
+
+namespace ImageInference
+{
+    namespace model
+    {
+        /// @brief Owns the process wide initialization of libxsmm.
+        ///
+        /// Every model holds a reference to the runtime. libxsmm is initialized when the first reference is acquired
+        /// and finalized when the last reference is released, so the JIT code cache survives as long as any model is alive
+        /// and one model can not finalize the library under another one.
+        ///
+        /// The weak reference to the runtime expires before its destructor runs, so an acquire in between creates a new runtime
+        /// while the old one is still alive. Therefore libxsmm is initialized and finalized by the count of the alive runtimes,
+        /// which only changes under the mutex.
+        class LibxsmmRuntime
+        {
+        private:
+            static std::mutex mutex;
+            static std::weak_ptr<LibxsmmRuntime> instance;
+            /// @brief The runtimes that are constructed and not yet destructed, guarded by the mutex.
+            static size_t alive;
+
+            int targetArchId;
+
+            /// @brief Initializes libxsmm if no other runtime is alive, must be called under the mutex.
+            LibxsmmRuntime();
+
+        public:
+            ~LibxsmmRuntime();
+
+            LibxsmmRuntime(const LibxsmmRuntime &) = delete;
+            LibxsmmRuntime &operator=(const LibxsmmRuntime &) = delete;
+
+            /// @brief Returns the runtime and initializes libxsmm if no runtime is alive.
+            /// @return Either the alive runtime or a new one, if every reference to the previous runtime is released.
+            static std::shared_ptr<LibxsmmRuntime> acquire();
+
+            /// @brief The architecture libxsmm generates code for e.g. LIBXSMM_X86_AVX512_SKX, detected at initialization.
+            int getTargetArchId() const;
+
+            /// @brief The name of the architecture libxsmm generates code for.
+            const char *getTargetArchName() const;
+        };
+    } // namespace model
+} // namespace ImageInference
+
+#endif // IMAGEINFERENCE_LIBXSMMRUNTIME_H
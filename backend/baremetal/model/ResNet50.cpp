@@ -3,58 +3,228 @@
 // SPDX-License-Identifier: MIT
 
 #include "ResNet50.h"
+#include "ResNet50Weights.h"
 #include <cstring>
 #include <new>
 #include <algorithm>
+#include <optional>
 
-ImageInference::model::ResNet50::ResNet50(const std::vector<void *> &modelWeights, ImageInference::types::ScalarType type)
-    : modelWeights(modelWeights), type(type)
+ImageInference::model::ResNet50::ResNet50(const std::vector<void *> &modelWeights, ImageInference::types::ScalarType type,
+                                          ImageInference::types::KernelLayout layout)
+    : ResNet50(modelWeights, type, layout,
+               layout == ImageInference::types::KernelLayout::Blocked ? ResNet50BlockSizes::uniform(RESNET50_BLOCK_SIZE) : ResNet50Tuning::host())
 {
-    libxsmm_init();
+}
+
+ImageInference::model::ResNet50::ResNet50(const std::vector<void *> &modelWeights, const ResNet50Calibration &calibration,
+                                          ImageInference::types::KernelLayout layout)
+    : ResNet50(modelWeights, ImageInference::types::ScalarType::Int8, layout,
+               layout == ImageInference::types::KernelLayout::Blocked ? ResNet50BlockSizes::uniform(RESNET50_BLOCK_SIZE) : ResNet50Tuning::host(),
+               calibration)
+{
+}
+
+ImageInference::model::ResNet50::ResNet50(const std::vector<void *> &modelWeights, ImageInference::types::ScalarType type,
+                                          ImageInference::types::KernelLayout layout, const ResNet50BlockSizes &blockSizes,
+                                          const ResNet50Calibration &calibration)
+    : modelWeights(modelWeights), type(type), runtime(LibxsmmRuntime::acquire())
+{
+    if (type == ImageInference::types::ScalarType::BFloat16)
+    {
+        weightsBFloat16 = std::make_unique<ResNet50Weights<ImageInference::types::BFloat16>>(modelWeights, layout, blockSizes);
+    }
+    else if (type == ImageInference::types::ScalarType::Int8)
+    {
+        weightsInt8 = std::make_unique<ResNet50Weights<uint8_t>>(modelWeights, layout, blockSizes, calibration);
+    }
+    else
+    {
+        weights = std::make_unique<ResNet50Weights<float>>(modelWeights, layout, blockSizes);
+    }
 }
 
 ImageInference::model::ResNet50::~ResNet50()
 {
-    libxsmm_finalize();
 }
 
 void ImageInference::model::ResNet50::inference(const float *input, float *output)
 {
-    // For a 7x7 kernel we need to add padding of 3.
-    auto image = ImageInference::types::Image<float, 3, 3, 3, 224, 224>(input);
-
-    auto kernel0 = ImageInference::types::Kernel<float, RESNET50_BLOCK_SIZE, 3, 64, 3, 7, 7>(getWeight<float>(weightIndex::conv1_weight));
-    auto batchNorm0 = ImageInference::types::BatchNorm<float, 64>(
-        getWeight<float>(weightIndex::bn1_weight),
-        getWeight<float>(weightIndex::bn1_bias),
-        getWeight<float>(weightIndex::bn1_running_mean),
-        getWeight<float>(weightIndex::bn1_running_var));
-    // For Max Pooling we need padding of 1 as it applies a 3x3 kernel.
-    auto imagePreConv = ImageInference::types::Image<float, 1, RESNET50_BLOCK_SIZE, 64, 112, 112>();
-    convBlock<2>(image, kernel0, batchNorm0, imagePreConv);
-
-    // Next is a 1x1 Kernel. Therefore no padding required.
-    auto imageMax0 = ImageInference::types::Image<float, 0, RESNET50_BLOCK_SIZE, 64, 56, 56>();
-    maxPool<2>(imagePreConv, imageMax0);
-
-    // Blocks
-    auto imageB0 = ImageInference::types::Image<float, 0, RESNET50_BLOCK_SIZE, 256, 56, 56>();
-    block0(imageMax0, imageB0);
-    auto imageB1 = ImageInference::types::Image<float, 0, RESNET50_BLOCK_SIZE, 512, 28, 28>();
-    block1(imageB0, imageB1);
-    auto imageB2 = ImageInference::types::Image<float, 0, RESNET50_BLOCK_SIZE, 1024, 14, 14>();
-    block2(imageB1, imageB2);
-    auto imageB3 = ImageInference::types::Image<float, 0, RESNET50_BLOCK_SIZE, 2048, 7, 7>();
-    block3(imageB2, imageB3);
-
-    // // Output
-    auto imageGAP = ImageInference::types::Image<float, 0, RESNET50_BLOCK_SIZE, 2048, 1, 1>(); // We don't need padding for a fully connected layer.
-    globalAveragePool(imageB3, imageGAP);
-    auto weight = ImageInference::types::Matrix<float, 1000, 2048>(getWeight<float>(weightIndex::fc_weight));
-    auto biasAccumulator = ImageInference::types::Array<float, 1000>(getWeight<float>(weightIndex::fc_bias));
-    auto flatten = imageGAP.flatten();
-    fullyConnectedLayer<RESNET50_BLOCK_SIZE>(flatten, weight, biasAccumulator);
-    std::copy(biasAccumulator.getPointer(), biasAccumulator.getPointer() + biasAccumulator.size, output);
+    inference(input, output, 1);
+}
+
+void ImageInference::model::ResNet50::inference(const float *input, float *output, const size_t batch)
+{
+    inference(input, output, batch, activationsPool);
+}
+
+void ImageInference::model::ResNet50::inference(const float *input, float *output, const size_t batch, ActivationsPool &activationsPool)
+{
+    if (weightsBFloat16)
+    {
+        forward(*weightsBFloat16, activationsPool, input, output, batch);
+    }
+    else if (weightsInt8)
+    {
+        forward(*weightsInt8, activationsPool, input, output, batch);
+    }
+    else
+    {
+        forward(*weights, activationsPool, input, output, batch);
+    }
+}
+
+template <typename T>
+std::vector<std::unique_ptr<ImageInference::model::ResNet50Activations<T>>> &ImageInference::model::ResNet50::ActivationsPool::get()
+{
+    if constexpr (std::is_same_v<T, ImageInference::types::BFloat16>)
+    {
+        return activationsBFloat16;
+    }
+    else if constexpr (std::is_same_v<T, uint8_t>)
+    {
+        return activationsInt8;
+    }
+    else
+    {
+        return activations;
+    }
+}
+
+template <typename T>
+void ImageInference::model::ResNet50::forward(ResNet50Weights<T> &weights, ActivationsPool &activationsPool,
+                                              const float *input, float *output, const size_t batch)
+{
+    constexpr const size_t inputSize = 3 * 224 * 224;
+    constexpr const size_t classes = 1000;
+
+    for (size_t iImage = 0; iImage < batch; iImage += RESNET50_BATCH)
+    {
+        const size_t group = std::min<size_t>(RESNET50_BATCH, batch - iImage);
+
+        // Every image of the group has its own activations, which are all alive until the head read them.
+        std::array<std::unique_ptr<ResNet50Activations<T>>, RESNET50_BATCH> activations;
+        for (size_t iGroup = 0; iGroup < group; iGroup++)
+        {
+            activations[iGroup] = acquireActivations(weights, activationsPool);
+        }
+
+        // Every layer reads the output of the previous one from the activations in the block size of the previous layer.
+        for (size_t iGroup = 0; iGroup < group; iGroup++)
+        {
+            weights.stem->inference(input + (iImage + iGroup) * inputSize, *activations[iGroup], &weights.gemmKernels);
+        }
+        // The layers run every convolution on the whole group, so the weights are read from memory once per group.
+        std::array<ResNet50Activations<T> *, RESNET50_BATCH> activationPtrs;
+        for (size_t iGroup = 0; iGroup < group; iGroup++)
+        {
+            activationPtrs[iGroup] = activations[iGroup].get();
+        }
+        for (auto *layer : {weights.layer1.get(), weights.layer2.get(), weights.layer3.get(), weights.layer4.get()})
+        {
+            layer->inference(activationPtrs.data(), group, &weights.gemmKernels);
+        }
+
+        // The head pools and classifies the group in one pass and writes the logits directly into the output.
+        ResNet50BlockSizes::dispatch(weights.blockSizes.layer4, [&](auto blockSize)
+                                     { dispatchBatch(group, [&](auto batchSize)
+                                                     {
+            using Image = ImageInference::types::Image<T, 0, decltype(blockSize)::value, 2048, 7, 7>;
+            // The views stay on the stack, the optional keeps them from being default constructed as owning images.
+            std::array<std::optional<Image>, decltype(batchSize)::value> images;
+            std::array<Image *, decltype(batchSize)::value> imagePtrs;
+            for (size_t iGroup = 0; iGroup < decltype(batchSize)::value; iGroup++)
+            {
+                imagePtrs[iGroup] = &images[iGroup].emplace(Image::view(activations[iGroup]->get(activations[iGroup]->layer4.back().output)));
+            }
+            if (weights.fcFloat16)
+            {
+                globalAveragePoolFullyConnected(imagePtrs, *weights.fcFloat16, weights.fcBias, output + iImage * classes, &weights.gemmKernels);
+            }
+            else
+            {
+                globalAveragePoolFullyConnected(imagePtrs, weights.fc, weights.fcBias, output + iImage * classes, &weights.gemmKernels);
+            } }); });
+
+        for (size_t iGroup = 0; iGroup < group; iGroup++)
+        {
+            releaseActivations(activationsPool, std::move(activations[iGroup]));
+        }
+    }
+}
+
+template <typename T>
+std::unique_ptr<ImageInference::model::ResNet50Activations<T>> ImageInference::model::ResNet50::acquireActivations(
+    const ResNet50Weights<T> &weights, ActivationsPool &activationsPool)
+{
+    {
+        std::lock_guard<std::mutex> lock(activationsPool.mutex);
+        auto &pooled = activationsPool.get<T>();
+        if (activationsPool.plan != activationsPlan)
+        {
+            pooled.clear();
+            activationsPool.plan = activationsPlan;
+        }
+        if (!pooled.empty())
+        {
+            auto activations = std::move(pooled.back());
+            pooled.pop_back();
+            return activations;
+        }
+    }
+
+    return std::make_unique<ResNet50Activations<T>>(weights.usesWinograd());
+}
+
+template <typename T>
+void ImageInference::model::ResNet50::releaseActivations(ActivationsPool &activationsPool, std::unique_ptr<ResNet50Activations<T>> activations)
+{
+    std::lock_guard<std::mutex> lock(activationsPool.mutex);
+    activationsPool.get<T>().push_back(std::move(activations));
+}
+
+void ImageInference::model::ResNet50::setWinograd(const size_t conv2Index, const bool enabled)
+{
+    if (weightsBFloat16)
+    {
+        weightsBFloat16->setWinograd(conv2Index, enabled);
+    }
+    else if (weightsInt8)
+    {
+        weightsInt8->setWinograd(conv2Index, enabled);
+    }
+    else
+    {
+        weights->setWinograd(conv2Index, enabled);
+    }
+
+    // The pooled activations of every pool are planned for the previous setting and are planned again on the next forward pass.
+    activationsPlan++;
+}
+
+void ImageInference::model::ResNet50::setFloat16Weights(const size_t weightIndex, const bool enabled)
+{
+    // The activations stay in the type of the model, so the pooled activations are still planned correctly.
+    if (weightsBFloat16)
+    {
+        weightsBFloat16->setFloat16(weightIndex, enabled);
+    }
+    else if (weightsInt8)
+    {
+        weightsInt8->setFloat16(weightIndex, enabled);
+    }
+    else
+    {
+        weights->setFloat16(weightIndex, enabled);
+    }
+}
+
+const ImageInference::model::ResNet50BlockSizes &ImageInference::model::ResNet50::getBlockSizes() const
+{
+    if (weightsBFloat16)
+    {
+        return weightsBFloat16->blockSizes;
+    }
+    return weightsInt8 ? weightsInt8->blockSizes : weights->blockSizes;
 }
 
 ImageInference::types::ScalarType ImageInference::model::ResNet50::getType()
@@ -6,6 +6,14 @@
 #define IMAGEINFERENCE_RESNET50_H
 
 #include "IModel.h"
+#include "GemmKernels.h"
+#include "LibxsmmRuntime.h"
+#include "ResNet50Activations.h"
+#include "ResNet50BlockSizes.h"
+#include "ResNet50Calibration.h"
+#include "ResNet50Tuning.h"
+#include "Winograd.h"
+#include "VectorKernels.h"
 #include "../types/Image.h"
 #include "../types/Kernel.h"
 #include "../types/Array.h"
@@ -13,6 +21,12 @@
 #include "../types/Matrix.h"
 #include "../types/ScalarTypes.h"
 #include <vector>
+#include <algorithm>
+#include <cstring>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <stdint.h>
 #include <omp.h>
 #include <iostream>
@@ -28,7 +42,12 @@
 #endif // LIBXSMM_AS_HEADER_ONLY
 
 #define MAX_RESNET50_SIZE 122 * 122 * 64 * 2 * 2 // 967936 additional 2x for zero padding
-#define RESNET50_BLOCK_SIZE 32
+#define RESNET50_GEMM_PIXELS 64        // Upper bound of the pixels of one flattened 1x1 convolution gemm
+#define RESNET50_FC_COLUMNS 64         // Upper bound of the columns of one fully connected layer gemm
+#define RESNET50_FUSED_ROWS 4          // Lower bound of the output rows of a thread in a fused bottleneck, as every thread recomputes two halo rows
+#define RESNET50_FUSED_WEIGHTS 2097152 // Upper bound of the bytes of the weights of a fused bottleneck, which every band reads again from the cache
+#define RESNET50_BATCH 8               // Upper bound of the images that go through the layers together and share the gemms of the head
+#define RESNET50_FLOAT16_WIDENED 32768 // Upper bound of the bytes of Float16 weights widened into float for one gemm, which reads them from the L1 cache
 
 #ifdef IMAGEINFERENCE_TESTING
 namespace ImageInference::model::test
@@ -44,71 +63,247 @@ namespace ImageInference
 {
     namespace model
     {
+        template <typename T>
+        class ResNet50Weights;
+
+        template <typename T, size_t BlockSize, size_t InBlockSize, size_t InChannels, size_t MidChannels, size_t OutChannels>
+        class ResNet50Bottleneck;
+
+        template <typename T, size_t BlockSize, size_t InBlockSize, size_t InChannels, size_t MidChannels, size_t OutChannels>
+        class ResNet50BottleneckProjection;
+
+        template <typename T, size_t BlockSize>
+        class ResNet50Stem;
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        class ResNet50Layer1;
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        class ResNet50Layer2;
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        class ResNet50Layer3;
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        class ResNet50Layer4;
+
         /// @brief The resnet50 v1.5 model from https://catalog.ngc.nvidia.com/orgs/nvidia/resources/resnet_50_v1_5_for_pytorch
         class ResNet50 : public IModel<float>
         {
+        public:
+            /// @brief The planned activations of finished forward passes, which are reused by the next ones.
+            ///
+            /// There is one activations per concurrent forward pass, so a shared model can be run from multiple threads.
+            /// The model keeps a pool for all callers. A caller that runs its forward passes on its own cores e.g. a group of
+            /// ResNet50Throughput keeps its own, so its activations are first touched and reused by the same cores.
+            class ActivationsPool
+            {
+                friend class ResNet50;
+
+            private:
+                std::vector<std::unique_ptr<ResNet50Activations<float>>> activations;
+                std::vector<std::unique_ptr<ResNet50Activations<ImageInference::types::BFloat16>>> activationsBFloat16;
+                std::vector<std::unique_ptr<ResNet50Activations<uint8_t>>> activationsInt8;
+                /// @brief The plan of the model the activations are planned for, see ResNet50::activationsPlan.
+                size_t plan = 0;
+                std::mutex mutex;
+
+                template <typename T>
+                std::vector<std::unique_ptr<ResNet50Activations<T>>> &get();
+            };
+
         private:
             std::vector<void *> modelWeights;
             ImageInference::types::ScalarType type;
-            // All the blocks start with a 1x1 kernel. Therefore no padding is required.
-
-            template <typename T, size_t BlockSize>
-            void block0(
-                ImageInference::types::Image<T, 0, BlockSize, 64, 56, 56> &input,
-                ImageInference::types::Image<T, 0, BlockSize, 256, 56, 56> &output);
-
-            template <typename T, size_t BlockSize>
-            void block1(
-                ImageInference::types::Image<T, 0, BlockSize, 256, 56, 56> &input,
-                ImageInference::types::Image<T, 0, BlockSize, 512, 28, 28> &output);
-
-            template <typename T, size_t BlockSize>
-            void block2(
-                ImageInference::types::Image<T, 0, BlockSize, 512, 28, 28> &input,
-                ImageInference::types::Image<T, 0, BlockSize, 1024, 14, 14> &output);
+            /// @brief Keeps libxsmm initialized while the model is alive, released after the weights.
+            std::shared_ptr<LibxsmmRuntime> runtime;
+            /// @brief The weights in the blocked format, which are prepared once at construction.
+            /// Only the weights of the type the model computes in are prepared, the others are null.
+            std::unique_ptr<ResNet50Weights<float>> weights;
+            std::unique_ptr<ResNet50Weights<ImageInference::types::BFloat16>> weightsBFloat16;
+            std::unique_ptr<ResNet50Weights<uint8_t>> weightsInt8;
+            /// @brief The pool of the forward passes that do not bring their own.
+            ActivationsPool activationsPool;
+            /// @brief Counts the changes that plan the activations differently e.g. setWinograd.
+            /// Pooled activations of an older plan are planned again when they are acquired.
+            std::atomic<size_t> activationsPlan{0};
+
+            // The bottlenecks and blocks run every convolution on all images of the batch before the next convolution,
+            // so its weights are read from memory once per batch and from the cache for the other images.
+            // The images are read from and written into their activations, which share the ids of their plan.
+
+            /// @brief The 3x3 convolution of a bottleneck with a stride of 1, which uses Winograd if it is enabled for the bottleneck.
+            /// Reads the reduce and writes the spatial activation of the bottleneck.
+            template <size_t Height, size_t Width, typename T, size_t BlockSize, size_t InBlockSize, size_t InChannels, size_t MidChannels, size_t OutChannels>
+            static void convBlockSpatial(
+                ResNet50Bottleneck<T, BlockSize, InBlockSize, InChannels, MidChannels, OutChannels> &bottleneck,
+                ResNet50Activations<T> *const *activations,
+                size_t batch,
+                const typename ResNet50Activations<T>::Bottleneck &bottleneckActivations,
+                const GemmKernels *gemmKernels);
+
+            /// @brief The first bottleneck of a layer, which reblocks the input and adds the projection shortcut.
+            /// Height and Width are the size of the input, which is reduced by the stride.
+            template <size_t Stride, size_t Height, size_t Width, typename T, size_t BlockSize, size_t InBlockSize, size_t InChannels, size_t MidChannels, size_t OutChannels>
+            static void bottleneckProjection(
+                ResNet50BottleneckProjection<T, BlockSize, InBlockSize, InChannels, MidChannels, OutChannels> &bottleneck,
+                ResNet50Activations<T> *const *activations,
+                size_t batch,
+                const typename ResNet50Activations<T>::Bottleneck &bottleneckActivations,
+                size_t input,
+                const GemmKernels *gemmKernels);
+
+            /// @brief A bottleneck with the identity shortcut. It is executed by bottleneckFused if its weights are at most RESNET50_FUSED_WEIGHTS,
+            /// its 3x3 convolution does not use Winograd, its weights are not stored in Float16 and every thread gets at least RESNET50_FUSED_ROWS rows.
+            /// Otherwise the convolutions are executed one after another. With the defaults the bottlenecks of layer1 and layer2 are fused,
+            /// whose large activations are bound by the memory bandwidth. The fused weights stay in the cache, so the images are fused one after another.
+            template <size_t Height, size_t Width, typename T, size_t BlockSize, size_t Channels, size_t MidChannels>
+            static void bottleneckIdentity(
+                ResNet50Bottleneck<T, BlockSize, BlockSize, Channels, MidChannels, Channels> &bottleneck,
+                ResNet50Activations<T> *const *activations,
+                size_t batch,
+                const typename ResNet50Activations<T>::Bottleneck &bottleneckActivations,
+                size_t input,
+                const GemmKernels *gemmKernels);
+
+            /// @brief A bottleneck with the identity shortcut executed depth first: every thread runs the 1x1, 3x3 and 1x1 convolution
+            /// with the residual add on a band of output rows before it moves on to the next band of its rows.
+            /// The reduced and the spatial rows of a band stay in the cache of the thread instead of going through memory as full images.
+            ///
+            /// A band is as many rows as the expand convolution computes in one gemm. The 3x3 convolution needs the reduced rows above
+            /// and below the band, which the next band of the thread reuses, so only the first band of a thread computes them twice.
+            /// Requires folded batch norms and float.
+            template <typename T, size_t BlockSize, size_t Channels, size_t MidChannels, size_t Height, size_t Width>
+            static void bottleneckFused(
+                ResNet50Bottleneck<T, BlockSize, BlockSize, Channels, MidChannels, Channels> &bottleneck,
+                ResNet50Activations<T> &activations,
+                ImageInference::types::Image<T, 0, BlockSize, Channels, Height, Width> &input,
+                ImageInference::types::Image<T, 0, BlockSize, Channels, Height, Width> &output,
+                const GemmKernels *gemmKernels);
 
-            template <typename T, size_t BlockSize>
-            void block3(
-                ImageInference::types::Image<T, 0, BlockSize, 1024, 14, 14> &input,
-                ImageInference::types::Image<T, 0, BlockSize, 2048, 7, 7> &output);
+            // All the blocks start with a 1x1 kernel. Therefore no padding is required.
+            // The input is blocked with the block size of the previous layer and reblocked by the first bottleneck.
+            // A block reads the output of the previous layer from the activations and writes the output of its last bottleneck.
+
+            template <typename T, size_t InBlockSize, size_t BlockSize>
+            static void block0(
+                ResNet50Layer1<T, InBlockSize, BlockSize> &weights,
+                ResNet50Activations<T> *const *activations,
+                size_t batch,
+                const GemmKernels *gemmKernels = nullptr);
+
+            template <typename T, size_t InBlockSize, size_t BlockSize>
+            static void block1(
+                ResNet50Layer2<T, InBlockSize, BlockSize> &weights,
+                ResNet50Activations<T> *const *activations,
+                size_t batch,
+                const GemmKernels *gemmKernels = nullptr);
+
+            template <typename T, size_t InBlockSize, size_t BlockSize>
+            static void block2(
+                ResNet50Layer3<T, InBlockSize, BlockSize> &weights,
+                ResNet50Activations<T> *const *activations,
+                size_t batch,
+                const GemmKernels *gemmKernels = nullptr);
+
+            template <typename T, size_t InBlockSize, size_t BlockSize>
+            static void block3(
+                ResNet50Layer4<T, InBlockSize, BlockSize> &weights,
+                ResNet50Activations<T> *const *activations,
+                size_t batch,
+                const GemmKernels *gemmKernels = nullptr);
 
 #ifdef IMAGEINFERENCE_BENCHMARK
         public:
 #endif // IMAGEINFERENCE_BENCHMARK
+            /// @brief Convolution with the batch norm and relu applied to the output.
+            /// The kernel is stored in the weight type of T. Kernels of float can also be stored in Float16, which are widened right before their gemms,
+            /// see batchReduceFloat16.
             template <size_t Stride, size_t OutPadding, size_t InPadding,
-                      typename T, size_t BlockSizeCount, size_t BlockSizeChannel,
+                      typename T, typename TWeight, size_t BlockSizeCount, size_t BlockSizeChannel,
                       size_t ImageChannels, size_t ImageHeight, size_t ImageWidth,
-                      size_t KernelCount, size_t KernelHeight, size_t KernelWidth>
+                      size_t KernelCount, size_t KernelHeight, size_t KernelWidth, bool BatchNormFolded>
             static void convBlock(
                 ImageInference::types::Image<T, InPadding, BlockSizeChannel, ImageChannels, ImageHeight, ImageWidth> &image,
-                ImageInference::types::Kernel<T, BlockSizeCount, BlockSizeChannel, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
-                ImageInference::types::BatchNorm<T, KernelCount> &batchNorm,
-                ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight / Stride, ImageWidth / Stride> &output);
-
-            template <size_t OutPadding, size_t InPadding, size_t ShortcutPadding,
+                ImageInference::types::Kernel<TWeight, BlockSizeCount, BlockSizeChannel, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
+                ImageInference::types::BatchNorm<typename ImageInference::types::Parameter<T>::type, KernelCount, BatchNormFolded> &batchNorm,
+                ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight / Stride, ImageWidth / Stride> &output,
+                const GemmKernels *gemmKernels = nullptr);
+
+            /// @brief 3x3 convolution with a stride of 1 that uses the Winograd transform F(4x4, 3x3), see Winograd.
+            /// The input is transformed into 6x6 tiles, multiplied with the transformed kernel by one gemm per position of the tile
+            /// and transformed back into 4x4 output tiles before the batch norm and relu are applied.
+            /// @param kernel The kernel transformed by Winograd::transformKernel.
+            /// @param scratch Memory of Winograd::scratchSize elements for the transformed input and output, allocated if nullptr.
+            template <size_t OutPadding,
                       typename T, size_t BlockSizeCount, size_t BlockSizeChannel,
                       size_t ImageChannels, size_t ImageHeight, size_t ImageWidth,
-                      size_t KernelCount, size_t KernelHeight, size_t KernelWidth>
+                      size_t KernelCount, bool BatchNormFolded>
+            static void convBlockWinograd(
+                ImageInference::types::Image<T, 1, BlockSizeChannel, ImageChannels, ImageHeight, ImageWidth> &image,
+                ImageInference::types::Kernel<T, BlockSizeCount, BlockSizeChannel, KernelCount, ImageChannels, Winograd::inputTile, Winograd::inputTile> &kernel,
+                ImageInference::types::BatchNorm<T, KernelCount, BatchNormFolded> &batchNorm,
+                ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight, ImageWidth> &output,
+                const GemmKernels *gemmKernels = nullptr,
+                T *scratch = nullptr);
+
+            /// @brief Convolution that reads the image directly in the planar format Channel x Height x Width,
+            /// the zero padding of KernelHeight / 2 is handled while gathering the taps of an output row, see planarStrip.
+            template <size_t Stride, size_t ImageHeight, size_t ImageWidth, size_t OutPadding,
+                      typename T, size_t BlockSizeCount, size_t ImageChannels,
+                      size_t KernelCount, size_t KernelHeight, size_t KernelWidth, bool BatchNormFolded>
+            static void convBlockPlanar(
+                const T *image,
+                ImageInference::types::Kernel<T, BlockSizeCount, ImageChannels, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
+                ImageInference::types::BatchNorm<T, KernelCount, BatchNormFolded> &batchNorm,
+                ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight / Stride, ImageWidth / Stride> &output,
+                const GemmKernels *gemmKernels = nullptr);
+
+            /// @brief The stem: convBlockPlanar followed by a 3x3 max pooling with a stride of 2 and a padding of 1.
+            /// Every task keeps only the three convolution rows of the current pooled row, so the output of the convolution is never stored.
+            /// The output can be stored in another type e.g. BFloat16 or uint8_t, then only the pooled rows are rounded, which needs float and a folded batch norm.
+            template <size_t Stride, size_t ImageHeight, size_t ImageWidth, size_t OutPadding,
+                      typename T, typename TOutput, size_t BlockSizeCount, size_t ImageChannels,
+                      size_t KernelCount, size_t KernelHeight, size_t KernelWidth, bool BatchNormFolded>
+            static void convBlockPlanarMaxPool(
+                const T *image,
+                ImageInference::types::Kernel<T, BlockSizeCount, ImageChannels, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
+                ImageInference::types::BatchNorm<T, KernelCount, BatchNormFolded> &batchNorm,
+                ImageInference::types::Image<TOutput, OutPadding, BlockSizeCount, KernelCount, ImageHeight / Stride / 2, ImageWidth / Stride / 2> &output,
+                const GemmKernels *gemmKernels = nullptr);
+
+            /// @brief Convolution with the shortcut added before the relu, the kernel is stored as for convBlock.
+            template <size_t OutPadding, size_t InPadding, size_t ShortcutPadding,
+                      typename T, typename TWeight, size_t BlockSizeCount, size_t BlockSizeChannel,
+                      size_t ImageChannels, size_t ImageHeight, size_t ImageWidth,
+                      size_t KernelCount, size_t KernelHeight, size_t KernelWidth, bool BatchNormFolded>
             static void convBlockAddIdentity(
                 ImageInference::types::Image<T, InPadding, BlockSizeChannel, ImageChannels, ImageHeight, ImageWidth> &image,
-                ImageInference::types::Kernel<T, BlockSizeCount, BlockSizeChannel, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
-                ImageInference::types::BatchNorm<T, KernelCount> &batchNorm,
+                ImageInference::types::Kernel<TWeight, BlockSizeCount, BlockSizeChannel, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
+                ImageInference::types::BatchNorm<typename ImageInference::types::Parameter<T>::type, KernelCount, BatchNormFolded> &batchNorm,
                 ImageInference::types::Image<T, ShortcutPadding, BlockSizeCount, KernelCount, ImageHeight, ImageWidth> &shortcut,
-                ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight, ImageWidth> &output);
-
+                ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight, ImageWidth> &output,
+                const GemmKernels *gemmKernels = nullptr);
+
+            /// @brief Convolution with the projected shortcut added before the relu.
+            /// The shortcut can use another block size than the output, e.g. the output of the previous layer,
+            /// then the projection reblocks it as part of its gemm.
+            /// With folded batch norms the projection is accumulated into the output, so no image of the projection is needed.
+            /// Both kernels are stored as for convBlock.
             template <size_t Stride, size_t ShortcutDimExpand,
                       size_t OutPadding, size_t InPadding, size_t ShortcutPadding,
-                      typename T, size_t BlockSizeCount, size_t BlockSizeChannel,
+                      typename T, typename TWeight, size_t BlockSizeCount, size_t BlockSizeChannel, size_t BlockSizeShortcut,
                       size_t ImageChannels, size_t ImageHeight, size_t ImageWidth,
-                      size_t KernelCount, size_t KernelHeight, size_t KernelWidth>
+                      size_t KernelCount, size_t KernelHeight, size_t KernelWidth, bool BatchNormFolded>
             static void convBlockAddProjection(
                 ImageInference::types::Image<T, InPadding, BlockSizeChannel, ImageChannels, ImageHeight / Stride, ImageWidth / Stride> &image,
-                ImageInference::types::Kernel<T, BlockSizeCount, BlockSizeChannel, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
-                ImageInference::types::BatchNorm<T, KernelCount> &batchNorm,
-                ImageInference::types::Image<T, ShortcutPadding, BlockSizeCount, KernelCount / ShortcutDimExpand, ImageHeight, ImageWidth> &shortcut,
-                ImageInference::types::Kernel<T, BlockSizeCount, BlockSizeCount, KernelCount, KernelCount / ShortcutDimExpand, 1, 1> &projectionKernel,
-                ImageInference::types::BatchNorm<T, KernelCount> &projectionBatchNorm,
-                ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight / Stride, ImageWidth / Stride> &output);
+                ImageInference::types::Kernel<TWeight, BlockSizeCount, BlockSizeChannel, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
+                ImageInference::types::BatchNorm<typename ImageInference::types::Parameter<T>::type, KernelCount, BatchNormFolded> &batchNorm,
+                ImageInference::types::Image<T, ShortcutPadding, BlockSizeShortcut, KernelCount / ShortcutDimExpand, ImageHeight, ImageWidth> &shortcut,
+                ImageInference::types::Kernel<TWeight, BlockSizeCount, BlockSizeShortcut, KernelCount, KernelCount / ShortcutDimExpand, 1, 1> &projectionKernel,
+                ImageInference::types::BatchNorm<typename ImageInference::types::Parameter<T>::type, KernelCount, BatchNormFolded> &projectionBatchNorm,
+                ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight / Stride, ImageWidth / Stride> &output,
+                const GemmKernels *gemmKernels = nullptr);
 
             template <size_t Stride, size_t OutPadding, size_t InPadding,
                       typename T, size_t BlockSize,
@@ -129,6 +324,79 @@ namespace ImageInference
                 ImageInference::types::Matrix<T, Columns, Rows> &weight,
                 ImageInference::types::Array<T, Columns> &biasAccumulator);
 
+            /// @brief The head: global average pooling of every image of the batch followed by the fully connected layer.
+            /// The pooled features stay on the stack and the logits are written directly to the output of Batch x Columns.
+            /// The images are pooled into the parameter type of T, in which the fully connected layer is computed.
+            /// @param weight The transposed weight of the fully connected layer, see ImageInference::types::Matrix::transposed.
+            /// It is stored in the parameter type of T or in Float16, which is widened chunk by chunk right before the gemms.
+            template <size_t Batch, size_t InPadding, typename T, typename TWeight, size_t BlockSize,
+                      size_t ImageChannels, size_t ImageHeight, size_t ImageWidth, size_t Columns>
+            static void globalAveragePoolFullyConnected(
+                const std::array<ImageInference::types::Image<T, InPadding, BlockSize, ImageChannels, ImageHeight, ImageWidth> *, Batch> &images,
+                ImageInference::types::Matrix<TWeight, ImageChannels, Columns> &weight,
+                ImageInference::types::Array<typename ImageInference::types::Parameter<T>::type, Columns> &bias,
+                typename ImageInference::types::Parameter<T>::type *output,
+                const GemmKernels *gemmKernels = nullptr);
+
+            /// @brief Calls the function with the batch as std::integral_constant, so it can be used as a template argument.
+            /// @param batch The number of images, from 1 to RESNET50_BATCH.
+            template <size_t Batch = 1, typename F>
+            static void dispatchBatch(size_t batch, F &&function);
+
+            /// @brief Classifies the batch with the prepared weights of the type the model computes in, see inference.
+            template <typename T>
+            void forward(ResNet50Weights<T> &weights, ActivationsPool &activationsPool, const float *input, float *output, size_t batch);
+
+            /// @brief Takes planned activations from the pool or plans new ones if all are in use.
+            template <typename T>
+            std::unique_ptr<ResNet50Activations<T>> acquireActivations(const ResNet50Weights<T> &weights, ActivationsPool &activationsPool);
+
+            /// @brief Returns the activations to the pool for the next forward pass.
+            template <typename T>
+            void releaseActivations(ActivationsPool &activationsPool, std::unique_ptr<ResNet50Activations<T>> activations);
+
+            /// @brief Calls the function with the kernel in Float16 if the kernel of float is stored in Float16, otherwise with the kernel itself.
+            /// Kernels of other types are never stored in Float16, see ResNet50Bottleneck::setFloat16.
+            template <typename TKernel, typename TKernelFloat16, typename F>
+            static void dispatchFloat16(TKernel &kernel, const std::unique_ptr<TKernelFloat16> &kernelFloat16, F &&function);
+
+            /// @brief Calls the function with both kernels in Float16 if they are stored in Float16, e.g. the kernel and the projection kernel of a bottleneck.
+            template <typename TKernel, typename TKernelFloat16, typename TOtherKernel, typename TOtherKernelFloat16, typename F>
+            static void dispatchFloat16(TKernel &kernel, const std::unique_ptr<TKernelFloat16> &kernelFloat16,
+                                        TOtherKernel &otherKernel, const std::unique_ptr<TOtherKernelFloat16> &otherKernelFloat16, F &&function);
+
+            /// @brief The batch-reduce gemm of a convolution over all taps of a count block with the kernel stored in Float16.
+            /// The taps are widened into float in chunks of at most RESNET50_FLOAT16_WIDENED bytes on the stack of the thread,
+            /// the first chunk is multiplied by gemmFunc and the following chunks are accumulated by accumulateFunc of the same shape.
+            /// The taps of a count block are consecutive in the order of the offsets, see batchReduceOffsets,
+            /// so the kernel offsets of the first taps also address the taps of every chunk.
+            /// @tparam TapSize The elements of a tap i.e. BlockSizeChannel x BlockSizeCount.
+            template <size_t TapSize, size_t BatchCount>
+            static void batchReduceFloat16(
+                const ImageInference::types::Float16 *kernel,
+                std::array<unsigned long long, BatchCount> &kernelOffsets,
+                float *image,
+                std::array<unsigned long long, BatchCount> &imageOffsets,
+                float *output,
+                libxsmm_gemmfunction gemmFunc,
+                libxsmm_gemmfunction accumulateFunc);
+
+            /// @brief Computes the byte offsets of the batch-reduce gemm of a convolution relative to the first channel block and kernel tap,
+            /// in the order (channel block, kernel row, kernel column) so the image and kernel offsets pair up.
+            template <typename T, size_t ChannelBlocks, size_t KernelHeight, size_t KernelWidth, typename TImage, typename TKernel>
+            static void batchReduceOffsets(
+                TImage &image,
+                TKernel &kernel,
+                std::array<unsigned long long, ChannelBlocks * KernelHeight * KernelWidth> &imageOffsets,
+                std::array<unsigned long long, ChannelBlocks * KernelHeight * KernelWidth> &kernelOffsets);
+
+            /// @brief Gathers the taps of an output row of a planar convolution into a strip of outputWidth x (KernelHeight x KernelWidth x Channels).
+            /// The taps are in the order of the blocked kernel with a single channel block, so the strip is the B matrix of one gemm
+            /// with the depth KernelHeight x KernelWidth x Channels. Taps in the zero padding are zero.
+            template <size_t Stride, size_t ImageChannels, size_t ImageHeight, size_t ImageWidth,
+                      size_t KernelHeight, size_t KernelWidth, typename T>
+            static void planarStrip(const T *image, size_t iHeight, T *strip);
+
             template <typename T>
             T *getWeight(size_t index);
 
@@ -140,11 +408,30 @@ namespace ImageInference
 
         public:
             /// @brief Initialize the model with the weights
-            /// @param weights The weights of the model with the following shape.
-            /// @param type The scalar type of the weights.
+            /// @param weights The weights of the model with the following shape, which are always given as float.
+            /// @param type The scalar type the model computes in. BFloat16 converts the convolutions of the layers while they are prepared
+            /// and stores their activations in BFloat16, while the gemms accumulate in float. The stem and the head compute in float.
+            /// Int8 quantizes the convolutions of the layers and stores their activations in uint8_t, which needs a calibration.
+            /// @param layout The layout of the convolution weights. Blocked weights need to use RESNET50_BLOCK_SIZE
+            /// and are used without copying, therefore they need to outlive the model.
+            ///
+            /// The layers use the block sizes of the tuning file in the environment variable IMAGEINFERENCE_TUNING_FILE,
+            /// otherwise the defaults of the host, see ResNet50Tuning::host. Blocked weights always use RESNET50_BLOCK_SIZE.
             ///
             /// see file backend/baremetal/resnet50weights.txt for size information.
-            ResNet50(const std::vector<void *> &modelWeights, ImageInference::types::ScalarType type);
+            ResNet50(const std::vector<void *> &modelWeights, ImageInference::types::ScalarType type,
+                     ImageInference::types::KernelLayout layout = ImageInference::types::KernelLayout::OIHW);
+
+            /// @brief Initialize the model with the weights and the block sizes of the layers.
+            /// @param blockSizes The block sizes of the layers, blocked weights need RESNET50_BLOCK_SIZE for all layers.
+            /// @param calibration The scales of the activations, which the type Int8 needs, see ResNet50Calibration.
+            ResNet50(const std::vector<void *> &modelWeights, ImageInference::types::ScalarType type,
+                     ImageInference::types::KernelLayout layout, const ResNet50BlockSizes &blockSizes,
+                     const ResNet50Calibration &calibration = ResNet50Calibration());
+
+            /// @brief Initialize the int8 model with the weights and the scales of its activations.
+            ResNet50(const std::vector<void *> &modelWeights, const ResNet50Calibration &calibration,
+                     ImageInference::types::KernelLayout layout = ImageInference::types::KernelLayout::OIHW);
             ~ResNet50();
 
             enum weightIndex
@@ -419,502 +706,451 @@ namespace ImageInference
             };
 
             void inference(const float *input, float *output) override;
+
+            /// @brief Classifies a batch of images of 3 x 224 x 224 into batch x 1000 logits.
+            ///
+            /// The images go through the model in groups of up to RESNET50_BATCH. Every layer runs for all images of a group
+            /// before the next layer starts, so the following images read the weights of the layer from the cache
+            /// and the fully connected layer of the head reads its weights once for the whole group.
+            void inference(const float *input, float *output, size_t batch) override;
+
+            /// @brief Classifies a batch of images like inference, but plans and reuses the activations in the given pool.
+            void inference(const float *input, float *output, size_t batch, ActivationsPool &activationsPool);
             ImageInference::types::ScalarType getType();
 
+            /// @brief Enables or disables the Winograd convolution F(4x4, 3x3) for the 3x3 convolution of a bottleneck.
+            /// The kernel is transformed once here, it must not be called while a forward pass is running. Only supported for float.
+            /// @param conv2Index The index of the conv2 weight of a bottleneck with a stride of 1 e.g. layer2_1_conv2_weight.
+            void setWinograd(size_t conv2Index, bool enabled);
+
+            /// @brief Stores the weights of a bottleneck or of the fully connected layer in Float16 or widens them back into float.
+            /// The activations and the gemms stay in float, the weights are widened right before their gemms, which halves the memory
+            /// that is read for them. Widening them back keeps the rounding to Float16. It must not be called while a forward pass is running.
+            /// The bottlenecks are only supported for float, the fully connected layer for every type as it computes in float.
+            /// @param weightIndex The index of the conv1 weight of a bottleneck e.g. layer3_1_conv1_weight or fc_weight.
+            void setFloat16Weights(size_t weightIndex, bool enabled);
+
+            /// @brief The block sizes the layers were prepared for.
+            const ResNet50BlockSizes &getBlockSizes() const;
+
+            /// @brief The number of output rows computed by one gemm of a convolution.
+            /// A 1x1 convolution without stride and padding reads and writes contiguous pixels, so whole rows are flattened
+            /// into one gemm of at most RESNET50_GEMM_PIXELS pixels. All other convolutions compute one row per gemm.
+            template <size_t Stride, size_t InPadding, size_t OutPadding, size_t KernelHeight, size_t KernelWidth, size_t OutputHeight, size_t OutputWidth>
+            static constexpr size_t gemmRows();
+
+            /// @brief The columns of the fully connected layer computed by one gemm of globalAveragePoolFullyConnected,
+            /// which is the largest divisor of Columns that is at most RESNET50_FC_COLUMNS.
+            template <size_t Columns>
+            static constexpr size_t fullyConnectedColumns();
+
+            /// @brief The channels of a fully connected layer in Float16 widened for one gemm of globalAveragePoolFullyConnected,
+            /// which is the largest divisor of Channels whose widened columns are at most RESNET50_FLOAT16_WIDENED bytes.
+            template <size_t Channels, size_t Columns>
+            static constexpr size_t fullyConnectedFloat16Channels();
+
+            // The prepared layers run their convolutions for the block sizes they were instantiated with.
+            template <typename T, size_t BlockSize>
+            friend class ResNet50Stem;
+            template <typename T, size_t InBlockSize, size_t BlockSize>
+            friend class ResNet50Layer1;
+            template <typename T, size_t InBlockSize, size_t BlockSize>
+            friend class ResNet50Layer2;
+            template <typename T, size_t InBlockSize, size_t BlockSize>
+            friend class ResNet50Layer3;
+            template <typename T, size_t InBlockSize, size_t BlockSize>
+            friend class ResNet50Layer4;
+
 #ifdef IMAGEINFERENCE_TESTING
             friend class ImageInference::model::test::ResNet50Test;
 #endif // IMAGEINFERENCE_TESTING
         };
 
-        template <typename T, size_t BlockSize>
+        template <typename T, size_t InBlockSize, size_t BlockSize>
         inline void ResNet50::block0(
-            ImageInference::types::Image<T, 0, BlockSize, 64, 56, 56> &input,
-            ImageInference::types::Image<T, 0, BlockSize, 256, 56, 56> &output)
+            ResNet50Layer1<T, InBlockSize, BlockSize> &weights,
+            ResNet50Activations<T> *const *activations,
+            const size_t batch,
+            const GemmKernels *gemmKernels)
+        {
+            // The activations of a batch are planned alike, so the ids of the first one are the ids of all.
+            const auto &ids = *activations[0];
+            bottleneckProjection<1, 56, 56>(weights.layer1_0, activations, batch, ids.layer1[0], ids.maxPool, gemmKernels);
+            bottleneckIdentity<56, 56>(weights.layer1_1, activations, batch, ids.layer1[1], ids.layer1[0].output, gemmKernels);
+            bottleneckIdentity<56, 56>(weights.layer1_2, activations, batch, ids.layer1[2], ids.layer1[1].output, gemmKernels);
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        void ResNet50::block1(
+            ResNet50Layer2<T, InBlockSize, BlockSize> &weights,
+            ResNet50Activations<T> *const *activations,
+            const size_t batch,
+            const GemmKernels *gemmKernels)
+        {
+            const auto &ids = *activations[0];
+            bottleneckProjection<2, 56, 56>(weights.layer2_0, activations, batch, ids.layer2[0], ids.layer1.back().output, gemmKernels);
+            bottleneckIdentity<28, 28>(weights.layer2_1, activations, batch, ids.layer2[1], ids.layer2[0].output, gemmKernels);
+            bottleneckIdentity<28, 28>(weights.layer2_2, activations, batch, ids.layer2[2], ids.layer2[1].output, gemmKernels);
+            bottleneckIdentity<28, 28>(weights.layer2_3, activations, batch, ids.layer2[3], ids.layer2[2].output, gemmKernels);
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        void ResNet50::block2(
+            ResNet50Layer3<T, InBlockSize, BlockSize> &weights,
+            ResNet50Activations<T> *const *activations,
+            const size_t batch,
+            const GemmKernels *gemmKernels)
+        {
+            const auto &ids = *activations[0];
+            bottleneckProjection<2, 28, 28>(weights.layer3_0, activations, batch, ids.layer3[0], ids.layer2.back().output, gemmKernels);
+            bottleneckIdentity<14, 14>(weights.layer3_1, activations, batch, ids.layer3[1], ids.layer3[0].output, gemmKernels);
+            bottleneckIdentity<14, 14>(weights.layer3_2, activations, batch, ids.layer3[2], ids.layer3[1].output, gemmKernels);
+            bottleneckIdentity<14, 14>(weights.layer3_3, activations, batch, ids.layer3[3], ids.layer3[2].output, gemmKernels);
+            bottleneckIdentity<14, 14>(weights.layer3_4, activations, batch, ids.layer3[4], ids.layer3[3].output, gemmKernels);
+            bottleneckIdentity<14, 14>(weights.layer3_5, activations, batch, ids.layer3[5], ids.layer3[4].output, gemmKernels);
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        void ResNet50::block3(
+            ResNet50Layer4<T, InBlockSize, BlockSize> &weights,
+            ResNet50Activations<T> *const *activations,
+            const size_t batch,
+            const GemmKernels *gemmKernels)
+        {
+            const auto &ids = *activations[0];
+            bottleneckProjection<2, 14, 14>(weights.layer4_0, activations, batch, ids.layer4[0], ids.layer3.back().output, gemmKernels);
+            bottleneckIdentity<7, 7>(weights.layer4_1, activations, batch, ids.layer4[1], ids.layer4[0].output, gemmKernels);
+            bottleneckIdentity<7, 7>(weights.layer4_2, activations, batch, ids.layer4[2], ids.layer4[1].output, gemmKernels);
+        }
+
+        template <size_t Height, size_t Width, typename T, size_t BlockSize, size_t InBlockSize, size_t InChannels, size_t MidChannels, size_t OutChannels>
+        inline void ResNet50::convBlockSpatial(
+            ResNet50Bottleneck<T, BlockSize, InBlockSize, InChannels, MidChannels, OutChannels> &bottleneck,
+            ResNet50Activations<T> *const *activations,
+            const size_t batch,
+            const typename ResNet50Activations<T>::Bottleneck &bottleneckActivations,
+            const GemmKernels *gemmKernels)
         {
+            using Reduce = ImageInference::types::Image<T, 1, BlockSize, MidChannels, Height, Width>;
+            using Spatial = ImageInference::types::Image<T, 0, BlockSize, MidChannels, Height, Width>; // OutPadding of 0 is because a 1x1 kernel is coming next
 
-            // OutPadding of 0 is because kernel_1_0 is a 1x1 kernel
-            auto image_0_2 = ImageInference::types::Image<T, 0, BlockSize, 256, 56, 56>();
-            {
-                auto kernel_0_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 64, 64, 1, 1>(getWeight<T>(weightIndex::layer1_0_conv1_weight));
-                auto batchNorm_0_0 = ImageInference::types::BatchNorm<T, 64>(
-                    getWeight<T>(weightIndex::layer1_0_bn1_weight),
-                    getWeight<T>(weightIndex::layer1_0_bn1_bias),
-                    getWeight<T>(weightIndex::layer1_0_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer1_0_bn1_running_var));
-                auto image_0_0 = ImageInference::types::Image<T, 1, BlockSize, 64, 56, 56>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(input, kernel_0_0, batchNorm_0_0, image_0_0);
-                auto kernel_0_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 64, 64, 3, 3>(getWeight<T>(weightIndex::layer1_0_conv2_weight));
-                auto batchNorm_0_1 = ImageInference::types::BatchNorm<T, 64>(
-                    getWeight<T>(weightIndex::layer1_0_bn2_weight),
-                    getWeight<T>(weightIndex::layer1_0_bn2_bias),
-                    getWeight<T>(weightIndex::layer1_0_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer1_0_bn2_running_var));
-                auto image_0_1 = ImageInference::types::Image<T, 0, BlockSize, 64, 56, 56>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<1>(image_0_0, kernel_0_1, batchNorm_0_1, image_0_1);
-                auto kernel_0_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 64, 1, 1>(getWeight<T>(weightIndex::layer1_0_conv3_weight));
-                auto batchNorm_0_2 = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer1_0_bn3_weight),
-                    getWeight<T>(weightIndex::layer1_0_bn3_bias),
-                    getWeight<T>(weightIndex::layer1_0_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer1_0_bn3_running_var));
-                auto projectionKernel = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 64, 1, 1>(getWeight<T>(weightIndex::layer1_0_downsample_0_weight));
-                auto projectionBatchNorm = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer1_0_downsample_1_weight),
-                    getWeight<T>(weightIndex::layer1_0_downsample_1_bias),
-                    getWeight<T>(weightIndex::layer1_0_downsample_1_running_mean),
-                    getWeight<T>(weightIndex::layer1_0_downsample_1_running_var));
-                convBlockAddProjection<1, 4>(image_0_1, kernel_0_2, batchNorm_0_2, input, projectionKernel, projectionBatchNorm, image_0_2);
-            }
-
-            // OutPadding of 0 is because kernel_2_0 is a 1x1
-            auto image_1_2 = ImageInference::types::Image<T, 0, BlockSize, 256, 56, 56>();
-            {
-                auto kernel_1_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 64, 256, 1, 1>(getWeight<T>(weightIndex::layer1_1_conv1_weight));
-                auto batchNorm_1_0 = ImageInference::types::BatchNorm<T, 64>(
-                    getWeight<T>(weightIndex::layer1_1_bn1_weight),
-                    getWeight<T>(weightIndex::layer1_1_bn1_bias),
-                    getWeight<T>(weightIndex::layer1_1_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer1_1_bn1_running_var));
-                auto image_1_0 = ImageInference::types::Image<T, 1, BlockSize, 64, 56, 56>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(image_0_2, kernel_1_0, batchNorm_1_0, image_1_0);                // OutPadding of 1 is because a 3x3 kernel is coming next
-                auto kernel_1_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 64, 64, 3, 3>(getWeight<T>(weightIndex::layer1_1_conv2_weight));
-                auto batchNorm_1_1 = ImageInference::types::BatchNorm<T, 64>(
-                    getWeight<T>(weightIndex::layer1_1_bn2_weight),
-                    getWeight<T>(weightIndex::layer1_1_bn2_bias),
-                    getWeight<T>(weightIndex::layer1_1_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer1_1_bn2_running_var));
-                auto image_1_1 = ImageInference::types::Image<T, 0, BlockSize, 64, 56, 56>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<1>(image_1_0, kernel_1_1, batchNorm_1_1, image_1_1);
-                auto kernel_1_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 64, 1, 1>(getWeight<T>(weightIndex::layer1_1_conv3_weight));
-                auto batchNorm_1_2 = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer1_1_bn3_weight),
-                    getWeight<T>(weightIndex::layer1_1_bn3_bias),
-                    getWeight<T>(weightIndex::layer1_1_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer1_1_bn3_running_var));
-                convBlockAddIdentity(image_1_1, kernel_1_2, batchNorm_1_2, image_0_2, image_1_2);
-            }
-
-            {
-                auto kernel_2_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 64, 256, 1, 1>(getWeight<T>(weightIndex::layer1_2_conv1_weight));
-                auto batchNorm_2_0 = ImageInference::types::BatchNorm<T, 64>(
-                    getWeight<T>(weightIndex::layer1_2_bn1_weight),
-                    getWeight<T>(weightIndex::layer1_2_bn1_bias),
-                    getWeight<T>(weightIndex::layer1_2_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer1_2_bn1_running_var));
-                auto image_2_0 = ImageInference::types::Image<T, 1, BlockSize, 64, 56, 56>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(image_1_2, kernel_2_0, batchNorm_2_0, image_2_0);
-                auto kernel_2_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 64, 64, 3, 3>(getWeight<T>(weightIndex::layer1_2_conv2_weight));
-                auto batchNorm_2_1 = ImageInference::types::BatchNorm<T, 64>(
-                    getWeight<T>(weightIndex::layer1_2_bn2_weight),
-                    getWeight<T>(weightIndex::layer1_2_bn2_bias),
-                    getWeight<T>(weightIndex::layer1_2_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer1_2_bn2_running_var));
-                auto image_2_1 = ImageInference::types::Image<T, 0, BlockSize, 64, 56, 56>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<1, 0>(image_2_0, kernel_2_1, batchNorm_2_1, image_2_1);
-                auto kernel_2_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 64, 1, 1>(getWeight<T>(weightIndex::layer1_2_conv3_weight));
-                auto batchNorm_2_2 = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer1_2_bn3_weight),
-                    getWeight<T>(weightIndex::layer1_2_bn3_bias),
-                    getWeight<T>(weightIndex::layer1_2_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer1_2_bn3_running_var));
-                convBlockAddIdentity(image_2_1, kernel_2_2, batchNorm_2_2, image_1_2, output);
+            // Winograd is only enabled for float, see ResNet50Bottleneck::setWinograd.
+            if constexpr (std::is_same<T, float>::value)
+            {
+                if (bottleneck.kernel2Winograd)
+                {
+                    for (size_t iImage = 0; iImage < batch; iImage++)
+                    {
+                        auto &imageActivations = *activations[iImage];
+                        auto image = Reduce::view(imageActivations.get(bottleneckActivations.reduce));
+                        auto output = Spatial(imageActivations.get(bottleneckActivations.spatial), imageActivations.getSize(bottleneckActivations.spatial), ImageInference::types::ImageInitialization::Padding);
+                        // Activations that are planned without Winograd have no scratch, then it is allocated by the convolution.
+                        T *scratch = nullptr;
+                        if (bottleneckActivations.winograd != ResNet50Activations<T>::none)
+                        {
+                            scratch = imageActivations.get(bottleneckActivations.winograd);
+                        }
+                        convBlockWinograd(image, *bottleneck.kernel2Winograd, bottleneck.batchNorm2, output, gemmKernels, scratch);
+                    }
+                    return;
+                }
             }
+
+            dispatchFloat16(bottleneck.kernel2, bottleneck.kernel2Float16, [&](auto &kernel)
+                            {
+                                for (size_t iImage = 0; iImage < batch; iImage++)
+                                {
+                                    auto &imageActivations = *activations[iImage];
+                                    auto image = Reduce::view(imageActivations.get(bottleneckActivations.reduce));
+                                    auto output = Spatial(imageActivations.get(bottleneckActivations.spatial), imageActivations.getSize(bottleneckActivations.spatial), ImageInference::types::ImageInitialization::Padding);
+                                    convBlock<1>(image, kernel, bottleneck.batchNorm2, output, gemmKernels);
+                                } });
         }
 
-        template <typename T, size_t BlockSize>
-        void ResNet50::block1(
-            ImageInference::types::Image<T, 0, BlockSize, 256, 56, 56> &input,
-            ImageInference::types::Image<T, 0, BlockSize, 512, 28, 28> &output)
+        template <size_t Stride, size_t Height, size_t Width, typename T, size_t BlockSize, size_t InBlockSize, size_t InChannels, size_t MidChannels, size_t OutChannels>
+        inline void ResNet50::bottleneckProjection(
+            ResNet50BottleneckProjection<T, BlockSize, InBlockSize, InChannels, MidChannels, OutChannels> &bottleneck,
+            ResNet50Activations<T> *const *activations,
+            const size_t batch,
+            const typename ResNet50Activations<T>::Bottleneck &bottleneckActivations,
+            const size_t input,
+            const GemmKernels *gemmKernels)
         {
+            using Input = ImageInference::types::Image<T, 0, InBlockSize, InChannels, Height, Width>;
+            using Reduce = ImageInference::types::Image<T, 1, BlockSize, MidChannels, Height, Width>; // OutPadding of 1 is because a 3x3 kernel is coming next
+            using Spatial = ImageInference::types::Image<T, 0, BlockSize, MidChannels, Height / Stride, Width / Stride>; // OutPadding of 0 is because a 1x1 kernel is coming next
+            using Output = ImageInference::types::Image<T, 0, BlockSize, OutChannels, Height / Stride, Width / Stride>; // OutPadding of 0 is because the next bottleneck starts with a 1x1 kernel
+
+            dispatchFloat16(bottleneck.kernel1, bottleneck.kernel1Float16, [&](auto &kernel)
+                            {
+                                for (size_t iImage = 0; iImage < batch; iImage++)
+                                {
+                                    auto &imageActivations = *activations[iImage];
+                                    auto image = Input::view(imageActivations.get(input));
+                                    auto reduce = Reduce(imageActivations.get(bottleneckActivations.reduce), imageActivations.getSize(bottleneckActivations.reduce), ImageInference::types::ImageInitialization::Padding);
+                                    convBlock<1>(image, kernel, bottleneck.batchNorm1, reduce, gemmKernels);
+                                } });
 
-            auto image_0_2 = ImageInference::types::Image<T, 0, BlockSize, 512, 28, 28>(); // OutPadding of 0 is because kernel_1_0 is a 1x1 kernel
-            {
-                auto kernel_0_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 128, 256, 1, 1>(getWeight<T>(weightIndex::layer2_0_conv1_weight));
-                auto batchNorm_0_0 = ImageInference::types::BatchNorm<T, 128>(
-                    getWeight<T>(weightIndex::layer2_0_bn1_weight),
-                    getWeight<T>(weightIndex::layer2_0_bn1_bias),
-                    getWeight<T>(weightIndex::layer2_0_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer2_0_bn1_running_var));
-                auto image_0_0 = ImageInference::types::Image<T, 1, BlockSize, 128, 56, 56>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(input, kernel_0_0, batchNorm_0_0, image_0_0);
-                auto kernel_0_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 128, 128, 3, 3>(getWeight<T>(weightIndex::layer2_0_conv2_weight));
-                auto batchNorm_0_1 = ImageInference::types::BatchNorm<T, 128>(
-                    getWeight<T>(weightIndex::layer2_0_bn2_weight),
-                    getWeight<T>(weightIndex::layer2_0_bn2_bias),
-                    getWeight<T>(weightIndex::layer2_0_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer2_0_bn2_running_var));
-                auto image_0_1 = ImageInference::types::Image<T, 0, BlockSize, 128, 28, 28>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<2>(image_0_0, kernel_0_1, batchNorm_0_1, image_0_1);
-                auto kernel_0_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 512, 128, 1, 1>(getWeight<T>(weightIndex::layer2_0_conv3_weight));
-                auto batchNorm_0_2 = ImageInference::types::BatchNorm<T, 512>(
-                    getWeight<T>(weightIndex::layer2_0_bn3_weight),
-                    getWeight<T>(weightIndex::layer2_0_bn3_bias),
-                    getWeight<T>(weightIndex::layer2_0_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer2_0_bn3_running_var));
-                auto projectionKernel = ImageInference::types::Kernel<T, BlockSize, BlockSize, 512, 256, 1, 1>(getWeight<T>(weightIndex::layer2_0_downsample_0_weight));
-                auto projectionBatchNorm = ImageInference::types::BatchNorm<T, 512>(
-                    getWeight<T>(weightIndex::layer2_0_downsample_1_weight),
-                    getWeight<T>(weightIndex::layer2_0_downsample_1_bias),
-                    getWeight<T>(weightIndex::layer2_0_downsample_1_running_mean),
-                    getWeight<T>(weightIndex::layer2_0_downsample_1_running_var));
-                convBlockAddProjection<2, 2>(image_0_1, kernel_0_2, batchNorm_0_2, input, projectionKernel, projectionBatchNorm, image_0_2);
-            }
-
-            auto image_1_2 = ImageInference::types::Image<T, 0, BlockSize, 512, 28, 28>(); // OutPadding of 0 is because kernel_2_0 is a 1x1 kernel
-            {
-                auto kernel_1_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 128, 512, 1, 1>(getWeight<T>(weightIndex::layer2_1_conv1_weight));
-                auto batchNorm_1_0 = ImageInference::types::BatchNorm<T, 128>(
-                    getWeight<T>(weightIndex::layer2_1_bn1_weight),
-                    getWeight<T>(weightIndex::layer2_1_bn1_bias),
-                    getWeight<T>(weightIndex::layer2_1_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer2_1_bn1_running_var));
-                auto image_1_0 = ImageInference::types::Image<T, 1, BlockSize, 128, 28, 28>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(image_0_2, kernel_1_0, batchNorm_1_0, image_1_0);
-                auto kernel_1_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 128, 128, 3, 3>(getWeight<T>(weightIndex::layer2_1_conv2_weight));
-                auto batchNorm_1_1 = ImageInference::types::BatchNorm<T, 128>(
-                    getWeight<T>(weightIndex::layer2_1_bn2_weight),
-                    getWeight<T>(weightIndex::layer2_1_bn2_bias),
-                    getWeight<T>(weightIndex::layer2_1_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer2_1_bn2_running_var));
-                auto image_1_1 = ImageInference::types::Image<T, 0, BlockSize, 128, 28, 28>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<1>(image_1_0, kernel_1_1, batchNorm_1_1, image_1_1);
-                auto kernel_1_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 512, 128, 1, 1>(getWeight<T>(weightIndex::layer2_1_conv3_weight));
-                auto batchNorm_1_2 = ImageInference::types::BatchNorm<T, 512>(
-                    getWeight<T>(weightIndex::layer2_1_bn3_weight),
-                    getWeight<T>(weightIndex::layer2_1_bn3_bias),
-                    getWeight<T>(weightIndex::layer2_1_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer2_1_bn3_running_var));
-                convBlockAddIdentity(image_1_1, kernel_1_2, batchNorm_1_2, image_0_2, image_1_2);
-            }
-
-            auto image_2_2 = ImageInference::types::Image<T, 0, BlockSize, 512, 28, 28>(); // OutPadding of 0 is because kernel_3_0 is a 1x1 kernel
-            {
-                auto kernel_2_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 128, 512, 1, 1>(getWeight<T>(weightIndex::layer2_2_conv1_weight));
-                auto batchNorm_2_0 = ImageInference::types::BatchNorm<T, 128>(
-                    getWeight<T>(weightIndex::layer2_2_bn1_weight),
-                    getWeight<T>(weightIndex::layer2_2_bn1_bias),
-                    getWeight<T>(weightIndex::layer2_2_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer2_2_bn1_running_var));
-                auto image_2_0 = ImageInference::types::Image<T, 1, BlockSize, 128, 28, 28>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(image_1_2, kernel_2_0, batchNorm_2_0, image_2_0);
-                auto kernel_2_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 128, 128, 3, 3>(getWeight<T>(weightIndex::layer2_2_conv2_weight));
-                auto batchNorm_2_1 = ImageInference::types::BatchNorm<T, 128>(
-                    getWeight<T>(weightIndex::layer2_2_bn2_weight),
-                    getWeight<T>(weightIndex::layer2_2_bn2_bias),
-                    getWeight<T>(weightIndex::layer2_2_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer2_2_bn2_running_var));
-                auto image_2_1 = ImageInference::types::Image<T, 0, BlockSize, 128, 28, 28>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<1>(image_2_0, kernel_2_1, batchNorm_2_1, image_2_1);
-                auto kernel_2_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 512, 128, 1, 1>(getWeight<T>(weightIndex::layer2_2_conv3_weight));
-                auto batchNorm_2_2 = ImageInference::types::BatchNorm<T, 512>(
-                    getWeight<T>(weightIndex::layer2_2_bn3_weight),
-                    getWeight<T>(weightIndex::layer2_2_bn3_bias),
-                    getWeight<T>(weightIndex::layer2_2_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer2_2_bn3_running_var));
-                convBlockAddIdentity(image_2_1, kernel_2_2, batchNorm_2_2, image_1_2, image_2_2);
-            }
-
-            {
-                auto kernel_3_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 128, 512, 1, 1>(getWeight<T>(weightIndex::layer2_3_conv1_weight));
-                auto batchNorm_3_0 = ImageInference::types::BatchNorm<T, 128>(
-                    getWeight<T>(weightIndex::layer2_3_bn1_weight),
-                    getWeight<T>(weightIndex::layer2_3_bn1_bias),
-                    getWeight<T>(weightIndex::layer2_3_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer2_3_bn1_running_var));
-                auto image_3_0 = ImageInference::types::Image<T, 1, BlockSize, 128, 28, 28>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(image_2_2, kernel_3_0, batchNorm_3_0, image_3_0);
-                auto kernel_3_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 128, 128, 3, 3>(getWeight<T>(weightIndex::layer2_3_conv2_weight));
-                auto batchNorm_3_1 = ImageInference::types::BatchNorm<T, 128>(
-                    getWeight<T>(weightIndex::layer2_3_bn2_weight),
-                    getWeight<T>(weightIndex::layer2_3_bn2_bias),
-                    getWeight<T>(weightIndex::layer2_3_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer2_3_bn2_running_var));
-                auto image_3_1 = ImageInference::types::Image<T, 0, BlockSize, 128, 28, 28>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<1>(image_3_0, kernel_3_1, batchNorm_3_1, image_3_1);
-                auto kernel_3_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 512, 128, 1, 1>(getWeight<T>(weightIndex::layer2_3_conv3_weight));
-                auto batchNorm_3_2 = ImageInference::types::BatchNorm<T, 512>(
-                    getWeight<T>(weightIndex::layer2_3_bn3_weight),
-                    getWeight<T>(weightIndex::layer2_3_bn3_bias),
-                    getWeight<T>(weightIndex::layer2_3_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer2_3_bn3_running_var));
-                convBlockAddIdentity(image_3_1, kernel_3_2, batchNorm_3_2, image_2_2, output);
+            if constexpr (Stride == 1)
+            {
+                convBlockSpatial<Height, Width>(bottleneck, activations, batch, bottleneckActivations, gemmKernels);
+            }
+            else
+            {
+                dispatchFloat16(bottleneck.kernel2, bottleneck.kernel2Float16, [&](auto &kernel)
+                                {
+                                    for (size_t iImage = 0; iImage < batch; iImage++)
+                                    {
+                                        auto &imageActivations = *activations[iImage];
+                                        auto reduce = Reduce::view(imageActivations.get(bottleneckActivations.reduce));
+                                        auto spatial = Spatial(imageActivations.get(bottleneckActivations.spatial), imageActivations.getSize(bottleneckActivations.spatial), ImageInference::types::ImageInitialization::Padding);
+                                        convBlock<Stride>(reduce, kernel, bottleneck.batchNorm2, spatial, gemmKernels);
+                                    } });
             }
+
+            dispatchFloat16(bottleneck.kernel3, bottleneck.kernel3Float16, bottleneck.projectionKernel, bottleneck.projectionKernelFloat16, [&](auto &kernel, auto &projectionKernel)
+                            {
+                                for (size_t iImage = 0; iImage < batch; iImage++)
+                                {
+                                    auto &imageActivations = *activations[iImage];
+                                    auto spatial = Spatial::view(imageActivations.get(bottleneckActivations.spatial));
+                                    auto image = Input::view(imageActivations.get(input));
+                                    auto output = Output(imageActivations.get(bottleneckActivations.output), imageActivations.getSize(bottleneckActivations.output), ImageInference::types::ImageInitialization::Padding);
+                                    convBlockAddProjection<Stride, OutChannels / InChannels>(spatial, kernel, bottleneck.batchNorm3, image, projectionKernel, bottleneck.projectionBatchNorm, output, gemmKernels);
+                                } });
         }
 
-        template <typename T, size_t BlockSize>
-        void ResNet50::block2(
-            ImageInference::types::Image<T, 0, BlockSize, 512, 28, 28> &input,
-            ImageInference::types::Image<T, 0, BlockSize, 1024, 14, 14> &output)
+        template <size_t Height, size_t Width, typename T, size_t BlockSize, size_t Channels, size_t MidChannels>
+        inline void ResNet50::bottleneckIdentity(
+            ResNet50Bottleneck<T, BlockSize, BlockSize, Channels, MidChannels, Channels> &bottleneck,
+            ResNet50Activations<T> *const *activations,
+            const size_t batch,
+            const typename ResNet50Activations<T>::Bottleneck &bottleneckActivations,
+            const size_t input,
+            const GemmKernels *gemmKernels)
         {
-            auto image_0_2 = ImageInference::types::Image<T, 0, BlockSize, 1024, 14, 14>(); // OutPadding of 0 is because kernel_1_0 is a 1x1 kernel
-            {
-                auto kernel_0_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 512, 1, 1>(getWeight<T>(weightIndex::layer3_0_conv1_weight));
-                auto batchNorm_0_0 = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer3_0_bn1_weight),
-                    getWeight<T>(weightIndex::layer3_0_bn1_bias),
-                    getWeight<T>(weightIndex::layer3_0_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer3_0_bn1_running_var));
-                auto image_0_0 = ImageInference::types::Image<T, 1, BlockSize, 256, 28, 28>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(input, kernel_0_0, batchNorm_0_0, image_0_0);
-                auto kernel_0_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 256, 3, 3>(getWeight<T>(weightIndex::layer3_0_conv2_weight));
-                auto batchNorm_0_1 = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer3_0_bn2_weight),
-                    getWeight<T>(weightIndex::layer3_0_bn2_bias),
-                    getWeight<T>(weightIndex::layer3_0_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer3_0_bn2_running_var));
-                auto image_0_1 = ImageInference::types::Image<T, 0, BlockSize, 256, 14, 14>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<2>(image_0_0, kernel_0_1, batchNorm_0_1, image_0_1);
-                auto kernel_0_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 1024, 256, 1, 1>(getWeight<T>(weightIndex::layer3_0_conv3_weight));
-                auto batchNorm_0_2 = ImageInference::types::BatchNorm<T, 1024>(
-                    getWeight<T>(weightIndex::layer3_0_bn3_weight),
-                    getWeight<T>(weightIndex::layer3_0_bn3_bias),
-                    getWeight<T>(weightIndex::layer3_0_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer3_0_bn3_running_var));
-                auto projectionKernel = ImageInference::types::Kernel<T, BlockSize, BlockSize, 1024, 512, 1, 1>(getWeight<T>(weightIndex::layer3_0_downsample_0_weight));
-                auto projectionBatchNorm = ImageInference::types::BatchNorm<T, 1024>(
-                    getWeight<T>(weightIndex::layer3_0_downsample_1_weight),
-                    getWeight<T>(weightIndex::layer3_0_downsample_1_bias),
-                    getWeight<T>(weightIndex::layer3_0_downsample_1_running_mean),
-                    getWeight<T>(weightIndex::layer3_0_downsample_1_running_var));
-                convBlockAddProjection<2, 2>(image_0_1, kernel_0_2, batchNorm_0_2, input, projectionKernel, projectionBatchNorm, image_0_2);
-            }
-
-            auto image_1_2 = ImageInference::types::Image<T, 0, BlockSize, 1024, 14, 14>(); // OutPadding of 0 is because kernel_2_0 is a 1x1 kernel
-            {
-                auto kernel_1_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 1024, 1, 1>(getWeight<T>(weightIndex::layer3_1_conv1_weight));
-                auto batchNorm_1_0 = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer3_1_bn1_weight),
-                    getWeight<T>(weightIndex::layer3_1_bn1_bias),
-                    getWeight<T>(weightIndex::layer3_1_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer3_1_bn1_running_var));
-                auto image_1_0 = ImageInference::types::Image<T, 1, BlockSize, 256, 14, 14>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(image_0_2, kernel_1_0, batchNorm_1_0, image_1_0);
-                auto kernel_1_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 256, 3, 3>(getWeight<T>(weightIndex::layer3_1_conv2_weight));
-                auto batchNorm_1_1 = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer3_1_bn2_weight),
-                    getWeight<T>(weightIndex::layer3_1_bn2_bias),
-                    getWeight<T>(weightIndex::layer3_1_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer3_1_bn2_running_var));
-                auto image_1_1 = ImageInference::types::Image<T, 0, BlockSize, 256, 14, 14>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<1>(image_1_0, kernel_1_1, batchNorm_1_1, image_1_1);
-                auto kernel_1_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 1024, 256, 1, 1>(getWeight<T>(weightIndex::layer3_1_conv3_weight));
-                auto batchNorm_1_2 = ImageInference::types::BatchNorm<T, 1024>(
-                    getWeight<T>(weightIndex::layer3_1_bn3_weight),
-                    getWeight<T>(weightIndex::layer3_1_bn3_bias),
-                    getWeight<T>(weightIndex::layer3_1_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer3_1_bn3_running_var));
-                convBlockAddIdentity(image_1_1, kernel_1_2, batchNorm_1_2, image_0_2, image_1_2);
-            }
-
-            auto image_2_2 = ImageInference::types::Image<T, 0, BlockSize, 1024, 14, 14>(); // OutPadding of 0 is because kernel_3_0 is a 1x1 kernel
-            {
-                auto kernel_2_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 1024, 1, 1>(getWeight<T>(weightIndex::layer3_2_conv1_weight));
-                auto batchNorm_2_0 = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer3_2_bn1_weight),
-                    getWeight<T>(weightIndex::layer3_2_bn1_bias),
-                    getWeight<T>(weightIndex::layer3_2_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer3_2_bn1_running_var));
-                auto image_2_0 = ImageInference::types::Image<T, 1, BlockSize, 256, 14, 14>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(image_1_2, kernel_2_0, batchNorm_2_0, image_2_0);
-                auto kernel_2_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 256, 3, 3>(getWeight<T>(weightIndex::layer3_2_conv2_weight));
-                auto batchNorm_2_1 = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer3_2_bn2_weight),
-                    getWeight<T>(weightIndex::layer3_2_bn2_bias),
-                    getWeight<T>(weightIndex::layer3_2_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer3_2_bn2_running_var));
-                auto image_2_1 = ImageInference::types::Image<T, 0, BlockSize, 256, 14, 14>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<1>(image_2_0, kernel_2_1, batchNorm_2_1, image_2_1);
-                auto kernel_2_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 1024, 256, 1, 1>(getWeight<T>(weightIndex::layer3_2_conv3_weight));
-                auto batchNorm_2_2 = ImageInference::types::BatchNorm<T, 1024>(
-                    getWeight<T>(weightIndex::layer3_2_bn3_weight),
-                    getWeight<T>(weightIndex::layer3_2_bn3_bias),
-                    getWeight<T>(weightIndex::layer3_2_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer3_2_bn3_running_var));
-                convBlockAddIdentity(image_2_1, kernel_2_2, batchNorm_2_2, image_1_2, image_2_2);
-            }
-
-            auto image_3_2 = ImageInference::types::Image<T, 0, BlockSize, 1024, 14, 14>(); // OutPadding of 0 is because kernel_4_0 is a 1x1 kernel
-            {
-                auto kernel_3_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 1024, 1, 1>(getWeight<T>(weightIndex::layer3_3_conv1_weight));
-                auto batchNorm_3_0 = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer3_3_bn1_weight),
-                    getWeight<T>(weightIndex::layer3_3_bn1_bias),
-                    getWeight<T>(weightIndex::layer3_3_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer3_3_bn1_running_var));
-                auto image_3_0 = ImageInference::types::Image<T, 1, BlockSize, 256, 14, 14>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(image_2_2, kernel_3_0, batchNorm_3_0, image_3_0);
-                auto kernel_3_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 256, 3, 3>(getWeight<T>(weightIndex::layer3_3_conv2_weight));
-                auto batchNorm_3_1 = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer3_3_bn2_weight),
-                    getWeight<T>(weightIndex::layer3_3_bn2_bias),
-                    getWeight<T>(weightIndex::layer3_3_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer3_3_bn2_running_var));
-                auto image_3_1 = ImageInference::types::Image<T, 0, BlockSize, 256, 14, 14>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<1>(image_3_0, kernel_3_1, batchNorm_3_1, image_3_1);
-                auto kernel_3_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 1024, 256, 1, 1>(getWeight<T>(weightIndex::layer3_3_conv3_weight));
-                auto batchNorm_3_2 = ImageInference::types::BatchNorm<T, 1024>(
-                    getWeight<T>(weightIndex::layer3_3_bn3_weight),
-                    getWeight<T>(weightIndex::layer3_3_bn3_bias),
-                    getWeight<T>(weightIndex::layer3_3_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer3_3_bn3_running_var));
-                convBlockAddIdentity(image_3_1, kernel_3_2, batchNorm_3_2, image_2_2, image_3_2);
-            }
-
-            auto image_4_2 = ImageInference::types::Image<T, 0, BlockSize, 1024, 14, 14>(); // OutPadding of 0 is because kernel_5_0 is a 1x1 kernel
-            {
-                auto kernel_4_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 1024, 1, 1>(getWeight<T>(weightIndex::layer3_4_conv1_weight));
-                auto batchNorm_4_0 = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer3_4_bn1_weight),
-                    getWeight<T>(weightIndex::layer3_4_bn1_bias),
-                    getWeight<T>(weightIndex::layer3_4_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer3_4_bn1_running_var));
-                auto image_4_0 = ImageInference::types::Image<T, 1, BlockSize, 256, 14, 14>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(image_3_2, kernel_4_0, batchNorm_4_0, image_4_0);
-                auto kernel_4_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 256, 3, 3>(getWeight<T>(weightIndex::layer3_4_conv2_weight));
-                auto batchNorm_4_1 = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer3_4_bn2_weight),
-                    getWeight<T>(weightIndex::layer3_4_bn2_bias),
-                    getWeight<T>(weightIndex::layer3_4_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer3_4_bn2_running_var));
-                auto image_4_1 = ImageInference::types::Image<T, 0, BlockSize, 256, 14, 14>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<1>(image_4_0, kernel_4_1, batchNorm_4_1, image_4_1);
-                auto kernel_4_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 1024, 256, 1, 1>(getWeight<T>(weightIndex::layer3_4_conv3_weight));
-                auto batchNorm_4_2 = ImageInference::types::BatchNorm<T, 1024>(
-                    getWeight<T>(weightIndex::layer3_4_bn3_weight),
-                    getWeight<T>(weightIndex::layer3_4_bn3_bias),
-                    getWeight<T>(weightIndex::layer3_4_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer3_4_bn3_running_var));
-                convBlockAddIdentity(image_4_1, kernel_4_2, batchNorm_4_2, image_3_2, image_4_2);
-            }
-
-            {
-                auto kernel_5_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 1024, 1, 1>(getWeight<T>(weightIndex::layer3_5_conv1_weight));
-                auto batchNorm_5_0 = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer3_5_bn1_weight),
-                    getWeight<T>(weightIndex::layer3_5_bn1_bias),
-                    getWeight<T>(weightIndex::layer3_5_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer3_5_bn1_running_var));
-                auto image_5_0 = ImageInference::types::Image<T, 1, BlockSize, 256, 14, 14>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(image_4_2, kernel_5_0, batchNorm_5_0, image_5_0);
-                auto kernel_5_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 256, 256, 3, 3>(getWeight<T>(weightIndex::layer3_5_conv2_weight));
-                auto batchNorm_5_1 = ImageInference::types::BatchNorm<T, 256>(
-                    getWeight<T>(weightIndex::layer3_5_bn2_weight),
-                    getWeight<T>(weightIndex::layer3_5_bn2_bias),
-                    getWeight<T>(weightIndex::layer3_5_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer3_5_bn2_running_var));
-                auto image_5_1 = ImageInference::types::Image<T, 0, BlockSize, 256, 14, 14>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<1>(image_5_0, kernel_5_1, batchNorm_5_1, image_5_1);
-                auto kernel_5_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 1024, 256, 1, 1>(getWeight<T>(weightIndex::layer3_5_conv3_weight));
-                auto batchNorm_5_2 = ImageInference::types::BatchNorm<T, 1024>(
-                    getWeight<T>(weightIndex::layer3_5_bn3_weight),
-                    getWeight<T>(weightIndex::layer3_5_bn3_bias),
-                    getWeight<T>(weightIndex::layer3_5_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer3_5_bn3_running_var));
-                convBlockAddIdentity(image_5_1, kernel_5_2, batchNorm_5_2, image_4_2, output);
+            using Input = ImageInference::types::Image<T, 0, BlockSize, Channels, Height, Width>;
+            using Reduce = ImageInference::types::Image<T, 1, BlockSize, MidChannels, Height, Width>; // OutPadding of 1 is because a 3x3 kernel is coming next
+            using Spatial = ImageInference::types::Image<T, 0, BlockSize, MidChannels, Height, Width>;
+            using Output = ImageInference::types::Image<T, 0, BlockSize, Channels, Height, Width>; // OutPadding of 0 is because the next bottleneck starts with a 1x1 kernel
+
+            constexpr const size_t weightsSize = sizeof(T) * (2 * Channels * MidChannels + 3 * 3 * MidChannels * MidChannels);
+            if constexpr (std::is_same<T, float>::value && weightsSize <= RESNET50_FUSED_WEIGHTS)
+            {
+                if (!bottleneck.kernel2Winograd && !bottleneck.kernel1Float16 && ResNet50Tuning::threads() * RESNET50_FUSED_ROWS <= Height)
+                {
+                    for (size_t iImage = 0; iImage < batch; iImage++)
+                    {
+                        auto &imageActivations = *activations[iImage];
+                        auto image = Input::view(imageActivations.get(input));
+                        auto output = Output(imageActivations.get(bottleneckActivations.output), imageActivations.getSize(bottleneckActivations.output), ImageInference::types::ImageInitialization::Padding);
+                        bottleneckFused(bottleneck, imageActivations, image, output, gemmKernels);
+                    }
+                    return;
+                }
             }
+
+            dispatchFloat16(bottleneck.kernel1, bottleneck.kernel1Float16, [&](auto &kernel)
+                            {
+                                for (size_t iImage = 0; iImage < batch; iImage++)
+                                {
+                                    auto &imageActivations = *activations[iImage];
+                                    auto image = Input::view(imageActivations.get(input));
+                                    auto reduce = Reduce(imageActivations.get(bottleneckActivations.reduce), imageActivations.getSize(bottleneckActivations.reduce), ImageInference::types::ImageInitialization::Padding);
+                                    convBlock<1>(image, kernel, bottleneck.batchNorm1, reduce, gemmKernels);
+                                } });
+            convBlockSpatial<Height, Width>(bottleneck, activations, batch, bottleneckActivations, gemmKernels);
+            dispatchFloat16(bottleneck.kernel3, bottleneck.kernel3Float16, [&](auto &kernel)
+                            {
+                                for (size_t iImage = 0; iImage < batch; iImage++)
+                                {
+                                    auto &imageActivations = *activations[iImage];
+                                    auto spatial = Spatial::view(imageActivations.get(bottleneckActivations.spatial));
+                                    auto image = Input::view(imageActivations.get(input));
+                                    auto output = Output(imageActivations.get(bottleneckActivations.output), imageActivations.getSize(bottleneckActivations.output), ImageInference::types::ImageInitialization::Padding);
+                                    convBlockAddIdentity(spatial, kernel, bottleneck.batchNorm3, image, output, gemmKernels);
+                                } });
         }
 
-        template <typename T, size_t BlockSize>
-        void ResNet50::block3(
-            ImageInference::types::Image<T, 0, BlockSize, 1024, 14, 14> &input,
-            ImageInference::types::Image<T, 0, BlockSize, 2048, 7, 7> &output)
+        template <typename T, size_t BlockSize, size_t Channels, size_t MidChannels, size_t Height, size_t Width>
+        inline void ResNet50::bottleneckFused(
+            ResNet50Bottleneck<T, BlockSize, BlockSize, Channels, MidChannels, Channels> &bottleneck,
+            ResNet50Activations<T> &activations,
+            ImageInference::types::Image<T, 0, BlockSize, Channels, Height, Width> &input,
+            ImageInference::types::Image<T, 0, BlockSize, Channels, Height, Width> &output,
+            const GemmKernels *gemmKernels)
         {
-            auto image_0_2 = ImageInference::types::Image<T, 0, BlockSize, 2048, 7, 7>(); // OutPadding of 0 is because kernel_1_0 is a 1x1 kernel
-            {
-                auto kernel_0_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 512, 1024, 1, 1>(getWeight<T>(weightIndex::layer4_0_conv1_weight));
-                auto batchNorm_0_0 = ImageInference::types::BatchNorm<T, 512>(
-                    getWeight<T>(weightIndex::layer4_0_bn1_weight),
-                    getWeight<T>(weightIndex::layer4_0_bn1_bias),
-                    getWeight<T>(weightIndex::layer4_0_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer4_0_bn1_running_var));
-                auto image_0_0 = ImageInference::types::Image<T, 1, BlockSize, 512, 14, 14>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(input, kernel_0_0, batchNorm_0_0, image_0_0);
-                auto kernel_0_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 512, 512, 3, 3>(getWeight<T>(weightIndex::layer4_0_conv2_weight));
-                auto batchNorm_0_1 = ImageInference::types::BatchNorm<T, 512>(
-                    getWeight<T>(weightIndex::layer4_0_bn2_weight),
-                    getWeight<T>(weightIndex::layer4_0_bn2_bias),
-                    getWeight<T>(weightIndex::layer4_0_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer4_0_bn2_running_var));
-                auto image_0_1 = ImageInference::types::Image<T, 0, BlockSize, 512, 7, 7>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<2>(image_0_0, kernel_0_1, batchNorm_0_1, image_0_1);
-                auto kernel_0_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 2048, 512, 1, 1>(getWeight<T>(weightIndex::layer4_0_conv3_weight));
-                auto batchNorm_0_2 = ImageInference::types::BatchNorm<T, 2048>(
-                    getWeight<T>(weightIndex::layer4_0_bn3_weight),
-                    getWeight<T>(weightIndex::layer4_0_bn3_bias),
-                    getWeight<T>(weightIndex::layer4_0_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer4_0_bn3_running_var));
-                auto projectionKernel = ImageInference::types::Kernel<T, BlockSize, BlockSize, 2048, 1024, 1, 1>(getWeight<T>(weightIndex::layer4_0_downsample_0_weight));
-                auto projectionBatchNorm = ImageInference::types::BatchNorm<T, 2048>(
-                    getWeight<T>(weightIndex::layer4_0_downsample_1_weight),
-                    getWeight<T>(weightIndex::layer4_0_downsample_1_bias),
-                    getWeight<T>(weightIndex::layer4_0_downsample_1_running_mean),
-                    getWeight<T>(weightIndex::layer4_0_downsample_1_running_var));
-                convBlockAddProjection<2, 2>(image_0_1, kernel_0_2, batchNorm_0_2, input, projectionKernel, projectionBatchNorm, image_0_2);
-            }
-
-            auto image_1_2 = ImageInference::types::Image<T, 0, BlockSize, 2048, 7, 7>(); // OutPadding of 0 is because kernel_2_0 is a 1x1 kernel
-            {
-                auto kernel_1_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 512, 2048, 1, 1>(getWeight<T>(weightIndex::layer4_1_conv1_weight));
-                auto batchNorm_1_0 = ImageInference::types::BatchNorm<T, 512>(
-                    getWeight<T>(weightIndex::layer4_1_bn1_weight),
-                    getWeight<T>(weightIndex::layer4_1_bn1_bias),
-                    getWeight<T>(weightIndex::layer4_1_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer4_1_bn1_running_var));
-                auto image_1_0 = ImageInference::types::Image<T, 1, BlockSize, 512, 7, 7>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(image_0_2, kernel_1_0, batchNorm_1_0, image_1_0);
-                auto kernel_1_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 512, 512, 3, 3>(getWeight<T>(weightIndex::layer4_1_conv2_weight));
-                auto batchNorm_1_1 = ImageInference::types::BatchNorm<T, 512>(
-                    getWeight<T>(weightIndex::layer4_1_bn2_weight),
-                    getWeight<T>(weightIndex::layer4_1_bn2_bias),
-                    getWeight<T>(weightIndex::layer4_1_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer4_1_bn2_running_var));
-                auto image_1_1 = ImageInference::types::Image<T, 0, BlockSize, 512, 7, 7>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<1>(image_1_0, kernel_1_1, batchNorm_1_1, image_1_1);
-                auto kernel_1_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 2048, 512, 1, 1>(getWeight<T>(weightIndex::layer4_1_conv3_weight));
-                auto batchNorm_1_2 = ImageInference::types::BatchNorm<T, 2048>(
-                    getWeight<T>(weightIndex::layer4_1_bn3_weight),
-                    getWeight<T>(weightIndex::layer4_1_bn3_bias),
-                    getWeight<T>(weightIndex::layer4_1_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer4_1_bn3_running_var));
-                convBlockAddIdentity(image_1_1, kernel_1_2, batchNorm_1_2, image_0_2, image_1_2);
-            }
-
-            {
-                auto kernel_2_0 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 512, 2048, 1, 1>(getWeight<T>(weightIndex::layer4_2_conv1_weight));
-                auto batchNorm_2_0 = ImageInference::types::BatchNorm<T, 512>(
-                    getWeight<T>(weightIndex::layer4_2_bn1_weight),
-                    getWeight<T>(weightIndex::layer4_2_bn1_bias),
-                    getWeight<T>(weightIndex::layer4_2_bn1_running_mean),
-                    getWeight<T>(weightIndex::layer4_2_bn1_running_var));
-                auto image_2_0 = ImageInference::types::Image<T, 1, BlockSize, 512, 7, 7>(); // OutPadding of 1 is because a 3x3 kernel is coming next
-                convBlock<1>(image_1_2, kernel_2_0, batchNorm_2_0, image_2_0);
-                auto kernel_2_1 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 512, 512, 3, 3>(getWeight<T>(weightIndex::layer4_2_conv2_weight));
-                auto batchNorm_2_1 = ImageInference::types::BatchNorm<T, 512>(
-                    getWeight<T>(weightIndex::layer4_2_bn2_weight),
-                    getWeight<T>(weightIndex::layer4_2_bn2_bias),
-                    getWeight<T>(weightIndex::layer4_2_bn2_running_mean),
-                    getWeight<T>(weightIndex::layer4_2_bn2_running_var));
-                auto image_2_1 = ImageInference::types::Image<T, 0, BlockSize, 512, 7, 7>(); // OutPadding of 0 is because a 1x1 kernel is coming next
-                convBlock<1>(image_2_0, kernel_2_1, batchNorm_2_1, image_2_1);
-                auto kernel_2_2 = ImageInference::types::Kernel<T, BlockSize, BlockSize, 2048, 512, 1, 1>(getWeight<T>(weightIndex::layer4_2_conv3_weight));
-                auto batchNorm_2_2 = ImageInference::types::BatchNorm<T, 2048>(
-                    getWeight<T>(weightIndex::layer4_2_bn3_weight),
-                    getWeight<T>(weightIndex::layer4_2_bn3_bias),
-                    getWeight<T>(weightIndex::layer4_2_bn3_running_mean),
-                    getWeight<T>(weightIndex::layer4_2_bn3_running_var));
-                convBlockAddIdentity<0>(image_2_1, kernel_2_2, batchNorm_2_2, image_1_2, output);
+            constexpr const size_t channelBlocks = Channels / BlockSize;
+            constexpr const size_t midBlocks = MidChannels / BlockSize;
+            constexpr const size_t rows = gemmRows<1, 0, 0, 1, 1, Height, Width>();
+            constexpr const size_t bands = Height / rows;
+
+            // The reduced rows of a band with a halo row above and below, padded for the 3x3 convolution.
+            // The band row iRow holds the image row iHeight + iRow - 1 of the band starting at iHeight.
+            using Band = ImageInference::types::Image<T, 1, BlockSize, MidChannels, rows, Width>;
+            // The rows of the 3x3 convolution of a band, read by one gemm of the expand convolution.
+            using BandSpatial = ImageInference::types::Image<T, 0, BlockSize, MidChannels, rows, Width>;
+            constexpr const size_t scratchSize = Band::size + BandSpatial::size;
+
+            // Every thread gets consecutive bands, so only the halo of its first band is computed twice.
+            const size_t threads = std::min(ResNet50Tuning::threads(), bands);
+            T *scratch = activations.getFusedScratch(threads * scratchSize);
+
+            libxsmm_datatype datatype;
+            if constexpr (std::is_same<T, float>::value)
+            {
+                datatype = LIBXSMM_DATATYPE(float);
+            }
+            else
+            {
+                std::cerr << "ResNet50::bottleneckFused: type is currently not supported! Supported are float." << std::endl;
+                throw std::runtime_error("ResNet50::bottleneckFused: type is currently not supported!");
+            }
+
+            // The 1x1 convolutions read unpadded rows and the 3x3 convolution has a stride of 1, so all use the gemms of the bottleneck.
+            constexpr const int NN = BlockSize;
+            constexpr const int KK = BlockSize;
+            const libxsmm_gemmfunction rowGemm = GemmKernels::get(
+                gemmKernels,
+                GemmShape{NN, static_cast<int>(Width), KK, NN, KK, NN, datatype, true, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET},
+                "ResNet50::bottleneckFused");
+            const libxsmm_gemmfunction bandGemm = GemmKernels::get(
+                gemmKernels,
+                GemmShape{NN, static_cast<int>(rows * Width), KK, NN, KK, NN, datatype, true, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET},
+                "ResNet50::bottleneckFused");
+
+            // The offsets only depend on the strides, so they are the same for the bands of all threads.
+            auto bandLayout = Band::view(scratch);
+            auto bandSpatialLayout = BandSpatial::view(scratch + Band::size);
+            std::array<unsigned long long, channelBlocks> reduceImageOffsets;
+            std::array<unsigned long long, channelBlocks> reduceKernelOffsets;
+            batchReduceOffsets<T, channelBlocks, 1, 1>(input, bottleneck.kernel1, reduceImageOffsets, reduceKernelOffsets);
+            std::array<unsigned long long, midBlocks * 3 * 3> spatialImageOffsets;
+            std::array<unsigned long long, midBlocks * 3 * 3> spatialKernelOffsets;
+            batchReduceOffsets<T, midBlocks, 3, 3>(bandLayout, bottleneck.kernel2, spatialImageOffsets, spatialKernelOffsets);
+            std::array<unsigned long long, midBlocks> expandImageOffsets;
+            std::array<unsigned long long, midBlocks> expandKernelOffsets;
+            batchReduceOffsets<T, midBlocks, 1, 1>(bandSpatialLayout, bottleneck.kernel3, expandImageOffsets, expandKernelOffsets);
+
+            const auto inputPtr = input.getPointer();                              // ChannelBlocks x Height x Width x ChannelElements
+            auto outputPtr = output.getPointer();                                  // ChannelBlocks x Height x Width x ChannelElements
+            const auto kernel1Ptr = bottleneck.kernel1.getPointer();               // MidBlocks x ChannelBlocks x 1 x 1 x ChannelElements x MidElements
+            const auto kernel2Ptr = bottleneck.kernel2.getPointer();               // MidBlocks x MidBlocks x 3 x 3 x MidElements x MidElements
+            const auto kernel3Ptr = bottleneck.kernel3.getPointer();               // ChannelBlocks x MidBlocks x 1 x 1 x MidElements x ChannelElements
+            const auto bias1Ptr = bottleneck.batchNorm1.getBiasPointer();          // MidChannels
+            const auto bias2Ptr = bottleneck.batchNorm2.getBiasPointer();          // MidChannels
+            const auto bias3Ptr = bottleneck.batchNorm3.getBiasPointer();          // Channels
+            const VectorKernels &vectorKernels = VectorKernels::host();
+
+#ifdef USE_OMP
+#pragma omp parallel for
+#endif // USE_OMP
+            for (size_t iThread = 0; iThread < threads; iThread++)
+            {
+                // The padding columns of the band are zeroed once and never written.
+                auto band = Band(scratch + iThread * scratchSize, Band::size, ImageInference::types::ImageInitialization::Padding);
+                auto bandSpatial = BandSpatial(scratch + iThread * scratchSize + Band::size, BandSpatial::size, ImageInference::types::ImageInitialization::Padding);
+                const auto bandPtr = band.getPointer();
+                const auto bandSpatialPtr = bandSpatial.getPointer();
+
+                const size_t firstBand = iThread * bands / threads;
+                const size_t lastBand = (iThread + 1) * bands / threads;
+                for (size_t iBand = firstBand; iBand < lastBand; iBand++)
+                {
+                    const size_t iHeight = iBand * rows;
+
+                    // The last two reduced rows of the previous band are the first two of this band.
+                    size_t firstRow = 0;
+                    if (iBand != firstBand)
+                    {
+                        for (size_t iBMid = 0; iBMid < midBlocks; iBMid++)
+                        {
+                            std::memmove(bandPtr + band.getOffset(iBMid, 0, 0, 0), bandPtr + band.getOffset(iBMid, rows, 0, 0), 2 * Band::strideHeight * sizeof(T));
+                        }
+                        firstRow = 2;
+                    }
+
+                    // 1x1 reduce, the halo rows outside of the image are the zero padding of the 3x3 convolution.
+                    for (size_t iRow = firstRow; iRow < rows + 2; iRow++)
+                    {
+                        const bool padding = iHeight + iRow == 0 || iHeight + iRow > Height;
+                        for (size_t iBMid = 0; iBMid < midBlocks; iBMid++)
+                        {
+                            T *rowPtr = bandPtr + band.getOffset(iBMid, iRow, 1, 0);
+                            if (padding)
+                            {
+                                std::fill(rowPtr, rowPtr + Width * BlockSize, T(0));
+                                continue;
+                            }
+
+                            unsigned long long count = channelBlocks;
+                            libxsmm_gemm_param param;
+                            param.a.primary = kernel1Ptr + bottleneck.kernel1.getOffset(iBMid, 0, 0, 0, 0, 0);
+                            param.a.secondary = reduceKernelOffsets.data();
+                            param.b.primary = inputPtr + input.getOffset(0, iHeight + iRow - 1, 0, 0);
+                            param.b.secondary = reduceImageOffsets.data();
+                            param.c.primary = rowPtr;
+                            param.op.tertiary = &count;
+                            rowGemm(&param);
+
+                            vectorKernels.biasRelu(rowPtr, bias1Ptr + iBMid * BlockSize, Width, BlockSize);
+                        }
+                    }
+
+                    // 3x3 spatial on the band.
+                    for (size_t iBMid = 0; iBMid < midBlocks; iBMid++)
+                    {
+                        for (size_t iRow = 0; iRow < rows; iRow++)
+                        {
+                            T *rowPtr = bandSpatialPtr + bandSpatial.getOffset(iBMid, iRow, 0, 0);
+
+                            unsigned long long count = midBlocks * 3 * 3;
+                            libxsmm_gemm_param param;
+                            param.a.primary = kernel2Ptr + bottleneck.kernel2.getOffset(iBMid, 0, 0, 0, 0, 0);
+                            param.a.secondary = spatialKernelOffsets.data();
+                            param.b.primary = bandPtr + band.getOffset(0, iRow, 0, 0);
+                            param.b.secondary = spatialImageOffsets.data();
+                            param.c.primary = rowPtr;
+                            param.op.tertiary = &count;
+                            rowGemm(&param);
+
+                            vectorKernels.biasRelu(rowPtr, bias2Ptr + iBMid * BlockSize, Width, BlockSize);
+                        }
+                    }
+
+                    // 1x1 expand of the whole band with the identity shortcut.
+                    for (size_t iBCount = 0; iBCount < channelBlocks; iBCount++)
+                    {
+                        unsigned long long count = midBlocks;
+                        libxsmm_gemm_param param;
+                        param.a.primary = kernel3Ptr + bottleneck.kernel3.getOffset(iBCount, 0, 0, 0, 0, 0);
+                        param.a.secondary = expandKernelOffsets.data();
+                        param.b.primary = bandSpatialPtr;
+                        param.b.secondary = expandImageOffsets.data();
+                        param.c.primary = outputPtr + output.getOffset(iBCount, iHeight, 0, 0);
+                        param.op.tertiary = &count;
+                        bandGemm(&param);
+
+                        for (size_t iRow = iHeight; iRow < iHeight + rows; iRow++)
+                        {
+                            vectorKernels.biasAddRelu(outputPtr + output.getOffset(iBCount, iRow, 0, 0), bias3Ptr + iBCount * BlockSize,
+                                                      inputPtr + input.getOffset(iBCount, iRow, 0, 0), Width, BlockSize);
+                        }
+                    }
+                }
             }
         }
 
         template <size_t Stride, size_t OutPadding, size_t InPadding,
-                  typename T, size_t BlockSizeCount, size_t BlockSizeChannel,
+                  typename T, typename TWeight, size_t BlockSizeCount, size_t BlockSizeChannel,
                   size_t ImageChannels, size_t ImageHeight, size_t ImageWidth,
-                  size_t KernelCount, size_t KernelHeight, size_t KernelWidth>
+                  size_t KernelCount, size_t KernelHeight, size_t KernelWidth, bool BatchNormFolded>
         inline void ResNet50::convBlock(
             ImageInference::types::Image<T, InPadding, BlockSizeChannel, ImageChannels, ImageHeight, ImageWidth> &image,
-            ImageInference::types::Kernel<T, BlockSizeCount, BlockSizeChannel, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
-            ImageInference::types::BatchNorm<T, KernelCount> &batchNorm,
-            ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight / Stride, ImageWidth / Stride> &output)
+            ImageInference::types::Kernel<TWeight, BlockSizeCount, BlockSizeChannel, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
+            ImageInference::types::BatchNorm<typename ImageInference::types::Parameter<T>::type, KernelCount, BatchNormFolded> &batchNorm,
+            ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight / Stride, ImageWidth / Stride> &output,
+            const GemmKernels *gemmKernels)
         {
             if constexpr (InPadding != KernelHeight / 2 || InPadding != KernelWidth / 2)
             {
@@ -924,6 +1160,11 @@ namespace ImageInference
                 throw std::runtime_error("ResNet50::convBlock: Padding is too small or to large for the kernel size!");
             }
 
+            using TAccumulator = typename ImageInference::types::Accumulator<T>::type;
+            using TParameter = typename ImageInference::types::Parameter<T>::type;
+            static_assert(std::is_same<TWeight, typename ImageInference::types::Weight<T>::type>::value ||
+                              (std::is_same<T, float>::value && std::is_same<TWeight, ImageInference::types::Float16>::value),
+                          "ResNet50::convBlock: The kernel needs the weight type of T or Float16 for float.");
             constexpr const size_t countBlocks = KernelCount / BlockSizeCount;
             constexpr const size_t channelBlocks = ImageChannels / BlockSizeChannel;
             constexpr const size_t outputHeight = ImageHeight / Stride;
@@ -936,6 +1177,11 @@ namespace ImageInference
             const auto gammaVariancePtr = batchNorm.getGammaVariancePointer(); // Count = CountBlocks x CountElements
             const auto betaPtr = batchNorm.getBetaPointer();                   // Count = CountBlocks x CountElements
             const auto meanPtr = batchNorm.getMeanPointer();                   // Count = CountBlocks x CountElements
+            const TParameter *biasPtr = nullptr;                                          // Count = CountBlocks x CountElements
+            if constexpr (BatchNormFolded)
+            {
+                biasPtr = batchNorm.getBiasPointer();
+            }
 
             // Kernel of shape BlockSizeChannel x BlockSizeCount
             // Input of shape ImageWidth x BlockSizeChannel
@@ -944,49 +1190,68 @@ namespace ImageInference
             // If we use libxsmm directly we don't need to do add separately!
             // If we use the leading dimension on the image we can use it as stride.
             // With the leading dimension we skip the next blocks as they should be skipped by the stride.
-            constexpr int MM = outputWidth;
+            constexpr const size_t rows = gemmRows<Stride, InPadding, OutPadding, KernelHeight, KernelWidth, outputHeight, outputWidth>();
+            constexpr int MM = rows * outputWidth;
             constexpr int KK = BlockSizeChannel;
             constexpr int NN = BlockSizeCount;
             constexpr int ldImage = KK * Stride;
 
-            constexpr char transa = 'N';
-            constexpr char transb = 'N';
 
             libxsmm_datatype datatype;
             if constexpr (std::is_same<T, float>::value)
             {
                 datatype = LIBXSMM_DATATYPE(float);
             }
+            else if constexpr (std::is_same<T, ImageInference::types::BFloat16>::value)
+            {
+                datatype = LIBXSMM_DATATYPE_BF16;
+            }
+            else if constexpr (std::is_same<T, uint8_t>::value)
+            {
+                datatype = LIBXSMM_DATATYPE_I8;
+            }
             else
             {
-                std::cerr << "ResNet50::convBlock: type is currently not supported! Supported are float." << std::endl;
+                std::cerr << "ResNet50::convBlock: type is currently not supported! Supported are float, BFloat16 and uint8_t." << std::endl;
                 throw std::runtime_error("ResNet50::convBlock: type is currently not supported!");
             }
 
-            const libxsmm_gemm_shape shape = libxsmm_create_gemm_shape(
-                NN /*required*/,
-                MM /*required*/,
-                KK /*required*/,
-                NN /*lda*/,
-                ldImage /*ldb*/,
-                NN /*ldc*/,
-                datatype, // input type
-                datatype, // input type
-                datatype, // output type
-                datatype  // outputtype
-            );
-            const libxsmm_bitfield flags = LIBXSMM_GEMM_FLAGS(transa, transb);
-
-            const libxsmm_gemmfunction gemmFunc = libxsmm_dispatch_gemm(
-                shape,
-                flags,
-                (libxsmm_bitfield)(LIBXSMM_PREFETCH) // Default from libxsmm_sgemm
-            );
+            // All (channel block, kernel row, kernel column) gemms of an output row are reduced in a single batch-reduce gemm,
+            // which keeps the output row in registers and overwrites the output with the sum.
+            constexpr const size_t batchCount = channelBlocks * KernelHeight * KernelWidth;
+            std::array<unsigned long long, batchCount> imageOffsets;
+            std::array<unsigned long long, batchCount> kernelOffsets;
+            batchReduceOffsets<T, channelBlocks, KernelHeight, KernelWidth>(image, kernel, imageOffsets, kernelOffsets);
+            unsigned long long count = batchCount;
+
+            const libxsmm_gemmfunction gemmFunc = GemmKernels::get(
+                gemmKernels,
+                GemmShape{NN, MM, KK, NN, ldImage, NN, datatype, true, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET},
+                "ResNet50::convBlock");
+
+            // Kernels stored in Float16 accumulate all but their first chunk of taps into the output, see batchReduceFloat16.
+            constexpr const bool widening = std::is_same<TWeight, ImageInference::types::Float16>::value;
+            libxsmm_gemmfunction accumulateFunc = nullptr;
+            if constexpr (widening)
+            {
+                accumulateFunc = GemmKernels::get(
+                    gemmKernels,
+                    GemmShape{NN, MM, KK, NN, ldImage, NN, datatype, false, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET},
+                    "ResNet50::convBlock");
+            }
 
-            if (gemmFunc == NULL)
+            // The folded batch norm of float uses the hand vectorized kernels of the host, see VectorKernels.
+            // Types that accumulate in another type e.g. BFloat16 write the gemm into a tile, whose epilogue rounds it into the output.
+            // The epilogue of uint8_t requantizes the int32_t tile with the scales of the batch norm, see BatchNorm::requantize.
+            constexpr const bool vectorized = std::is_same<T, float>::value && BatchNormFolded;
+            constexpr const bool tiled = !std::is_same<T, TAccumulator>::value;
+            constexpr const bool quantized = std::is_same<T, uint8_t>::value;
+            static_assert(!tiled || BatchNormFolded, "ResNet50::convBlock: Types with another accumulator type need a folded batch norm.");
+            const VectorKernels &vectorKernels = VectorKernels::host();
+            const TParameter *scalePtr = nullptr; // Count = CountBlocks x CountElements
+            if constexpr (quantized)
             {
-                std::cerr << "ResNet50::convBlock: libxsmm_dispatch_gemm failed!" << std::endl;
-                throw std::runtime_error("ResNet50::convBlock: libxsmm_dispatch_gemm failed!");
+                scalePtr = batchNorm.getScalePointer();
             }
 
 #ifdef USE_OMP
@@ -994,239 +1259,903 @@ namespace ImageInference
 #endif // USE_OMP
             for (size_t iBCount = 0; iBCount < countBlocks; iBCount++)
             {
-                for (size_t iHeight = 0; iHeight < outputHeight; iHeight++)
+                for (size_t iHeight = 0; iHeight < outputHeight; iHeight += rows)
                 {
                     // Do convolution calculation
-                    for (size_t iBChannel = 0; iBChannel < channelBlocks; iBChannel++)
-                    {
-                        for (size_t kHeight = 0; kHeight < KernelHeight; kHeight++)
-                        {
-                            for (size_t kWidth = 0; kWidth < KernelWidth; kWidth++)
-                            {
-                                const size_t imageOffset = image.getOffset(iBChannel, iHeight * Stride + kHeight, kWidth, 0);
-                                const size_t kernelOffset = kernel.getOffset(iBCount, iBChannel, kHeight, kWidth, 0, 0);
-                                const size_t outputOffset = output.getOffset(iBCount, iHeight, 0, 0);
+                    const size_t imageOffset = image.getOffset(0, iHeight * Stride, 0, 0);
+                    const size_t kernelOffset = kernel.getOffset(iBCount, 0, 0, 0, 0, 0);
+                    const size_t outputOffset = output.getOffset(iBCount, iHeight, 0, 0);
 
 #ifdef IMAGEINFERENCE_TESTING
-                                // Get the last element touched by the matmul.
-                                image.getOffset(iBChannel, iHeight * Stride + kHeight, ImageWidth - 1 + kWidth, BlockSizeChannel - 1);
-                                kernel.getOffset(iBCount, iBChannel, kHeight, kWidth, BlockSizeChannel - 1, BlockSizeCount - 1);
-                                // Adding padding offset as this is already applied at the output.
-                                output.getOffset(iBCount, iHeight, outputWidth - 1, BlockSizeCount - 1 + output.paddingOffset);
+                    // Get the last element touched by the batch.
+                    image.getOffset(channelBlocks - 1, (iHeight + rows - 1) * Stride + KernelHeight - 1, ImageWidth - 1 + KernelWidth - 1, BlockSizeChannel - 1);
+                    kernel.getOffset(iBCount, channelBlocks - 1, KernelHeight - 1, KernelWidth - 1, BlockSizeChannel - 1, BlockSizeCount - 1);
+                    // Adding padding offset as this is already applied at the output.
+                    output.getOffset(iBCount, iHeight + rows - 1, outputWidth - 1, BlockSizeCount - 1 + output.paddingOffset);
 #endif // IMAGEINFERENCE_TESTING
 
-                                libxsmm_gemm_param param;
-                                param.a.primary = kernelPtr + kernelOffset;
-                                param.b.primary = imagePtr + imageOffset;
-                                param.c.primary = outputPtr + outputOffset;
-
-                                LIBXSMM_XGEMM_PREFETCH(
-                                    datatype,
-                                    datatype,
-                                    NN,
-                                    MM,
-                                    KK,
-                                    param);
-
-                                gemmFunc(&param);
-                            }
-                        }
+                    // Kernel of shape BlockSizeChannel x BlockSizeCount
+                    // Input of shape (rows x outputWidth) x BlockSizeChannel, strided by ldImage
+                    // Output of shape (rows x outputWidth) x BlockSizeCount
+                    alignas(64) TAccumulator tile[tiled ? MM * NN : 1];
+                    libxsmm_gemm_param param;
+                    param.a.primary = kernelPtr + kernelOffset;
+                    param.a.secondary = kernelOffsets.data();
+                    param.b.primary = imagePtr + imageOffset;
+                    param.b.secondary = imageOffsets.data();
+                    if constexpr (tiled)
+                    {
+                        param.c.primary = tile;
+                    }
+                    else
+                    {
+                        param.c.primary = outputPtr + outputOffset;
+                    }
+                    param.op.tertiary = &count;
+                    if constexpr (widening)
+                    {
+                        batchReduceFloat16<BlockSizeChannel * BlockSizeCount>(kernelPtr + kernelOffset, kernelOffsets, imagePtr + imageOffset, imageOffsets,
+                                                                              outputPtr + outputOffset, gemmFunc, accumulateFunc);
+                    }
+                    else
+                    {
+                        gemmFunc(&param);
                     }
 
-                    // At this point we completed a complete row of the output.
+                    // At this point we completed complete rows of the output.
                     // Now we apply the batch norm and relu.
-                    for (size_t iWidth = 0; iWidth < outputWidth; iWidth++)
+                    if constexpr (quantized)
+                    {
+                        for (size_t iRow = iHeight; iRow < iHeight + rows; iRow++)
+                        {
+                            vectorKernels.requantizeRelu(outputPtr + output.getOffset(iBCount, iRow, 0, 0), tile + (iRow - iHeight) * outputWidth * NN,
+                                                         scalePtr + iBCount * BlockSizeCount, biasPtr + iBCount * BlockSizeCount, outputWidth, BlockSizeCount);
+                        }
+                    }
+                    else if constexpr (tiled)
+                    {
+                        for (size_t iRow = iHeight; iRow < iHeight + rows; iRow++)
+                        {
+                            vectorKernels.biasReluBFloat16(outputPtr + output.getOffset(iBCount, iRow, 0, 0), tile + (iRow - iHeight) * outputWidth * NN,
+                                                           biasPtr + iBCount * BlockSizeCount, outputWidth, BlockSizeCount);
+                        }
+                    }
+                    else if constexpr (vectorized)
+                    {
+                        for (size_t iRow = iHeight; iRow < iHeight + rows; iRow++)
+                        {
+                            vectorKernels.biasRelu(outputPtr + output.getOffset(iBCount, iRow, 0, 0), biasPtr + iBCount * BlockSizeCount, outputWidth, BlockSizeCount);
+                        }
+                    }
+                    else
                     {
+                        for (size_t iRow = iHeight; iRow < iHeight + rows; iRow++)
+                        {
+                            for (size_t iWidth = 0; iWidth < outputWidth; iWidth++)
+                            {
 #ifdef USE_OMP
 #pragma omp simd
 #endif // USE_OMP
-                        for (size_t iCount = 0; iCount < BlockSizeCount; iCount++)
-                        {
-                            const size_t offsetOutput = output.getOffset(iBCount, iHeight, iWidth, iCount);
-                            const size_t offsetCount = iBCount * BlockSizeCount + iCount;
-                            outputPtr[offsetOutput] = relu<T>(ResNet50::batchNorm<T>(
-                                outputPtr[offsetOutput],
-                                gammaVariancePtr[offsetCount],
-                                betaPtr[offsetCount],
-                                meanPtr[offsetCount]));
+                                for (size_t iCount = 0; iCount < BlockSizeCount; iCount++)
+                                {
+                                    const size_t offsetOutput = output.getOffset(iBCount, iRow, iWidth, iCount);
+                                    const size_t offsetCount = iBCount * BlockSizeCount + iCount;
+                                    if constexpr (BatchNormFolded)
+                                    {
+                                        outputPtr[offsetOutput] = relu<T>(outputPtr[offsetOutput] + biasPtr[offsetCount]);
+                                    }
+                                    else
+                                    {
+                                        outputPtr[offsetOutput] = relu<T>(ResNet50::batchNorm<T>(
+                                            outputPtr[offsetOutput],
+                                            gammaVariancePtr[offsetCount],
+                                            betaPtr[offsetCount],
+                                            meanPtr[offsetCount]));
+                                    }
+                                }
+                            }
                         }
                     }
                 }
             }
         }
 
-        template <size_t OutPadding, size_t InPadding, size_t ShortcutPadding,
+        template <size_t OutPadding,
                   typename T, size_t BlockSizeCount, size_t BlockSizeChannel,
                   size_t ImageChannels, size_t ImageHeight, size_t ImageWidth,
-                  size_t KernelCount, size_t KernelHeight, size_t KernelWidth>
-        inline void ResNet50::convBlockAddIdentity(
-            ImageInference::types::Image<T, InPadding, BlockSizeChannel, ImageChannels, ImageHeight, ImageWidth> &image,
-            ImageInference::types::Kernel<T, BlockSizeCount, BlockSizeChannel, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
-            ImageInference::types::BatchNorm<T, KernelCount> &batchNorm,
-            ImageInference::types::Image<T, ShortcutPadding, BlockSizeCount, KernelCount, ImageHeight, ImageWidth> &shortcut,
-            ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight, ImageWidth> &output)
+                  size_t KernelCount, bool BatchNormFolded>
+        inline void ResNet50::convBlockWinograd(
+            ImageInference::types::Image<T, 1, BlockSizeChannel, ImageChannels, ImageHeight, ImageWidth> &image,
+            ImageInference::types::Kernel<T, BlockSizeCount, BlockSizeChannel, KernelCount, ImageChannels, Winograd::inputTile, Winograd::inputTile> &kernel,
+            ImageInference::types::BatchNorm<T, KernelCount, BatchNormFolded> &batchNorm,
+            ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight, ImageWidth> &output,
+            const GemmKernels *gemmKernels,
+            T *scratch)
         {
-            if constexpr (InPadding != KernelHeight / 2 || InPadding != KernelWidth / 2)
-            {
-                std::cerr << "ResNet50::convBlockAddIdentity: Padding is too small or to large for the kernel size. Padding: " << InPadding
-                          << " KernelHeight: " << KernelHeight << " KernelWidth: " << KernelWidth << std::endl
-                          << "Should be KernelHeight / 2 or KernelWidth / 2 = Padding." << std::endl;
-                throw std::runtime_error("ResNet50::convBlockAddIdentity: Padding is too small or to large for the kernel size!");
-            }
-
             constexpr const size_t countBlocks = KernelCount / BlockSizeCount;
             constexpr const size_t channelBlocks = ImageChannels / BlockSizeChannel;
-            constexpr const size_t outputHeight = ImageHeight;
-            constexpr const size_t outputWidth = ImageWidth;
+            constexpr const size_t inputTile = Winograd::inputTile;
+            constexpr const size_t outputTile = Winograd::outputTile;
+            constexpr const size_t positions = Winograd::positions;
+            constexpr const size_t tilesWidth = (ImageWidth + outputTile - 1) / outputTile;
+            constexpr const size_t tiles = Winograd::tiles<ImageHeight, ImageWidth>();
+            // The image includes the padding of 1, the last tiles are partial and read zeros outside of it.
+            constexpr const size_t paddedHeight = ImageHeight + 2;
+            constexpr const size_t paddedWidth = ImageWidth + 2;
+
+            // Without a given scratch the transformed input and output are stored in a temporary buffer.
+            std::unique_ptr<T[]> temporaryScratch;
+            if (scratch == nullptr)
+            {
+                temporaryScratch = std::make_unique<T[]>(Winograd::scratchSize<ImageChannels, KernelCount, ImageHeight, ImageWidth>());
+                scratch = temporaryScratch.get();
+            }
+            T *transformedImagePtr = scratch;                                     // Positions x ChannelBlocks x Tiles x ChannelElements
+            T *transformedOutputPtr = scratch + positions * ImageChannels * tiles; // Positions x CountBlocks x Tiles x CountElements
 
             auto outputPtr = output.getPointer() + output.paddingOffset; // We skip the padding as we want to start at the data section.
 
             const auto imagePtr = image.getPointer();                          // ChannelBlocks x Height x Width x ChannelElements
-            const auto kernelPtr = kernel.getPointer();                        // CountBlocks x ChannelBlocks x Height x Width x ChannelElements x CountElements
+            const auto kernelPtr = kernel.getPointer();                        // CountBlocks x ChannelBlocks x 6 x 6 x ChannelElements x CountElements
             const auto gammaVariancePtr = batchNorm.getGammaVariancePointer(); // Count = CountBlocks x CountElements
             const auto betaPtr = batchNorm.getBetaPointer();                   // Count = CountBlocks x CountElements
             const auto meanPtr = batchNorm.getMeanPointer();                   // Count = CountBlocks x CountElements
-            const auto shortcutPtr = shortcut.getPointer();                    // ChannelBlocks x Height x Width x ChannelElements
-
-            // If we use libxsmm directly we don't need to do add separately!
-            constexpr const int MM = outputWidth;
-            constexpr const int KK = BlockSizeChannel;
-            constexpr const int NN = BlockSizeCount;
-            constexpr const int ldImage = KK;
-
-            constexpr const char transa = 'N';
-            constexpr const char transb = 'N';
-
-            libxsmm_datatype datatype;
-            if constexpr (std::is_same<T, float>::value)
-            {
-                datatype = LIBXSMM_DATATYPE(float);
-            }
-            else
-            {
-                std::cerr << "ResNet50::convBlock: type is currently not supported! Supported are float." << std::endl;
-                throw std::runtime_error("ResNet50::convBlock: type is currently not supported!");
-            }
-
-            const libxsmm_gemm_shape shape = libxsmm_create_gemm_shape(
-                NN /*required*/,
-                MM /*required*/,
-                KK /*required*/,
-                NN /*lda*/,
-                ldImage /*ldb*/,
-                NN /*ldc*/,
-                datatype, // input type
-                datatype, // input type
-                datatype, // output type
-                datatype  // outputtype
-            );
-            const libxsmm_bitfield flags = LIBXSMM_GEMM_FLAGS(transa, transb);
-
-            const libxsmm_gemmfunction gemmFunc = libxsmm_dispatch_gemm(
-                shape,
-                flags,
-                (libxsmm_bitfield)(LIBXSMM_PREFETCH) // Default from libxsmm_sgemm
-            );
-
-            if (gemmFunc == NULL)
+            const T *biasPtr = nullptr;                                        // Count = CountBlocks x CountElements
+            if constexpr (BatchNormFolded)
             {
-                std::cerr << "ResNet50::convBlock: libxsmm_dispatch_gemm failed!" << std::endl;
-                throw std::runtime_error("ResNet50::convBlock: libxsmm_dispatch_gemm failed!");
+                biasPtr = batchNorm.getBiasPointer();
             }
 
+            // Transform the input tiles
 #ifdef USE_OMP
 #pragma omp parallel for collapse(2)
 #endif // USE_OMP
-            for (size_t iBCount = 0; iBCount < countBlocks; iBCount++)
+            for (size_t iBChannel = 0; iBChannel < channelBlocks; iBChannel++)
             {
-                for (size_t iHeight = 0; iHeight < outputHeight; iHeight++)
+                for (size_t iTile = 0; iTile < tiles; iTile++)
                 {
-                    // Do convolution calculation
-                    for (size_t iBChannel = 0; iBChannel < channelBlocks; iBChannel++)
+                    const size_t tileHeight = iTile / tilesWidth * outputTile;
+                    const size_t tileWidth = iTile % tilesWidth * outputTile;
+
+                    T tile[inputTile][inputTile][BlockSizeChannel];
+                    for (size_t iHeight = 0; iHeight < inputTile; iHeight++)
                     {
-                        for (size_t kHeight = 0; kHeight < KernelHeight; kHeight++)
+                        for (size_t iWidth = 0; iWidth < inputTile; iWidth++)
                         {
-                            for (size_t kWidth = 0; kWidth < KernelWidth; kWidth++)
+                            const bool inside = tileHeight + iHeight < paddedHeight && tileWidth + iWidth < paddedWidth;
+                            const T *imageTilePtr = inside ? imagePtr + image.getOffset(iBChannel, tileHeight + iHeight, tileWidth + iWidth, 0) : nullptr;
+#ifdef USE_OMP
+#pragma omp simd
+#endif // USE_OMP
+                            for (size_t iChannel = 0; iChannel < BlockSizeChannel; iChannel++)
                             {
-                                const size_t imageOffset = image.getOffset(iBChannel, iHeight + kHeight, kWidth, 0);
-                                const size_t kernelOffset = kernel.getOffset(iBCount, iBChannel, kHeight, kWidth, 0, 0);
-                                const size_t outputOffset = output.getOffset(iBCount, iHeight, 0, 0);
-
-                                // Kernel of shape BlockSizeChannel x BlockSizeCount
-                                // Input of shape ImageWidth x BlockSizeChannel
-                                // Output of shape outputWidth x BlockSizeCount === ImageWidth x BlockSizeCount
-
-                                libxsmm_gemm_param param;
-                                param.a.primary = kernelPtr + kernelOffset;
-                                param.b.primary = imagePtr + imageOffset;
-                                param.c.primary = outputPtr + outputOffset;
-
-                                LIBXSMM_XGEMM_PREFETCH(
-                                    datatype,
-                                    datatype,
-                                    NN,
-                                    MM,
-                                    KK,
-                                    param);
-
-                                gemmFunc(&param);
+                                tile[iHeight][iWidth][iChannel] = inside ? imageTilePtr[iChannel] : 0;
                             }
                         }
                     }
 
-                    // At this point we completed a complete row of the output.
-                    // Now we apply the batch norm and relu.
-                    for (size_t iWidth = 0; iWidth < ImageWidth; iWidth++)
+                    T transformed[inputTile][inputTile][BlockSizeChannel];
+                    Winograd::transformInput<T, BlockSizeChannel>(tile, transformed);
+
+                    for (size_t iPosition = 0; iPosition < positions; iPosition++)
                     {
+                        T *transformedImageTilePtr = transformedImagePtr + ((iPosition * channelBlocks + iBChannel) * tiles + iTile) * BlockSizeChannel;
+                        const T *transformedTilePtr = transformed[iPosition / inputTile][iPosition % inputTile];
 #ifdef USE_OMP
 #pragma omp simd
 #endif // USE_OMP
-                        for (size_t iCount = 0; iCount < BlockSizeCount; iCount++)
+                        for (size_t iChannel = 0; iChannel < BlockSizeChannel; iChannel++)
                         {
-                            const size_t offsetOutput = output.getOffset(iBCount, iHeight, iWidth, iCount);
-                            const size_t offsetShortcut = shortcut.getOffset(iBCount, iHeight, iWidth, iCount);
-                            const size_t offsetCount = iBCount * BlockSizeCount + iCount;
-                            T batchNormValue = ResNet50::batchNorm<T>(
-                                outputPtr[offsetOutput],
-                                gammaVariancePtr[offsetCount],
-                                betaPtr[offsetCount],
-                                meanPtr[offsetCount]);
-                            outputPtr[offsetOutput] = relu<T>(batchNormValue + shortcutPtr[offsetShortcut]);
+                            transformedImageTilePtr[iChannel] = transformedTilePtr[iChannel];
                         }
                     }
                 }
             }
-        }
 
-        template <size_t Stride, size_t ShortcutDimExpand, size_t OutPadding, size_t InPadding, size_t ShortcutPadding,
-                  typename T, size_t BlockSizeCount, size_t BlockSizeChannel,
-                  size_t ImageChannels, size_t ImageHeight, size_t ImageWidth,
-                  size_t KernelCount, size_t KernelHeight, size_t KernelWidth>
-        inline void ResNet50::convBlockAddProjection(
-            ImageInference::types::Image<T, InPadding, BlockSizeChannel, ImageChannels, ImageHeight / Stride, ImageWidth / Stride> &image,
-            ImageInference::types::Kernel<T, BlockSizeCount, BlockSizeChannel, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
-            ImageInference::types::BatchNorm<T, KernelCount> &batchNorm,
-            ImageInference::types::Image<T, ShortcutPadding, BlockSizeCount, KernelCount / ShortcutDimExpand, ImageHeight, ImageWidth> &shortcut,
-            ImageInference::types::Kernel<T, BlockSizeCount, BlockSizeCount, KernelCount, KernelCount / ShortcutDimExpand, 1, 1> &projectionKernel,
-            ImageInference::types::BatchNorm<T, KernelCount> &projectionBatchNorm,
-            ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight / Stride, ImageWidth / Stride> &output)
-        {
-            if constexpr (InPadding != KernelHeight / 2 || InPadding != KernelWidth / 2)
+            // Every position of the tiles is a gemm of all tiles, reduced over the channel blocks.
+            constexpr int MM = tiles;
+            constexpr int KK = BlockSizeChannel;
+            constexpr int NN = BlockSizeCount;
+
+            libxsmm_datatype datatype;
+            if constexpr (std::is_same<T, float>::value)
             {
-                std::cerr << "ResNet50::convBlockAddProjection: Padding is too small or to large for the kernel size. Padding: " << InPadding
-                          << " KernelHeight: " << KernelHeight << " KernelWidth: " << KernelWidth << std::endl
-                          << "Should be KernelHeight / 2 or KernelWidth / 2 = Padding." << std::endl;
-                throw std::runtime_error("ResNet50::convBlockAddProjection: Padding is too small or to large for the kernel size!");
+                datatype = LIBXSMM_DATATYPE(float);
             }
-
-            constexpr const size_t countBlocks = KernelCount / BlockSizeCount;
+            else
+            {
+                std::cerr << "ResNet50::convBlockWinograd: type is currently not supported! Supported are float." << std::endl;
+                throw std::runtime_error("ResNet50::convBlockWinograd: type is currently not supported!");
+            }
+
+            std::array<unsigned long long, channelBlocks> imageOffsets;
+            std::array<unsigned long long, channelBlocks> kernelOffsets;
+            for (size_t iBChannel = 0; iBChannel < channelBlocks; iBChannel++)
+            {
+                imageOffsets[iBChannel] = iBChannel * tiles * BlockSizeChannel * sizeof(T);
+                kernelOffsets[iBChannel] = kernel.getOffset(0, iBChannel, 0, 0, 0, 0) * sizeof(T);
+            }
+            unsigned long long count = channelBlocks;
+
+            const libxsmm_gemmfunction gemmFunc = GemmKernels::get(
+                gemmKernels,
+                GemmShape{NN, MM, KK, NN, KK, NN, datatype, true, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET},
+                "ResNet50::convBlockWinograd");
+
+#ifdef USE_OMP
+#pragma omp parallel for collapse(2)
+#endif // USE_OMP
+            for (size_t iPosition = 0; iPosition < positions; iPosition++)
+            {
+                for (size_t iBCount = 0; iBCount < countBlocks; iBCount++)
+                {
+                    // Kernel of shape BlockSizeChannel x BlockSizeCount
+                    // Input of shape Tiles x BlockSizeChannel
+                    // Output of shape Tiles x BlockSizeCount
+                    libxsmm_gemm_param param;
+                    param.a.primary = kernelPtr + kernel.getOffset(iBCount, 0, iPosition / inputTile, iPosition % inputTile, 0, 0);
+                    param.a.secondary = kernelOffsets.data();
+                    param.b.primary = transformedImagePtr + iPosition * channelBlocks * tiles * BlockSizeChannel;
+                    param.b.secondary = imageOffsets.data();
+                    param.c.primary = transformedOutputPtr + (iPosition * countBlocks + iBCount) * tiles * BlockSizeCount;
+                    param.op.tertiary = &count;
+                    gemmFunc(&param);
+                }
+            }
+
+            // Transform the output tiles back and apply the batch norm and relu.
+#ifdef USE_OMP
+#pragma omp parallel for collapse(2)
+#endif // USE_OMP
+            for (size_t iBCount = 0; iBCount < countBlocks; iBCount++)
+            {
+                for (size_t iTile = 0; iTile < tiles; iTile++)
+                {
+                    const size_t tileHeight = iTile / tilesWidth * outputTile;
+                    const size_t tileWidth = iTile % tilesWidth * outputTile;
+
+                    T tile[inputTile][inputTile][BlockSizeCount];
+                    for (size_t iPosition = 0; iPosition < positions; iPosition++)
+                    {
+                        const T *transformedOutputTilePtr = transformedOutputPtr + ((iPosition * countBlocks + iBCount) * tiles + iTile) * BlockSizeCount;
+                        T *tilePtr = tile[iPosition / inputTile][iPosition % inputTile];
+#ifdef USE_OMP
+#pragma omp simd
+#endif // USE_OMP
+                        for (size_t iCount = 0; iCount < BlockSizeCount; iCount++)
+                        {
+                            tilePtr[iCount] = transformedOutputTilePtr[iCount];
+                        }
+                    }
+
+                    T transformed[outputTile][outputTile][BlockSizeCount];
+                    Winograd::transformOutput<T, BlockSizeCount>(tile, transformed);
+
+                    // Partial tiles only write the part inside of the output.
+                    for (size_t iHeight = 0; iHeight < outputTile && tileHeight + iHeight < ImageHeight; iHeight++)
+                    {
+                        for (size_t iWidth = 0; iWidth < outputTile && tileWidth + iWidth < ImageWidth; iWidth++)
+                        {
+#ifdef USE_OMP
+#pragma omp simd
+#endif // USE_OMP
+                            for (size_t iCount = 0; iCount < BlockSizeCount; iCount++)
+                            {
+                                const size_t offsetOutput = output.getOffset(iBCount, tileHeight + iHeight, tileWidth + iWidth, iCount);
+                                const size_t offsetCount = iBCount * BlockSizeCount + iCount;
+                                if constexpr (BatchNormFolded)
+                                {
+                                    outputPtr[offsetOutput] = relu<T>(transformed[iHeight][iWidth][iCount] + biasPtr[offsetCount]);
+                                }
+                                else
+                                {
+                                    outputPtr[offsetOutput] = relu<T>(ResNet50::batchNorm<T>(
+                                        transformed[iHeight][iWidth][iCount],
+                                        gammaVariancePtr[offsetCount],
+                                        betaPtr[offsetCount],
+                                        meanPtr[offsetCount]));
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        template <size_t Stride, size_t ImageHeight, size_t ImageWidth, size_t OutPadding,
+                  typename T, size_t BlockSizeCount, size_t ImageChannels,
+                  size_t KernelCount, size_t KernelHeight, size_t KernelWidth, bool BatchNormFolded>
+        inline void ResNet50::convBlockPlanar(
+            const T *image,
+            ImageInference::types::Kernel<T, BlockSizeCount, ImageChannels, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
+            ImageInference::types::BatchNorm<T, KernelCount, BatchNormFolded> &batchNorm,
+            ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight / Stride, ImageWidth / Stride> &output,
+            const GemmKernels *gemmKernels)
+        {
+            constexpr const size_t countBlocks = KernelCount / BlockSizeCount;
+            constexpr const size_t outputHeight = ImageHeight / Stride;
+            constexpr const size_t outputWidth = ImageWidth / Stride;
+            constexpr const size_t depth = KernelHeight * KernelWidth * ImageChannels;
+
+            auto outputPtr = output.getPointer() + output.paddingOffset; // We skip the padding as we want to start at the data section.
+
+            const auto kernelPtr = kernel.getPointer();                        // CountBlocks x 1 x Height x Width x Channels x CountElements
+            const auto gammaVariancePtr = batchNorm.getGammaVariancePointer(); // Count = CountBlocks x CountElements
+            const auto betaPtr = batchNorm.getBetaPointer();                   // Count = CountBlocks x CountElements
+            const auto meanPtr = batchNorm.getMeanPointer();                   // Count = CountBlocks x CountElements
+            const T *biasPtr = nullptr;                                        // Count = CountBlocks x CountElements
+            if constexpr (BatchNormFolded)
+            {
+                biasPtr = batchNorm.getBiasPointer();
+            }
+
+            libxsmm_datatype datatype;
+            if constexpr (std::is_same<T, float>::value)
+            {
+                datatype = LIBXSMM_DATATYPE(float);
+            }
+            else
+            {
+                std::cerr << "ResNet50::convBlockPlanar: type is currently not supported! Supported are float." << std::endl;
+                throw std::runtime_error("ResNet50::convBlockPlanar: type is currently not supported!");
+            }
+
+            // The input has only a few channels, therefore a gemm over the channels would be tiny.
+            // Instead the kernel of a count block is a single depth x BlockSizeCount matrix and every output row is one gemm over its strip.
+            constexpr int MM = outputWidth;
+            constexpr int KK = depth;
+            constexpr int NN = BlockSizeCount;
+            const libxsmm_gemmfunction gemmFunc = GemmKernels::get(
+                gemmKernels,
+                GemmShape{NN, MM, KK, NN, KK, NN, datatype, true},
+                "ResNet50::convBlockPlanar");
+
+            // The folded batch norm of float uses the hand vectorized kernels of the host, see VectorKernels.
+            constexpr const bool vectorized = std::is_same<T, float>::value && BatchNormFolded;
+            const VectorKernels &vectorKernels = VectorKernels::host();
+
+#ifdef USE_OMP
+#pragma omp parallel for
+#endif // USE_OMP
+            for (size_t iHeight = 0; iHeight < outputHeight; iHeight++)
+            {
+                // The strip is shared by all count blocks of the row.
+                alignas(64) T strip[outputWidth * depth];
+                planarStrip<Stride, ImageChannels, ImageHeight, ImageWidth, KernelHeight, KernelWidth>(image, iHeight, strip);
+
+                for (size_t iBCount = 0; iBCount < countBlocks; iBCount++)
+                {
+                    // Kernel of shape depth x BlockSizeCount
+                    // Strip of shape outputWidth x depth
+                    // Output of shape outputWidth x BlockSizeCount
+                    libxsmm_gemm_param param;
+                    param.a.primary = kernelPtr + kernel.getOffset(iBCount, 0, 0, 0, 0, 0);
+                    param.b.primary = strip;
+                    param.c.primary = outputPtr + output.getOffset(iBCount, iHeight, 0, 0);
+                    gemmFunc(&param);
+
+                    // At this point we completed a complete row of the output.
+                    // Now we apply the batch norm and relu.
+                    if constexpr (vectorized)
+                    {
+                        vectorKernels.biasRelu(outputPtr + output.getOffset(iBCount, iHeight, 0, 0), biasPtr + iBCount * BlockSizeCount, outputWidth, BlockSizeCount);
+                    }
+                    else
+                    {
+                        for (size_t iWidth = 0; iWidth < outputWidth; iWidth++)
+                        {
+#ifdef USE_OMP
+#pragma omp simd
+#endif // USE_OMP
+                            for (size_t iCount = 0; iCount < BlockSizeCount; iCount++)
+                            {
+                                const size_t offsetOutput = output.getOffset(iBCount, iHeight, iWidth, iCount);
+                                const size_t offsetCount = iBCount * BlockSizeCount + iCount;
+                                if constexpr (BatchNormFolded)
+                                {
+                                    outputPtr[offsetOutput] = relu<T>(outputPtr[offsetOutput] + biasPtr[offsetCount]);
+                                }
+                                else
+                                {
+                                    outputPtr[offsetOutput] = relu<T>(ResNet50::batchNorm<T>(
+                                        outputPtr[offsetOutput],
+                                        gammaVariancePtr[offsetCount],
+                                        betaPtr[offsetCount],
+                                        meanPtr[offsetCount]));
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        template <size_t Stride, size_t ImageHeight, size_t ImageWidth, size_t OutPadding,
+                  typename T, typename TOutput, size_t BlockSizeCount, size_t ImageChannels,
+                  size_t KernelCount, size_t KernelHeight, size_t KernelWidth, bool BatchNormFolded>
+        inline void ResNet50::convBlockPlanarMaxPool(
+            const T *image,
+            ImageInference::types::Kernel<T, BlockSizeCount, ImageChannels, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
+            ImageInference::types::BatchNorm<T, KernelCount, BatchNormFolded> &batchNorm,
+            ImageInference::types::Image<TOutput, OutPadding, BlockSizeCount, KernelCount, ImageHeight / Stride / 2, ImageWidth / Stride / 2> &output,
+            const GemmKernels *gemmKernels)
+        {
+            constexpr const size_t countBlocks = KernelCount / BlockSizeCount;
+            constexpr const size_t convHeight = ImageHeight / Stride;
+            constexpr const size_t convWidth = ImageWidth / Stride;
+            constexpr const size_t outputHeight = convHeight / 2;
+            constexpr const size_t outputWidth = convWidth / 2;
+            constexpr const size_t depth = KernelHeight * KernelWidth * ImageChannels;
+
+            // The pooled rows of a task. Every task but the first recomputes the convolution row above its first pooled row.
+            constexpr const size_t poolRows = 4;
+            constexpr const size_t bands = (outputHeight + poolRows - 1) / poolRows;
+
+            auto outputPtr = output.getPointer() + output.paddingOffset; // We skip the padding as we want to start at the data section.
+
+            const auto kernelPtr = kernel.getPointer();                        // CountBlocks x 1 x Height x Width x Channels x CountElements
+            const auto gammaVariancePtr = batchNorm.getGammaVariancePointer(); // Count = CountBlocks x CountElements
+            const auto betaPtr = batchNorm.getBetaPointer();                   // Count = CountBlocks x CountElements
+            const auto meanPtr = batchNorm.getMeanPointer();                   // Count = CountBlocks x CountElements
+            const T *biasPtr = nullptr;                                        // Count = CountBlocks x CountElements
+            if constexpr (BatchNormFolded)
+            {
+                biasPtr = batchNorm.getBiasPointer();
+            }
+
+            libxsmm_datatype datatype;
+            if constexpr (std::is_same<T, float>::value)
+            {
+                datatype = LIBXSMM_DATATYPE(float);
+            }
+            else
+            {
+                std::cerr << "ResNet50::convBlockPlanarMaxPool: type is currently not supported! Supported are float." << std::endl;
+                throw std::runtime_error("ResNet50::convBlockPlanarMaxPool: type is currently not supported!");
+            }
+
+            // Same gemm as convBlockPlanar, the output row is written into a buffer of the task instead of the image.
+            constexpr int MM = convWidth;
+            constexpr int KK = depth;
+            constexpr int NN = BlockSizeCount;
+            const libxsmm_gemmfunction gemmFunc = GemmKernels::get(
+                gemmKernels,
+                GemmShape{NN, MM, KK, NN, KK, NN, datatype, true},
+                "ResNet50::convBlockPlanarMaxPool");
+
+            // The folded batch norm of float uses the hand vectorized kernels of the host, see VectorKernels.
+            constexpr const bool vectorized = std::is_same<T, float>::value && BatchNormFolded;
+            constexpr const bool rounded = !std::is_same<T, TOutput>::value;
+            static_assert(!rounded || vectorized, "ResNet50::convBlockPlanarMaxPool: Another output type needs float and a folded batch norm.");
+            const VectorKernels &vectorKernels = VectorKernels::host();
+
+#ifdef USE_OMP
+#pragma omp parallel for collapse(2)
+#endif // USE_OMP
+            for (size_t iBCount = 0; iBCount < countBlocks; iBCount++)
+            {
+                for (size_t iBand = 0; iBand < bands; iBand++)
+                {
+                    const size_t heightBegin = iBand * poolRows;
+                    const size_t heightEnd = std::min(heightBegin + poolRows, outputHeight);
+
+#ifdef IMAGEINFERENCE_TESTING
+                    // Get the last element touched by the task.
+                    kernel.getOffset(iBCount, 0, KernelHeight - 1, KernelWidth - 1, ImageChannels - 1, BlockSizeCount - 1);
+                    // Adding padding offset as this is already applied at the output.
+                    output.getOffset(iBCount, heightEnd - 1, outputWidth - 1, BlockSizeCount - 1 + output.paddingOffset);
+#endif // IMAGEINFERENCE_TESTING
+
+                    // Every row starts with a pixel of zero padding for the max pooling, which can not win against the relu output.
+                    alignas(64) T strip[convWidth * depth];
+                    alignas(64) T rows[3][(convWidth + 1) * BlockSizeCount]; // (1 + convWidth) x BlockSizeCount each
+                    for (auto &row : rows)
+                    {
+                        std::fill(row, row + BlockSizeCount, T(0));
+                    }
+                    T *previous = rows[0] + BlockSizeCount;
+                    T *current = rows[1] + BlockSizeCount;
+                    T *next = rows[2] + BlockSizeCount;
+                    // The pooled row before it is rounded into the output type.
+                    alignas(64) T pooled[rounded ? outputWidth * BlockSizeCount : 1];
+
+                    // Computes a row of the convolution with the batch norm and relu.
+                    const auto convRow = [&](const size_t iConv, T *row)
+                    {
+                        planarStrip<Stride, ImageChannels, ImageHeight, ImageWidth, KernelHeight, KernelWidth>(image, iConv, strip);
+
+                        libxsmm_gemm_param param;
+                        param.a.primary = kernelPtr + kernel.getOffset(iBCount, 0, 0, 0, 0, 0);
+                        param.b.primary = strip;
+                        param.c.primary = row;
+                        gemmFunc(&param);
+
+                        if constexpr (vectorized)
+                        {
+                            vectorKernels.biasRelu(row, biasPtr + iBCount * BlockSizeCount, convWidth, BlockSizeCount);
+                        }
+                        else
+                        {
+                            for (size_t iWidth = 0; iWidth < convWidth; iWidth++)
+                            {
+#ifdef USE_OMP
+#pragma omp simd
+#endif // USE_OMP
+                                for (size_t iCount = 0; iCount < BlockSizeCount; iCount++)
+                                {
+                                    const size_t offsetRow = iWidth * BlockSizeCount + iCount;
+                                    const size_t offsetCount = iBCount * BlockSizeCount + iCount;
+                                    if constexpr (BatchNormFolded)
+                                    {
+                                        row[offsetRow] = relu<T>(row[offsetRow] + biasPtr[offsetCount]);
+                                    }
+                                    else
+                                    {
+                                        row[offsetRow] = relu<T>(ResNet50::batchNorm<T>(
+                                            row[offsetRow],
+                                            gammaVariancePtr[offsetCount],
+                                            betaPtr[offsetCount],
+                                            meanPtr[offsetCount]));
+                                    }
+                                }
+                            }
+                        }
+                    };
+
+                    // The pooled row iHeight reads the convolution rows 2 x iHeight - 1 to 2 x iHeight + 1,
+                    // the last one is the first one of the next pooled row.
+                    if (heightBegin > 0)
+                    {
+                        convRow(2 * heightBegin - 1, previous);
+                    }
+
+                    for (size_t iHeight = heightBegin; iHeight < heightEnd; iHeight++)
+                    {
+                        const bool hasPrevious = iHeight > 0;
+                        const bool hasNext = 2 * iHeight + 1 < convHeight;
+                        convRow(2 * iHeight, current);
+                        if (hasNext)
+                        {
+                            convRow(2 * iHeight + 1, next);
+                        }
+
+                        if constexpr (vectorized)
+                        {
+                            // The max over the rows is kept in the current row, which is not read by the next pooled row.
+                            if (hasPrevious)
+                            {
+                                vectorKernels.maximum(current, previous, convWidth * BlockSizeCount);
+                            }
+                            if (hasNext)
+                            {
+                                vectorKernels.maximum(current, next, convWidth * BlockSizeCount);
+                            }
+                            if constexpr (rounded)
+                            {
+                                vectorKernels.maxPoolRow(pooled, current - BlockSizeCount, outputWidth, 2, BlockSizeCount);
+                                TOutput *pooledOutput = outputPtr + output.getOffset(iBCount, iHeight, 0, 0);
+                                for (size_t iPooled = 0; iPooled < outputWidth * BlockSizeCount; iPooled++)
+                                {
+                                    pooledOutput[iPooled] = ImageInference::types::roundTo<TOutput>(pooled[iPooled]);
+                                }
+                            }
+                            else
+                            {
+                                vectorKernels.maxPoolRow(outputPtr + output.getOffset(iBCount, iHeight, 0, 0), current - BlockSizeCount, outputWidth, 2, BlockSizeCount);
+                            }
+                        }
+                        else
+                        {
+                            // 3x3 Stencil that gets the max value, the padding of 1 is skipped instead of being compared.
+                            for (size_t iWidth = 0; iWidth < outputWidth; iWidth++)
+                            {
+                                const size_t widthBegin = iWidth > 0 ? 2 * iWidth - 1 : 0;
+                                const size_t widthEnd = std::min(2 * iWidth + 2, convWidth);
+                                const size_t preOffsetOutput = output.getOffset(iBCount, iHeight, iWidth, 0);
+
+#ifdef USE_OMP
+#pragma omp simd
+#endif // USE_OMP
+                                for (size_t iCount = 0; iCount < BlockSizeCount; iCount++)
+                                {
+                                    const size_t offsetOutput = preOffsetOutput + iCount * output.strideChannel;
+                                    outputPtr[offsetOutput] = std::numeric_limits<T>::lowest();
+                                }
+
+                                for (size_t kWidth = widthBegin; kWidth < widthEnd; kWidth++)
+                                {
+#ifdef USE_OMP // We can apply simd because the elements are independent of each other.
+#pragma omp simd
+#endif // USE_OMP
+                                    for (size_t iCount = 0; iCount < BlockSizeCount; iCount++)
+                                    {
+                                        const size_t offsetOutput = preOffsetOutput + iCount * output.strideChannel;
+                                        const size_t offsetRow = kWidth * BlockSizeCount + iCount;
+                                        T value = current[offsetRow];
+                                        if (hasPrevious)
+                                        {
+                                            value = std::max(value, previous[offsetRow]);
+                                        }
+                                        if (hasNext)
+                                        {
+                                            value = std::max(value, next[offsetRow]);
+                                        }
+                                        outputPtr[offsetOutput] = std::max(outputPtr[offsetOutput], value);
+                                    }
+                                }
+                            }
+                        }
+
+                        std::swap(previous, next);
+                    }
+                }
+            }
+        }
+
+        template <size_t OutPadding, size_t InPadding, size_t ShortcutPadding,
+                  typename T, typename TWeight, size_t BlockSizeCount, size_t BlockSizeChannel,
+                  size_t ImageChannels, size_t ImageHeight, size_t ImageWidth,
+                  size_t KernelCount, size_t KernelHeight, size_t KernelWidth, bool BatchNormFolded>
+        inline void ResNet50::convBlockAddIdentity(
+            ImageInference::types::Image<T, InPadding, BlockSizeChannel, ImageChannels, ImageHeight, ImageWidth> &image,
+            ImageInference::types::Kernel<TWeight, BlockSizeCount, BlockSizeChannel, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
+            ImageInference::types::BatchNorm<typename ImageInference::types::Parameter<T>::type, KernelCount, BatchNormFolded> &batchNorm,
+            ImageInference::types::Image<T, ShortcutPadding, BlockSizeCount, KernelCount, ImageHeight, ImageWidth> &shortcut,
+            ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight, ImageWidth> &output,
+            const GemmKernels *gemmKernels)
+        {
+            if constexpr (InPadding != KernelHeight / 2 || InPadding != KernelWidth / 2)
+            {
+                std::cerr << "ResNet50::convBlockAddIdentity: Padding is too small or to large for the kernel size. Padding: " << InPadding
+                          << " KernelHeight: " << KernelHeight << " KernelWidth: " << KernelWidth << std::endl
+                          << "Should be KernelHeight / 2 or KernelWidth / 2 = Padding." << std::endl;
+                throw std::runtime_error("ResNet50::convBlockAddIdentity: Padding is too small or to large for the kernel size!");
+            }
+
+            using TAccumulator = typename ImageInference::types::Accumulator<T>::type;
+            using TParameter = typename ImageInference::types::Parameter<T>::type;
+            static_assert(std::is_same<TWeight, typename ImageInference::types::Weight<T>::type>::value ||
+                              (std::is_same<T, float>::value && std::is_same<TWeight, ImageInference::types::Float16>::value),
+                          "ResNet50::convBlockAddIdentity: The kernel needs the weight type of T or Float16 for float.");
+            constexpr const size_t countBlocks = KernelCount / BlockSizeCount;
+            constexpr const size_t channelBlocks = ImageChannels / BlockSizeChannel;
+            constexpr const size_t outputHeight = ImageHeight;
+            constexpr const size_t outputWidth = ImageWidth;
+
+            auto outputPtr = output.getPointer() + output.paddingOffset; // We skip the padding as we want to start at the data section.
+
+            const auto imagePtr = image.getPointer();                          // ChannelBlocks x Height x Width x ChannelElements
+            const auto kernelPtr = kernel.getPointer();                        // CountBlocks x ChannelBlocks x Height x Width x ChannelElements x CountElements
+            const auto gammaVariancePtr = batchNorm.getGammaVariancePointer(); // Count = CountBlocks x CountElements
+            const auto betaPtr = batchNorm.getBetaPointer();                   // Count = CountBlocks x CountElements
+            const auto meanPtr = batchNorm.getMeanPointer();                   // Count = CountBlocks x CountElements
+            const TParameter *biasPtr = nullptr;                                          // Count = CountBlocks x CountElements
+            if constexpr (BatchNormFolded)
+            {
+                biasPtr = batchNorm.getBiasPointer();
+            }
+            const auto shortcutPtr = shortcut.getPointer();                    // ChannelBlocks x Height x Width x ChannelElements
+
+            // If we use libxsmm directly we don't need to do add separately!
+            constexpr const size_t rows = gemmRows<1, InPadding, OutPadding, KernelHeight, KernelWidth, outputHeight, outputWidth>();
+            constexpr const int MM = rows * outputWidth;
+            constexpr const int KK = BlockSizeChannel;
+            constexpr const int NN = BlockSizeCount;
+            constexpr const int ldImage = KK;
+
+
+            libxsmm_datatype datatype;
+            if constexpr (std::is_same<T, float>::value)
+            {
+                datatype = LIBXSMM_DATATYPE(float);
+            }
+            else if constexpr (std::is_same<T, ImageInference::types::BFloat16>::value)
+            {
+                datatype = LIBXSMM_DATATYPE_BF16;
+            }
+            else if constexpr (std::is_same<T, uint8_t>::value)
+            {
+                datatype = LIBXSMM_DATATYPE_I8;
+            }
+            else
+            {
+                std::cerr << "ResNet50::convBlock: type is currently not supported! Supported are float, BFloat16 and uint8_t." << std::endl;
+                throw std::runtime_error("ResNet50::convBlock: type is currently not supported!");
+            }
+
+            // All (channel block, kernel row, kernel column) gemms of an output row are reduced in a single batch-reduce gemm,
+            // which keeps the output row in registers and overwrites the output with the sum.
+            constexpr const size_t batchCount = channelBlocks * KernelHeight * KernelWidth;
+            std::array<unsigned long long, batchCount> imageOffsets;
+            std::array<unsigned long long, batchCount> kernelOffsets;
+            batchReduceOffsets<T, channelBlocks, KernelHeight, KernelWidth>(image, kernel, imageOffsets, kernelOffsets);
+            unsigned long long count = batchCount;
+
+            const libxsmm_gemmfunction gemmFunc = GemmKernels::get(
+                gemmKernels,
+                GemmShape{NN, MM, KK, NN, ldImage, NN, datatype, true, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET},
+                "ResNet50::convBlockAddIdentity");
+
+            // Kernels stored in Float16 accumulate all but their first chunk of taps into the output, see batchReduceFloat16.
+            constexpr const bool widening = std::is_same<TWeight, ImageInference::types::Float16>::value;
+            libxsmm_gemmfunction accumulateFunc = nullptr;
+            if constexpr (widening)
+            {
+                accumulateFunc = GemmKernels::get(
+                    gemmKernels,
+                    GemmShape{NN, MM, KK, NN, ldImage, NN, datatype, false, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET},
+                    "ResNet50::convBlockAddIdentity");
+            }
+
+            // The folded batch norm of float uses the hand vectorized kernels of the host, see VectorKernels.
+            // Types that accumulate in another type e.g. BFloat16 write the gemm into a tile, whose epilogue rounds it into the output.
+            // The epilogue of uint8_t requantizes the int32_t tile with the scales of the batch norm, see BatchNorm::requantize.
+            constexpr const bool vectorized = std::is_same<T, float>::value && BatchNormFolded;
+            constexpr const bool tiled = !std::is_same<T, TAccumulator>::value;
+            constexpr const bool quantized = std::is_same<T, uint8_t>::value;
+            static_assert(!tiled || BatchNormFolded, "ResNet50::convBlockAddIdentity: Types with another accumulator type need a folded batch norm.");
+            const VectorKernels &vectorKernels = VectorKernels::host();
+            const TParameter *scalePtr = nullptr; // Count = CountBlocks x CountElements
+            TParameter shortcutScale = 0;
+            if constexpr (quantized)
+            {
+                scalePtr = batchNorm.getScalePointer();
+                shortcutScale = batchNorm.getShortcutScale();
+            }
+
+#ifdef USE_OMP
+#pragma omp parallel for collapse(2)
+#endif // USE_OMP
+            for (size_t iBCount = 0; iBCount < countBlocks; iBCount++)
+            {
+                for (size_t iHeight = 0; iHeight < outputHeight; iHeight += rows)
+                {
+                    // Do convolution calculation
+                    const size_t imageOffset = image.getOffset(0, iHeight, 0, 0);
+                    const size_t kernelOffset = kernel.getOffset(iBCount, 0, 0, 0, 0, 0);
+                    const size_t outputOffset = output.getOffset(iBCount, iHeight, 0, 0);
+
+#ifdef IMAGEINFERENCE_TESTING
+                    // Get the last element touched by the batch.
+                    image.getOffset(channelBlocks - 1, iHeight + rows - 1 + KernelHeight - 1, ImageWidth - 1 + KernelWidth - 1, BlockSizeChannel - 1);
+                    kernel.getOffset(iBCount, channelBlocks - 1, KernelHeight - 1, KernelWidth - 1, BlockSizeChannel - 1, BlockSizeCount - 1);
+                    // Adding padding offset as this is already applied at the output.
+                    output.getOffset(iBCount, iHeight + rows - 1, outputWidth - 1, BlockSizeCount - 1 + output.paddingOffset);
+#endif // IMAGEINFERENCE_TESTING
+
+                    // Kernel of shape BlockSizeChannel x BlockSizeCount
+                    // Input of shape (rows x outputWidth) x BlockSizeChannel, strided by ldImage
+                    // Output of shape (rows x outputWidth) x BlockSizeCount
+                    alignas(64) TAccumulator tile[tiled ? MM * NN : 1];
+                    libxsmm_gemm_param param;
+                    param.a.primary = kernelPtr + kernelOffset;
+                    param.a.secondary = kernelOffsets.data();
+                    param.b.primary = imagePtr + imageOffset;
+                    param.b.secondary = imageOffsets.data();
+                    if constexpr (tiled)
+                    {
+                        param.c.primary = tile;
+                    }
+                    else
+                    {
+                        param.c.primary = outputPtr + outputOffset;
+                    }
+                    param.op.tertiary = &count;
+                    if constexpr (widening)
+                    {
+                        batchReduceFloat16<BlockSizeChannel * BlockSizeCount>(kernelPtr + kernelOffset, kernelOffsets, imagePtr + imageOffset, imageOffsets,
+                                                                              outputPtr + outputOffset, gemmFunc, accumulateFunc);
+                    }
+                    else
+                    {
+                        gemmFunc(&param);
+                    }
+
+                    // At this point we completed complete rows of the output.
+                    // Now we apply the batch norm and relu.
+                    if constexpr (quantized)
+                    {
+                        for (size_t iRow = iHeight; iRow < iHeight + rows; iRow++)
+                        {
+                            vectorKernels.requantizeAddRelu(outputPtr + output.getOffset(iBCount, iRow, 0, 0), tile + (iRow - iHeight) * outputWidth * NN,
+                                                            scalePtr + iBCount * BlockSizeCount, biasPtr + iBCount * BlockSizeCount,
+                                                            shortcutPtr + shortcut.getOffset(iBCount, iRow, 0, 0), shortcutScale, ImageWidth, BlockSizeCount);
+                        }
+                    }
+                    else if constexpr (tiled)
+                    {
+                        for (size_t iRow = iHeight; iRow < iHeight + rows; iRow++)
+                        {
+                            vectorKernels.biasAddReluBFloat16(outputPtr + output.getOffset(iBCount, iRow, 0, 0), tile + (iRow - iHeight) * outputWidth * NN,
+                                                              biasPtr + iBCount * BlockSizeCount, shortcutPtr + shortcut.getOffset(iBCount, iRow, 0, 0), ImageWidth, BlockSizeCount);
+                        }
+                    }
+                    else if constexpr (vectorized)
+                    {
+                        for (size_t iRow = iHeight; iRow < iHeight + rows; iRow++)
+                        {
+                            vectorKernels.biasAddRelu(outputPtr + output.getOffset(iBCount, iRow, 0, 0), biasPtr + iBCount * BlockSizeCount,
+                                                      shortcutPtr + shortcut.getOffset(iBCount, iRow, 0, 0), ImageWidth, BlockSizeCount);
+                        }
+                    }
+                    else
+                    {
+                        for (size_t iRow = iHeight; iRow < iHeight + rows; iRow++)
+                        {
+                            for (size_t iWidth = 0; iWidth < ImageWidth; iWidth++)
+                            {
+#ifdef USE_OMP
+#pragma omp simd
+#endif // USE_OMP
+                                for (size_t iCount = 0; iCount < BlockSizeCount; iCount++)
+                                {
+                                    const size_t offsetOutput = output.getOffset(iBCount, iRow, iWidth, iCount);
+                                    const size_t offsetShortcut = shortcut.getOffset(iBCount, iRow, iWidth, iCount);
+                                    const size_t offsetCount = iBCount * BlockSizeCount + iCount;
+                                    T batchNormValue;
+                                    if constexpr (BatchNormFolded)
+                                    {
+                                        batchNormValue = outputPtr[offsetOutput] + biasPtr[offsetCount];
+                                    }
+                                    else
+                                    {
+                                        batchNormValue = ResNet50::batchNorm<T>(
+                                            outputPtr[offsetOutput],
+                                            gammaVariancePtr[offsetCount],
+                                            betaPtr[offsetCount],
+                                            meanPtr[offsetCount]);
+                                    }
+                                    outputPtr[offsetOutput] = relu<T>(batchNormValue + shortcutPtr[offsetShortcut]);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        template <size_t Stride, size_t ShortcutDimExpand, size_t OutPadding, size_t InPadding, size_t ShortcutPadding,
+                  typename T, typename TWeight, size_t BlockSizeCount, size_t BlockSizeChannel, size_t BlockSizeShortcut,
+                  size_t ImageChannels, size_t ImageHeight, size_t ImageWidth,
+                  size_t KernelCount, size_t KernelHeight, size_t KernelWidth, bool BatchNormFolded>
+        inline void ResNet50::convBlockAddProjection(
+            ImageInference::types::Image<T, InPadding, BlockSizeChannel, ImageChannels, ImageHeight / Stride, ImageWidth / Stride> &image,
+            ImageInference::types::Kernel<TWeight, BlockSizeCount, BlockSizeChannel, KernelCount, ImageChannels, KernelHeight, KernelWidth> &kernel,
+            ImageInference::types::BatchNorm<typename ImageInference::types::Parameter<T>::type, KernelCount, BatchNormFolded> &batchNorm,
+            ImageInference::types::Image<T, ShortcutPadding, BlockSizeShortcut, KernelCount / ShortcutDimExpand, ImageHeight, ImageWidth> &shortcut,
+            ImageInference::types::Kernel<TWeight, BlockSizeCount, BlockSizeShortcut, KernelCount, KernelCount / ShortcutDimExpand, 1, 1> &projectionKernel,
+            ImageInference::types::BatchNorm<typename ImageInference::types::Parameter<T>::type, KernelCount, BatchNormFolded> &projectionBatchNorm,
+            ImageInference::types::Image<T, OutPadding, BlockSizeCount, KernelCount, ImageHeight / Stride, ImageWidth / Stride> &output,
+            const GemmKernels *gemmKernels)
+        {
+            if constexpr (InPadding != KernelHeight / 2 || InPadding != KernelWidth / 2)
+            {
+                std::cerr << "ResNet50::convBlockAddProjection: Padding is too small or to large for the kernel size. Padding: " << InPadding
+                          << " KernelHeight: " << KernelHeight << " KernelWidth: " << KernelWidth << std::endl
+                          << "Should be KernelHeight / 2 or KernelWidth / 2 = Padding." << std::endl;
+                throw std::runtime_error("ResNet50::convBlockAddProjection: Padding is too small or to large for the kernel size!");
+            }
+
+            using TAccumulator = typename ImageInference::types::Accumulator<T>::type;
+            using TParameter = typename ImageInference::types::Parameter<T>::type;
+            static_assert(std::is_same<TWeight, typename ImageInference::types::Weight<T>::type>::value ||
+                              (std::is_same<T, float>::value && std::is_same<TWeight, ImageInference::types::Float16>::value),
+                          "ResNet50::convBlockAddProjection: The kernel needs the weight type of T or Float16 for float.");
+            constexpr const size_t countBlocks = KernelCount / BlockSizeCount;
             constexpr const size_t channelBlocks = ImageChannels / BlockSizeChannel;
             constexpr const size_t outputHeight = ImageHeight / Stride;
             constexpr const size_t outputWidth = ImageWidth / Stride;
-            constexpr const size_t shortcutChannelBlock = KernelCount / ShortcutDimExpand / BlockSizeCount;
+            constexpr const size_t shortcutChannelBlock = KernelCount / ShortcutDimExpand / BlockSizeShortcut;
 
-            ImageInference::types::Image<T, 0, BlockSizeCount, KernelCount, ImageHeight / Stride, ImageWidth / Stride> projection;
-            auto projectionPtr = projection.getPointer() + projection.paddingOffset; // We skip the padding as we want to start at the data section.
+            // With folded batch norms both convolutions only differ by their bias, so the projection gemm accumulates into the output.
+            // Otherwise each needs its own batch norm, then the projection is stored in a temporary image.
+            std::unique_ptr<ImageInference::types::Image<T, 0, BlockSizeCount, KernelCount, ImageHeight / Stride, ImageWidth / Stride>> projection;
+            T *projectionPtr = nullptr;
+            if constexpr (!BatchNormFolded)
+            {
+                projection = std::make_unique<ImageInference::types::Image<T, 0, BlockSizeCount, KernelCount, ImageHeight / Stride, ImageWidth / Stride>>();
+                projectionPtr = projection->getPointer();
+            }
 
             auto outputPtr = output.getPointer() + output.paddingOffset; // We skip the padding as we want to start at the data section.
 
@@ -1236,95 +2165,124 @@ namespace ImageInference
             const auto betaPtr = batchNorm.getBetaPointer();                                       // Count = CountBlocks x CountElements
             const auto meanPtr = batchNorm.getMeanPointer();                                       // Count = CountBlocks x CountElements
             const auto shortcutPtr = shortcut.getPointer();                                        // ChannelBlocks x Height x Width x ChannelElements
-            const auto projectionKernelPtr = projectionKernel.getPointer();                        // CountBlocks x CountBlocks x 1 x 1 x CountElements x CountElements
+            const auto projectionKernelPtr = projectionKernel.getPointer();                        // CountBlocks x ShortcutBlocks x 1 x 1 x ShortcutElements x CountElements
             const auto projectionGammaVariancePtr = projectionBatchNorm.getGammaVariancePointer(); // Count = CountBlocks x CountElements
             const auto projectionBetaPtr = projectionBatchNorm.getBetaPointer();                   // Count = CountBlocks x CountElements
             const auto projectionMeanPtr = projectionBatchNorm.getMeanPointer();                   // Count = CountBlocks x CountElements
+            const TParameter *biasPtr = nullptr;                                                              // Count = CountBlocks x CountElements
+            const TParameter *projectionBiasPtr = nullptr;                                                    // Count = CountBlocks x CountElements
+            if constexpr (BatchNormFolded)
+            {
+                biasPtr = batchNorm.getBiasPointer();
+                projectionBiasPtr = projectionBatchNorm.getBiasPointer();
+            }
 
             // If we use libxsmm directly we don't need to do add separately!
             // Both input and output have the same stride therefore we can do a norma matrix multiplication.
-            constexpr const int MM = outputWidth;
+            constexpr const size_t rows = gemmRows<1, InPadding, OutPadding, KernelHeight, KernelWidth, outputHeight, outputWidth>();
+            constexpr const int MM = rows * outputWidth;
             constexpr const int KK = BlockSizeChannel;
             constexpr const int NN = BlockSizeCount;
             constexpr const int ldImage = KK;
 
-            constexpr const char transa = 'N';
-            constexpr const char transb = 'N';
 
             libxsmm_datatype datatype;
             if constexpr (std::is_same<T, float>::value)
             {
                 datatype = LIBXSMM_DATATYPE(float);
             }
+            else if constexpr (std::is_same<T, ImageInference::types::BFloat16>::value)
+            {
+                datatype = LIBXSMM_DATATYPE_BF16;
+            }
+            else if constexpr (std::is_same<T, uint8_t>::value)
+            {
+                datatype = LIBXSMM_DATATYPE_I8;
+            }
             else
             {
-                std::cerr << "ResNet50::convBlock: type is currently not supported! Supported are float." << std::endl;
+                std::cerr << "ResNet50::convBlock: type is currently not supported! Supported are float, BFloat16 and uint8_t." << std::endl;
                 throw std::runtime_error("ResNet50::convBlock: type is currently not supported!");
             }
 
-            const libxsmm_gemm_shape shape = libxsmm_create_gemm_shape(
-                NN /*required*/,
-                MM /*required*/,
-                KK /*required*/,
-                NN /*lda*/,
-                ldImage /*ldb*/,
-                NN /*ldc*/,
-                datatype, // input type
-                datatype, // input type
-                datatype, // output type
-                datatype  // output type
-            );
-            const libxsmm_bitfield flags = LIBXSMM_GEMM_FLAGS(transa, transb);
-
-            const libxsmm_gemmfunction gemmFunc = libxsmm_dispatch_gemm(
-                shape,
-                flags,
-                (libxsmm_bitfield)(LIBXSMM_PREFETCH) // Default from libxsmm_sgemm
-            );
-
-            if (gemmFunc == NULL)
+            // All (channel block, kernel row, kernel column) gemms of an output row are reduced in a single batch-reduce gemm,
+            // which keeps the output row in registers and overwrites the output with the sum.
+            constexpr const size_t batchCount = channelBlocks * KernelHeight * KernelWidth;
+            std::array<unsigned long long, batchCount> imageOffsets;
+            std::array<unsigned long long, batchCount> kernelOffsets;
+            batchReduceOffsets<T, channelBlocks, KernelHeight, KernelWidth>(image, kernel, imageOffsets, kernelOffsets);
+            unsigned long long count = batchCount;
+
+            const libxsmm_gemmfunction gemmFunc = GemmKernels::get(
+                gemmKernels,
+                GemmShape{NN, MM, KK, NN, ldImage, NN, datatype, true, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET},
+                "ResNet50::convBlockAddProjection");
+
+            // Kernels stored in Float16 accumulate all but their first chunk of taps into the output, see batchReduceFloat16.
+            constexpr const bool widening = std::is_same<TWeight, ImageInference::types::Float16>::value;
+            libxsmm_gemmfunction accumulateFunc = nullptr;
+            if constexpr (widening)
             {
-                std::cerr << "ResNet50::convBlock: libxsmm_dispatch_gemm failed!" << std::endl;
-                throw std::runtime_error("ResNet50::convBlock: libxsmm_dispatch_gemm failed!");
+                accumulateFunc = GemmKernels::get(
+                    gemmKernels,
+                    GemmShape{NN, MM, KK, NN, ldImage, NN, datatype, false, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET},
+                    "ResNet50::convBlockAddProjection");
             }
 
             // Gemm setup for projection
 
-            // If we use libxsmm directly we don't need to do add separately!
             // If we use the leading dimension on the image we can use it as stride.
             // With the leading dimension we skip the next blocks as they should be skipped by the stride.
-            constexpr const int pMM = outputWidth;
-            constexpr const int pKK = BlockSizeChannel;
+            // The strided or padded shortcut is not contiguous, then the projection is calculated row by row.
+            constexpr const size_t pRows = gemmRows<Stride, ShortcutPadding, 0, 1, 1, outputHeight, outputWidth>() == rows ? rows : 1;
+            constexpr const int pMM = pRows * outputWidth;
+            constexpr const int pKK = BlockSizeShortcut;
             constexpr const int pNN = BlockSizeCount;
-            constexpr const int pLdImage = KK * Stride;
-
-            constexpr const char pTransa = 'N';
-            constexpr const char pTransb = 'N';
-
-            const libxsmm_gemm_shape pShape = libxsmm_create_gemm_shape(
-                pNN /*required*/,
-                pMM /*required*/,
-                pKK /*required*/,
-                pNN /*lda*/,
-                pLdImage /*ldb*/,
-                pNN /*ldc*/,
-                datatype, // input type
-                datatype, // input type
-                datatype, // output type
-                datatype  // output type
-            );
-            const libxsmm_bitfield pFlags = LIBXSMM_GEMM_FLAGS(pTransa, pTransb);
-
-            const libxsmm_gemmfunction pGemmFunc = libxsmm_dispatch_gemm(
-                pShape,
-                pFlags,
-                (libxsmm_bitfield)(LIBXSMM_PREFETCH) // Default from libxsmm_sgemm
-            );
+            constexpr const int pLdImage = pKK * Stride;
+
+            std::array<unsigned long long, shortcutChannelBlock> shortcutOffsets;
+            std::array<unsigned long long, shortcutChannelBlock> projectionKernelOffsets;
+            batchReduceOffsets<T, shortcutChannelBlock, 1, 1>(shortcut, projectionKernel, shortcutOffsets, projectionKernelOffsets);
+            unsigned long long pCount = shortcutChannelBlock;
+
+            // The folded batch norm of float uses the hand vectorized kernels of the host, see VectorKernels.
+            // Types that accumulate in another type e.g. BFloat16 write both gemms into a tile, whose epilogue rounds it into the output.
+            // The weights of uint8_t have other scales for both convolutions, so the projection gets its own int32_t tile,
+            // which the epilogue requantizes with the scales of the projection batch norm, see BatchNorm::requantize.
+            // Both biases are added to the output, so they are summed once up front.
+            constexpr const bool vectorized = std::is_same<T, float>::value && BatchNormFolded;
+            constexpr const bool tiled = !std::is_same<T, TAccumulator>::value;
+            constexpr const bool quantized = std::is_same<T, uint8_t>::value;
+            static_assert(!tiled || BatchNormFolded, "ResNet50::convBlockAddProjection: Types with another accumulator type need a folded batch norm.");
+            const VectorKernels &vectorKernels = VectorKernels::host();
+            alignas(64) TParameter biasSum[KernelCount];
+            const TParameter *biasSumPtr = biasSum;
+            const TParameter *scalePtr = nullptr;           // Count = CountBlocks x CountElements
+            const TParameter *projectionScalePtr = nullptr; // Count = CountBlocks x CountElements
+            if constexpr (quantized)
+            {
+                scalePtr = batchNorm.getScalePointer();
+                projectionScalePtr = projectionBatchNorm.getScalePointer();
+            }
 
-            if (pGemmFunc == NULL)
+            const libxsmm_gemmfunction pGemmFunc = GemmKernels::get(
+                gemmKernels,
+                GemmShape{pNN, pMM, pKK, pNN, pLdImage, pNN, datatype, !BatchNormFolded || quantized, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET},
+                "ResNet50::convBlockAddProjection (projection)");
+            libxsmm_gemmfunction pAccumulateFunc = nullptr;
+            if constexpr (widening)
+            {
+                pAccumulateFunc = GemmKernels::get(
+                    gemmKernels,
+                    GemmShape{pNN, pMM, pKK, pNN, pLdImage, pNN, datatype, false, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET},
+                    "ResNet50::convBlockAddProjection (projection)");
+            }
+            if constexpr (vectorized || tiled)
             {
-                std::cerr << "ResNet50::convBlock: libxsmm_dispatch_gemm for projection failed!" << std::endl;
-                throw std::runtime_error("ResNet50::convBlock: libxsmm_dispatch_gemm for projection failed!");
+                for (size_t iCount = 0; iCount < KernelCount; iCount++)
+                {
+                    biasSum[iCount] = biasPtr[iCount] + projectionBiasPtr[iCount];
+                }
             }
 
 #ifdef USE_OMP
@@ -1332,94 +2290,154 @@ namespace ImageInference
 #endif // USE_OMP
             for (size_t iBCount = 0; iBCount < countBlocks; iBCount++)
             {
-                for (size_t iHeight = 0; iHeight < outputHeight; iHeight++)
+                for (size_t iHeight = 0; iHeight < outputHeight; iHeight += rows)
                 {
                     // Do convolution calculation
-                    for (size_t iBChannel = 0; iBChannel < channelBlocks; iBChannel++)
+                    const size_t imageOffset = image.getOffset(0, iHeight, 0, 0);
+                    const size_t kernelOffset = kernel.getOffset(iBCount, 0, 0, 0, 0, 0);
+                    const size_t outputOffset = output.getOffset(iBCount, iHeight, 0, 0);
+
+#ifdef IMAGEINFERENCE_TESTING
+                    // Get the last element touched by the batch.
+                    image.getOffset(channelBlocks - 1, iHeight + rows - 1 + KernelHeight - 1, outputWidth - 1 + KernelWidth - 1, BlockSizeChannel - 1);
+                    kernel.getOffset(iBCount, channelBlocks - 1, KernelHeight - 1, KernelWidth - 1, BlockSizeChannel - 1, BlockSizeCount - 1);
+                    // Adding padding offset as this is already applied at the output.
+                    output.getOffset(iBCount, iHeight + rows - 1, outputWidth - 1, BlockSizeCount - 1 + output.paddingOffset);
+#endif // IMAGEINFERENCE_TESTING
+
+                    // Kernel of shape BlockSizeChannel x BlockSizeCount
+                    // Input of shape (rows x outputWidth) x BlockSizeChannel, strided by ldImage
+                    // Output of shape (rows x outputWidth) x BlockSizeCount
+                    alignas(64) TAccumulator tile[tiled ? MM * NN : 1];
+                    alignas(64) TAccumulator projectionTile[quantized ? MM * NN : 1];
+                    libxsmm_gemm_param param;
+                    param.a.primary = kernelPtr + kernelOffset;
+                    param.a.secondary = kernelOffsets.data();
+                    param.b.primary = imagePtr + imageOffset;
+                    param.b.secondary = imageOffsets.data();
+                    if constexpr (tiled)
                     {
-                        for (size_t kHeight = 0; kHeight < KernelHeight; kHeight++)
-                        {
-                            for (size_t kWidth = 0; kWidth < KernelWidth; kWidth++)
-                            {
-                                const size_t imageOffset = image.getOffset(iBChannel, iHeight + kHeight, kWidth, 0);
-                                const size_t kernelOffset = kernel.getOffset(iBCount, iBChannel, kHeight, kWidth, 0, 0);
-                                const size_t outputOffset = output.getOffset(iBCount, iHeight, 0, 0);
-
-                                // Kernel of shape BlockSizeChannel x BlockSizeCount
-                                // Input of shape ImageWidth x BlockSizeChannel
-                                // Output of shape outputWidth x BlockSizeCount === ImageWidth / Stride x BlockSizeCount
-
-                                libxsmm_gemm_param param;
-                                param.a.primary = kernelPtr + kernelOffset;
-                                param.b.primary = imagePtr + imageOffset;
-                                param.c.primary = outputPtr + outputOffset;
-
-                                LIBXSMM_XGEMM_PREFETCH(
-                                    datatype,
-                                    datatype,
-                                    NN,
-                                    MM,
-                                    KK,
-                                    param);
-
-                                gemmFunc(&param);
-                            }
-                        }
+                        param.c.primary = tile;
+                    }
+                    else
+                    {
+                        param.c.primary = outputPtr + outputOffset;
+                    }
+                    param.op.tertiary = &count;
+                    if constexpr (widening)
+                    {
+                        batchReduceFloat16<BlockSizeChannel * BlockSizeCount>(kernelPtr + kernelOffset, kernelOffsets, imagePtr + imageOffset, imageOffsets,
+                                                                              outputPtr + outputOffset, gemmFunc, accumulateFunc);
+                    }
+                    else
+                    {
+                        gemmFunc(&param);
                     }
 
                     // Calculate the shortcut projection
-                    for (size_t iBChannel = 0; iBChannel < shortcutChannelBlock; iBChannel++)
+                    for (size_t iRow = iHeight; iRow < iHeight + rows; iRow += pRows)
                     {
-                        const size_t offsetShortcut = shortcut.getOffset(iBChannel, iHeight * Stride, 0, 0);
-                        const size_t offsetProjectionKernel = projectionKernel.getOffset(iBCount, iBChannel, 0, 0, 0, 0);
-                        const size_t offsetProjection = projection.getOffset(iBCount, iHeight, 0, 0);
-
-                        // Kernel of shape BlockSizeChannel x BlockSizeCount
-                        // Input of shape ImageWidth x BlockSizeChannel
-                        // Output of shape outputWidth x BlockSizeCount === ImageWidth / Stride x BlockSizeCount
+                        const size_t offsetShortcut = shortcut.getOffset(0, iRow * Stride, 0, 0);
+                        const size_t offsetProjectionKernel = projectionKernel.getOffset(iBCount, 0, 0, 0, 0, 0);
 
                         libxsmm_gemm_param pParam;
                         pParam.a.primary = projectionKernelPtr + offsetProjectionKernel;
+                        pParam.a.secondary = projectionKernelOffsets.data();
                         pParam.b.primary = shortcutPtr + offsetShortcut;
-                        pParam.c.primary = projectionPtr + offsetProjection;
-
-                        LIBXSMM_XGEMM_PREFETCH(
-                            datatype,
-                            datatype,
-                            pNN,
-                            pMM,
-                            pKK,
-                            pParam);
-
-                        pGemmFunc(&pParam);
+                        pParam.b.secondary = shortcutOffsets.data();
+                        if constexpr (quantized)
+                        {
+                            pParam.c.primary = projectionTile + (iRow - iHeight) * outputWidth * NN;
+                        }
+                        else if constexpr (tiled)
+                        {
+                            pParam.c.primary = tile + (iRow - iHeight) * outputWidth * NN;
+                        }
+                        else if constexpr (BatchNormFolded)
+                        {
+                            pParam.c.primary = outputPtr + output.getOffset(iBCount, iRow, 0, 0);
+                        }
+                        else
+                        {
+                            pParam.c.primary = projectionPtr + projection->getOffset(iBCount, iRow, 0, 0);
+                        }
+                        pParam.op.tertiary = &pCount;
+                        if constexpr (widening)
+                        {
+                            batchReduceFloat16<BlockSizeShortcut * BlockSizeCount>(projectionKernelPtr + offsetProjectionKernel, projectionKernelOffsets,
+                                                                                   shortcutPtr + offsetShortcut, shortcutOffsets,
+                                                                                   static_cast<float *>(pParam.c.primary), pGemmFunc, pAccumulateFunc);
+                        }
+                        else
+                        {
+                            pGemmFunc(&pParam);
+                        }
                     }
 
-                    // At this point we completed a complete row of the projection.
+                    // At this point we completed complete rows of the output, which already contain the projection if the batch norms are folded.
                     // Now we apply the batch norm.
-                    for (size_t iWidth = 0; iWidth < outputWidth; iWidth++)
+                    if constexpr (quantized)
+                    {
+                        for (size_t iRow = iHeight; iRow < iHeight + rows; iRow++)
+                        {
+                            vectorKernels.requantizeProjectionRelu(outputPtr + output.getOffset(iBCount, iRow, 0, 0), tile + (iRow - iHeight) * outputWidth * NN,
+                                                                   scalePtr + iBCount * BlockSizeCount, biasSumPtr + iBCount * BlockSizeCount,
+                                                                   projectionTile + (iRow - iHeight) * outputWidth * NN, projectionScalePtr + iBCount * BlockSizeCount,
+                                                                   outputWidth, BlockSizeCount);
+                        }
+                    }
+                    else if constexpr (tiled)
+                    {
+                        for (size_t iRow = iHeight; iRow < iHeight + rows; iRow++)
+                        {
+                            vectorKernels.biasReluBFloat16(outputPtr + output.getOffset(iBCount, iRow, 0, 0), tile + (iRow - iHeight) * outputWidth * NN,
+                                                           biasSumPtr + iBCount * BlockSizeCount, outputWidth, BlockSizeCount);
+                        }
+                    }
+                    else if constexpr (vectorized)
+                    {
+                        for (size_t iRow = iHeight; iRow < iHeight + rows; iRow++)
+                        {
+                            vectorKernels.biasRelu(outputPtr + output.getOffset(iBCount, iRow, 0, 0), biasSumPtr + iBCount * BlockSizeCount, outputWidth, BlockSizeCount);
+                        }
+                    }
+                    else
                     {
+                        for (size_t iRow = iHeight; iRow < iHeight + rows; iRow++)
+                        {
+                            for (size_t iWidth = 0; iWidth < outputWidth; iWidth++)
+                            {
 #ifdef USE_OMP
 #pragma omp simd
 #endif // USE_OMP
-                        for (size_t iCount = 0; iCount < BlockSizeCount; iCount++)
-                        {
-                            const size_t offsetProject = projection.getOffset(iBCount, iHeight, iWidth, iCount);
-                            const size_t offsetOutput = output.getOffset(iBCount, iHeight, iWidth, iCount);
-                            const size_t offsetCount = iBCount * BlockSizeCount + iCount;
-
-                            const T batchNormValue = ResNet50::batchNorm<T>(
-                                outputPtr[offsetOutput],
-                                gammaVariancePtr[offsetCount],
-                                betaPtr[offsetCount],
-                                meanPtr[offsetCount]);
-
-                            const T projectedValue = ResNet50::batchNorm<T>(
-                                projectionPtr[offsetProject],
-                                projectionGammaVariancePtr[offsetCount],
-                                projectionBetaPtr[offsetCount],
-                                projectionMeanPtr[offsetCount]);
-
-                            outputPtr[offsetOutput] = relu<T>(batchNormValue + projectedValue);
+                                for (size_t iCount = 0; iCount < BlockSizeCount; iCount++)
+                                {
+                                    const size_t offsetOutput = output.getOffset(iBCount, iRow, iWidth, iCount);
+                                    const size_t offsetCount = iBCount * BlockSizeCount + iCount;
+
+                                    if constexpr (BatchNormFolded)
+                                    {
+                                        outputPtr[offsetOutput] = relu<T>(outputPtr[offsetOutput] + biasPtr[offsetCount] + projectionBiasPtr[offsetCount]);
+                                    }
+                                    else
+                                    {
+                                        const size_t offsetProject = projection->getOffset(iBCount, iRow, iWidth, iCount);
+                                        const T batchNormValue = ResNet50::batchNorm<T>(
+                                            outputPtr[offsetOutput],
+                                            gammaVariancePtr[offsetCount],
+                                            betaPtr[offsetCount],
+                                            meanPtr[offsetCount]);
+
+                                        const T projectedValue = ResNet50::batchNorm<T>(
+                                            projectionPtr[offsetProject],
+                                            projectionGammaVariancePtr[offsetCount],
+                                            projectionBetaPtr[offsetCount],
+                                            projectionMeanPtr[offsetCount]);
+
+                                        outputPtr[offsetOutput] = relu<T>(batchNormValue + projectedValue);
+                                    }
+                                }
+                            }
                         }
                     }
                 }
@@ -1448,6 +2466,30 @@ namespace ImageInference
 
             const auto imagePtr = image.getPointer();
 
+            if constexpr (std::is_same<T, float>::value)
+            {
+                // The hand vectorized kernels of the host take the max over the three rows, followed by the max over the three pixels.
+                const VectorKernels &vectorKernels = VectorKernels::host();
+                constexpr const size_t paddedWidth = ImageWidth + 2 * InPadding;
+
+#ifdef USE_OMP
+#pragma omp parallel for collapse(2)
+#endif // USE_OMP
+                for (size_t iBChannel = 0; iBChannel < channelBlocks; iBChannel++)
+                {
+                    for (size_t iHeight = 0; iHeight < outputHeight; iHeight++)
+                    {
+                        alignas(64) T row[paddedWidth * BlockSize];
+                        const T *imageRow = imagePtr + image.getOffset(iBChannel, iHeight * Stride, 0, 0);
+                        std::copy(imageRow, imageRow + paddedWidth * BlockSize, row);
+                        vectorKernels.maximum(row, imagePtr + image.getOffset(iBChannel, iHeight * Stride + 1, 0, 0), paddedWidth * BlockSize);
+                        vectorKernels.maximum(row, imagePtr + image.getOffset(iBChannel, iHeight * Stride + 2, 0, 0), paddedWidth * BlockSize);
+                        vectorKernels.maxPoolRow(outputPtr + output.getOffset(iBChannel, iHeight, 0, 0), row, outputWidth, Stride, BlockSize);
+                    }
+                }
+                return;
+            }
+
 // 3x3 Stencil that gets the max value
 #ifdef USE_OMP // We can parallelize the channel blocks as they are independent of each other for this max operation.
 #pragma omp parallel for collapse(2)
@@ -1502,6 +2544,31 @@ namespace ImageInference
             auto imagePtr = image.getPointer() + image.paddingOffset; // We skip the padding as padding should not be averaged.
             constexpr const float scale = 1.0f / (ImageHeight * ImageWidth);
 
+            if constexpr (std::is_same<T, float>::value)
+            {
+                // Every channel block is summed by one thread with the hand vectorized kernels of the host, so no reduction between the threads is needed.
+                const VectorKernels &vectorKernels = VectorKernels::host();
+
+#ifdef USE_OMP
+#pragma omp parallel for
+#endif // USE_OMP
+                for (size_t iBChannel = 0; iBChannel < channelBlocks; iBChannel++)
+                {
+                    T sum[BlockSize] = {};
+                    for (size_t iHeight = 0; iHeight < ImageHeight; iHeight++)
+                    {
+                        vectorKernels.sumPixels(sum, imagePtr + image.getOffset(iBChannel, iHeight, 0, 0), ImageWidth, BlockSize);
+                    }
+
+                    T *outputBlock = outputPtr + output.getOffset(iBChannel, 0, 0, 0);
+                    for (size_t iChannel = 0; iChannel < BlockSize; iChannel++)
+                    {
+                        outputBlock[iChannel] += sum[iChannel] * scale;
+                    }
+                }
+                return;
+            }
+
 // We can do this reduction because the ouput has only one element per channel.
 // The channel are larger (2048). Therefore we have many blocks to parallelize on.
 // Otherwise the loops should be split and collapsed.
@@ -1566,6 +2633,334 @@ namespace ImageInference
             biasMap += Fastor::matmul(weightMap, inputMap);
         }
 
+        template <size_t Batch, size_t InPadding, typename T, typename TWeight, size_t BlockSize,
+                  size_t ImageChannels, size_t ImageHeight, size_t ImageWidth, size_t Columns>
+        inline void ResNet50::globalAveragePoolFullyConnected(
+            const std::array<ImageInference::types::Image<T, InPadding, BlockSize, ImageChannels, ImageHeight, ImageWidth> *, Batch> &images,
+            ImageInference::types::Matrix<TWeight, ImageChannels, Columns> &weight,
+            ImageInference::types::Array<typename ImageInference::types::Parameter<T>::type, Columns> &bias,
+            typename ImageInference::types::Parameter<T>::type *output,
+            const GemmKernels *gemmKernels)
+        {
+            using TParameter = typename ImageInference::types::Parameter<T>::type;
+            constexpr const size_t channelBlocks = ImageChannels / BlockSize;
+            constexpr const TParameter scale = TParameter(1) / (ImageHeight * ImageWidth);
+            constexpr const size_t columnsPerGemm = fullyConnectedColumns<Columns>();
+            constexpr const size_t gemms = Columns / columnsPerGemm;
+            static_assert(std::is_same<TWeight, TParameter>::value || std::is_same<TWeight, ImageInference::types::Float16>::value,
+                          "ResNet50::globalAveragePoolFullyConnected: The weight needs the parameter type of T or Float16.");
+            constexpr const bool widening = std::is_same<TWeight, ImageInference::types::Float16>::value;
+            constexpr const size_t widenedChannels = fullyConnectedFloat16Channels<ImageChannels, Columns>();
+
+            const auto weightPtr = weight.getPointer(); // Channels x Columns
+            const auto biasPtr = bias.getPointer();
+
+            libxsmm_datatype datatype;
+            if constexpr (std::is_same<TParameter, float>::value)
+            {
+                datatype = LIBXSMM_DATATYPE(float);
+            }
+            else
+            {
+                std::cerr << "ResNet50::globalAveragePoolFullyConnected: type is currently not supported! Supported are float, BFloat16 and uint8_t." << std::endl;
+                throw std::runtime_error("ResNet50::globalAveragePoolFullyConnected: type is currently not supported!");
+            }
+
+            // Every image of the batch is a column of the features, so the fully connected layer is a single gemm over the batch.
+            alignas(64) TParameter features[Batch * ImageChannels]; // Batch x Channels
+
+            // Every channel block is averaged by one thread, so no reduction between the threads is needed.
+            // The rows of float are summed with the hand vectorized kernels of the host, see VectorKernels.
+            const VectorKernels &vectorKernels = VectorKernels::host();
+#ifdef USE_OMP
+#pragma omp parallel for collapse(2)
+#endif // USE_OMP
+            for (size_t iBatch = 0; iBatch < Batch; iBatch++)
+            {
+                for (size_t iBChannel = 0; iBChannel < channelBlocks; iBChannel++)
+                {
+                    auto &image = *images[iBatch];
+                    const auto imagePtr = image.getPointer() + image.paddingOffset; // We skip the padding as padding should not be averaged.
+
+                    TParameter sum[BlockSize] = {};
+                    for (size_t iHeight = 0; iHeight < ImageHeight; iHeight++)
+                    {
+                        if constexpr (std::is_same<T, float>::value)
+                        {
+                            vectorKernels.sumPixels(sum, imagePtr + image.getOffset(iBChannel, iHeight, 0, 0), ImageWidth, BlockSize);
+                        }
+                        else
+                        {
+                            for (size_t iWidth = 0; iWidth < ImageWidth; iWidth++)
+                            {
+#ifdef USE_OMP // We can apply simd because the elements are independent of each other.
+#pragma omp simd
+#endif // USE_OMP
+                                for (size_t iChannel = 0; iChannel < BlockSize; iChannel++)
+                                {
+                                    sum[iChannel] += imagePtr[image.getOffset(iBChannel, iHeight, iWidth, iChannel)];
+                                }
+                            }
+                        }
+                    }
+
+                    TParameter *featuresBlock = features + iBatch * ImageChannels + iBChannel * BlockSize;
+#ifdef USE_OMP
+#pragma omp simd
+#endif // USE_OMP
+                    for (size_t iChannel = 0; iChannel < BlockSize; iChannel++)
+                    {
+                        featuresBlock[iChannel] = sum[iChannel] * scale;
+                    }
+                }
+            }
+
+            // Reading the weight dominates the fully connected layer, so the columns are split over many gemms.
+            // Weight of shape Channels x columnsPerGemm, strided by Columns
+            // Features of shape Batch x Channels
+            // Output of shape Batch x columnsPerGemm, strided by Columns
+            // The weight in Float16 is widened into a contiguous chunk of widenedChannels x columnsPerGemm per gemm instead.
+            const GemmShape shape = widening
+                                        ? GemmShape{static_cast<int>(columnsPerGemm), static_cast<int>(Batch), static_cast<int>(widenedChannels),
+                                                    static_cast<int>(columnsPerGemm), static_cast<int>(ImageChannels), static_cast<int>(Columns), datatype}
+                                        : GemmShape{static_cast<int>(columnsPerGemm), static_cast<int>(Batch), static_cast<int>(ImageChannels),
+                                                    static_cast<int>(Columns), static_cast<int>(ImageChannels), static_cast<int>(Columns), datatype};
+            const libxsmm_gemmfunction gemmFunc = GemmKernels::get(gemmKernels, shape, "ResNet50::globalAveragePoolFullyConnected");
+
+#ifdef USE_OMP
+#pragma omp parallel for
+#endif // USE_OMP
+            for (size_t iGemm = 0; iGemm < gemms; iGemm++)
+            {
+                const size_t column = iGemm * columnsPerGemm;
+
+                // The bias is copied into the output as the gemm accumulates into it.
+                for (size_t iBatch = 0; iBatch < Batch; iBatch++)
+                {
+                    std::copy(biasPtr + bias.getOffset(column), biasPtr + bias.getOffset(column) + columnsPerGemm, output + iBatch * Columns + column);
+                }
+
+#ifdef IMAGEINFERENCE_TESTING
+                // Get the last element touched by the gemm.
+                weight.getOffset(ImageChannels - 1, column + columnsPerGemm - 1);
+#endif // IMAGEINFERENCE_TESTING
+
+                if constexpr (widening)
+                {
+                    alignas(64) float widened[widenedChannels * columnsPerGemm];
+                    for (size_t iChannel = 0; iChannel < ImageChannels; iChannel += widenedChannels)
+                    {
+                        for (size_t iRow = 0; iRow < widenedChannels; iRow++)
+                        {
+                            vectorKernels.widenFloat16(widened + iRow * columnsPerGemm, weightPtr + weight.getOffset(iChannel + iRow, column), columnsPerGemm);
+                        }
+
+                        libxsmm_gemm_param param;
+                        param.a.primary = widened;
+                        param.b.primary = features + iChannel;
+                        param.c.primary = output + column;
+                        gemmFunc(&param);
+                    }
+                }
+                else
+                {
+                    libxsmm_gemm_param param;
+                    param.a.primary = weightPtr + weight.getOffset(0, column);
+                    param.b.primary = features;
+                    param.c.primary = output + column;
+                    gemmFunc(&param);
+                }
+            }
+        }
+
+        template <size_t Batch, typename F>
+        inline void ResNet50::dispatchBatch(const size_t batch, F &&function)
+        {
+            if constexpr (Batch < RESNET50_BATCH)
+            {
+                if (batch != Batch)
+                {
+                    dispatchBatch<Batch + 1>(batch, std::forward<F>(function));
+                    return;
+                }
+            }
+            else if (batch != Batch)
+            {
+                std::cerr << "ResNet50::dispatchBatch: The batch " << batch << " is not between 1 and " << RESNET50_BATCH << "." << std::endl;
+                throw std::runtime_error("ResNet50::dispatchBatch: The batch is not supported!");
+            }
+
+            function(std::integral_constant<size_t, Batch>());
+        }
+
+        template <size_t Stride, size_t InPadding, size_t OutPadding, size_t KernelHeight, size_t KernelWidth, size_t OutputHeight, size_t OutputWidth>
+        constexpr size_t ResNet50::gemmRows()
+        {
+            if constexpr (Stride != 1 || InPadding != 0 || OutPadding != 0 || KernelHeight != 1 || KernelWidth != 1)
+            {
+                return 1;
+            }
+
+            // The rows need to divide the height, so every gemm has the same shape.
+            size_t rows = 1;
+            for (size_t iRows = 1; iRows <= OutputHeight; iRows++)
+            {
+                if (OutputHeight % iRows == 0 && iRows * OutputWidth <= RESNET50_GEMM_PIXELS)
+                {
+                    rows = iRows;
+                }
+            }
+            return rows;
+        }
+
+        template <size_t Columns>
+        constexpr size_t ResNet50::fullyConnectedColumns()
+        {
+            // The columns need to divide Columns, so every gemm has the same shape.
+            size_t columns = 1;
+            for (size_t iColumns = 1; iColumns <= Columns && iColumns <= RESNET50_FC_COLUMNS; iColumns++)
+            {
+                if (Columns % iColumns == 0)
+                {
+                    columns = iColumns;
+                }
+            }
+            return columns;
+        }
+
+        template <size_t Channels, size_t Columns>
+        constexpr size_t ResNet50::fullyConnectedFloat16Channels()
+        {
+            // The channels need to divide Channels, so every gemm has the same shape.
+            constexpr const size_t columns = fullyConnectedColumns<Columns>();
+            size_t channels = 1;
+            for (size_t iChannels = 1; iChannels <= Channels && iChannels * columns * sizeof(float) <= RESNET50_FLOAT16_WIDENED; iChannels++)
+            {
+                if (Channels % iChannels == 0)
+                {
+                    channels = iChannels;
+                }
+            }
+            return channels;
+        }
+
+        template <typename TKernel, typename TKernelFloat16, typename F>
+        inline void ResNet50::dispatchFloat16(TKernel &kernel, const std::unique_ptr<TKernelFloat16> &kernelFloat16, F &&function)
+        {
+            if constexpr (std::is_same<TKernel, typename TKernel::template WithType<float>>::value)
+            {
+                if (kernelFloat16)
+                {
+                    function(*kernelFloat16);
+                    return;
+                }
+            }
+            function(kernel);
+        }
+
+        template <typename TKernel, typename TKernelFloat16, typename TOtherKernel, typename TOtherKernelFloat16, typename F>
+        inline void ResNet50::dispatchFloat16(TKernel &kernel, const std::unique_ptr<TKernelFloat16> &kernelFloat16,
+                                              TOtherKernel &otherKernel, const std::unique_ptr<TOtherKernelFloat16> &otherKernelFloat16, F &&function)
+        {
+            // Both kernels belong to the same bottleneck and are converted together, see ResNet50BottleneckProjection::setFloat16.
+            if constexpr (std::is_same<TKernel, typename TKernel::template WithType<float>>::value)
+            {
+                if (kernelFloat16 && otherKernelFloat16)
+                {
+                    function(*kernelFloat16, *otherKernelFloat16);
+                    return;
+                }
+            }
+            function(kernel, otherKernel);
+        }
+
+        template <size_t TapSize, size_t BatchCount>
+        inline void ResNet50::batchReduceFloat16(
+            const ImageInference::types::Float16 *kernel,
+            std::array<unsigned long long, BatchCount> &kernelOffsets,
+            float *image,
+            std::array<unsigned long long, BatchCount> &imageOffsets,
+            float *output,
+            const libxsmm_gemmfunction gemmFunc,
+            const libxsmm_gemmfunction accumulateFunc)
+        {
+            constexpr const size_t chunkTaps = std::max<size_t>(1, std::min<size_t>(BatchCount, RESNET50_FLOAT16_WIDENED / (TapSize * sizeof(float))));
+            alignas(64) float widened[chunkTaps * TapSize];
+            const VectorKernels &vectorKernels = VectorKernels::host();
+
+            for (size_t iBatch = 0; iBatch < BatchCount; iBatch += chunkTaps)
+            {
+                unsigned long long count = std::min(chunkTaps, BatchCount - iBatch);
+                vectorKernels.widenFloat16(widened, kernel + iBatch * TapSize, count * TapSize);
+
+                libxsmm_gemm_param param;
+                param.a.primary = widened;
+                param.a.secondary = kernelOffsets.data();
+                param.b.primary = image;
+                param.b.secondary = imageOffsets.data() + iBatch;
+                param.c.primary = output;
+                param.op.tertiary = &count;
+                (iBatch == 0 ? gemmFunc : accumulateFunc)(&param);
+            }
+        }
+
+        template <typename T, size_t ChannelBlocks, size_t KernelHeight, size_t KernelWidth, typename TImage, typename TKernel>
+        inline void ResNet50::batchReduceOffsets(
+            TImage &image,
+            TKernel &kernel,
+            std::array<unsigned long long, ChannelBlocks * KernelHeight * KernelWidth> &imageOffsets,
+            std::array<unsigned long long, ChannelBlocks * KernelHeight * KernelWidth> &kernelOffsets)
+        {
+            size_t iBatch = 0;
+            for (size_t iBChannel = 0; iBChannel < ChannelBlocks; iBChannel++)
+            {
+                for (size_t kHeight = 0; kHeight < KernelHeight; kHeight++)
+                {
+                    for (size_t kWidth = 0; kWidth < KernelWidth; kWidth++)
+                    {
+                        imageOffsets[iBatch] = image.getOffset(iBChannel, kHeight, kWidth, 0) * sizeof(T);
+                        kernelOffsets[iBatch] = kernel.getOffset(0, iBChannel, kHeight, kWidth, 0, 0) * sizeof(T);
+                        iBatch++;
+                    }
+                }
+            }
+        }
+
+        template <size_t Stride, size_t ImageChannels, size_t ImageHeight, size_t ImageWidth,
+                  size_t KernelHeight, size_t KernelWidth, typename T>
+        inline void ResNet50::planarStrip(const T *image, const size_t iHeight, T *strip)
+        {
+            constexpr const size_t outputWidth = ImageWidth / Stride;
+            constexpr const size_t depth = KernelHeight * KernelWidth * ImageChannels;
+            constexpr const long paddingHeight = KernelHeight / 2;
+            constexpr const long paddingWidth = KernelWidth / 2;
+
+            constexpr const size_t strideImageChannel = ImageHeight * ImageWidth;
+            constexpr const size_t strideImageHeight = ImageWidth;
+
+            for (size_t iWidth = 0; iWidth < outputWidth; iWidth++)
+            {
+                T *column = strip + iWidth * depth; // KernelHeight x KernelWidth x Channels
+                for (size_t kHeight = 0; kHeight < KernelHeight; kHeight++)
+                {
+                    const long iImageHeight = static_cast<long>(iHeight * Stride + kHeight) - paddingHeight;
+                    const bool insideHeight = iImageHeight >= 0 && iImageHeight < static_cast<long>(ImageHeight);
+
+                    for (size_t kWidth = 0; kWidth < KernelWidth; kWidth++)
+                    {
+                        const long iImageWidth = static_cast<long>(iWidth * Stride + kWidth) - paddingWidth;
+                        const bool inside = insideHeight && iImageWidth >= 0 && iImageWidth < static_cast<long>(ImageWidth);
+
+                        T *tap = column + (kHeight * KernelWidth + kWidth) * ImageChannels;
+                        for (size_t iChannel = 0; iChannel < ImageChannels; iChannel++)
+                        {
+                            tap[iChannel] = inside ? image[iChannel * strideImageChannel + iImageHeight * strideImageHeight + iImageWidth] : T(0);
+                        }
+                    }
+                }
+            }
+        }
+
         template <typename T>
         inline T *ResNet50::getWeight(const size_t index)
         {
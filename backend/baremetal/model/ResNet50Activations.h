@@ -0,0 +1,192 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef IMAGEINFERENCE_RESNET50ACTIVATIONS_H
+#define IMAGEINFERENCE_RESNET50ACTIVATIONS_H
+
+#include "ActivationArena.h"
+#include "Winograd.h"
+#include "../types/Image.h"
+#include <array>
+#include <memory>
+#include <stddef.h>
+
+namespace ImageInference
+{
+    namespace model
+    {
+        /// @brief The activations of one forward pass through ResNet50, planned into a single arena.
+        ///
+        /// The graph is fixed, therefore the lifetimes are known up front. The forward pass is split into steps:
+        /// step 0 is the stem convolution with the fused max pooling, every bottleneck takes three steps
+        /// (1x1 reduce, 3x3 spatial, 1x1 expand with the shortcut) and the head reads the output of the last bottleneck.
+        /// The output of a bottleneck is alive until the next bottleneck consumed it as shortcut,
+        /// so the bottleneck outputs ping-pong between two places in the arena.
+        ///
+        /// With Winograd the 3x3 convolutions with a stride of 1 also get a scratch for the transformed tiles,
+        /// which is only alive during the 3x3 step.
+        ///
+        /// An instance can only be used by one forward pass at a time.
+        ///
+        /// The size of an activation does not depend on the block size of its channels,
+        /// so the same plan is used for all block sizes of the layers.
+        ///
+        /// @tparam T The type of the activations.
+        template <typename T>
+        class ResNet50Activations
+        {
+        public:
+            /// @brief The ids of the activations of a single bottleneck.
+            struct Bottleneck
+            {
+                size_t reduce;
+                size_t spatial;
+                size_t output;
+                /// @brief The scratch of the Winograd convolution or none.
+                size_t winograd;
+            };
+
+            /// @brief The id of an activation that is not planned.
+            static constexpr const size_t none = static_cast<size_t>(-1);
+
+            size_t maxPool;
+            std::array<Bottleneck, 3> layer1;
+            std::array<Bottleneck, 4> layer2;
+            std::array<Bottleneck, 6> layer3;
+            std::array<Bottleneck, 3> layer4;
+
+            /// @param winograd Plans the scratch of the Winograd convolutions.
+            explicit ResNet50Activations(bool winograd = false);
+
+            /// @brief The memory of the activation, to be used with the Image constructor for external memory.
+            T *get(size_t id);
+
+            /// @brief The number of elements of the activation.
+            size_t getSize(size_t id) const;
+
+            const ActivationArena &getArena() const;
+
+            /// @brief The scratch of the fused bottlenecks, see ResNet50::bottleneckFused.
+            /// The bottlenecks run one after another and share it. Its size depends on the threads of the forward pass,
+            /// therefore it is not planned but allocated by the first forward pass and reused by the next ones.
+            /// @param size The number of elements.
+            T *getFusedScratch(size_t size);
+
+        private:
+            ActivationArena arena;
+            std::unique_ptr<T[]> fusedScratch;
+            size_t fusedScratchSize = 0;
+            size_t bottleneckCount = 0;
+            bool winograd;
+
+            static constexpr const size_t stepStem = 0;
+            static constexpr const size_t stepFirstBottleneck = 1;
+            static constexpr const size_t stepsPerBottleneck = 3;
+
+            template <size_t Padding, size_t Channels, size_t Height, size_t Width>
+            size_t add(size_t firstStep, size_t lastStep);
+
+            /// @brief Adds the bottlenecks of a layer, the first one applies the stride and projects the shortcut.
+            template <size_t MidChannels, size_t OutChannels, size_t InSize, size_t Stride, size_t Count>
+            void addLayer(std::array<Bottleneck, Count> &layer);
+        };
+
+        template <typename T>
+        inline ResNet50Activations<T>::ResNet50Activations(bool winograd)
+            : winograd(winograd)
+        {
+            // The stem reads the caller's input in place and keeps the rows of its convolution on the stack,
+            // therefore only the pooled output is part of the arena. Read as shortcut by the last step of the first bottleneck.
+            maxPool = add<0, 64, 56, 56>(stepStem, stepFirstBottleneck + stepsPerBottleneck - 1);
+
+            addLayer<64, 256, 56, 1>(layer1);
+            addLayer<128, 512, 56, 2>(layer2);
+            addLayer<256, 1024, 28, 2>(layer3);
+            addLayer<512, 2048, 14, 2>(layer4);
+
+            arena.plan();
+        }
+
+        template <typename T>
+        inline T *ResNet50Activations<T>::get(size_t id)
+        {
+            return static_cast<T *>(arena.get(id));
+        }
+
+        template <typename T>
+        inline size_t ResNet50Activations<T>::getSize(size_t id) const
+        {
+            return arena.getSize(id) / sizeof(T);
+        }
+
+        template <typename T>
+        inline const ActivationArena &ResNet50Activations<T>::getArena() const
+        {
+            return arena;
+        }
+
+        template <typename T>
+        inline T *ResNet50Activations<T>::getFusedScratch(size_t size)
+        {
+            if (size > fusedScratchSize)
+            {
+                fusedScratch = std::make_unique<T[]>(size);
+                fusedScratchSize = size;
+            }
+            return fusedScratch.get();
+        }
+
+        template <typename T>
+        template <size_t Padding, size_t Channels, size_t Height, size_t Width>
+        inline size_t ResNet50Activations<T>::add(size_t firstStep, size_t lastStep)
+        {
+            // A single block of all channels, as the size is the same for every block size.
+            return arena.add(sizeof(T) * ImageInference::types::Image<T, Padding, Channels, Channels, Height, Width>::size, firstStep, lastStep);
+        }
+
+        template <typename T>
+        template <size_t MidChannels, size_t OutChannels, size_t InSize, size_t Stride, size_t Count>
+        inline void ResNet50Activations<T>::addLayer(std::array<Bottleneck, Count> &layer)
+        {
+            constexpr size_t OutSize = InSize / Stride;
+            const size_t stepLayer = stepFirstBottleneck + bottleneckCount * stepsPerBottleneck;
+
+            for (size_t i = 0; i < Count; i++)
+            {
+                const size_t stepReduce = stepFirstBottleneck + bottleneckCount * stepsPerBottleneck;
+                const size_t stepSpatial = stepReduce + 1;
+                const size_t stepExpand = stepReduce + 2;
+                bottleneckCount++;
+
+                // The images are initialized when they are created, which is when the bottleneck starts and not when they are written.
+                // The output of the last bottleneck is the output of the layer, which is created before the layer starts.
+                const size_t stepOutput = i + 1 == Count ? stepLayer : stepReduce;
+
+                auto &bottleneck = layer[i];
+                if (i == 0)
+                {
+                    // Padding of 1 as the 3x3 kernel is coming next, which applies the stride.
+                    bottleneck.reduce = add<1, MidChannels, InSize, InSize>(stepReduce, stepSpatial);
+                    // The projection of the shortcut is accumulated into the output, so it needs no activation.
+                }
+                else
+                {
+                    bottleneck.reduce = add<1, MidChannels, OutSize, OutSize>(stepReduce, stepSpatial);
+                }
+                bottleneck.spatial = add<0, MidChannels, OutSize, OutSize>(stepReduce, stepExpand);
+                // The output is the shortcut of the next bottleneck or read by the head.
+                bottleneck.output = add<0, OutChannels, OutSize, OutSize>(stepOutput, stepExpand + stepsPerBottleneck);
+
+                // Only the 3x3 convolutions without stride can use Winograd.
+                bottleneck.winograd = none;
+                if (winograd && (i > 0 || Stride == 1))
+                {
+                    bottleneck.winograd = arena.add(sizeof(T) * Winograd::scratchSize<MidChannels, MidChannels, OutSize, OutSize>(), stepSpatial, stepSpatial);
+                }
+            }
+        }
+    } // namespace model
+} // namespace ImageInference
+
+#endif // IMAGEINFERENCE_RESNET50ACTIVATIONS_H
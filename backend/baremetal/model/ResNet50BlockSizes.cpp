@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#include "ResNet50BlockSizes.h"
+#include <algorithm>
+
+ImageInference::model::ResNet50BlockSizes ImageInference::model::ResNet50BlockSizes::uniform(const size_t blockSize)
+{
+    return ResNet50BlockSizes{blockSize, blockSize, blockSize, blockSize, blockSize};
+}
+
+ImageInference::model::ResNet50BlockSizes ImageInference::model::ResNet50BlockSizes::forIsa(const VectorIsa isa)
+{
+    // The block size is the m of the gemms, which libxsmm keeps in registers.
+    // The layers at the end have many channels on small images, so larger blocks give every gemm more work.
+    switch (isa)
+    {
+    case VectorIsa::AVX512: // 32 registers of 16 floats
+        return ResNet50BlockSizes{32, 32, 32, 64, 64};
+    case VectorIsa::AVX2: // 16 registers of 8 floats
+        return ResNet50BlockSizes{16, 16, 32, 32, 32};
+    default:
+        return uniform(16);
+    }
+}
+
+ImageInference::model::ResNet50BlockSizes ImageInference::model::ResNet50BlockSizes::host()
+{
+    return forIsa(VectorKernels::detect());
+}
+
+bool ImageInference::model::ResNet50BlockSizes::isUniform(const size_t blockSize) const
+{
+    return *this == uniform(blockSize);
+}
+
+void ImageInference::model::ResNet50BlockSizes::check() const
+{
+    for (const size_t blockSize : {stem, layer1, layer2, layer3, layer4})
+    {
+        if (std::find(supported.begin(), supported.end(), blockSize) == supported.end())
+        {
+            std::cerr << "ResNet50BlockSizes::check: The block size " << blockSize << " of " << *this << " is not supported. Supported are 16, 32 and 64." << std::endl;
+            throw std::runtime_error("ResNet50BlockSizes::check: The block size is not supported!");
+        }
+    }
+}
+
+bool ImageInference::model::ResNet50BlockSizes::operator==(const ResNet50BlockSizes &other) const
+{
+    return stem == other.stem && layer1 == other.layer1 && layer2 == other.layer2 && layer3 == other.layer3 && layer4 == other.layer4;
+}
+
+std::ostream &ImageInference::model::operator<<(std::ostream &stream, const ResNet50BlockSizes &blockSizes)
+{
+    return stream << "{stem: " << blockSizes.stem << ", layer1: " << blockSizes.layer1 << ", layer2: " << blockSizes.layer2
+                  << ", layer3: " << blockSizes.layer3 << ", layer4: " << blockSizes.layer4 << "}";
+}
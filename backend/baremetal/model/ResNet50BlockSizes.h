@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef IMAGEINFERENCE_RESNET50BLOCKSIZES_H
+#define IMAGEINFERENCE_RESNET50BLOCKSIZES_H
+
+#include "VectorKernels.h"
+#include <array>
+#include <ostream>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <stddef.h>
+
+#define RESNET50_BLOCK_SIZE 32 // Block size of the blocked weights export and of the layers if it is not chosen at runtime
+
+namespace ImageInference
+{
+    namespace model
+    {
+        /// @brief The block sizes of the channel dimension of the layers of the ResNet50, chosen at runtime.
+        ///
+        /// The model is compiled for all supported block sizes. The first convolutions of a layer read the output
+        /// of the previous layer in its block size, so the reblocking between two layers is part of their gemms
+        /// and does not need a separate pass over the activations.
+        struct ResNet50BlockSizes
+        {
+            /// @brief The convolution with the fused max pooling.
+            size_t stem = RESNET50_BLOCK_SIZE;
+            /// @brief The bottlenecks with 256 output channels on 56 x 56.
+            size_t layer1 = RESNET50_BLOCK_SIZE;
+            /// @brief The bottlenecks with 512 output channels on 28 x 28.
+            size_t layer2 = RESNET50_BLOCK_SIZE;
+            /// @brief The bottlenecks with 1024 output channels on 14 x 14.
+            size_t layer3 = RESNET50_BLOCK_SIZE;
+            /// @brief The bottlenecks with 2048 output channels on 7 x 7, read by the head.
+            size_t layer4 = RESNET50_BLOCK_SIZE;
+
+            /// @brief The block sizes the model is compiled for. All of them divide the 64 channels of the narrowest layer.
+            static constexpr const std::array<size_t, 3> supported = {16, 32, 64};
+
+            /// @brief The same block size for every layer.
+            static ResNet50BlockSizes uniform(size_t blockSize);
+
+            /// @brief The default block sizes for the registers of an instruction set.
+            static ResNet50BlockSizes forIsa(VectorIsa isa);
+
+            /// @brief The default block sizes for the instruction set of the host.
+            static ResNet50BlockSizes host();
+
+            /// @brief True if every layer uses the block size.
+            bool isUniform(size_t blockSize) const;
+
+            /// @brief Throws if a block size is not supported.
+            void check() const;
+
+            bool operator==(const ResNet50BlockSizes &other) const;
+
+            /// @brief Calls the function with the block size as std::integral_constant, so it can be used as a template argument.
+            /// Throws if the block size is not supported.
+            template <typename F>
+            static auto dispatch(size_t blockSize, F &&function);
+        };
+
+        std::ostream &operator<<(std::ostream &stream, const ResNet50BlockSizes &blockSizes);
+
+        template <typename F>
+        inline auto ResNet50BlockSizes::dispatch(const size_t blockSize, F &&function)
+        {
+            switch (blockSize)
+            {
+            case 16:
+                return function(std::integral_constant<size_t, 16>());
+            case 32:
+                return function(std::integral_constant<size_t, 32>());
+            case 64:
+                return function(std::integral_constant<size_t, 64>());
+            default:
+                std::cerr << "ResNet50BlockSizes::dispatch: The block size " << blockSize << " is not supported. Supported are 16, 32 and 64." << std::endl;
+                throw std::runtime_error("ResNet50BlockSizes::dispatch: The block size is not supported!");
+            }
+        }
+    } // namespace model
+} // namespace ImageInference
+
+#endif // IMAGEINFERENCE_RESNET50BLOCKSIZES_H
@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#include "ResNet50Calibration.h"
+#include "ResNet50.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+    using ImageInference::model::ResNet50;
+
+    /// @brief The conv1 weights of the bottlenecks in the order of the model.
+    constexpr const std::array<size_t, ImageInference::model::ResNet50Calibration::bottlenecks> conv1Indices = {
+        ResNet50::layer1_0_conv1_weight, ResNet50::layer1_1_conv1_weight, ResNet50::layer1_2_conv1_weight,
+        ResNet50::layer2_0_conv1_weight, ResNet50::layer2_1_conv1_weight, ResNet50::layer2_2_conv1_weight, ResNet50::layer2_3_conv1_weight,
+        ResNet50::layer3_0_conv1_weight, ResNet50::layer3_1_conv1_weight, ResNet50::layer3_2_conv1_weight,
+        ResNet50::layer3_3_conv1_weight, ResNet50::layer3_4_conv1_weight, ResNet50::layer3_5_conv1_weight,
+        ResNet50::layer4_0_conv1_weight, ResNet50::layer4_1_conv1_weight, ResNet50::layer4_2_conv1_weight};
+
+    /// @brief The bottlenecks of the layers of the model.
+    constexpr const std::array<size_t, 4> layerBottlenecks = {3, 4, 6, 3};
+
+    bool isComment(const std::string &line)
+    {
+        const size_t start = line.find_first_not_of(" \t");
+        return start == std::string::npos || line[start] == '#';
+    }
+} // namespace
+
+ImageInference::model::ResNet50Calibration::ResNet50Calibration()
+{
+    scales.fill(0.0f);
+}
+
+ImageInference::model::ResNet50Calibration::ResNet50Calibration(const float *scales)
+{
+    std::copy(scales, scales + size, this->scales.begin());
+    check();
+}
+
+bool ImageInference::model::ResNet50Calibration::empty() const
+{
+    return scales[0] == 0.0f;
+}
+
+float ImageInference::model::ResNet50Calibration::stem() const
+{
+    return scales[0];
+}
+
+ImageInference::model::ResNet50Calibration::Bottleneck ImageInference::model::ResNet50Calibration::bottleneck(const size_t conv1Index) const
+{
+    const auto found = std::find(conv1Indices.begin(), conv1Indices.end(), conv1Index);
+    if (found == conv1Indices.end())
+    {
+        std::cerr << "ResNet50Calibration::bottleneck: " << conv1Index << " is not the index of a conv1 weight." << std::endl;
+        throw std::runtime_error("ResNet50Calibration::bottleneck: The index is not a conv1 weight!");
+    }
+
+    // The scales of a bottleneck follow the output of the previous one, which is its input.
+    const size_t first = 1 + 3 * static_cast<size_t>(found - conv1Indices.begin());
+    return Bottleneck{scales[first - 1], scales[first], scales[first + 1], scales[first + 2]};
+}
+
+const std::array<float, ImageInference::model::ResNet50Calibration::size> &ImageInference::model::ResNet50Calibration::getScales() const
+{
+    return scales;
+}
+
+std::string ImageInference::model::ResNet50Calibration::name(const size_t index)
+{
+    if (index == 0)
+    {
+        return "maxpool";
+    }
+
+    size_t bottleneck = (index - 1) / 3;
+    size_t layer = 0;
+    while (layer < layerBottlenecks.size() && bottleneck >= layerBottlenecks[layer])
+    {
+        bottleneck -= layerBottlenecks[layer];
+        layer++;
+    }
+
+    if (layer == layerBottlenecks.size())
+    {
+        std::cerr << "ResNet50Calibration::name: " << index << " is not the index of a scale, there are " << size << "." << std::endl;
+        throw std::runtime_error("ResNet50Calibration::name: The index is out of bounds!");
+    }
+
+    const std::string module = "layer" + std::to_string(layer + 1) + "." + std::to_string(bottleneck);
+    switch ((index - 1) % 3)
+    {
+    case 0:
+        return module + ".conv1";
+    case 1:
+        return module + ".conv2";
+    default:
+        return module;
+    }
+}
+
+ImageInference::model::ResNet50Calibration ImageInference::model::ResNet50Calibration::load(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        std::cerr << "ResNet50Calibration::load: Could not read the calibration file " << path << "." << std::endl;
+        throw std::runtime_error("ResNet50Calibration::load: Could not read the calibration file!");
+    }
+
+    std::array<std::string, size> names;
+    for (size_t i = 0; i < size; i++)
+    {
+        names[i] = name(i);
+    }
+
+    ResNet50Calibration calibration;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        if (isComment(line))
+        {
+            continue;
+        }
+
+        std::istringstream stream(line);
+        std::string entryName;
+        float scale;
+        if (!(stream >> entryName >> scale))
+        {
+            std::cerr << "ResNet50Calibration::load: The line " << lineNumber << " of " << path << " is not an entry." << std::endl;
+            throw std::runtime_error("ResNet50Calibration::load: The calibration file is malformed!");
+        }
+
+        const auto found = std::find(names.begin(), names.end(), entryName);
+        if (found == names.end())
+        {
+            std::cerr << "ResNet50Calibration::load: The line " << lineNumber << " of " << path << " names the unknown activation " << entryName << "." << std::endl;
+            throw std::runtime_error("ResNet50Calibration::load: The calibration file is malformed!");
+        }
+        calibration.scales[found - names.begin()] = scale;
+    }
+
+    calibration.check();
+    return calibration;
+}
+
+void ImageInference::model::ResNet50Calibration::store(const std::string &path) const
+{
+    check();
+
+    std::ofstream file(path, std::ios::trunc);
+    file << "# activation scale" << "\n";
+    file.precision(9);
+    for (size_t i = 0; i < size; i++)
+    {
+        file << name(i) << " " << scales[i] << "\n";
+    }
+
+    if (!file)
+    {
+        std::cerr << "ResNet50Calibration::store: Could not write the calibration file " << path << "." << std::endl;
+        throw std::runtime_error("ResNet50Calibration::store: Could not write the calibration file!");
+    }
+}
+
+void ImageInference::model::ResNet50Calibration::check() const
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        if (!(scales[i] > 0.0f) || !std::isfinite(scales[i]))
+        {
+            std::cerr << "ResNet50Calibration: The scale of " << name(i) << " is " << scales[i] << ", but needs to be positive." << std::endl;
+            throw std::runtime_error("ResNet50Calibration: The scales need to be positive!");
+        }
+    }
+}
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef IMAGEINFERENCE_RESNET50CALIBRATION_H
+#define IMAGEINFERENCE_RESNET50CALIBRATION_H
+
+#include <array>
+#include <string>
+#include <stddef.h>
+
+namespace ImageInference
+{
+    namespace model
+    {
+        /// @brief The scales of the quantized activations of the int8 model, one per tensor, stored in a calibration file.
+        ///
+        /// Every activation follows a relu, so it is quantized without a zero point: value = scale x uint8_t,
+        /// where the scale is the largest value seen during the calibration divided by 255.
+        /// The activations are named after the modules of torchvision that produce them: maxpool for the output of the stem,
+        /// layerL.I.conv1 and layerL.I.conv2 for the relu after the first two convolutions of a bottleneck and layerL.I for its output.
+        ///
+        /// Every line of the file is the name of an activation followed by its scale. Empty lines and lines starting with # are ignored.
+        /// The file is written by export_utils.writeCalibration.
+        class ResNet50Calibration
+        {
+        public:
+            static constexpr const size_t bottlenecks = 16;
+
+            /// @brief The number of scales, the stem and three per bottleneck.
+            static constexpr const size_t size = 1 + 3 * bottlenecks;
+
+            /// @brief The scales of the activations a bottleneck reads and writes.
+            struct Bottleneck
+            {
+                /// The input, which is the output of the stem or the previous bottleneck.
+                float input;
+                /// The output of the 1x1 convolution that reduces the channels.
+                float reduce;
+                /// The output of the 3x3 convolution.
+                float spatial;
+                float output;
+            };
+
+            /// @brief An empty calibration, which is used by the models that are not quantized.
+            ResNet50Calibration();
+
+            /// @brief The calibration from the scales in the order of name, e.g. the tensor of the custom op.
+            explicit ResNet50Calibration(const float *scales);
+
+            bool empty() const;
+
+            /// @brief The scale of the output of the stem.
+            float stem() const;
+
+            /// @brief The scales of a bottleneck.
+            /// @param conv1Index The index of the conv1 weight of the bottleneck e.g. ResNet50::layer2_1_conv1_weight.
+            Bottleneck bottleneck(size_t conv1Index) const;
+
+            const std::array<float, size> &getScales() const;
+
+            /// @brief The name of the activation of a scale.
+            static std::string name(size_t index);
+
+            /// @brief Reads the calibration file, which needs a positive scale for every activation.
+            static ResNet50Calibration load(const std::string &path);
+
+            void store(const std::string &path) const;
+
+        private:
+            std::array<float, size> scales;
+
+            /// @brief Throws if a scale is not positive and finite.
+            void check() const;
+        };
+    } // namespace model
+} // namespace ImageInference
+
+#endif // IMAGEINFERENCE_RESNET50CALIBRATION_H
@@ -0,0 +1,268 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#include "ResNet50Throughput.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#ifdef USE_OMP
+#include <omp.h>
+#endif // USE_OMP
+#ifdef __linux__
+#include <sched.h>
+#endif // __linux__
+
+namespace
+{
+    /// @brief Pins the calling thread to the cores, returns false if the operating system refused it.
+    bool pinThread(const std::vector<int> &cores)
+    {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (const int core : cores)
+        {
+            CPU_SET(core, &set);
+        }
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+        (void)cores;
+        return true;
+#endif // __linux__
+    }
+} // namespace
+
+ImageInference::model::ResNet50Throughput::ResNet50Throughput(ResNet50 &model, const size_t groups)
+    : ResNet50Throughput(model, partition(availableCores(), groups))
+{
+}
+
+ImageInference::model::ResNet50Throughput::ResNet50Throughput(ResNet50 &model, const std::vector<std::vector<int>> &coreGroups)
+    : model(model)
+{
+    if (coreGroups.empty())
+    {
+        std::cerr << "ResNet50Throughput: At least one group of cores is required." << std::endl;
+        throw std::runtime_error("ResNet50Throughput: At least one group of cores is required.");
+    }
+
+    const std::vector<int> available = availableCores();
+    for (const auto &cores : coreGroups)
+    {
+        if (cores.empty())
+        {
+            std::cerr << "ResNet50Throughput: A group of cores is empty." << std::endl;
+            throw std::runtime_error("ResNet50Throughput: A group of cores is empty.");
+        }
+        for (const int core : cores)
+        {
+            if (std::find(available.begin(), available.end(), core) == available.end())
+            {
+                std::cerr << "ResNet50Throughput: The process may not run on core " << core << "." << std::endl;
+                throw std::runtime_error("ResNet50Throughput: The process may not run on a core of a group.");
+            }
+        }
+    }
+
+    for (const auto &cores : coreGroups)
+    {
+        groups.push_back(std::make_unique<Group>());
+        groups.back()->cores = cores;
+    }
+    for (auto &group : groups)
+    {
+        group->thread = std::thread(&ResNet50Throughput::run, this, std::ref(*group));
+    }
+}
+
+ImageInference::model::ResNet50Throughput::~ResNet50Throughput()
+{
+    for (auto &group : groups)
+    {
+        {
+            std::lock_guard<std::mutex> lock(group->mutex);
+            group->stopping = true;
+        }
+        group->wake.notify_one();
+    }
+    for (auto &group : groups)
+    {
+        group->thread.join();
+    }
+}
+
+void ImageInference::model::ResNet50Throughput::run(Group &group)
+{
+    if (!pinThread(group.cores))
+    {
+        std::cerr << "ResNet50Throughput: Could not pin a group to its cores, it runs unpinned." << std::endl;
+    }
+
+#ifdef USE_OMP
+    // OpenMP keeps a team of threads for every thread that starts parallel regions, so the team pinned here
+    // runs all forward passes of the group, and ResNet50Tuning::threads is the size of the group.
+    omp_set_num_threads(static_cast<int>(group.cores.size()));
+#pragma omp parallel
+    {
+        pinThread({group.cores[omp_get_thread_num()]});
+    }
+#endif // USE_OMP
+
+    while (true)
+    {
+        Request request{};
+        {
+            std::unique_lock<std::mutex> lock(group.mutex);
+            group.wake.wait(lock, [&group]
+                            { return group.stopping || !group.requests.empty(); });
+            // The queued requests are finished before the group stops.
+            if (group.requests.empty())
+            {
+                return;
+            }
+            request = std::move(group.requests.front());
+            group.requests.pop_front();
+        }
+
+        std::exception_ptr exception;
+        try
+        {
+            model.inference(request.input, request.output, request.batch, group.activationsPool);
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(group.mutex);
+            group.pending--;
+        }
+        if (exception)
+        {
+            request.done.set_exception(exception);
+        }
+        else
+        {
+            request.done.set_value();
+        }
+    }
+}
+
+std::future<void> ImageInference::model::ResNet50Throughput::enqueue(Group &group, const float *input, float *output, const size_t batch)
+{
+    std::future<void> done;
+    {
+        std::lock_guard<std::mutex> lock(group.mutex);
+        group.requests.push_back(Request{input, output, batch, std::promise<void>()});
+        done = group.requests.back().done.get_future();
+        group.pending++;
+    }
+    group.wake.notify_one();
+    return done;
+}
+
+std::future<void> ImageInference::model::ResNet50Throughput::submit(const float *input, float *output, const size_t batch)
+{
+    Group *idlest = nullptr;
+    size_t idlestPending = 0;
+    for (auto &group : groups)
+    {
+        std::lock_guard<std::mutex> lock(group->mutex);
+        if (idlest == nullptr || group->pending < idlestPending)
+        {
+            idlest = group.get();
+            idlestPending = group->pending;
+        }
+    }
+    return enqueue(*idlest, input, output, batch);
+}
+
+void ImageInference::model::ResNet50Throughput::inference(const float *input, float *output)
+{
+    submit(input, output, 1).get();
+}
+
+void ImageInference::model::ResNet50Throughput::inference(const float *input, float *output, const size_t batch)
+{
+    constexpr const size_t inputSize = 3 * 224 * 224;
+    constexpr const size_t classes = 1000;
+
+    const size_t part = (batch + groups.size() - 1) / groups.size();
+    std::vector<std::future<void>> parts;
+    for (size_t iImage = 0, iGroup = 0; iImage < batch; iImage += part, iGroup++)
+    {
+        parts.push_back(enqueue(*groups[iGroup], input + iImage * inputSize, output + iImage * classes, std::min(part, batch - iImage)));
+    }
+
+    // All parts use the input and the output, so every part is finished before an exception is passed on.
+    for (auto &done : parts)
+    {
+        done.wait();
+    }
+    for (auto &done : parts)
+    {
+        done.get();
+    }
+}
+
+size_t ImageInference::model::ResNet50Throughput::getGroupCount() const
+{
+    return groups.size();
+}
+
+const std::vector<int> &ImageInference::model::ResNet50Throughput::getCores(const size_t group) const
+{
+    return groups.at(group)->cores;
+}
+
+std::vector<int> ImageInference::model::ResNet50Throughput::availableCores()
+{
+    std::vector<int> cores;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for (int core = 0; core < CPU_SETSIZE; core++)
+        {
+            if (CPU_ISSET(core, &set))
+            {
+                cores.push_back(core);
+            }
+        }
+    }
+#endif // __linux__
+
+    if (cores.empty())
+    {
+        const unsigned int count = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int core = 0; core < count; core++)
+        {
+            cores.push_back(static_cast<int>(core));
+        }
+    }
+    return cores;
+}
+
+std::vector<std::vector<int>> ImageInference::model::ResNet50Throughput::partition(const std::vector<int> &cores, const size_t groups)
+{
+    if (groups == 0 || groups > cores.size())
+    {
+        std::cerr << "ResNet50Throughput: Can not split " << cores.size() << " cores into " << groups << " groups." << std::endl;
+        throw std::runtime_error("ResNet50Throughput: The number of groups must be between 1 and the number of cores.");
+    }
+
+    // The first groups take one more core if the cores can not be split evenly.
+    std::vector<std::vector<int>> partition;
+    auto begin = cores.begin();
+    for (size_t iGroup = 0; iGroup < groups; iGroup++)
+    {
+        const size_t size = cores.size() / groups + (iGroup < cores.size() % groups ? 1 : 0);
+        partition.emplace_back(begin, begin + size);
+        begin += size;
+    }
+    return partition;
+}
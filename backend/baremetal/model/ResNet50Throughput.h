@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef IMAGEINFERENCE_RESNET50THROUGHPUT_H
+#define IMAGEINFERENCE_RESNET50THROUGHPUT_H
+
+#include "IModel.h"
+#include "ResNet50.h"
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ImageInference
+{
+    namespace model
+    {
+        /// @brief Runs the forward passes of one model on independent groups of cores for throughput.
+        ///
+        /// Every group has its own thread, which pins itself and its OpenMP team to the cores of the group, its own queue of requests
+        /// and its own pool of activations. The groups share the prepared weights of the model, which are only read by a forward pass.
+        /// A forward pass is then split across the cores of one group only, so small groups spend less time synchronizing
+        /// the threads and running the layers with too little work per thread, while more images are in flight at once.
+        ///
+        /// The settings of the model e.g. setWinograd must not be changed while requests are queued.
+        class ResNet50Throughput : public IModel<float>
+        {
+        private:
+            struct Request
+            {
+                const float *input;
+                float *output;
+                size_t batch;
+                std::promise<void> done;
+            };
+
+            struct Group
+            {
+                std::vector<int> cores;
+                ResNet50::ActivationsPool activationsPool;
+                std::deque<Request> requests;
+                /// @brief The number of requests that are queued or running.
+                size_t pending = 0;
+                bool stopping = false;
+                std::mutex mutex;
+                std::condition_variable wake;
+                std::thread thread;
+            };
+
+            ResNet50 &model;
+            std::vector<std::unique_ptr<Group>> groups;
+
+            /// @brief Pins the thread and its OpenMP team to the cores of the group and runs its requests until it is stopped.
+            void run(Group &group);
+
+            std::future<void> enqueue(Group &group, const float *input, float *output, size_t batch);
+
+        public:
+            /// @brief Splits the cores the process may run on into groups of consecutive cores, see partition.
+            /// @param model The model, which must outlive the runtime.
+            /// @param groups The number of groups, from 1 to the number of cores.
+            ResNet50Throughput(ResNet50 &model, size_t groups);
+
+            /// @brief Runs the groups on the given cores, e.g. to keep the hyperthreads of a core or the cores of a NUMA node together.
+            /// @param model The model, which must outlive the runtime.
+            /// @param coreGroups The cores of every group, each must be one of availableCores.
+            ResNet50Throughput(ResNet50 &model, const std::vector<std::vector<int>> &coreGroups);
+
+            /// @brief Finishes the queued requests and stops the groups.
+            ~ResNet50Throughput();
+
+            ResNet50Throughput(const ResNet50Throughput &) = delete;
+            ResNet50Throughput &operator=(const ResNet50Throughput &) = delete;
+
+            /// @brief Queues a batch of images on the group with the fewest pending requests.
+            /// The input and the output must stay valid until the returned future is ready.
+            /// @return The future, which is ready when the logits are written or holds the exception of the forward pass.
+            std::future<void> submit(const float *input, float *output, size_t batch = 1);
+
+            void inference(const float *input, float *output) override;
+
+            /// @brief Classifies a batch of images, split into consecutive parts for all groups, and waits for all of them.
+            void inference(const float *input, float *output, size_t batch) override;
+
+            size_t getGroupCount() const;
+
+            /// @brief The cores the group runs on.
+            const std::vector<int> &getCores(size_t group) const;
+
+            /// @brief The cores the process may run on, which are all cores of the machine if the affinity can not be read.
+            static std::vector<int> availableCores();
+
+            /// @brief Splits the cores into groups of consecutive cores, whose sizes differ by at most one.
+            static std::vector<std::vector<int>> partition(const std::vector<int> &cores, size_t groups);
+        };
+    } // namespace model
+} // namespace ImageInference
+
+#endif // IMAGEINFERENCE_RESNET50THROUGHPUT_H
@@ -0,0 +1,207 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#include "ResNet50Tuning.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <limits>
+#include <iostream>
+#include <stdexcept>
+#ifdef USE_OMP
+#include <omp.h>
+#endif // USE_OMP
+
+namespace
+{
+    /// @brief Parses an entry of the tuning file, returns false for comments and empty lines.
+    bool parseEntry(const std::string &line, std::string &cpuModel, size_t &threads, ImageInference::model::ResNet50BlockSizes &blockSizes)
+    {
+        std::istringstream stream(line);
+        if (!(stream >> threads >> blockSizes.stem >> blockSizes.layer1 >> blockSizes.layer2 >> blockSizes.layer3 >> blockSizes.layer4))
+        {
+            return false;
+        }
+
+        std::getline(stream >> std::ws, cpuModel);
+        return true;
+    }
+
+    bool isComment(const std::string &line)
+    {
+        const size_t start = line.find_first_not_of(" \t");
+        return start == std::string::npos || line[start] == '#';
+    }
+} // namespace
+
+std::string ImageInference::model::ResNet50Tuning::cpuModel()
+{
+    std::ifstream cpuInfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuInfo, line))
+    {
+        if (line.rfind("model name", 0) == 0)
+        {
+            const size_t separator = line.find(':');
+            const size_t start = line.find_first_not_of(" \t", separator + 1);
+            if (separator != std::string::npos && start != std::string::npos)
+            {
+                return line.substr(start);
+            }
+        }
+    }
+    return "unknown";
+}
+
+size_t ImageInference::model::ResNet50Tuning::threads()
+{
+#ifdef USE_OMP
+    return static_cast<size_t>(omp_get_max_threads());
+#else
+    return 1;
+#endif // USE_OMP
+}
+
+bool ImageInference::model::ResNet50Tuning::load(const std::string &path, const std::string &cpuModel, const size_t threads, ResNet50BlockSizes &blockSizes)
+{
+    std::ifstream file(path);
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        if (isComment(line))
+        {
+            continue;
+        }
+
+        std::string entryCpuModel;
+        size_t entryThreads;
+        ResNet50BlockSizes entryBlockSizes;
+        if (!parseEntry(line, entryCpuModel, entryThreads, entryBlockSizes))
+        {
+            std::cerr << "ResNet50Tuning::load: The line " << lineNumber << " of " << path << " is not an entry." << std::endl;
+            throw std::runtime_error("ResNet50Tuning::load: The tuning file is malformed!");
+        }
+
+        if (entryCpuModel == cpuModel && entryThreads == threads)
+        {
+            entryBlockSizes.check();
+            blockSizes = entryBlockSizes;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ImageInference::model::ResNet50Tuning::store(const std::string &path, const std::string &cpuModel, const size_t threads, const ResNet50BlockSizes &blockSizes)
+{
+    blockSizes.check();
+
+    // Keep everything but the previous entry of the machine.
+    std::vector<std::string> lines;
+    {
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::string entryCpuModel;
+            size_t entryThreads;
+            ResNet50BlockSizes entryBlockSizes;
+            if (!isComment(line) && parseEntry(line, entryCpuModel, entryThreads, entryBlockSizes) && entryCpuModel == cpuModel && entryThreads == threads)
+            {
+                continue;
+            }
+            lines.push_back(line);
+        }
+    }
+
+    if (lines.empty())
+    {
+        lines.push_back("# threads stem layer1 layer2 layer3 layer4 cpu model");
+    }
+
+    std::ostringstream entry;
+    entry << threads << " " << blockSizes.stem << " " << blockSizes.layer1 << " " << blockSizes.layer2 << " "
+          << blockSizes.layer3 << " " << blockSizes.layer4 << " " << cpuModel;
+    lines.push_back(entry.str());
+
+    std::ofstream file(path, std::ios::trunc);
+    for (const auto &line : lines)
+    {
+        file << line << "\n";
+    }
+
+    if (!file)
+    {
+        std::cerr << "ResNet50Tuning::store: Could not write the tuning file " << path << "." << std::endl;
+        throw std::runtime_error("ResNet50Tuning::store: Could not write the tuning file!");
+    }
+}
+
+ImageInference::model::ResNet50BlockSizes ImageInference::model::ResNet50Tuning::host()
+{
+    const char *path = std::getenv(environmentVariable);
+    if (path == nullptr || *path == '\0')
+    {
+        return ResNet50BlockSizes::host();
+    }
+
+    ResNet50BlockSizes blockSizes;
+    if (!load(path, cpuModel(), threads(), blockSizes))
+    {
+        std::cerr << "ResNet50Tuning: " << path << " has no entry for " << cpuModel() << " with " << threads() << " threads, using the defaults." << std::endl;
+        return ResNet50BlockSizes::host();
+    }
+    return blockSizes;
+}
+
+ImageInference::model::ResNet50BlockSizes ImageInference::model::ResNet50Tuning::fastest(const StageTimes &times)
+{
+    constexpr const size_t count = ResNet50BlockSizes::supported.size();
+
+    // The fastest time up to a stage for every block size of the stage and the block size of the previous stage it is reached with.
+    std::array<std::array<double, count>, stages> total;
+    std::array<std::array<size_t, count>, stages> previous;
+    for (size_t iBlockSize = 0; iBlockSize < count; iBlockSize++)
+    {
+        total[0][iBlockSize] = times[0][0][iBlockSize];
+    }
+
+    for (size_t iStage = 1; iStage < stages; iStage++)
+    {
+        for (size_t iBlockSize = 0; iBlockSize < count; iBlockSize++)
+        {
+            total[iStage][iBlockSize] = std::numeric_limits<double>::infinity();
+            previous[iStage][iBlockSize] = 0;
+            for (size_t iInBlockSize = 0; iInBlockSize < count; iInBlockSize++)
+            {
+                const double time = total[iStage - 1][iInBlockSize] + times[iStage][iInBlockSize][iBlockSize];
+                if (time < total[iStage][iBlockSize])
+                {
+                    total[iStage][iBlockSize] = time;
+                    previous[iStage][iBlockSize] = iInBlockSize;
+                }
+            }
+        }
+    }
+
+    std::array<size_t, stages> chosen;
+    chosen[stages - 1] = 0;
+    for (size_t iBlockSize = 1; iBlockSize < count; iBlockSize++)
+    {
+        if (total[stages - 1][iBlockSize] < total[stages - 1][chosen[stages - 1]])
+        {
+            chosen[stages - 1] = iBlockSize;
+        }
+    }
+    for (size_t iStage = stages - 1; iStage > 0; iStage--)
+    {
+        chosen[iStage - 1] = previous[iStage][chosen[iStage]];
+    }
+
+    const auto &supported = ResNet50BlockSizes::supported;
+    return ResNet50BlockSizes{supported[chosen[0]], supported[chosen[1]], supported[chosen[2]], supported[chosen[3]], supported[chosen[4]]};
+}
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef IMAGEINFERENCE_RESNET50TUNING_H
+#define IMAGEINFERENCE_RESNET50TUNING_H
+
+#include "ResNet50BlockSizes.h"
+#include <array>
+#include <string>
+#include <stddef.h>
+
+namespace ImageInference
+{
+    namespace model
+    {
+        /// @brief The block sizes measured to be the fastest on a machine, stored in a tuning file.
+        ///
+        /// The entries of the file are keyed by the CPU model and the number of threads, so one file can hold
+        /// the tuning of every machine a model is deployed to. Every line is one entry:
+        /// threads, the block sizes of the stem and layer1 to layer4, then the CPU model up to the end of the line.
+        /// Empty lines and lines starting with # are ignored.
+        ///
+        /// The file is written by the Autotune benchmarks, see test/benchmarks/resnet50.cpp.
+        class ResNet50Tuning
+        {
+        public:
+            /// @brief The environment variable with the path of the tuning file, which is read when a model is constructed.
+            static constexpr const char *environmentVariable = "IMAGEINFERENCE_TUNING_FILE";
+
+            /// @brief The stem and the four layers.
+            static constexpr const size_t stages = 5;
+
+            /// @brief The time of every stage for every input block size and block size, both indexed like ResNet50BlockSizes::supported.
+            /// The stem reads the planar image, so only the input block size with index 0 is used for it.
+            using StageTimes = std::array<std::array<std::array<double, ResNet50BlockSizes::supported.size()>, ResNet50BlockSizes::supported.size()>, stages>;
+
+            /// @brief The name of the CPU of the host, or "unknown" if the operating system does not provide it.
+            static std::string cpuModel();
+
+            /// @brief The number of threads a forward pass uses.
+            static size_t threads();
+
+            /// @brief Reads the entry of the machine from the tuning file.
+            /// @return False if the file does not exist or has no entry for the machine.
+            static bool load(const std::string &path, const std::string &cpuModel, size_t threads, ResNet50BlockSizes &blockSizes);
+
+            /// @brief Writes the entry of the machine into the tuning file, the entries of other machines are kept.
+            static void store(const std::string &path, const std::string &cpuModel, size_t threads, const ResNet50BlockSizes &blockSizes);
+
+            /// @brief The block sizes of the host from the tuning file of the environment variable,
+            /// otherwise the defaults of ResNet50BlockSizes::host().
+            static ResNet50BlockSizes host();
+
+            /// @brief The block sizes with the smallest sum of the times of all stages.
+            /// The time of a layer depends on the block size of the previous stage, so the choices are not independent.
+            static ResNet50BlockSizes fastest(const StageTimes &times);
+        };
+    } // namespace model
+} // namespace ImageInference
+
+#endif // IMAGEINFERENCE_RESNET50TUNING_H
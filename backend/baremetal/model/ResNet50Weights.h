@@ -0,0 +1,988 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef IMAGEINFERENCE_RESNET50WEIGHTS_H
+#define IMAGEINFERENCE_RESNET50WEIGHTS_H
+
+#include "ResNet50.h"
+#include "ResNet50Activations.h"
+#include "ResNet50BlockSizes.h"
+#include "ResNet50Calibration.h"
+#include "GemmKernels.h"
+#include "Winograd.h"
+#include "../types/Kernel.h"
+#include "../types/BatchNorm.h"
+#include "../types/Matrix.h"
+#include "../types/Array.h"
+#include "../types/ScalarTypes.h"
+#include <vector>
+#include <memory>
+#include <stddef.h>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+
+// Header that export_utils.compressParameters puts in front of weights that are exported in the blocked kernel layout.
+// All entries are stored as floats: magic, layout version, block size, scalar type, followed by zeros up to the header size.
+// Since layout version 2 the batch norm scale is already folded into the blocked convolution weights.
+// The scalar type is the ImageInference::types::ScalarType the model computes in, the weights themselves are always float.
+// Int8 weights are still quantized while they are prepared, as the scales of their activations come from the calibration.
+// Older exports have a zero there, which is read as float.
+#define RESNET50_BLOCKED_WEIGHTS_MAGIC 7225050
+#define RESNET50_BLOCKED_WEIGHTS_LAYOUT_VERSION 2
+#define RESNET50_BLOCKED_WEIGHTS_HEADER_SIZE 16
+
+namespace ImageInference
+{
+    namespace model
+    {
+        /// @brief The prepared weights of a single bottleneck i.e. 1x1 -> 3x3 -> 1x1 convolution.
+        /// The batch norms are folded into the kernels, blocked kernels are expected to be folded during export.
+        ///
+        /// The weights of a bottleneck are stored consecutive in the model weights with the order
+        /// conv1, bn1.weight, bn1.bias, conv2, bn2.weight, bn2.bias, conv3, bn3.weight, bn3.bias
+        /// and the running statistics with the order bn1.mean, bn1.var, bn2.mean, bn2.var, bn3.mean, bn3.var.
+        /// see file backend/baremetal/resnet50weights.txt
+        ///
+        /// Kernels of int8_t are quantized per output channel while they are prepared, see prepareKernel.
+        ///
+        /// @tparam T The type of the activations, the kernels are stored in the weight type of T and the batch norms in the parameter type of T.
+        /// @tparam BlockSize The block size used for the count dimension of the kernels and the channel dimension of kernel2 and kernel3.
+        /// @tparam InBlockSize The block size of the input of the bottleneck, which is the channel dimension of kernel1.
+        /// @tparam InChannels The number of channels that are the input to the bottleneck.
+        /// @tparam MidChannels The number of channels of the 1x1 and 3x3 convolution.
+        /// @tparam OutChannels The number of channels that are the output of the bottleneck.
+        template <typename T, size_t BlockSize, size_t InBlockSize, size_t InChannels, size_t MidChannels, size_t OutChannels>
+        class ResNet50Bottleneck
+        {
+        public:
+            using TWeight = typename ImageInference::types::Weight<T>::type;
+            using TParameter = typename ImageInference::types::Parameter<T>::type;
+
+            /// @brief The scales of the quantized activations of the bottleneck, only used if T is quantized.
+            const ResNet50Calibration::Bottleneck scales;
+            // Every batch norm is prepared before its kernel, which gets the scale of the batch norm folded in.
+            ImageInference::types::BatchNorm<TParameter, MidChannels, true> batchNorm1;
+            ImageInference::types::Kernel<TWeight, BlockSize, InBlockSize, MidChannels, InChannels, 1, 1> kernel1;
+            ImageInference::types::BatchNorm<TParameter, MidChannels, true> batchNorm2;
+            ImageInference::types::Kernel<TWeight, BlockSize, BlockSize, MidChannels, MidChannels, 3, 3> kernel2;
+            ImageInference::types::BatchNorm<TParameter, OutChannels, true> batchNorm3;
+            ImageInference::types::Kernel<TWeight, BlockSize, BlockSize, OutChannels, MidChannels, 1, 1> kernel3;
+            /// @brief The 3x3 kernel transformed for the Winograd convolution, only set if Winograd is enabled for the bottleneck.
+            std::unique_ptr<ImageInference::types::Kernel<T, BlockSize, BlockSize, MidChannels, MidChannels, Winograd::inputTile, Winograd::inputTile>> kernel2Winograd;
+            /// @brief The kernels stored in Float16, only set if Float16 is enabled for the bottleneck, then the kernels of float are released.
+            std::unique_ptr<ImageInference::types::Kernel<ImageInference::types::Float16, BlockSize, InBlockSize, MidChannels, InChannels, 1, 1>> kernel1Float16;
+            std::unique_ptr<ImageInference::types::Kernel<ImageInference::types::Float16, BlockSize, BlockSize, MidChannels, MidChannels, 3, 3>> kernel2Float16;
+            std::unique_ptr<ImageInference::types::Kernel<ImageInference::types::Float16, BlockSize, BlockSize, OutChannels, MidChannels, 1, 1>> kernel3Float16;
+            /// @brief The index of the conv2 weight, which identifies the bottleneck.
+            const size_t conv2Index;
+
+            /// @brief Converts the weights of the bottleneck into the blocked format.
+            /// @param weights The weights of the model.
+            /// @param conv1Index The index of the conv1 weight of the bottleneck.
+            /// @param runningMeanIndex The index of the bn1 running mean of the bottleneck.
+            /// @param layout The layout in which the convolution weights are stored.
+            /// @param calibration The scales of the activations, only used if T is quantized.
+            ResNet50Bottleneck(const std::vector<void *> &weights, size_t conv1Index, size_t runningMeanIndex,
+                               ImageInference::types::KernelLayout layout, const ResNet50Calibration &calibration);
+
+            /// @brief Transforms the 3x3 kernel for the Winograd convolution or releases the transformed kernel.
+            /// The Winograd convolution is only supported for float.
+            void setWinograd(bool enabled);
+
+            /// @brief Stores the kernels in Float16 and releases the kernels of float, or widens them back into float.
+            /// Float16 is only supported for float, the transformed Winograd kernel stays in float.
+            void setFloat16(bool enabled);
+        };
+
+        /// @brief The prepared weights of a bottleneck that uses a projection on the shortcut.
+        ///
+        /// The downsample weights follow directly after the bn3 weights i.e. downsample.0, downsample.1.weight, downsample.1.bias
+        /// and the running statistics after the bn3 running statistics i.e. downsample.1.mean, downsample.1.var.
+        template <typename T, size_t BlockSize, size_t InBlockSize, size_t InChannels, size_t MidChannels, size_t OutChannels>
+        class ResNet50BottleneckProjection : public ResNet50Bottleneck<T, BlockSize, InBlockSize, InChannels, MidChannels, OutChannels>
+        {
+        public:
+            ImageInference::types::BatchNorm<typename ResNet50Bottleneck<T, BlockSize, InBlockSize, InChannels, MidChannels, OutChannels>::TParameter, OutChannels, true> projectionBatchNorm;
+            ImageInference::types::Kernel<typename ResNet50Bottleneck<T, BlockSize, InBlockSize, InChannels, MidChannels, OutChannels>::TWeight, BlockSize, InBlockSize, OutChannels, InChannels, 1, 1> projectionKernel;
+            std::unique_ptr<ImageInference::types::Kernel<ImageInference::types::Float16, BlockSize, InBlockSize, OutChannels, InChannels, 1, 1>> projectionKernelFloat16;
+
+            ResNet50BottleneckProjection(const std::vector<void *> &weights, size_t conv1Index, size_t runningMeanIndex,
+                                         ImageInference::types::KernelLayout layout, const ResNet50Calibration &calibration);
+
+            /// @brief Stores the kernels in Float16 like ResNet50Bottleneck::setFloat16, including the projection kernel.
+            void setFloat16(bool enabled);
+        };
+
+        /// @brief The prepared weights of the stem, independent of the block size it is prepared for.
+        template <typename T>
+        class IResNet50Stem
+        {
+        public:
+            virtual ~IResNet50Stem() {}
+
+            /// @brief Adds the gemm kernels used by the stem.
+            /// @param datatype The libxsmm type of the parameter type of T.
+            virtual void addGemmKernels(GemmKernels &gemmKernels, libxsmm_datatype datatype) const = 0;
+
+            /// @brief The convolution with the fused max pooling, writes the maxPool activation.
+            /// @param input The planar input image 3 x 224 x 224.
+            virtual void inference(const typename ImageInference::types::Parameter<T>::type *input, ResNet50Activations<T> &activations, const GemmKernels *gemmKernels) = 0;
+        };
+
+        /// @brief The prepared weights of the 7x7 convolution of the stem.
+        /// The stem computes in the parameter type of T and only stores its output in T: the input is given in the parameter type
+        /// and the depth of 7 x 7 x 3 is odd, which can not be packed for the BFloat16 and int8 gemms.
+        /// The output of the int8 model is quantized by dividing the kernel and the bias by its scale, as the relu and the max pooling commute with it.
+        /// @tparam BlockSize The block size of the output of the stem.
+        template <typename T, size_t BlockSize>
+        class ResNet50Stem : public IResNet50Stem<T>
+        {
+        public:
+            using TParameter = typename ImageInference::types::Parameter<T>::type;
+
+            ImageInference::types::BatchNorm<TParameter, 64, true> batchNorm1;
+            ImageInference::types::Kernel<TParameter, BlockSize, 3, 64, 3, 7, 7> conv1;
+
+            ResNet50Stem(const std::vector<void *> &weights, ImageInference::types::KernelLayout layout, const ResNet50Calibration &calibration);
+
+            void addGemmKernels(GemmKernels &gemmKernels, libxsmm_datatype datatype) const override;
+            void inference(const TParameter *input, ResNet50Activations<T> &activations, const GemmKernels *gemmKernels) override;
+        };
+
+        /// @brief The prepared weights of a layer of bottlenecks, independent of the block sizes it is prepared for.
+        /// A layer reads the output of the previous layer from the activations and writes its output into the activations.
+        template <typename T>
+        class IResNet50Layer
+        {
+        public:
+            virtual ~IResNet50Layer() {}
+
+            /// @brief Adds the gemm kernels used by the bottlenecks of the layer.
+            virtual void addGemmKernels(GemmKernels &gemmKernels, libxsmm_datatype datatype) const = 0;
+
+            /// @brief Runs the layer on a batch of images. Every convolution runs on all images before the next one,
+            /// so its weights are read from memory once per batch. The activations of the batch share their plan.
+            virtual void inference(ResNet50Activations<T> *const *activations, size_t batch, const GemmKernels *gemmKernels) = 0;
+
+            /// @brief Runs the layer on a single image.
+            void inference(ResNet50Activations<T> &activations, const GemmKernels *gemmKernels)
+            {
+                ResNet50Activations<T> *const batch[] = {&activations};
+                inference(batch, 1, gemmKernels);
+            }
+
+            /// @brief Enables or disables the Winograd convolution of the bottleneck with the conv2 weight and adds its gemm kernel.
+            /// @return False if the bottleneck is not part of the layer.
+            virtual bool setWinograd(size_t conv2Index, bool enabled, GemmKernels &gemmKernels) = 0;
+
+            /// @brief True if any bottleneck of the layer uses the Winograd convolution.
+            virtual bool usesWinograd() const = 0;
+
+            /// @brief Stores the kernels of the bottleneck with the conv1 weight in Float16 or widens them back into float.
+            /// Enabling adds the gemm kernels that accumulate the widened chunks of taps, see ResNet50::batchReduceFloat16.
+            /// @return False if the bottleneck is not part of the layer.
+            virtual bool setFloat16(size_t conv1Index, bool enabled, GemmKernels &gemmKernels) = 0;
+
+        protected:
+            /// @brief Adds the gemm kernels of the bottlenecks of a layer, the first bottleneck reads the input blocked with InBlockSize,
+            /// applies the stride and projects the shortcut. See ResNet50::convBlock, ResNet50::convBlockAddIdentity and ResNet50::convBlockAddProjection.
+            /// @param accumulate Adds the gemms that accumulate into the output instead of the ones that overwrite it.
+            template <size_t BlockSize, size_t InBlockSize, size_t InSize, size_t Stride>
+            static void addBottleneckGemmKernels(GemmKernels &gemmKernels, libxsmm_datatype datatype, bool accumulate = false);
+
+            /// @brief Sets Winograd if the conv2 index belongs to the bottleneck and adds the gemm over all tiles of the image.
+            template <typename TBottleneck>
+            static bool setBottleneckWinograd(TBottleneck &bottleneck, size_t conv2Index, bool enabled, int blockSize, int tiles, GemmKernels &gemmKernels);
+
+            /// @brief Sets Float16 if the conv1 index belongs to the bottleneck.
+            template <typename TBottleneck>
+            static bool setBottleneckFloat16(TBottleneck &bottleneck, size_t conv1Index, bool enabled);
+        };
+
+        /// @brief The prepared weights of layer1, the bottlenecks with 256 output channels on 56 x 56.
+        /// @tparam InBlockSize The block size of the output of the stem, which is reblocked by the first bottleneck.
+        /// @tparam BlockSize The block size of the layer.
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        class ResNet50Layer1 : public IResNet50Layer<T>
+        {
+        public:
+            ResNet50BottleneckProjection<T, BlockSize, InBlockSize, 64, 64, 256> layer1_0;
+            ResNet50Bottleneck<T, BlockSize, BlockSize, 256, 64, 256> layer1_1;
+            ResNet50Bottleneck<T, BlockSize, BlockSize, 256, 64, 256> layer1_2;
+
+            ResNet50Layer1(const std::vector<void *> &weights, ImageInference::types::KernelLayout layout,
+                           const ResNet50Calibration &calibration = ResNet50Calibration());
+
+            void addGemmKernels(GemmKernels &gemmKernels, libxsmm_datatype datatype) const override;
+            using IResNet50Layer<T>::inference;
+            void inference(ResNet50Activations<T> *const *activations, size_t batch, const GemmKernels *gemmKernels) override;
+            bool setWinograd(size_t conv2Index, bool enabled, GemmKernels &gemmKernels) override;
+            bool usesWinograd() const override;
+            bool setFloat16(size_t conv1Index, bool enabled, GemmKernels &gemmKernels) override;
+        };
+
+        /// @brief The prepared weights of layer2, the bottlenecks with 512 output channels on 28 x 28.
+        /// @tparam InBlockSize The block size of the output of layer1, which is reblocked by the first bottleneck.
+        /// @tparam BlockSize The block size of the layer.
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        class ResNet50Layer2 : public IResNet50Layer<T>
+        {
+        public:
+            ResNet50BottleneckProjection<T, BlockSize, InBlockSize, 256, 128, 512> layer2_0;
+            ResNet50Bottleneck<T, BlockSize, BlockSize, 512, 128, 512> layer2_1;
+            ResNet50Bottleneck<T, BlockSize, BlockSize, 512, 128, 512> layer2_2;
+            ResNet50Bottleneck<T, BlockSize, BlockSize, 512, 128, 512> layer2_3;
+
+            ResNet50Layer2(const std::vector<void *> &weights, ImageInference::types::KernelLayout layout,
+                           const ResNet50Calibration &calibration = ResNet50Calibration());
+
+            void addGemmKernels(GemmKernels &gemmKernels, libxsmm_datatype datatype) const override;
+            using IResNet50Layer<T>::inference;
+            void inference(ResNet50Activations<T> *const *activations, size_t batch, const GemmKernels *gemmKernels) override;
+            bool setWinograd(size_t conv2Index, bool enabled, GemmKernels &gemmKernels) override;
+            bool usesWinograd() const override;
+            bool setFloat16(size_t conv1Index, bool enabled, GemmKernels &gemmKernels) override;
+        };
+
+        /// @brief The prepared weights of layer3, the bottlenecks with 1024 output channels on 14 x 14.
+        /// @tparam InBlockSize The block size of the output of layer2, which is reblocked by the first bottleneck.
+        /// @tparam BlockSize The block size of the layer.
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        class ResNet50Layer3 : public IResNet50Layer<T>
+        {
+        public:
+            ResNet50BottleneckProjection<T, BlockSize, InBlockSize, 512, 256, 1024> layer3_0;
+            ResNet50Bottleneck<T, BlockSize, BlockSize, 1024, 256, 1024> layer3_1;
+            ResNet50Bottleneck<T, BlockSize, BlockSize, 1024, 256, 1024> layer3_2;
+            ResNet50Bottleneck<T, BlockSize, BlockSize, 1024, 256, 1024> layer3_3;
+            ResNet50Bottleneck<T, BlockSize, BlockSize, 1024, 256, 1024> layer3_4;
+            ResNet50Bottleneck<T, BlockSize, BlockSize, 1024, 256, 1024> layer3_5;
+
+            ResNet50Layer3(const std::vector<void *> &weights, ImageInference::types::KernelLayout layout,
+                           const ResNet50Calibration &calibration = ResNet50Calibration());
+
+            void addGemmKernels(GemmKernels &gemmKernels, libxsmm_datatype datatype) const override;
+            using IResNet50Layer<T>::inference;
+            void inference(ResNet50Activations<T> *const *activations, size_t batch, const GemmKernels *gemmKernels) override;
+            bool setWinograd(size_t conv2Index, bool enabled, GemmKernels &gemmKernels) override;
+            bool usesWinograd() const override;
+            bool setFloat16(size_t conv1Index, bool enabled, GemmKernels &gemmKernels) override;
+        };
+
+        /// @brief The prepared weights of layer4, the bottlenecks with 2048 output channels on 7 x 7.
+        /// @tparam InBlockSize The block size of the output of layer3, which is reblocked by the first bottleneck.
+        /// @tparam BlockSize The block size of the layer.
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        class ResNet50Layer4 : public IResNet50Layer<T>
+        {
+        public:
+            ResNet50BottleneckProjection<T, BlockSize, InBlockSize, 1024, 512, 2048> layer4_0;
+            ResNet50Bottleneck<T, BlockSize, BlockSize, 2048, 512, 2048> layer4_1;
+            ResNet50Bottleneck<T, BlockSize, BlockSize, 2048, 512, 2048> layer4_2;
+
+            ResNet50Layer4(const std::vector<void *> &weights, ImageInference::types::KernelLayout layout,
+                           const ResNet50Calibration &calibration = ResNet50Calibration());
+
+            void addGemmKernels(GemmKernels &gemmKernels, libxsmm_datatype datatype) const override;
+            using IResNet50Layer<T>::inference;
+            void inference(ResNet50Activations<T> *const *activations, size_t batch, const GemmKernels *gemmKernels) override;
+            bool setWinograd(size_t conv2Index, bool enabled, GemmKernels &gemmKernels) override;
+            bool usesWinograd() const override;
+            bool setFloat16(size_t conv1Index, bool enabled, GemmKernels &gemmKernels) override;
+        };
+
+        /// @brief All weights of the ResNet50 converted into the layout that is used during inference.
+        /// Creating this container does the complete reblocking of the kernels and the batch norm computation.
+        /// Therefore it should be created once and reused for every inference.
+        ///
+        /// Every layer is prepared for the block size chosen for it at runtime, see ResNet50BlockSizes.
+        ///
+        /// The weights of the model are given in the parameter type of T. The convolutions of the layers are converted into the weight type of T,
+        /// while the stem and the fully connected layer stay in the parameter type, see ResNet50Stem.
+        ///
+        /// @tparam T The type of the activations, float, BFloat16 or uint8_t for the int8 model.
+        template <typename T>
+        class ResNet50Weights
+        {
+        public:
+            using TParameter = typename ImageInference::types::Parameter<T>::type;
+
+            const ResNet50BlockSizes blockSizes;
+
+            std::unique_ptr<IResNet50Stem<T>> stem;
+            std::unique_ptr<IResNet50Layer<T>> layer1;
+            std::unique_ptr<IResNet50Layer<T>> layer2;
+            std::unique_ptr<IResNet50Layer<T>> layer3;
+            std::unique_ptr<IResNet50Layer<T>> layer4;
+
+            /// @brief Transposed to Input x Output, so the fully connected layer is a gemm with the output in the fast dimension.
+            /// The int8 model has the scale of the output of layer4 folded in, so it reads the pooled activations as they are.
+            ImageInference::types::Matrix<TParameter, 2048, 1000> fc;
+            ImageInference::types::Array<TParameter, 1000> fcBias;
+            /// @brief The weight of the fully connected layer stored in Float16, only set if Float16 is enabled for it, then fc is released.
+            std::unique_ptr<ImageInference::types::Matrix<ImageInference::types::Float16, 2048, 1000>> fcFloat16;
+
+            /// @brief All gemm kernels used by the convolutions, dispatched once at construction.
+            GemmKernels gemmKernels;
+
+            /// @brief Converts all weights of the model into the blocked format.
+            /// @param weights The weights of the model see file backend/baremetal/resnet50weights.txt for size information.
+            /// @param layout The layout in which the convolution weights are stored.
+            /// If the weights are already blocked with RESNET50_BLOCK_SIZE they are used in place, then all layers need to use this block size.
+            /// @param blockSizes The block sizes of the layers.
+            /// @param calibration The scales of the activations, which the int8 model needs.
+            ResNet50Weights(const std::vector<void *> &weights,
+                            ImageInference::types::KernelLayout layout = ImageInference::types::KernelLayout::OIHW,
+                            const ResNet50BlockSizes &blockSizes = ResNet50BlockSizes(),
+                            const ResNet50Calibration &calibration = ResNet50Calibration());
+
+            /// @brief Enables or disables the Winograd convolution for the 3x3 convolution of a bottleneck.
+            /// Only the 3x3 convolutions with a stride of 1 are supported, i.e. all but the first of layer 2 to 4, and only for float.
+            /// @param conv2Index The index of the conv2 weight of the bottleneck e.g. ResNet50::layer2_1_conv2_weight.
+            void setWinograd(size_t conv2Index, bool enabled);
+
+            /// @brief True if any bottleneck uses the Winograd convolution.
+            bool usesWinograd() const;
+
+            /// @brief Stores the weights of a bottleneck or of the fully connected layer in Float16 or widens them back into float.
+            /// The bottlenecks are only supported for float, the fully connected layer for every type.
+            /// @param weightIndex The index of the conv1 weight of the bottleneck e.g. ResNet50::layer3_1_conv1_weight or ResNet50::fc_weight.
+            void setFloat16(size_t weightIndex, bool enabled);
+
+        private:
+            /// @brief Prepares a layer for the block sizes, which are dispatched from the runtime values to the template arguments.
+            template <template <typename, size_t, size_t> class TLayer>
+            static std::unique_ptr<IResNet50Layer<T>> makeLayer(size_t inBlockSize, size_t blockSize, const std::vector<void *> &weights,
+                                                                ImageInference::types::KernelLayout layout, const ResNet50Calibration &calibration);
+        };
+
+        /// @brief Prepares a convolution kernel from a weight of the model, which is given in the type of the batch norm.
+        /// Kernels in the OIHW layout get the scale of the batch norm folded in, blocked kernels are already folded during export.
+        /// Kernels of another type are converted from the folded kernel, so every weight is only rounded once.
+        ///
+        /// Kernels of int8_t are quantized symmetrically per output channel with the scale max(|weight|) / 127
+        /// and the batch norm is requantized from the scales of the input and the weights into the scale of the output, see BatchNorm::requantize.
+        /// The scales are only used for int8_t.
+        ///
+        /// @param inputScale The scale of the quantized input of the convolution.
+        /// @param outputScale The scale of the quantized output of the convolution.
+        /// @param shortcutScale The scale of the quantized shortcut that is added to the output, 0 without a shortcut.
+        template <typename TKernel, typename TWeight, size_t Count>
+        inline TKernel prepareKernel(void *weight, const ImageInference::types::KernelLayout layout,
+                                     ImageInference::types::BatchNorm<TWeight, Count, true> &batchNorm,
+                                     const TWeight inputScale = 0, const TWeight outputScale = 0, const TWeight shortcutScale = 0)
+        {
+            using TWeightKernel = typename TKernel::template WithType<TWeight>;
+            // Blocked kernels are only read, the view aliases the weights of the caller.
+            TWeightKernel kernel = layout == ImageInference::types::KernelLayout::Blocked
+                                       ? TWeightKernel::view(static_cast<TWeight *>(weight))
+                                       : TWeightKernel(static_cast<const TWeight *>(weight));
+            if (layout == ImageInference::types::KernelLayout::OIHW)
+            {
+                kernel.scaleCount(batchNorm.getGammaVariancePointer());
+            }
+
+            if constexpr (std::is_same<TKernel, TWeightKernel>::value)
+            {
+                return kernel;
+            }
+            else if constexpr (std::is_same<TKernel, typename TKernel::template WithType<int8_t>>::value)
+            {
+                // A kernel of zeros keeps a scale of 1, so the factors stay finite.
+                std::vector<TWeight> scales(Count);
+                std::vector<TWeight> factors(Count);
+                kernel.absMaxCount(scales.data());
+                for (size_t iCount = 0; iCount < Count; iCount++)
+                {
+                    scales[iCount] = scales[iCount] > 0 ? scales[iCount] / 127 : TWeight(1);
+                    factors[iCount] = TWeight(1) / scales[iCount];
+                }
+
+                batchNorm.requantize(scales.data(), inputScale, outputScale, shortcutScale);
+                return TKernel(kernel, factors.data());
+            }
+            else
+            {
+                return TKernel(kernel);
+            }
+        }
+
+        template <typename T, size_t BlockSize, size_t InBlockSize, size_t InChannels, size_t MidChannels, size_t OutChannels>
+        inline ResNet50Bottleneck<T, BlockSize, InBlockSize, InChannels, MidChannels, OutChannels>::ResNet50Bottleneck(
+            const std::vector<void *> &weights, const size_t conv1Index, const size_t runningMeanIndex,
+            const ImageInference::types::KernelLayout layout, const ResNet50Calibration &calibration)
+            : scales(calibration.bottleneck(conv1Index)),
+              batchNorm1(weights[conv1Index + 1], weights[conv1Index + 2], weights[runningMeanIndex], weights[runningMeanIndex + 1]),
+              kernel1(prepareKernel<decltype(kernel1)>(weights[conv1Index], layout, batchNorm1, scales.input, scales.reduce)),
+              batchNorm2(weights[conv1Index + 4], weights[conv1Index + 5], weights[runningMeanIndex + 2], weights[runningMeanIndex + 3]),
+              kernel2(prepareKernel<decltype(kernel2)>(weights[conv1Index + 3], layout, batchNorm2, scales.reduce, scales.spatial)),
+              batchNorm3(weights[conv1Index + 7], weights[conv1Index + 8], weights[runningMeanIndex + 4], weights[runningMeanIndex + 5]),
+              kernel3(prepareKernel<decltype(kernel3)>(weights[conv1Index + 6], layout, batchNorm3, scales.spatial, scales.output, scales.input)),
+              conv2Index(conv1Index + 3)
+        {
+        }
+
+        template <typename T, size_t BlockSize, size_t InBlockSize, size_t InChannels, size_t MidChannels, size_t OutChannels>
+        inline void ResNet50Bottleneck<T, BlockSize, InBlockSize, InChannels, MidChannels, OutChannels>::setWinograd(const bool enabled)
+        {
+            if (!enabled)
+            {
+                kernel2Winograd.reset();
+                return;
+            }
+
+            if constexpr (std::is_same<T, float>::value)
+            {
+                if (!kernel2Winograd)
+                {
+                    // The batch norm scale is already folded into kernel2, so it is part of the transformed kernel.
+                    // A kernel stored in Float16 is transformed from its widened copy.
+                    if (kernel2Float16)
+                    {
+                        decltype(kernel2) widened(*kernel2Float16);
+                        kernel2Winograd = std::make_unique<ImageInference::types::Kernel<T, BlockSize, BlockSize, MidChannels, MidChannels, Winograd::inputTile, Winograd::inputTile>>(
+                            Winograd::transformKernel(widened));
+                    }
+                    else
+                    {
+                        kernel2Winograd = std::make_unique<ImageInference::types::Kernel<T, BlockSize, BlockSize, MidChannels, MidChannels, Winograd::inputTile, Winograd::inputTile>>(
+                            Winograd::transformKernel(kernel2));
+                    }
+                }
+            }
+            else
+            {
+                std::cerr << "ResNet50Bottleneck::setWinograd: type is currently not supported! Supported are float." << std::endl;
+                throw std::runtime_error("ResNet50Bottleneck::setWinograd: type is currently not supported!");
+            }
+        }
+
+        template <typename T, size_t BlockSize, size_t InBlockSize, size_t InChannels, size_t MidChannels, size_t OutChannels>
+        inline void ResNet50Bottleneck<T, BlockSize, InBlockSize, InChannels, MidChannels, OutChannels>::setFloat16(const bool enabled)
+        {
+            if constexpr (std::is_same<T, float>::value)
+            {
+                if (enabled && !kernel1Float16)
+                {
+                    // Assigning an empty view frees the kernels of float, blocked kernels used in place are only no longer referenced.
+                    kernel1Float16 = std::make_unique<typename decltype(kernel1)::template WithType<ImageInference::types::Float16>>(kernel1);
+                    kernel2Float16 = std::make_unique<typename decltype(kernel2)::template WithType<ImageInference::types::Float16>>(kernel2);
+                    kernel3Float16 = std::make_unique<typename decltype(kernel3)::template WithType<ImageInference::types::Float16>>(kernel3);
+                    kernel1 = decltype(kernel1)::view(nullptr);
+                    kernel2 = decltype(kernel2)::view(nullptr);
+                    kernel3 = decltype(kernel3)::view(nullptr);
+                }
+                else if (!enabled && kernel1Float16)
+                {
+                    kernel1 = decltype(kernel1)(*kernel1Float16);
+                    kernel2 = decltype(kernel2)(*kernel2Float16);
+                    kernel3 = decltype(kernel3)(*kernel3Float16);
+                    kernel1Float16.reset();
+                    kernel2Float16.reset();
+                    kernel3Float16.reset();
+                }
+            }
+            else if (enabled)
+            {
+                std::cerr << "ResNet50Bottleneck::setFloat16: type is currently not supported! Supported are float." << std::endl;
+                throw std::runtime_error("ResNet50Bottleneck::setFloat16: type is currently not supported!");
+            }
+        }
+
+        template <typename T, size_t BlockSize, size_t InBlockSize, size_t InChannels, size_t MidChannels, size_t OutChannels>
+        inline ResNet50BottleneckProjection<T, BlockSize, InBlockSize, InChannels, MidChannels, OutChannels>::ResNet50BottleneckProjection(
+            const std::vector<void *> &weights, const size_t conv1Index, const size_t runningMeanIndex,
+            const ImageInference::types::KernelLayout layout, const ResNet50Calibration &calibration)
+            : ResNet50Bottleneck<T, BlockSize, InBlockSize, InChannels, MidChannels, OutChannels>(weights, conv1Index, runningMeanIndex, layout, calibration),
+              projectionBatchNorm(weights[conv1Index + 10], weights[conv1Index + 11], weights[runningMeanIndex + 6], weights[runningMeanIndex + 7]),
+              projectionKernel(prepareKernel<decltype(projectionKernel)>(weights[conv1Index + 9], layout, projectionBatchNorm, this->scales.input, this->scales.output))
+        {
+        }
+
+        template <typename T, size_t BlockSize, size_t InBlockSize, size_t InChannels, size_t MidChannels, size_t OutChannels>
+        inline void ResNet50BottleneckProjection<T, BlockSize, InBlockSize, InChannels, MidChannels, OutChannels>::setFloat16(const bool enabled)
+        {
+            ResNet50Bottleneck<T, BlockSize, InBlockSize, InChannels, MidChannels, OutChannels>::setFloat16(enabled);
+            if constexpr (std::is_same<T, float>::value)
+            {
+                if (enabled && !projectionKernelFloat16)
+                {
+                    projectionKernelFloat16 = std::make_unique<typename decltype(projectionKernel)::template WithType<ImageInference::types::Float16>>(projectionKernel);
+                    projectionKernel = decltype(projectionKernel)::view(nullptr);
+                }
+                else if (!enabled && projectionKernelFloat16)
+                {
+                    projectionKernel = decltype(projectionKernel)(*projectionKernelFloat16);
+                    projectionKernelFloat16.reset();
+                }
+            }
+        }
+
+        template <typename T, size_t BlockSize>
+        inline ResNet50Stem<T, BlockSize>::ResNet50Stem(const std::vector<void *> &weights, const ImageInference::types::KernelLayout layout,
+                                                        const ResNet50Calibration &calibration)
+            : batchNorm1(weights[ResNet50::bn1_weight], weights[ResNet50::bn1_bias], weights[ResNet50::bn1_running_mean], weights[ResNet50::bn1_running_var]),
+              conv1(prepareKernel<decltype(conv1)>(weights[ResNet50::conv1_weight], layout, batchNorm1))
+        {
+            if constexpr (std::is_same<T, uint8_t>::value)
+            {
+                // The copy also owns blocked weights, which are used in place otherwise.
+                std::vector<TParameter> factors(64, TParameter(1) / calibration.stem());
+                conv1 = decltype(conv1)(conv1, factors.data());
+                batchNorm1.requantize(nullptr, 1, calibration.stem());
+            }
+        }
+
+        template <typename T, size_t BlockSize>
+        inline void ResNet50Stem<T, BlockSize>::addGemmKernels(GemmKernels &gemmKernels, const libxsmm_datatype datatype) const
+        {
+            // conv1 reads the planar input directly and does one gemm over the 7 x 7 x 3 taps per output row, see ResNet50::convBlockPlanarMaxPool.
+            constexpr const int blockSize = BlockSize;
+            constexpr const int stemDepth = 7 * 7 * 3;
+            gemmKernels.add(GemmShape{blockSize, 112, stemDepth, blockSize, stemDepth, blockSize, datatype, true});
+        }
+
+        template <typename T, size_t BlockSize>
+        inline void ResNet50Stem<T, BlockSize>::inference(const TParameter *input, ResNet50Activations<T> &activations, const GemmKernels *gemmKernels)
+        {
+            // The stem reads the input in place, the padding of 3 for the 7x7 kernel is handled by the convolution.
+            // The pooled output is rounded into T, so the stem computes completely in the parameter type.
+            // The max pooling is fused into the convolution, next is a 1x1 Kernel. Therefore no padding required.
+            auto output = ImageInference::types::Image<T, 0, BlockSize, 64, 56, 56>(
+                activations.get(activations.maxPool), activations.getSize(activations.maxPool), ImageInference::types::ImageInitialization::Padding);
+            ResNet50::convBlockPlanarMaxPool<2, 224, 224>(input, conv1, batchNorm1, output, gemmKernels);
+        }
+
+        template <typename T>
+        template <size_t BlockSize, size_t InBlockSize, size_t InSize, size_t Stride>
+        inline void IResNet50Layer<T>::addBottleneckGemmKernels(GemmKernels &gemmKernels, const libxsmm_datatype datatype, const bool accumulate)
+        {
+            constexpr const int blockSize = BlockSize;
+            constexpr const int inBlockSize = InBlockSize;
+            constexpr const int stride = Stride;
+            constexpr const int inWidth = InSize;
+            constexpr const size_t OutSize = InSize / Stride;
+            constexpr const int width = OutSize;
+
+            // Every convolution does one batch-reduce gemm per output row: BlockSize x Width = sum over (channel block, kernel tap) of
+            // (BlockSize x InBlockSize) * (InBlockSize x Width) with the stride applied through the leading dimension of the image.
+            // The 1x1 convolutions that expand the channels at the end of a bottleneck flatten whole rows into one gemm.
+            constexpr const int pixels = ResNet50::gemmRows<1, 0, 0, 1, 1, OutSize, OutSize>() * OutSize;
+
+            // The first bottleneck reads the input of the layer, the 3x3 convolution applies the stride.
+            gemmKernels.add(GemmShape{blockSize, inWidth, inBlockSize, blockSize, inBlockSize, blockSize, datatype, !accumulate, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET});
+            gemmKernels.add(GemmShape{blockSize, width, blockSize, blockSize, blockSize * stride, blockSize, datatype, !accumulate, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET});
+            gemmKernels.add(GemmShape{blockSize, pixels, blockSize, blockSize, blockSize, blockSize, datatype, !accumulate, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET});
+
+            // The projection of the strided shortcut is computed row by row and accumulated into the output.
+            constexpr const int projectionPixels = Stride == 1 ? pixels : width;
+            gemmKernels.add(GemmShape{blockSize, projectionPixels, inBlockSize, blockSize, inBlockSize * stride, blockSize, datatype, false, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET});
+
+            // The other bottlenecks read the output of the previous one. Fused they use the same gemms on their bands, see ResNet50::bottleneckFused.
+            gemmKernels.add(GemmShape{blockSize, width, blockSize, blockSize, blockSize, blockSize, datatype, !accumulate, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET});
+        }
+
+        template <typename T>
+        template <typename TBottleneck>
+        inline bool IResNet50Layer<T>::setBottleneckWinograd(TBottleneck &bottleneck, const size_t conv2Index, const bool enabled,
+                                                             const int blockSize, const int tiles, GemmKernels &gemmKernels)
+        {
+            if (bottleneck.conv2Index != conv2Index)
+            {
+                return false;
+            }
+
+            bottleneck.setWinograd(enabled);
+            if (enabled)
+            {
+                const libxsmm_datatype datatype = LIBXSMM_DATATYPE(float); // Other types are rejected by ResNet50Bottleneck::setWinograd.
+                gemmKernels.add(GemmShape{blockSize, tiles, blockSize, blockSize, blockSize, blockSize, datatype, true, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET});
+            }
+            return true;
+        }
+
+        template <typename T>
+        template <typename TBottleneck>
+        inline bool IResNet50Layer<T>::setBottleneckFloat16(TBottleneck &bottleneck, const size_t conv1Index, const bool enabled)
+        {
+            if (bottleneck.conv2Index != conv1Index + 3)
+            {
+                return false;
+            }
+
+            bottleneck.setFloat16(enabled);
+            return true;
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline ResNet50Layer1<T, InBlockSize, BlockSize>::ResNet50Layer1(const std::vector<void *> &weights, const ImageInference::types::KernelLayout layout,
+                                                                        const ResNet50Calibration &calibration)
+            : layer1_0(weights, ResNet50::layer1_0_conv1_weight, ResNet50::layer1_0_bn1_running_mean, layout, calibration),
+              layer1_1(weights, ResNet50::layer1_1_conv1_weight, ResNet50::layer1_1_bn1_running_mean, layout, calibration),
+              layer1_2(weights, ResNet50::layer1_2_conv1_weight, ResNet50::layer1_2_bn1_running_mean, layout, calibration)
+        {
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline void ResNet50Layer1<T, InBlockSize, BlockSize>::addGemmKernels(GemmKernels &gemmKernels, const libxsmm_datatype datatype) const
+        {
+            IResNet50Layer<T>::template addBottleneckGemmKernels<BlockSize, InBlockSize, 56, 1>(gemmKernels, datatype);
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline void ResNet50Layer1<T, InBlockSize, BlockSize>::inference(ResNet50Activations<T> *const *activations, const size_t batch, const GemmKernels *gemmKernels)
+        {
+            // The input was written by the stem and is only read, the output of the last bottleneck is the output of the layer.
+            ResNet50::block0(*this, activations, batch, gemmKernels);
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline bool ResNet50Layer1<T, InBlockSize, BlockSize>::setWinograd(const size_t conv2Index, const bool enabled, GemmKernels &gemmKernels)
+        {
+            constexpr const int tiles = Winograd::tiles<56, 56>();
+            return this->setBottleneckWinograd(layer1_0, conv2Index, enabled, BlockSize, tiles, gemmKernels) ||
+                   this->setBottleneckWinograd(layer1_1, conv2Index, enabled, BlockSize, tiles, gemmKernels) ||
+                   this->setBottleneckWinograd(layer1_2, conv2Index, enabled, BlockSize, tiles, gemmKernels);
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline bool ResNet50Layer1<T, InBlockSize, BlockSize>::usesWinograd() const
+        {
+            return layer1_0.kernel2Winograd || layer1_1.kernel2Winograd || layer1_2.kernel2Winograd;
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline bool ResNet50Layer1<T, InBlockSize, BlockSize>::setFloat16(const size_t conv1Index, const bool enabled, GemmKernels &gemmKernels)
+        {
+            const bool found = this->setBottleneckFloat16(layer1_0, conv1Index, enabled) ||
+                          this->setBottleneckFloat16(layer1_1, conv1Index, enabled) ||
+                          this->setBottleneckFloat16(layer1_2, conv1Index, enabled);
+            if (found && enabled)
+            {
+                // Other types are rejected by ResNet50Bottleneck::setFloat16.
+                IResNet50Layer<T>::template addBottleneckGemmKernels<BlockSize, InBlockSize, 56, 1>(gemmKernels, LIBXSMM_DATATYPE(float), true);
+            }
+            return found;
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline ResNet50Layer2<T, InBlockSize, BlockSize>::ResNet50Layer2(const std::vector<void *> &weights, const ImageInference::types::KernelLayout layout,
+                                                                        const ResNet50Calibration &calibration)
+            : layer2_0(weights, ResNet50::layer2_0_conv1_weight, ResNet50::layer2_0_bn1_running_mean, layout, calibration),
+              layer2_1(weights, ResNet50::layer2_1_conv1_weight, ResNet50::layer2_1_bn1_running_mean, layout, calibration),
+              layer2_2(weights, ResNet50::layer2_2_conv1_weight, ResNet50::layer2_2_bn1_running_mean, layout, calibration),
+              layer2_3(weights, ResNet50::layer2_3_conv1_weight, ResNet50::layer2_3_bn1_running_mean, layout, calibration)
+        {
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline void ResNet50Layer2<T, InBlockSize, BlockSize>::addGemmKernels(GemmKernels &gemmKernels, const libxsmm_datatype datatype) const
+        {
+            IResNet50Layer<T>::template addBottleneckGemmKernels<BlockSize, InBlockSize, 56, 2>(gemmKernels, datatype);
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline void ResNet50Layer2<T, InBlockSize, BlockSize>::inference(ResNet50Activations<T> *const *activations, const size_t batch, const GemmKernels *gemmKernels)
+        {
+            // The input was written by layer1 and is only read, the output of the last bottleneck is the output of the layer.
+            ResNet50::block1(*this, activations, batch, gemmKernels);
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline bool ResNet50Layer2<T, InBlockSize, BlockSize>::setWinograd(const size_t conv2Index, const bool enabled, GemmKernels &gemmKernels)
+        {
+            constexpr const int tiles = Winograd::tiles<28, 28>();
+            return this->setBottleneckWinograd(layer2_1, conv2Index, enabled, BlockSize, tiles, gemmKernels) ||
+                   this->setBottleneckWinograd(layer2_2, conv2Index, enabled, BlockSize, tiles, gemmKernels) ||
+                   this->setBottleneckWinograd(layer2_3, conv2Index, enabled, BlockSize, tiles, gemmKernels);
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline bool ResNet50Layer2<T, InBlockSize, BlockSize>::usesWinograd() const
+        {
+            // The first bottleneck applies the stride, so it can not use Winograd.
+            return layer2_1.kernel2Winograd || layer2_2.kernel2Winograd || layer2_3.kernel2Winograd;
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline bool ResNet50Layer2<T, InBlockSize, BlockSize>::setFloat16(const size_t conv1Index, const bool enabled, GemmKernels &gemmKernels)
+        {
+            const bool found = this->setBottleneckFloat16(layer2_0, conv1Index, enabled) ||
+                          this->setBottleneckFloat16(layer2_1, conv1Index, enabled) ||
+                          this->setBottleneckFloat16(layer2_2, conv1Index, enabled) ||
+                          this->setBottleneckFloat16(layer2_3, conv1Index, enabled);
+            if (found && enabled)
+            {
+                // Other types are rejected by ResNet50Bottleneck::setFloat16.
+                IResNet50Layer<T>::template addBottleneckGemmKernels<BlockSize, InBlockSize, 56, 2>(gemmKernels, LIBXSMM_DATATYPE(float), true);
+            }
+            return found;
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline ResNet50Layer3<T, InBlockSize, BlockSize>::ResNet50Layer3(const std::vector<void *> &weights, const ImageInference::types::KernelLayout layout,
+                                                                        const ResNet50Calibration &calibration)
+            : layer3_0(weights, ResNet50::layer3_0_conv1_weight, ResNet50::layer3_0_bn1_running_mean, layout, calibration),
+              layer3_1(weights, ResNet50::layer3_1_conv1_weight, ResNet50::layer3_1_bn1_running_mean, layout, calibration),
+              layer3_2(weights, ResNet50::layer3_2_conv1_weight, ResNet50::layer3_2_bn1_running_mean, layout, calibration),
+              layer3_3(weights, ResNet50::layer3_3_conv1_weight, ResNet50::layer3_3_bn1_running_mean, layout, calibration),
+              layer3_4(weights, ResNet50::layer3_4_conv1_weight, ResNet50::layer3_4_bn1_running_mean, layout, calibration),
+              layer3_5(weights, ResNet50::layer3_5_conv1_weight, ResNet50::layer3_5_bn1_running_mean, layout, calibration)
+        {
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline void ResNet50Layer3<T, InBlockSize, BlockSize>::addGemmKernels(GemmKernels &gemmKernels, const libxsmm_datatype datatype) const
+        {
+            IResNet50Layer<T>::template addBottleneckGemmKernels<BlockSize, InBlockSize, 28, 2>(gemmKernels, datatype);
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline void ResNet50Layer3<T, InBlockSize, BlockSize>::inference(ResNet50Activations<T> *const *activations, const size_t batch, const GemmKernels *gemmKernels)
+        {
+            // The input was written by layer2 and is only read, the output of the last bottleneck is the output of the layer.
+            ResNet50::block2(*this, activations, batch, gemmKernels);
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline bool ResNet50Layer3<T, InBlockSize, BlockSize>::setWinograd(const size_t conv2Index, const bool enabled, GemmKernels &gemmKernels)
+        {
+            constexpr const int tiles = Winograd::tiles<14, 14>();
+            return this->setBottleneckWinograd(layer3_1, conv2Index, enabled, BlockSize, tiles, gemmKernels) ||
+                   this->setBottleneckWinograd(layer3_2, conv2Index, enabled, BlockSize, tiles, gemmKernels) ||
+                   this->setBottleneckWinograd(layer3_3, conv2Index, enabled, BlockSize, tiles, gemmKernels) ||
+                   this->setBottleneckWinograd(layer3_4, conv2Index, enabled, BlockSize, tiles, gemmKernels) ||
+                   this->setBottleneckWinograd(layer3_5, conv2Index, enabled, BlockSize, tiles, gemmKernels);
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline bool ResNet50Layer3<T, InBlockSize, BlockSize>::usesWinograd() const
+        {
+            // The first bottleneck applies the stride, so it can not use Winograd.
+            return layer3_1.kernel2Winograd || layer3_2.kernel2Winograd || layer3_3.kernel2Winograd || layer3_4.kernel2Winograd || layer3_5.kernel2Winograd;
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline bool ResNet50Layer3<T, InBlockSize, BlockSize>::setFloat16(const size_t conv1Index, const bool enabled, GemmKernels &gemmKernels)
+        {
+            const bool found = this->setBottleneckFloat16(layer3_0, conv1Index, enabled) ||
+                          this->setBottleneckFloat16(layer3_1, conv1Index, enabled) ||
+                          this->setBottleneckFloat16(layer3_2, conv1Index, enabled) ||
+                          this->setBottleneckFloat16(layer3_3, conv1Index, enabled) ||
+                          this->setBottleneckFloat16(layer3_4, conv1Index, enabled) ||
+                          this->setBottleneckFloat16(layer3_5, conv1Index, enabled);
+            if (found && enabled)
+            {
+                // Other types are rejected by ResNet50Bottleneck::setFloat16.
+                IResNet50Layer<T>::template addBottleneckGemmKernels<BlockSize, InBlockSize, 28, 2>(gemmKernels, LIBXSMM_DATATYPE(float), true);
+            }
+            return found;
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline ResNet50Layer4<T, InBlockSize, BlockSize>::ResNet50Layer4(const std::vector<void *> &weights, const ImageInference::types::KernelLayout layout,
+                                                                        const ResNet50Calibration &calibration)
+            : layer4_0(weights, ResNet50::layer4_0_conv1_weight, ResNet50::layer4_0_bn1_running_mean, layout, calibration),
+              layer4_1(weights, ResNet50::layer4_1_conv1_weight, ResNet50::layer4_1_bn1_running_mean, layout, calibration),
+              layer4_2(weights, ResNet50::layer4_2_conv1_weight, ResNet50::layer4_2_bn1_running_mean, layout, calibration)
+        {
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline void ResNet50Layer4<T, InBlockSize, BlockSize>::addGemmKernels(GemmKernels &gemmKernels, const libxsmm_datatype datatype) const
+        {
+            IResNet50Layer<T>::template addBottleneckGemmKernels<BlockSize, InBlockSize, 14, 2>(gemmKernels, datatype);
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline void ResNet50Layer4<T, InBlockSize, BlockSize>::inference(ResNet50Activations<T> *const *activations, const size_t batch, const GemmKernels *gemmKernels)
+        {
+            // The input was written by layer3 and is only read, the output of the last bottleneck is the output of the layer.
+            ResNet50::block3(*this, activations, batch, gemmKernels);
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline bool ResNet50Layer4<T, InBlockSize, BlockSize>::setWinograd(const size_t conv2Index, const bool enabled, GemmKernels &gemmKernels)
+        {
+            constexpr const int tiles = Winograd::tiles<7, 7>();
+            return this->setBottleneckWinograd(layer4_1, conv2Index, enabled, BlockSize, tiles, gemmKernels) ||
+                   this->setBottleneckWinograd(layer4_2, conv2Index, enabled, BlockSize, tiles, gemmKernels);
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline bool ResNet50Layer4<T, InBlockSize, BlockSize>::usesWinograd() const
+        {
+            // The first bottleneck applies the stride, so it can not use Winograd.
+            return layer4_1.kernel2Winograd || layer4_2.kernel2Winograd;
+        }
+
+        template <typename T, size_t InBlockSize, size_t BlockSize>
+        inline bool ResNet50Layer4<T, InBlockSize, BlockSize>::setFloat16(const size_t conv1Index, const bool enabled, GemmKernels &gemmKernels)
+        {
+            const bool found = this->setBottleneckFloat16(layer4_0, conv1Index, enabled) ||
+                          this->setBottleneckFloat16(layer4_1, conv1Index, enabled) ||
+                          this->setBottleneckFloat16(layer4_2, conv1Index, enabled);
+            if (found && enabled)
+            {
+                // Other types are rejected by ResNet50Bottleneck::setFloat16.
+                IResNet50Layer<T>::template addBottleneckGemmKernels<BlockSize, InBlockSize, 14, 2>(gemmKernels, LIBXSMM_DATATYPE(float), true);
+            }
+            return found;
+        }
+
+        template <typename T>
+        inline ResNet50Weights<T>::ResNet50Weights(const std::vector<void *> &weights,
+                                                   const ImageInference::types::KernelLayout layout,
+                                                   const ResNet50BlockSizes &blockSizes,
+                                                   const ResNet50Calibration &calibration)
+            : blockSizes(blockSizes),
+              fc(ImageInference::types::Matrix<TParameter, 2048, 1000>::transposed(static_cast<const TParameter *>(weights[ResNet50::fc_weight]))),
+              fcBias(static_cast<const TParameter *>(weights[ResNet50::fc_bias]))
+        {
+            // The stem and the fully connected layer compute in the parameter type, which is float for all supported types.
+            libxsmm_datatype datatype;
+            const libxsmm_datatype parameterDatatype = LIBXSMM_DATATYPE(float);
+            if constexpr (std::is_same<T, float>::value)
+            {
+                datatype = LIBXSMM_DATATYPE(float);
+            }
+            else if constexpr (std::is_same<T, ImageInference::types::BFloat16>::value)
+            {
+                datatype = LIBXSMM_DATATYPE_BF16;
+            }
+            else if constexpr (std::is_same<T, uint8_t>::value)
+            {
+                datatype = LIBXSMM_DATATYPE_I8;
+                if (calibration.empty())
+                {
+                    std::cerr << "ResNet50Weights: The int8 model needs the scales of the activations, but the calibration is empty." << std::endl;
+                    throw std::runtime_error("ResNet50Weights: The int8 model needs a calibration!");
+                }
+
+                // The head averages the quantized output of layer4, whose scale is applied by the fully connected layer.
+                const TParameter outputScale = calibration.bottleneck(ResNet50::layer4_2_conv1_weight).output;
+                TParameter *fcPtr = fc.getPointer();
+                for (size_t i = 0; i < fc.size; i++)
+                {
+                    fcPtr[i] *= outputScale;
+                }
+            }
+            else
+            {
+                std::cerr << "ResNet50Weights: type is currently not supported! Supported are float, BFloat16 and uint8_t." << std::endl;
+                throw std::runtime_error("ResNet50Weights: type is currently not supported!");
+            }
+
+            blockSizes.check();
+            if (layout == ImageInference::types::KernelLayout::Blocked && !blockSizes.isUniform(RESNET50_BLOCK_SIZE))
+            {
+                std::cerr << "ResNet50Weights: Blocked weights are exported with the block size " << RESNET50_BLOCK_SIZE
+                          << " for all layers, but the block sizes are " << blockSizes << "." << std::endl;
+                throw std::runtime_error("ResNet50Weights: Blocked weights need the block size RESNET50_BLOCK_SIZE for all layers!");
+            }
+
+            stem = ResNet50BlockSizes::dispatch(blockSizes.stem, [&](auto blockSize) -> std::unique_ptr<IResNet50Stem<T>>
+                                                { return std::make_unique<ResNet50Stem<T, decltype(blockSize)::value>>(weights, layout, calibration); });
+            layer1 = makeLayer<ResNet50Layer1>(blockSizes.stem, blockSizes.layer1, weights, layout, calibration);
+            layer2 = makeLayer<ResNet50Layer2>(blockSizes.layer1, blockSizes.layer2, weights, layout, calibration);
+            layer3 = makeLayer<ResNet50Layer3>(blockSizes.layer2, blockSizes.layer3, weights, layout, calibration);
+            layer4 = makeLayer<ResNet50Layer4>(blockSizes.layer3, blockSizes.layer4, weights, layout, calibration);
+
+            stem->addGemmKernels(gemmKernels, parameterDatatype);
+            for (const auto *layer : {layer1.get(), layer2.get(), layer3.get(), layer4.get()})
+            {
+                layer->addGemmKernels(gemmKernels, datatype);
+            }
+
+            // The fully connected layer of every group size of a batch, see ResNet50::globalAveragePoolFullyConnected.
+            constexpr const int fcColumns = ResNet50::fullyConnectedColumns<1000>();
+            for (int batch = 1; batch <= RESNET50_BATCH; batch++)
+            {
+                gemmKernels.add(GemmShape{fcColumns, batch, 2048, 1000, 2048, 1000, parameterDatatype});
+            }
+
+            gemmKernels.report(std::cerr);
+        }
+
+        template <typename T>
+        template <template <typename, size_t, size_t> class TLayer>
+        inline std::unique_ptr<IResNet50Layer<T>> ResNet50Weights<T>::makeLayer(const size_t inBlockSize, const size_t blockSize, const std::vector<void *> &weights,
+                                                                                 const ImageInference::types::KernelLayout layout,
+                                                                                 const ResNet50Calibration &calibration)
+        {
+            return ResNet50BlockSizes::dispatch(inBlockSize, [&](auto inBlockSizeConstant)
+                                                { return ResNet50BlockSizes::dispatch(blockSize, [&](auto blockSizeConstant) -> std::unique_ptr<IResNet50Layer<T>>
+                                                                                      { return std::make_unique<TLayer<T, decltype(inBlockSizeConstant)::value, decltype(blockSizeConstant)::value>>(weights, layout, calibration); }); });
+        }
+
+        template <typename T>
+        inline void ResNet50Weights<T>::setWinograd(const size_t conv2Index, const bool enabled)
+        {
+            for (auto *layer : {layer1.get(), layer2.get(), layer3.get(), layer4.get()})
+            {
+                if (layer->setWinograd(conv2Index, enabled, gemmKernels))
+                {
+                    return;
+                }
+            }
+
+            if (conv2Index == ResNet50::layer2_0_conv2_weight || conv2Index == ResNet50::layer3_0_conv2_weight || conv2Index == ResNet50::layer4_0_conv2_weight)
+            {
+                std::cerr << "ResNet50Weights::setWinograd: Winograd only supports a stride of 1, the 3x3 convolution " << conv2Index
+                          << " uses a stride of 2." << std::endl;
+                throw std::runtime_error("ResNet50Weights::setWinograd: Winograd only supports a stride of 1!");
+            }
+
+            std::cerr << "ResNet50Weights::setWinograd: " << conv2Index << " is not the index of a conv2 weight." << std::endl;
+            throw std::runtime_error("ResNet50Weights::setWinograd: The index is not a conv2 weight!");
+        }
+
+        template <typename T>
+        inline bool ResNet50Weights<T>::usesWinograd() const
+        {
+            return layer1->usesWinograd() || layer2->usesWinograd() || layer3->usesWinograd() || layer4->usesWinograd();
+        }
+
+        template <typename T>
+        inline void ResNet50Weights<T>::setFloat16(const size_t weightIndex, const bool enabled)
+        {
+            if (weightIndex == ResNet50::fc_weight)
+            {
+                if (enabled && !fcFloat16)
+                {
+                    fcFloat16 = std::make_unique<ImageInference::types::Matrix<ImageInference::types::Float16, 2048, 1000>>(fc);
+                    fc = ImageInference::types::Matrix<TParameter, 2048, 1000>::view(nullptr);
+
+                    // The widened chunks of every group size of a batch, see ResNet50::globalAveragePoolFullyConnected.
+                    constexpr const int fcColumns = ResNet50::fullyConnectedColumns<1000>();
+                    constexpr const int fcChannels = ResNet50::fullyConnectedFloat16Channels<2048, 1000>();
+                    for (int batch = 1; batch <= RESNET50_BATCH; batch++)
+                    {
+                        gemmKernels.add(GemmShape{fcColumns, batch, fcChannels, fcColumns, 2048, 1000, LIBXSMM_DATATYPE(float)});
+                    }
+                }
+                else if (!enabled && fcFloat16)
+                {
+                    fc = ImageInference::types::Matrix<TParameter, 2048, 1000>(*fcFloat16);
+                    fcFloat16.reset();
+                }
+                return;
+            }
+
+            for (auto *layer : {layer1.get(), layer2.get(), layer3.get(), layer4.get()})
+            {
+                if (layer->setFloat16(weightIndex, enabled, gemmKernels))
+                {
+                    return;
+                }
+            }
+
+            std::cerr << "ResNet50Weights::setFloat16: " << weightIndex << " is neither the index of a conv1 weight nor of the fc weight." << std::endl;
+            throw std::runtime_error("ResNet50Weights::setFloat16: The index is neither a conv1 weight nor the fc weight!");
+        }
+    } // namespace model
+} // namespace ImageInference
+
+#endif // IMAGEINFERENCE_RESNET50WEIGHTS_H
@@ -0,0 +1,302 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#include "VectorKernels.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define IMAGEINFERENCE_VECTOR_X86
+#include <immintrin.h>
+#endif // __x86_64__ || __i386__
+
+namespace
+{
+    namespace scalar
+    {
+#define IMAGEINFERENCE_VECTOR_TARGET
+        using Vector = float;
+        constexpr const size_t width = 1;
+
+        inline Vector load(const float *memory) { return *memory; }
+        inline void store(float *memory, const Vector value) { *memory = value; }
+        inline Vector add(const Vector a, const Vector b) { return a + b; }
+        inline Vector max(const Vector a, const Vector b) { return std::max(a, b); }
+        inline Vector zero() { return 0.0f; }
+        inline Vector loadBFloat16(const ImageInference::types::BFloat16 *memory) { return *memory; }
+        inline void storeBFloat16(ImageInference::types::BFloat16 *memory, const Vector value) { *memory = value; }
+        inline Vector loadInt32(const int32_t *memory) { return static_cast<float>(*memory); }
+        inline Vector loadUInt8(const uint8_t *memory) { return *memory; }
+        inline Vector loadFloat16(const ImageInference::types::Float16 *memory) { return *memory; }
+        inline void storeUInt8(uint8_t *memory, const Vector value) { *memory = ImageInference::types::roundTo<uint8_t>(value); }
+        inline Vector mul(const Vector a, const Vector b) { return a * b; }
+        inline Vector broadcast(const float value) { return value; }
+
+#include "VectorKernels.inl"
+#undef IMAGEINFERENCE_VECTOR_TARGET
+    } // namespace scalar
+
+#ifdef IMAGEINFERENCE_VECTOR_X86
+    namespace sse4
+    {
+#define IMAGEINFERENCE_VECTOR_TARGET __attribute__((target("sse4.1")))
+        using Vector = __m128;
+        constexpr const size_t width = 4;
+
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector load(const float *memory) { return _mm_loadu_ps(memory); }
+        IMAGEINFERENCE_VECTOR_TARGET inline void store(float *memory, const Vector value) { _mm_storeu_ps(memory, value); }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector add(const Vector a, const Vector b) { return _mm_add_ps(a, b); }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector max(const Vector a, const Vector b) { return _mm_max_ps(a, b); }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector zero() { return _mm_setzero_ps(); }
+        // A BFloat16 is the upper half of a float, the rounding to nearest even adds half of the lower half and the lowest kept bit.
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector loadBFloat16(const ImageInference::types::BFloat16 *memory)
+        {
+            const __m128i bits = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(memory)));
+            return _mm_castsi128_ps(_mm_slli_epi32(bits, 16));
+        }
+        IMAGEINFERENCE_VECTOR_TARGET inline void storeBFloat16(ImageInference::types::BFloat16 *memory, const Vector value)
+        {
+            const __m128i bits = _mm_castps_si128(value);
+            const __m128i rounding = _mm_add_epi32(_mm_set1_epi32(0x7FFF), _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(1)));
+            const __m128i rounded = _mm_srli_epi32(_mm_add_epi32(bits, rounding), 16);
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(memory), _mm_packus_epi32(rounded, rounded));
+        }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector loadInt32(const int32_t *memory) { return _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(memory))); }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector loadUInt8(const uint8_t *memory)
+        {
+            int32_t bytes;
+            std::memcpy(&bytes, memory, sizeof(bytes));
+            return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes)));
+        }
+        // The conversion rounds to nearest even, values above the range of int32 would wrap, so they are saturated to 255 first.
+        IMAGEINFERENCE_VECTOR_TARGET inline void storeUInt8(uint8_t *memory, const Vector value)
+        {
+            const __m128i integers = _mm_cvtps_epi32(_mm_min_ps(value, _mm_set1_ps(255.0f)));
+            const __m128i words = _mm_packs_epi32(integers, integers);
+            const int32_t bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+            std::memcpy(memory, &bytes, sizeof(bytes));
+        }
+        // Without F16C the magnitude is moved into the float bits and scaled by 2^112 from the exponent bias 15 to 127,
+        // which also widens the subnormals. Infinity and NaN keep the exponent of all ones.
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector loadFloat16(const ImageInference::types::Float16 *memory)
+        {
+            const __m128i bits = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(memory)));
+            const __m128i magnitude = _mm_slli_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x7FFF)), 13);
+            const __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(magnitude), _mm_castsi128_ps(_mm_set1_epi32(0x77800000)));
+            const __m128i special = _mm_and_si128(_mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x0F7FFFFF)), _mm_set1_epi32(0x7F800000));
+            const __m128i sign = _mm_slli_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x8000)), 16);
+            return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(special, sign)));
+        }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector mul(const Vector a, const Vector b) { return _mm_mul_ps(a, b); }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector broadcast(const float value) { return _mm_set1_ps(value); }
+
+#include "VectorKernels.inl"
+#undef IMAGEINFERENCE_VECTOR_TARGET
+    } // namespace sse4
+
+    namespace avx2
+    {
+#define IMAGEINFERENCE_VECTOR_TARGET __attribute__((target("avx2,f16c")))
+        using Vector = __m256;
+        constexpr const size_t width = 8;
+
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector load(const float *memory) { return _mm256_loadu_ps(memory); }
+        IMAGEINFERENCE_VECTOR_TARGET inline void store(float *memory, const Vector value) { _mm256_storeu_ps(memory, value); }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector add(const Vector a, const Vector b) { return _mm256_add_ps(a, b); }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector max(const Vector a, const Vector b) { return _mm256_max_ps(a, b); }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector zero() { return _mm256_setzero_ps(); }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector loadBFloat16(const ImageInference::types::BFloat16 *memory)
+        {
+            const __m256i bits = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(memory)));
+            return _mm256_castsi256_ps(_mm256_slli_epi32(bits, 16));
+        }
+        IMAGEINFERENCE_VECTOR_TARGET inline void storeBFloat16(ImageInference::types::BFloat16 *memory, const Vector value)
+        {
+            const __m256i bits = _mm256_castps_si256(value);
+            const __m256i rounding = _mm256_add_epi32(_mm256_set1_epi32(0x7FFF), _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1)));
+            const __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(bits, rounding), 16);
+            // The pack works within the 128 bit lanes, so the lanes are packed with each other instead.
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(memory), _mm_packus_epi32(_mm256_castsi256_si128(rounded), _mm256_extracti128_si256(rounded, 1)));
+        }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector loadInt32(const int32_t *memory) { return _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(memory))); }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector loadUInt8(const uint8_t *memory)
+        {
+            return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(memory))));
+        }
+        IMAGEINFERENCE_VECTOR_TARGET inline void storeUInt8(uint8_t *memory, const Vector value)
+        {
+            const __m256i integers = _mm256_cvtps_epi32(_mm256_min_ps(value, _mm256_set1_ps(255.0f)));
+            // As for storeBFloat16 the lanes are packed with each other.
+            const __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(integers), _mm256_extracti128_si256(integers, 1));
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(memory), _mm_packus_epi16(words, words));
+        }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector loadFloat16(const ImageInference::types::Float16 *memory)
+        {
+            return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(memory)));
+        }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector mul(const Vector a, const Vector b) { return _mm256_mul_ps(a, b); }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector broadcast(const float value) { return _mm256_set1_ps(value); }
+
+#include "VectorKernels.inl"
+#undef IMAGEINFERENCE_VECTOR_TARGET
+    } // namespace avx2
+
+    namespace avx512
+    {
+#define IMAGEINFERENCE_VECTOR_TARGET __attribute__((target("avx512f")))
+        using Vector = __m512;
+        constexpr const size_t width = 16;
+
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector load(const float *memory) { return _mm512_loadu_ps(memory); }
+        IMAGEINFERENCE_VECTOR_TARGET inline void store(float *memory, const Vector value) { _mm512_storeu_ps(memory, value); }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector add(const Vector a, const Vector b) { return _mm512_add_ps(a, b); }
+        // The masked form avoids the undefined source of _mm512_max_ps, which GCC reports as maybe uninitialized.
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector max(const Vector a, const Vector b) { return _mm512_maskz_max_ps(static_cast<__mmask16>(0xFFFF), a, b); }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector zero() { return _mm512_setzero_ps(); }
+        // The masked forms avoid the undefined sources as for max.
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector loadBFloat16(const ImageInference::types::BFloat16 *memory)
+        {
+            const __mmask16 all = 0xFFFF;
+            const __m512i bits = _mm512_maskz_cvtepu16_epi32(all, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(memory)));
+            return _mm512_castsi512_ps(_mm512_maskz_slli_epi32(all, bits, 16));
+        }
+        IMAGEINFERENCE_VECTOR_TARGET inline void storeBFloat16(ImageInference::types::BFloat16 *memory, const Vector value)
+        {
+            const __mmask16 all = 0xFFFF;
+            const __m512i bits = _mm512_castps_si512(value);
+            const __m512i rounding = _mm512_add_epi32(_mm512_set1_epi32(0x7FFF), _mm512_and_si512(_mm512_maskz_srli_epi32(all, bits, 16), _mm512_set1_epi32(1)));
+            const __m512i rounded = _mm512_maskz_srli_epi32(all, _mm512_add_epi32(bits, rounding), 16);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(memory), _mm512_maskz_cvtepi32_epi16(all, rounded));
+        }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector loadInt32(const int32_t *memory)
+        {
+            return _mm512_maskz_cvtepi32_ps(static_cast<__mmask16>(0xFFFF), _mm512_loadu_si512(memory));
+        }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector loadUInt8(const uint8_t *memory)
+        {
+            const __mmask16 all = 0xFFFF;
+            return _mm512_maskz_cvtepi32_ps(all, _mm512_maskz_cvtepu8_epi32(all, _mm_loadu_si128(reinterpret_cast<const __m128i *>(memory))));
+        }
+        // The unsigned saturation also covers the values above the range of int32, which convert to 0x80000000.
+        IMAGEINFERENCE_VECTOR_TARGET inline void storeUInt8(uint8_t *memory, const Vector value)
+        {
+            const __mmask16 all = 0xFFFF;
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(memory), _mm512_maskz_cvtusepi32_epi8(all, _mm512_maskz_cvtps_epi32(all, value)));
+        }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector loadFloat16(const ImageInference::types::Float16 *memory)
+        {
+            return _mm512_maskz_cvtph_ps(static_cast<__mmask16>(0xFFFF), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(memory)));
+        }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector mul(const Vector a, const Vector b) { return _mm512_mul_ps(a, b); }
+        IMAGEINFERENCE_VECTOR_TARGET inline Vector broadcast(const float value) { return _mm512_set1_ps(value); }
+
+#include "VectorKernels.inl"
+#undef IMAGEINFERENCE_VECTOR_TARGET
+    } // namespace avx512
+#endif // IMAGEINFERENCE_VECTOR_X86
+
+    using ImageInference::model::VectorIsa;
+    using ImageInference::model::VectorKernels;
+
+    const VectorKernels scalarKernels{VectorIsa::Scalar, scalar::biasRelu, scalar::biasAddRelu, scalar::maximum, scalar::maxPoolRow, scalar::sumPixels,
+                                      scalar::biasReluBFloat16, scalar::biasAddReluBFloat16,
+                                      scalar::requantizeRelu, scalar::requantizeAddRelu, scalar::requantizeProjectionRelu,
+                                      scalar::widenFloat16};
+#ifdef IMAGEINFERENCE_VECTOR_X86
+    const VectorKernels sse4Kernels{VectorIsa::SSE4, sse4::biasRelu, sse4::biasAddRelu, sse4::maximum, sse4::maxPoolRow, sse4::sumPixels,
+                                      sse4::biasReluBFloat16, sse4::biasAddReluBFloat16,
+                                      sse4::requantizeRelu, sse4::requantizeAddRelu, sse4::requantizeProjectionRelu,
+                                      sse4::widenFloat16};
+    const VectorKernels avx2Kernels{VectorIsa::AVX2, avx2::biasRelu, avx2::biasAddRelu, avx2::maximum, avx2::maxPoolRow, avx2::sumPixels,
+                                      avx2::biasReluBFloat16, avx2::biasAddReluBFloat16,
+                                      avx2::requantizeRelu, avx2::requantizeAddRelu, avx2::requantizeProjectionRelu,
+                                      avx2::widenFloat16};
+    const VectorKernels avx512Kernels{VectorIsa::AVX512, avx512::biasRelu, avx512::biasAddRelu, avx512::maximum, avx512::maxPoolRow, avx512::sumPixels,
+                                      avx512::biasReluBFloat16, avx512::biasAddReluBFloat16,
+                                      avx512::requantizeRelu, avx512::requantizeAddRelu, avx512::requantizeProjectionRelu,
+                                      avx512::widenFloat16};
+#endif // IMAGEINFERENCE_VECTOR_X86
+} // namespace
+
+std::ostream &ImageInference::model::operator<<(std::ostream &stream, const VectorIsa isa)
+{
+    switch (isa)
+    {
+    case VectorIsa::Scalar:
+        return stream << "Scalar";
+    case VectorIsa::SSE4:
+        return stream << "SSE4";
+    case VectorIsa::AVX2:
+        return stream << "AVX2";
+    case VectorIsa::AVX512:
+        return stream << "AVX512";
+    }
+    return stream << "Unknown";
+}
+
+bool ImageInference::model::VectorKernels::supported(const VectorIsa isa)
+{
+#ifdef IMAGEINFERENCE_VECTOR_X86
+    // The checks include the support of the operating system for the registers.
+    switch (isa)
+    {
+    case VectorIsa::Scalar:
+        return true;
+    case VectorIsa::SSE4:
+        return __builtin_cpu_supports("sse4.1");
+    case VectorIsa::AVX2:
+        // The widening of Float16 uses F16C, which came with every AVX2 host but is a separate flag.
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+    case VectorIsa::AVX512:
+        return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+#else
+    return isa == VectorIsa::Scalar;
+#endif // IMAGEINFERENCE_VECTOR_X86
+}
+
+ImageInference::model::VectorIsa ImageInference::model::VectorKernels::detect()
+{
+    for (const VectorIsa isa : {VectorIsa::AVX512, VectorIsa::AVX2, VectorIsa::SSE4})
+    {
+        if (supported(isa))
+        {
+            return isa;
+        }
+    }
+    return VectorIsa::Scalar;
+}
+
+const ImageInference::model::VectorKernels &ImageInference::model::VectorKernels::get(const VectorIsa isa)
+{
+    if (!supported(isa))
+    {
+        std::cerr << "VectorKernels: The host does not support " << isa << "." << std::endl;
+        throw std::runtime_error("VectorKernels: The host does not support the instruction set!");
+    }
+
+#ifdef IMAGEINFERENCE_VECTOR_X86
+    switch (isa)
+    {
+    case VectorIsa::SSE4:
+        return sse4Kernels;
+    case VectorIsa::AVX2:
+        return avx2Kernels;
+    case VectorIsa::AVX512:
+        return avx512Kernels;
+    default:
+        break;
+    }
+#endif // IMAGEINFERENCE_VECTOR_X86
+    return scalarKernels;
+}
+
+const ImageInference::model::VectorKernels &ImageInference::model::VectorKernels::host()
+{
+    static const VectorKernels &kernels = get(detect());
+    return kernels;
+}
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef IMAGEINFERENCE_VECTORKERNELS_H
+#define IMAGEINFERENCE_VECTORKERNELS_H
+
+#include "../types/ScalarTypes.h"
+#include <ostream>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ImageInference
+{
+    namespace model
+    {
+        /// @brief The instruction sets of the hand vectorized kernels, ordered from the smallest to the widest.
+        enum class VectorIsa
+        {
+            Scalar,
+            SSE4,
+            AVX2,
+            AVX512
+        };
+
+        std::ostream &operator<<(std::ostream &stream, VectorIsa isa);
+
+        /// @brief A table of hand vectorized float kernels for the epilogues and poolings of the blocked images.
+        /// The BFloat16 kernels compute in float and only load and store BFloat16.
+        /// The requantize kernels convert the int32_t accumulator of an int8 gemm to float and round the result into uint8_t.
+        /// The Float16 kernel widens weights that are stored in Float16 for the float gemms.
+        ///
+        /// The table of the host is picked once from CPUID, so one binary uses the widest instruction set of every host
+        /// independent of the flags it was compiled with. Every instruction set other than Scalar is only available on x86.
+        ///
+        /// A row is Pixels x BlockSize with the block as the fast dimension, the block size does not need to be a multiple of the vector width.
+        struct VectorKernels
+        {
+            VectorIsa isa;
+
+            /// @brief row = max(row + bias, 0) with the bias of the block.
+            void (*biasRelu)(float *row, const float *bias, size_t pixels, size_t blockSize);
+
+            /// @brief row = max(row + bias + addend, 0) with the bias of the block and the addend of the same shape as the row e.g. the shortcut.
+            void (*biasAddRelu)(float *row, const float *bias, const float *addend, size_t pixels, size_t blockSize);
+
+            /// @brief output = max(output, input) for count elements.
+            void (*maximum)(float *output, const float *input, size_t count);
+
+            /// @brief output[o] = max(row[o x stride], row[o x stride + 1], row[o x stride + 2]) for every pixel o of the output,
+            /// which is the 3 wide max pooling of a row that starts at the padding.
+            void (*maxPoolRow)(float *output, const float *row, size_t outputPixels, size_t stride, size_t blockSize);
+
+            /// @brief sum += the sum of all pixels of the row.
+            void (*sumPixels)(float *sum, const float *row, size_t pixels, size_t blockSize);
+
+            /// @brief output = max(row + bias, 0) rounded to BFloat16, the epilogue of a BFloat16 gemm that accumulated the row in float.
+            void (*biasReluBFloat16)(ImageInference::types::BFloat16 *output, const float *row, const float *bias, size_t pixels, size_t blockSize);
+
+            /// @brief output = max(row + bias + addend, 0) rounded to BFloat16 with the addend in BFloat16 e.g. the shortcut.
+            void (*biasAddReluBFloat16)(ImageInference::types::BFloat16 *output, const float *row, const float *bias,
+                                        const ImageInference::types::BFloat16 *addend, size_t pixels, size_t blockSize);
+
+            /// @brief output = max(row x scale + bias, 0) rounded to uint8_t with the scale and bias of the block,
+            /// the epilogue of an int8 gemm that accumulated the row in int32_t, see ImageInference::types::BatchNorm::requantize.
+            void (*requantizeRelu)(uint8_t *output, const int32_t *row, const float *scale, const float *bias, size_t pixels, size_t blockSize);
+
+            /// @brief output = max(row x scale + bias + addend x addendScale, 0) rounded to uint8_t with the addend in uint8_t e.g. the shortcut.
+            void (*requantizeAddRelu)(uint8_t *output, const int32_t *row, const float *scale, const float *bias,
+                                      const uint8_t *addend, float addendScale, size_t pixels, size_t blockSize);
+
+            /// @brief output = max(row x scale + bias + projection x projectionScale, 0) rounded to uint8_t
+            /// with the projection accumulated in int32_t and its scale of the block e.g. the projected shortcut.
+            void (*requantizeProjectionRelu)(uint8_t *output, const int32_t *row, const float *scale, const float *bias,
+                                             const int32_t *projection, const float *projectionScale, size_t pixels, size_t blockSize);
+
+            /// @brief output = input widened to float for count elements e.g. the Float16 weights of a gemm, every Float16 is exact in float.
+            void (*widenFloat16)(float *output, const ImageInference::types::Float16 *input, size_t count);
+
+            /// @brief The widest instruction set supported by the host.
+            static VectorIsa detect();
+
+            /// @brief True if the host can run the kernels of the instruction set.
+            static bool supported(VectorIsa isa);
+
+            /// @brief The kernels of the instruction set, throws if the host does not support it.
+            static const VectorKernels &get(VectorIsa isa);
+
+            /// @brief The kernels of the widest instruction set of the host, detected on the first call.
+            static const VectorKernels &host();
+        };
+    } // namespace model
+} // namespace ImageInference
+
+#endif // IMAGEINFERENCE_VECTORKERNELS_H
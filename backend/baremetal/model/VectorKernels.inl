@@ -0,0 +1,251 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+// The kernels of VectorKernels for one instruction set, included once per instruction set by VectorKernels.cpp.
+// The including namespace provides Vector, width, load, store, loadBFloat16, storeBFloat16, loadInt32, loadUInt8, storeUInt8,
+// loadFloat16, add, mul, max, zero, broadcast and IMAGEINFERENCE_VECTOR_TARGET.
+// The elements of a block that do not fill a vector are handled without vectors.
+
+IMAGEINFERENCE_VECTOR_TARGET void biasRelu(float *row, const float *bias, const size_t pixels, const size_t blockSize)
+{
+    const size_t vectorized = blockSize - blockSize % width;
+    for (size_t iBlock = 0; iBlock < vectorized; iBlock += width)
+    {
+        const Vector biasVector = load(bias + iBlock);
+        for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+        {
+            float *element = row + iPixel * blockSize + iBlock;
+            store(element, max(add(load(element), biasVector), zero()));
+        }
+    }
+
+    for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+    {
+        for (size_t iBlock = vectorized; iBlock < blockSize; iBlock++)
+        {
+            float &element = row[iPixel * blockSize + iBlock];
+            element = std::max(element + bias[iBlock], 0.0f);
+        }
+    }
+}
+
+IMAGEINFERENCE_VECTOR_TARGET void biasAddRelu(float *row, const float *bias, const float *addend, const size_t pixels, const size_t blockSize)
+{
+    const size_t vectorized = blockSize - blockSize % width;
+    for (size_t iBlock = 0; iBlock < vectorized; iBlock += width)
+    {
+        const Vector biasVector = load(bias + iBlock);
+        for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+        {
+            const size_t offset = iPixel * blockSize + iBlock;
+            store(row + offset, max(add(add(load(row + offset), load(addend + offset)), biasVector), zero()));
+        }
+    }
+
+    for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+    {
+        for (size_t iBlock = vectorized; iBlock < blockSize; iBlock++)
+        {
+            const size_t offset = iPixel * blockSize + iBlock;
+            row[offset] = std::max(row[offset] + addend[offset] + bias[iBlock], 0.0f);
+        }
+    }
+}
+
+IMAGEINFERENCE_VECTOR_TARGET void maximum(float *output, const float *input, const size_t count)
+{
+    const size_t vectorized = count - count % width;
+    for (size_t i = 0; i < vectorized; i += width)
+    {
+        store(output + i, max(load(output + i), load(input + i)));
+    }
+
+    for (size_t i = vectorized; i < count; i++)
+    {
+        output[i] = std::max(output[i], input[i]);
+    }
+}
+
+IMAGEINFERENCE_VECTOR_TARGET void maxPoolRow(float *output, const float *row, const size_t outputPixels, const size_t stride, const size_t blockSize)
+{
+    const size_t vectorized = blockSize - blockSize % width;
+    for (size_t iPixel = 0; iPixel < outputPixels; iPixel++)
+    {
+        const float *window = row + iPixel * stride * blockSize;
+        float *outputPixel = output + iPixel * blockSize;
+        for (size_t iBlock = 0; iBlock < vectorized; iBlock += width)
+        {
+            const Vector value = max(max(load(window + iBlock), load(window + blockSize + iBlock)), load(window + 2 * blockSize + iBlock));
+            store(outputPixel + iBlock, value);
+        }
+
+        for (size_t iBlock = vectorized; iBlock < blockSize; iBlock++)
+        {
+            outputPixel[iBlock] = std::max({window[iBlock], window[blockSize + iBlock], window[2 * blockSize + iBlock]});
+        }
+    }
+}
+
+IMAGEINFERENCE_VECTOR_TARGET void sumPixels(float *sum, const float *row, const size_t pixels, const size_t blockSize)
+{
+    const size_t vectorized = blockSize - blockSize % width;
+    for (size_t iBlock = 0; iBlock < vectorized; iBlock += width)
+    {
+        Vector accumulator = load(sum + iBlock);
+        for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+        {
+            accumulator = add(accumulator, load(row + iPixel * blockSize + iBlock));
+        }
+        store(sum + iBlock, accumulator);
+    }
+
+    for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+    {
+        for (size_t iBlock = vectorized; iBlock < blockSize; iBlock++)
+        {
+            sum[iBlock] += row[iPixel * blockSize + iBlock];
+        }
+    }
+}
+
+IMAGEINFERENCE_VECTOR_TARGET void biasReluBFloat16(ImageInference::types::BFloat16 *output, const float *row, const float *bias, const size_t pixels, const size_t blockSize)
+{
+    const size_t vectorized = blockSize - blockSize % width;
+    for (size_t iBlock = 0; iBlock < vectorized; iBlock += width)
+    {
+        const Vector biasVector = load(bias + iBlock);
+        for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+        {
+            const size_t offset = iPixel * blockSize + iBlock;
+            storeBFloat16(output + offset, max(add(load(row + offset), biasVector), zero()));
+        }
+    }
+
+    for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+    {
+        for (size_t iBlock = vectorized; iBlock < blockSize; iBlock++)
+        {
+            const size_t offset = iPixel * blockSize + iBlock;
+            output[offset] = std::max(row[offset] + bias[iBlock], 0.0f);
+        }
+    }
+}
+
+IMAGEINFERENCE_VECTOR_TARGET void biasAddReluBFloat16(ImageInference::types::BFloat16 *output, const float *row, const float *bias,
+                                                      const ImageInference::types::BFloat16 *addend, const size_t pixels, const size_t blockSize)
+{
+    const size_t vectorized = blockSize - blockSize % width;
+    for (size_t iBlock = 0; iBlock < vectorized; iBlock += width)
+    {
+        const Vector biasVector = load(bias + iBlock);
+        for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+        {
+            const size_t offset = iPixel * blockSize + iBlock;
+            storeBFloat16(output + offset, max(add(add(load(row + offset), loadBFloat16(addend + offset)), biasVector), zero()));
+        }
+    }
+
+    for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+    {
+        for (size_t iBlock = vectorized; iBlock < blockSize; iBlock++)
+        {
+            const size_t offset = iPixel * blockSize + iBlock;
+            output[offset] = std::max(row[offset] + static_cast<float>(addend[offset]) + bias[iBlock], 0.0f);
+        }
+    }
+}
+
+IMAGEINFERENCE_VECTOR_TARGET void requantizeRelu(uint8_t *output, const int32_t *row, const float *scale, const float *bias, const size_t pixels, const size_t blockSize)
+{
+    const size_t vectorized = blockSize - blockSize % width;
+    for (size_t iBlock = 0; iBlock < vectorized; iBlock += width)
+    {
+        const Vector scaleVector = load(scale + iBlock);
+        const Vector biasVector = load(bias + iBlock);
+        for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+        {
+            const size_t offset = iPixel * blockSize + iBlock;
+            storeUInt8(output + offset, max(add(mul(loadInt32(row + offset), scaleVector), biasVector), zero()));
+        }
+    }
+
+    for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+    {
+        for (size_t iBlock = vectorized; iBlock < blockSize; iBlock++)
+        {
+            const size_t offset = iPixel * blockSize + iBlock;
+            output[offset] = ImageInference::types::roundTo<uint8_t>(std::max(static_cast<float>(row[offset]) * scale[iBlock] + bias[iBlock], 0.0f));
+        }
+    }
+}
+
+IMAGEINFERENCE_VECTOR_TARGET void requantizeAddRelu(uint8_t *output, const int32_t *row, const float *scale, const float *bias,
+                                                    const uint8_t *addend, const float addendScale, const size_t pixels, const size_t blockSize)
+{
+    const size_t vectorized = blockSize - blockSize % width;
+    const Vector addendScaleVector = broadcast(addendScale);
+    for (size_t iBlock = 0; iBlock < vectorized; iBlock += width)
+    {
+        const Vector scaleVector = load(scale + iBlock);
+        const Vector biasVector = load(bias + iBlock);
+        for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+        {
+            const size_t offset = iPixel * blockSize + iBlock;
+            const Vector value = add(add(mul(loadInt32(row + offset), scaleVector), mul(loadUInt8(addend + offset), addendScaleVector)), biasVector);
+            storeUInt8(output + offset, max(value, zero()));
+        }
+    }
+
+    for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+    {
+        for (size_t iBlock = vectorized; iBlock < blockSize; iBlock++)
+        {
+            const size_t offset = iPixel * blockSize + iBlock;
+            const float value = static_cast<float>(row[offset]) * scale[iBlock] + static_cast<float>(addend[offset]) * addendScale + bias[iBlock];
+            output[offset] = ImageInference::types::roundTo<uint8_t>(std::max(value, 0.0f));
+        }
+    }
+}
+
+IMAGEINFERENCE_VECTOR_TARGET void requantizeProjectionRelu(uint8_t *output, const int32_t *row, const float *scale, const float *bias,
+                                                           const int32_t *projection, const float *projectionScale, const size_t pixels, const size_t blockSize)
+{
+    const size_t vectorized = blockSize - blockSize % width;
+    for (size_t iBlock = 0; iBlock < vectorized; iBlock += width)
+    {
+        const Vector scaleVector = load(scale + iBlock);
+        const Vector projectionScaleVector = load(projectionScale + iBlock);
+        const Vector biasVector = load(bias + iBlock);
+        for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+        {
+            const size_t offset = iPixel * blockSize + iBlock;
+            const Vector value = add(add(mul(loadInt32(row + offset), scaleVector), mul(loadInt32(projection + offset), projectionScaleVector)), biasVector);
+            storeUInt8(output + offset, max(value, zero()));
+        }
+    }
+
+    for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+    {
+        for (size_t iBlock = vectorized; iBlock < blockSize; iBlock++)
+        {
+            const size_t offset = iPixel * blockSize + iBlock;
+            const float value = static_cast<float>(row[offset]) * scale[iBlock] + static_cast<float>(projection[offset]) * projectionScale[iBlock] + bias[iBlock];
+            output[offset] = ImageInference::types::roundTo<uint8_t>(std::max(value, 0.0f));
+        }
+    }
+}
+
+IMAGEINFERENCE_VECTOR_TARGET void widenFloat16(float *output, const ImageInference::types::Float16 *input, const size_t count)
+{
+    const size_t vectorized = count - count % width;
+    for (size_t i = 0; i < vectorized; i += width)
+    {
+        store(output + i, loadFloat16(input + i));
+    }
+
+    for (size_t i = vectorized; i < count; i++)
+    {
+        output[i] = input[i];
+    }
+}
@@ -0,0 +1,222 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef IMAGEINFERENCE_WINOGRAD_H
+#define IMAGEINFERENCE_WINOGRAD_H
+
+#include "../types/Kernel.h"
+#include <vector>
+#include <stddef.h>
+
+namespace ImageInference
+{
+    namespace model
+    {
+        /// @brief The transforms of the Winograd convolution F(4x4, 3x3) from https://arxiv.org/abs/1509.09308
+        /// Y = A^T [(G g G^T) * (B^T d B)] A, with g the 3x3 kernel, d a 6x6 input tile and Y a 4x4 output tile.
+        ///
+        /// A 3x3 convolution with a stride of 1 needs 36 instead of 144 multiplications per output tile and channel,
+        /// the 36 element wise products are summed over the channels with one gemm per position of the tile.
+        /// The transformed kernel is stored as a Kernel with a height and width of 6,
+        /// so every position of the tile is a blocked BlockSizeChannel x BlockSizeCount matrix.
+        class Winograd
+        {
+        public:
+            /// @brief The size of an output tile.
+            static constexpr const size_t outputTile = 4;
+            /// @brief The size of an input tile and of the transformed kernel.
+            static constexpr const size_t inputTile = outputTile + 2;
+            /// @brief The number of positions of a transformed tile, every one is a separate gemm.
+            static constexpr const size_t positions = inputTile * inputTile;
+
+            /// @brief The number of tiles of an image, the last tiles are partial if the size is not a multiple of 4.
+            template <size_t Height, size_t Width>
+            static constexpr size_t tiles();
+
+            /// @brief The number of elements of the transformed input and the transformed output of a convolution.
+            template <size_t Channels, size_t Count, size_t Height, size_t Width>
+            static constexpr size_t scratchSize();
+
+            /// @brief Transforms the blocked 3x3 kernel with G g G^T into the blocked 6x6 kernel.
+            template <typename T, size_t BlockSizeCount, size_t BlockSizeChannel, size_t Count, size_t Channels>
+            static ImageInference::types::Kernel<T, BlockSizeCount, BlockSizeChannel, Count, Channels, inputTile, inputTile> transformKernel(
+                ImageInference::types::Kernel<T, BlockSizeCount, BlockSizeChannel, Count, Channels, 3, 3> &kernel);
+
+            /// @brief Transforms an input tile with B^T d B for every element of the block.
+            template <typename T, size_t BlockSize>
+            static void transformInput(const T (&tile)[inputTile][inputTile][BlockSize], T (&transformed)[inputTile][inputTile][BlockSize]);
+
+            /// @brief Transforms a tile of the products with A^T m A for every element of the block.
+            template <typename T, size_t BlockSize>
+            static void transformOutput(const T (&tile)[inputTile][inputTile][BlockSize], T (&transformed)[outputTile][outputTile][BlockSize]);
+        };
+
+        template <size_t Height, size_t Width>
+        constexpr size_t Winograd::tiles()
+        {
+            return ((Height + outputTile - 1) / outputTile) * ((Width + outputTile - 1) / outputTile);
+        }
+
+        template <size_t Channels, size_t Count, size_t Height, size_t Width>
+        constexpr size_t Winograd::scratchSize()
+        {
+            return positions * (Channels + Count) * tiles<Height, Width>();
+        }
+
+        template <typename T, size_t BlockSizeCount, size_t BlockSizeChannel, size_t Count, size_t Channels>
+        inline ImageInference::types::Kernel<T, BlockSizeCount, BlockSizeChannel, Count, Channels, Winograd::inputTile, Winograd::inputTile> Winograd::transformKernel(
+            ImageInference::types::Kernel<T, BlockSizeCount, BlockSizeChannel, Count, Channels, 3, 3> &kernel)
+        {
+            // The transformed kernel is written in the format Count x Channel x 6 x 6 and blocked by the Kernel constructor.
+            std::vector<T> transformed(Count * Channels * positions);
+            const T *kernelPtr = kernel.getPointer();
+
+#ifdef USE_OMP
+#pragma omp parallel for collapse(2)
+#endif // USE_OMP
+            for (size_t iCount = 0; iCount < Count; iCount++)
+            {
+                for (size_t iChannel = 0; iChannel < Channels; iChannel++)
+                {
+                    T g[3][3];
+                    for (size_t kHeight = 0; kHeight < 3; kHeight++)
+                    {
+                        for (size_t kWidth = 0; kWidth < 3; kWidth++)
+                        {
+                            g[kHeight][kWidth] = kernelPtr[kernel.getOffset(
+                                iCount / BlockSizeCount, iChannel / BlockSizeChannel, kHeight, kWidth,
+                                iChannel % BlockSizeChannel, iCount % BlockSizeCount)];
+                        }
+                    }
+
+                    // G g, then (G g) G^T
+                    T gg[inputTile][3];
+                    for (size_t kWidth = 0; kWidth < 3; kWidth++)
+                    {
+                        gg[0][kWidth] = g[0][kWidth] / 4;
+                        gg[1][kWidth] = -(g[0][kWidth] + g[1][kWidth] + g[2][kWidth]) / 6;
+                        gg[2][kWidth] = -(g[0][kWidth] - g[1][kWidth] + g[2][kWidth]) / 6;
+                        gg[3][kWidth] = g[0][kWidth] / 24 + g[1][kWidth] / 12 + g[2][kWidth] / 6;
+                        gg[4][kWidth] = g[0][kWidth] / 24 - g[1][kWidth] / 12 + g[2][kWidth] / 6;
+                        gg[5][kWidth] = g[2][kWidth];
+                    }
+
+                    T *u = transformed.data() + (iCount * Channels + iChannel) * positions;
+                    for (size_t iHeight = 0; iHeight < inputTile; iHeight++)
+                    {
+                        const T *row = gg[iHeight];
+                        u[iHeight * inputTile + 0] = row[0] / 4;
+                        u[iHeight * inputTile + 1] = -(row[0] + row[1] + row[2]) / 6;
+                        u[iHeight * inputTile + 2] = -(row[0] - row[1] + row[2]) / 6;
+                        u[iHeight * inputTile + 3] = row[0] / 24 + row[1] / 12 + row[2] / 6;
+                        u[iHeight * inputTile + 4] = row[0] / 24 - row[1] / 12 + row[2] / 6;
+                        u[iHeight * inputTile + 5] = row[2];
+                    }
+                }
+            }
+
+            return ImageInference::types::Kernel<T, BlockSizeCount, BlockSizeChannel, Count, Channels, inputTile, inputTile>(transformed.data());
+        }
+
+        template <typename T, size_t BlockSize>
+        inline void Winograd::transformInput(const T (&tile)[inputTile][inputTile][BlockSize], T (&transformed)[inputTile][inputTile][BlockSize])
+        {
+            // B^T d
+            T temp[inputTile][inputTile][BlockSize];
+            for (size_t iWidth = 0; iWidth < inputTile; iWidth++)
+            {
+#ifdef USE_OMP
+#pragma omp simd
+#endif // USE_OMP
+                for (size_t i = 0; i < BlockSize; i++)
+                {
+                    const T d0 = tile[0][iWidth][i];
+                    const T d1 = tile[1][iWidth][i];
+                    const T d2 = tile[2][iWidth][i];
+                    const T d3 = tile[3][iWidth][i];
+                    const T d4 = tile[4][iWidth][i];
+                    const T d5 = tile[5][iWidth][i];
+                    temp[0][iWidth][i] = 4 * d0 - 5 * d2 + d4;
+                    temp[1][iWidth][i] = -4 * d1 - 4 * d2 + d3 + d4;
+                    temp[2][iWidth][i] = 4 * d1 - 4 * d2 - d3 + d4;
+                    temp[3][iWidth][i] = -2 * d1 - d2 + 2 * d3 + d4;
+                    temp[4][iWidth][i] = 2 * d1 - d2 - 2 * d3 + d4;
+                    temp[5][iWidth][i] = 4 * d1 - 5 * d3 + d5;
+                }
+            }
+
+            // (B^T d) B
+            for (size_t iHeight = 0; iHeight < inputTile; iHeight++)
+            {
+#ifdef USE_OMP
+#pragma omp simd
+#endif // USE_OMP
+                for (size_t i = 0; i < BlockSize; i++)
+                {
+                    const T d0 = temp[iHeight][0][i];
+                    const T d1 = temp[iHeight][1][i];
+                    const T d2 = temp[iHeight][2][i];
+                    const T d3 = temp[iHeight][3][i];
+                    const T d4 = temp[iHeight][4][i];
+                    const T d5 = temp[iHeight][5][i];
+                    transformed[iHeight][0][i] = 4 * d0 - 5 * d2 + d4;
+                    transformed[iHeight][1][i] = -4 * d1 - 4 * d2 + d3 + d4;
+                    transformed[iHeight][2][i] = 4 * d1 - 4 * d2 - d3 + d4;
+                    transformed[iHeight][3][i] = -2 * d1 - d2 + 2 * d3 + d4;
+                    transformed[iHeight][4][i] = 2 * d1 - d2 - 2 * d3 + d4;
+                    transformed[iHeight][5][i] = 4 * d1 - 5 * d3 + d5;
+                }
+            }
+        }
+
+        template <typename T, size_t BlockSize>
+        inline void Winograd::transformOutput(const T (&tile)[inputTile][inputTile][BlockSize], T (&transformed)[outputTile][outputTile][BlockSize])
+        {
+            // A^T m
+            T temp[outputTile][inputTile][BlockSize];
+            for (size_t iWidth = 0; iWidth < inputTile; iWidth++)
+            {
+#ifdef USE_OMP
+#pragma omp simd
+#endif // USE_OMP
+                for (size_t i = 0; i < BlockSize; i++)
+                {
+                    const T m0 = tile[0][iWidth][i];
+                    const T m1 = tile[1][iWidth][i];
+                    const T m2 = tile[2][iWidth][i];
+                    const T m3 = tile[3][iWidth][i];
+                    const T m4 = tile[4][iWidth][i];
+                    const T m5 = tile[5][iWidth][i];
+                    temp[0][iWidth][i] = m0 + m1 + m2 + m3 + m4;
+                    temp[1][iWidth][i] = m1 - m2 + 2 * m3 - 2 * m4;
+                    temp[2][iWidth][i] = m1 + m2 + 4 * m3 + 4 * m4;
+                    temp[3][iWidth][i] = m1 - m2 + 8 * m3 - 8 * m4 + m5;
+                }
+            }
+
+            // (A^T m) A
+            for (size_t iHeight = 0; iHeight < outputTile; iHeight++)
+            {
+#ifdef USE_OMP
+#pragma omp simd
+#endif // USE_OMP
+                for (size_t i = 0; i < BlockSize; i++)
+                {
+                    const T m0 = temp[iHeight][0][i];
+                    const T m1 = temp[iHeight][1][i];
+                    const T m2 = temp[iHeight][2][i];
+                    const T m3 = temp[iHeight][3][i];
+                    const T m4 = temp[iHeight][4][i];
+                    const T m5 = temp[iHeight][5][i];
+                    transformed[iHeight][0][i] = m0 + m1 + m2 + m3 + m4;
+                    transformed[iHeight][1][i] = m1 - m2 + 2 * m3 - 2 * m4;
+                    transformed[iHeight][2][i] = m1 + m2 + 4 * m3 + 4 * m4;
+                    transformed[iHeight][3][i] = m1 - m2 + 8 * m3 - 8 * m4 + m5;
+                }
+            }
+        }
+    } // namespace model
+} // namespace ImageInference
+
+#endif // IMAGEINFERENCE_WINOGRAD_H
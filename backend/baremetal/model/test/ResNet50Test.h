@@ -6,12 +6,16 @@
 #define IMAGEINFERENCE_RESNET50TEST_H
 
 #include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
 #include "../../types/Image.h"
 #include "../../types/Kernel.h"
 #include "../../types/Array.h"
 #include "../../types/BatchNorm.h"
 #include "../../types/Matrix.h"
 #include "../ResNet50.h"
+#include "../ResNet50Weights.h"
 
 namespace ImageInference
 {
@@ -25,10 +29,87 @@ namespace ImageInference
                 ResNet50Test();
                 ~ResNet50Test();
 
-                static void block0(ImageInference::model::ResNet50 &resnet50, const float *input, float *output);
-                static void block1(ImageInference::model::ResNet50 &resnet50, const float *input, float *output);
-                static void block2(ImageInference::model::ResNet50 &resnet50, const float *input, float *output);
-                static void block3(ImageInference::model::ResNet50 &resnet50, const float *input, float *output);
+                /// The blocks read the input in TInBlockSize and write the output in TBlockSize, so they also test the reblocking between layers.
+                template <size_t TInBlockSize = 16UL, size_t TBlockSize = 16UL>
+                static void block0(ImageInference::model::ResNet50 &resnet50, const float *input, float *output)
+                {
+                    ImageInference::types::Image<float, 0, TInBlockSize, 64UL, 56UL, 56UL> inputImage(input);
+                    auto weights = ImageInference::model::ResNet50Layer1<float, TInBlockSize, TBlockSize>(resnet50.modelWeights, ImageInference::types::KernelLayout::OIHW);
+                    auto activations = ImageInference::model::ResNet50Activations<float>();
+                    // The layer reads its input from the activations like in the forward pass.
+                    std::copy(inputImage.getPointer(), inputImage.getPointer() + inputImage.size, activations.get(activations.maxPool));
+                    weights.inference(activations, nullptr);
+                    auto outputImage = ImageInference::types::Image<float, 0, TBlockSize, 256UL, 56UL, 56UL>::view(activations.get(activations.layer1.back().output));
+                    auto flatten = outputImage.flatten(); // Get the data order of Channel x Height x Width
+                    std::copy(flatten.getPointer(), flatten.getPointer() + flatten.size, output);
+                }
+
+                template <size_t TInBlockSize = 16UL, size_t TBlockSize = 16UL>
+                static void block1(ImageInference::model::ResNet50 &resnet50, const float *input, float *output)
+                {
+                    ImageInference::types::Image<float, 0, TInBlockSize, 256UL, 56UL, 56UL> inputImage(input);
+                    auto weights = ImageInference::model::ResNet50Layer2<float, TInBlockSize, TBlockSize>(resnet50.modelWeights, ImageInference::types::KernelLayout::OIHW);
+                    auto activations = ImageInference::model::ResNet50Activations<float>();
+                    // The layer reads its input from the activations like in the forward pass.
+                    std::copy(inputImage.getPointer(), inputImage.getPointer() + inputImage.size, activations.get(activations.layer1.back().output));
+                    weights.inference(activations, nullptr);
+                    auto outputImage = ImageInference::types::Image<float, 0, TBlockSize, 512UL, 28UL, 28UL>::view(activations.get(activations.layer2.back().output));
+                    auto flatten = outputImage.flatten(); // Get the data order of Channel x Height x Width
+                    std::copy(flatten.getPointer(), flatten.getPointer() + flatten.size, output);
+                }
+
+                template <size_t TInBlockSize = 16UL, size_t TBlockSize = 16UL>
+                static void block2(ImageInference::model::ResNet50 &resnet50, const float *input, float *output)
+                {
+                    ImageInference::types::Image<float, 0, TInBlockSize, 512UL, 28UL, 28UL> inputImage(input);
+                    auto weights = ImageInference::model::ResNet50Layer3<float, TInBlockSize, TBlockSize>(resnet50.modelWeights, ImageInference::types::KernelLayout::OIHW);
+                    auto activations = ImageInference::model::ResNet50Activations<float>();
+                    // The layer reads its input from the activations like in the forward pass.
+                    std::copy(inputImage.getPointer(), inputImage.getPointer() + inputImage.size, activations.get(activations.layer2.back().output));
+                    weights.inference(activations, nullptr);
+                    auto outputImage = ImageInference::types::Image<float, 0, TBlockSize, 1024UL, 14UL, 14UL>::view(activations.get(activations.layer3.back().output));
+                    auto flatten = outputImage.flatten(); // Get the data order of Channel x Height x Width
+                    std::copy(flatten.getPointer(), flatten.getPointer() + flatten.size, output);
+                }
+
+                template <size_t TInBlockSize = 16UL, size_t TBlockSize = 16UL>
+                static void block3(ImageInference::model::ResNet50 &resnet50, const float *input, float *output)
+                {
+                    ImageInference::types::Image<float, 0, TInBlockSize, 1024UL, 14UL, 14UL> inputImage(input);
+                    auto weights = ImageInference::model::ResNet50Layer4<float, TInBlockSize, TBlockSize>(resnet50.modelWeights, ImageInference::types::KernelLayout::OIHW);
+                    auto activations = ImageInference::model::ResNet50Activations<float>();
+                    // The layer reads its input from the activations like in the forward pass.
+                    std::copy(inputImage.getPointer(), inputImage.getPointer() + inputImage.size, activations.get(activations.layer3.back().output));
+                    weights.inference(activations, nullptr);
+                    auto outputImage = ImageInference::types::Image<float, 0, TBlockSize, 2048UL, 7UL, 7UL>::view(activations.get(activations.layer4.back().output));
+                    auto flatten = outputImage.flatten(); // Get the data order of Channel x Height x Width
+                    std::copy(flatten.getPointer(), flatten.getPointer() + flatten.size, output);
+                }
+
+                /// Runs the second bottleneck of layer1 once fused on bands of rows and once convolution by convolution.
+                template <size_t TBlockSize = 16UL>
+                static void bottleneckFused(ImageInference::model::ResNet50 &resnet50, const float *input, float *outputFused, float *output)
+                {
+                    ImageInference::types::Image<float, 0, TBlockSize, 256UL, 56UL, 56UL> inputImage(input);
+                    auto weights = ImageInference::model::ResNet50Layer1<float, TBlockSize, TBlockSize>(resnet50.modelWeights, ImageInference::types::KernelLayout::OIHW);
+                    auto &bottleneck = weights.layer1_1;
+
+                    auto activations = ImageInference::model::ResNet50Activations<float>();
+                    auto outputFusedImage = ImageInference::types::Image<float, 0, TBlockSize, 256UL, 56UL, 56UL>();
+                    ImageInference::model::ResNet50::bottleneckFused(bottleneck, activations, inputImage, outputFusedImage, nullptr);
+
+                    auto reduceImage = ImageInference::types::Image<float, 1, TBlockSize, 64UL, 56UL, 56UL>(ImageInference::types::ImageInitialization::Padding);
+                    ImageInference::model::ResNet50::convBlock<1>(inputImage, bottleneck.kernel1, bottleneck.batchNorm1, reduceImage);
+                    auto spatialImage = ImageInference::types::Image<float, 0, TBlockSize, 64UL, 56UL, 56UL>();
+                    ImageInference::model::ResNet50::convBlock<1>(reduceImage, bottleneck.kernel2, bottleneck.batchNorm2, spatialImage);
+                    auto outputImage = ImageInference::types::Image<float, 0, TBlockSize, 256UL, 56UL, 56UL>();
+                    ImageInference::model::ResNet50::convBlockAddIdentity(spatialImage, bottleneck.kernel3, bottleneck.batchNorm3, inputImage, outputImage);
+
+                    auto flattenFused = outputFusedImage.flatten(); // Get the data order of Channel x Height x Width
+                    std::copy(flattenFused.getPointer(), flattenFused.getPointer() + flattenFused.size, outputFused);
+                    auto flatten = outputImage.flatten();
+                    std::copy(flatten.getPointer(), flatten.getPointer() + flatten.size, output);
+                }
 
                 template <size_t TStride, size_t TInPadding, size_t TBlockSize,
                           size_t TOutChannels, size_t TInChannels,
@@ -46,6 +127,52 @@ namespace ImageInference
                     std::copy(flatten.getPointer(), flatten.getPointer() + flatten.size, output);
                 }
 
+                template <size_t TStride, size_t TBlockSize,
+                          size_t TOutChannels, size_t TInChannels,
+                          size_t THeight, size_t TWidth,
+                          size_t TKernelHeight, size_t TKernelWidth>
+                static void convBlockPlanar(const float *input, const float *kernel, const float *batchGamma, const float *batchBeta, const float *batchMean, const float *batchVariance, float *output)
+                {
+                    ImageInference::types::Kernel<float, TBlockSize, TInChannels, TOutChannels, TInChannels, TKernelHeight, TKernelWidth> inputKernel(kernel);
+                    ImageInference::types::BatchNorm<float, TOutChannels> batchNorm(batchGamma, batchBeta, batchMean, batchVariance);
+
+                    auto outputImage = ImageInference::types::Image<float, 1, TBlockSize, TOutChannels, THeight / TStride, TWidth / TStride>(ImageInference::types::ImageInitialization::Padding);
+                    ImageInference::model::ResNet50::convBlockPlanar<TStride, THeight, TWidth>(input, inputKernel, batchNorm, outputImage);
+                    auto flatten = outputImage.flatten(); // Get the data order of Channel x Height x Width
+                    std::copy(flatten.getPointer(), flatten.getPointer() + flatten.size, output);
+                }
+
+                template <size_t TStride, size_t TBlockSize,
+                          size_t TOutChannels, size_t TInChannels,
+                          size_t THeight, size_t TWidth,
+                          size_t TKernelHeight, size_t TKernelWidth>
+                static void convBlockPlanarMaxPool(const float *input, const float *kernel, const float *batchGamma, const float *batchBeta, const float *batchMean, const float *batchVariance, float *output)
+                {
+                    ImageInference::types::Kernel<float, TBlockSize, TInChannels, TOutChannels, TInChannels, TKernelHeight, TKernelWidth> inputKernel(kernel);
+                    ImageInference::types::BatchNorm<float, TOutChannels> batchNorm(batchGamma, batchBeta, batchMean, batchVariance);
+
+                    auto outputImage = ImageInference::types::Image<float, 0, TBlockSize, TOutChannels, THeight / TStride / 2, TWidth / TStride / 2>();
+                    ImageInference::model::ResNet50::convBlockPlanarMaxPool<TStride, THeight, TWidth>(input, inputKernel, batchNorm, outputImage);
+                    auto flatten = outputImage.flatten(); // Get the data order of Channel x Height x Width
+                    std::copy(flatten.getPointer(), flatten.getPointer() + flatten.size, output);
+                }
+
+                template <size_t TBlockSize,
+                          size_t TOutChannels, size_t TInChannels,
+                          size_t THeight, size_t TWidth>
+                static void convBlockWinograd(const float *input, const float *kernel, const float *batchGamma, const float *batchBeta, const float *batchMean, const float *batchVariance, float *output)
+                {
+                    ImageInference::types::Image<float, 1, TBlockSize, TInChannels, THeight, TWidth> inputImage(input);
+                    ImageInference::types::Kernel<float, TBlockSize, TBlockSize, TOutChannels, TInChannels, 3, 3> inputKernel(kernel);
+                    auto winogradKernel = ImageInference::model::Winograd::transformKernel(inputKernel);
+                    ImageInference::types::BatchNorm<float, TOutChannels> batchNorm(batchGamma, batchBeta, batchMean, batchVariance);
+
+                    auto outputImage = ImageInference::types::Image<float, 0, TBlockSize, TOutChannels, THeight, TWidth>(ImageInference::types::ImageInitialization::Padding);
+                    ImageInference::model::ResNet50::convBlockWinograd(inputImage, winogradKernel, batchNorm, outputImage);
+                    auto flatten = outputImage.flatten(); // Get the data order of Channel x Height x Width
+                    std::copy(flatten.getPointer(), flatten.getPointer() + flatten.size, output);
+                }
+
                 template <size_t TInPadding, size_t TBlockSize,
                           size_t TOutChannels, size_t TInChannels,
                           size_t THeight, size_t TWidth,
@@ -136,11 +263,30 @@ namespace ImageInference
                     std::copy(biasAccumulator.getPointer(), biasAccumulator.getPointer() + biasAccumulator.size, output);
                 }
 
+                /// The input holds the TBatch images one after the other.
+                template <size_t TBatch, size_t TInPadding, size_t TBlockSize,
+                          size_t TInChannels, size_t THeight, size_t TWidth, size_t TColumns>
+                static void globalAveragePoolFullyConnected(const float *input, const float *weight, const float *bias, float *output)
+                {
+                    using InputImage = ImageInference::types::Image<float, TInPadding, TBlockSize, TInChannels, THeight, TWidth>;
+                    std::vector<std::unique_ptr<InputImage>> inputImages;
+                    std::array<InputImage *, TBatch> images;
+                    for (size_t iBatch = 0; iBatch < TBatch; iBatch++)
+                    {
+                        inputImages.push_back(std::make_unique<InputImage>(input + iBatch * TInChannels * THeight * TWidth));
+                        images[iBatch] = inputImages.back().get();
+                    }
+                    auto weightMatrix = ImageInference::types::Matrix<float, TInChannels, TColumns>::transposed(weight);
+                    ImageInference::types::Array<float, TColumns> biasArray(bias);
+
+                    ResNet50::globalAveragePoolFullyConnected(images, weightMatrix, biasArray, output);
+                }
+
                 static float relu(float input);
 
                 static float batchNorm(float input, float gammaVariance, float beta, float mean);
 
-                static float *getWeight(ImageInference::model::ResNet50 resnet50, size_t index);
+                static float *getWeight(ImageInference::model::ResNet50 &resnet50, size_t index);
             };
         }
     }
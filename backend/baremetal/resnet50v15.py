@@ -12,7 +12,7 @@ from torchvision.models import ResNet50_Weights
 from torchvision.models._api import WeightsEnum
 from executorch.examples.portable.utils import export_to_exec_prog, _core_aten_to_edge, _to_core_aten
 from executorch.exir import EdgeCompileConfig
-from .resnet50v15_module import custom_resnet50
+from .resnet50v15_module import custom_resnet50, custom_resnet50_int8
 from . import export_utils
 from torch._export import capture_pre_autograd_graph
 from torch.export import export, ExportedProgram
@@ -34,8 +34,32 @@ if __name__ == "__main__":
         "--quantize",
         required=False,
         default=False,
-        help="Flag for producing quantized or floating-point model",
-        choices=["false"],
+        help="Flag for producing quantized or floating-point model. bf16 computes the layers in BFloat16 and needs blocked weights. "
+        "int8 quantizes the layers with the scales of the --calibration file.",
+        choices=["false", "bf16", "int8"],
+    )
+    parser.add_argument(
+        "-c",
+        "--calibration",
+        required=False,
+        default=None,
+        help="The calibration file with the scales of the activations for int8, see export_utils.writeCalibration.",
+    )
+    parser.add_argument(
+        "-b",
+        "--block_size",
+        required=False,
+        type=int,
+        default=32,
+        help="Stores the convolution weights blocked for this block size, needs to match RESNET50_BLOCK_SIZE. Use 0 for the plain layout.",
+    )
+    parser.add_argument(
+        "-n",
+        "--batch_size",
+        required=False,
+        type=int,
+        default=1,
+        help="The number of images the exported program classifies per call.",
     )
     args = parser.parse_args()
 
@@ -63,12 +87,29 @@ if __name__ == "__main__":
     # Registering a opaque operator for the custom implementation to not trace into it
     @torch.library.register_fake("baremetal_ops::resnet50")
     def _(input: torch.Tensor, weights: torch.Tensor) -> torch.Tensor:
-        return torch.zeros([1, 1000])
+        return torch.zeros([input.shape[0], 1000])
+
+    @torch.library.register_fake("baremetal_ops::resnet50_int8")
+    def _(input: torch.Tensor, weights: torch.Tensor, scales: torch.Tensor) -> torch.Tensor:
+        return torch.zeros([input.shape[0], 1000])
 
     # Lowering the Model with Executorch
     parameters = export_utils.getResnet50Weights(ResNet50_Weights.IMAGENET1K_V2)
-    model = custom_resnet50(export_utils.compressParameters(parameters))
-    sample_input = (torch.randn(1, 3, 224, 224),)
+    blockSize = args.block_size if args.block_size > 0 else None
+    scalarType = {"bf16": export_utils.SCALAR_TYPE_BFLOAT16, "int8": export_utils.SCALAR_TYPE_INT8}.get(args.quantize, export_utils.SCALAR_TYPE_FLOAT)
+    if scalarType == export_utils.SCALAR_TYPE_BFLOAT16 and blockSize is None:
+        parser.error("--quantize bf16 needs blocked weights, use a --block_size greater than 0")
+    if scalarType == export_utils.SCALAR_TYPE_INT8:
+        if args.calibration is None:
+            parser.error("--quantize int8 needs the scales of the activations, use --calibration")
+        # The plain layout can only store float, the int8 op quantizes the weights either way.
+        if blockSize is None:
+            scalarType = export_utils.SCALAR_TYPE_FLOAT
+        model = custom_resnet50_int8(export_utils.compressParameters(parameters, blockSize, scalarType),
+                                     export_utils.readCalibration(args.calibration))
+    else:
+        model = custom_resnet50(export_utils.compressParameters(parameters, blockSize, scalarType))
+    sample_input = (torch.randn(args.batch_size, 3, 224, 224),)
 
     exec_program = export_to_exec_prog(
         model,
@@ -23,3 +23,23 @@ class custom_resnet50(torch.nn.Module):
 
     def forward(self, x: Tensor) -> Tensor:
         return self._forward_impl(x)
+
+
+class custom_resnet50_int8(torch.nn.Module):
+
+    weight: Tensor
+    scales: Tensor
+
+    def __init__(self, compressedParameters: Dict[str, Optional[Parameter]], scales: Tensor):
+        super(custom_resnet50_int8, self).__init__()
+
+        self._parameters = compressedParameters
+        self.weight = self.get_parameter("weight")
+        # The scales of the activations, see export_utils.calibrateActivations
+        self.register_buffer("scales", scales)
+
+    def _forward_impl(self, x: Tensor) -> Tensor:
+        return torch.ops.baremetal_ops.resnet50_int8.default(x, self.weight, self.scales)
+
+    def forward(self, x: Tensor) -> Tensor:
+        return self._forward_impl(x)
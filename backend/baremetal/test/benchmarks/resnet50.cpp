@@ -10,7 +10,13 @@
 #include <torch/library.h>
 #include <iostream>
 #include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
 #include "../../model/test/ResNet50Test.h"
+#include "../../model/ResNet50Throughput.h"
+#include "../../model/ResNet50Tuning.h"
+#include "../utils/Reader.h"
 #include <benchmark/benchmark.h>
 
 namespace ImageInference
@@ -355,6 +361,172 @@ namespace ImageInference
             }
         };
 
+        template <ImageInference::model::VectorIsa TIsa, size_t TBlockSize, size_t TPixels>
+        class VectorKernelsFixture : public benchmark::Fixture
+        {
+        public:
+            constexpr static ImageInference::model::VectorIsa isa = TIsa;
+            constexpr static size_t blockSize = TBlockSize;
+            constexpr static size_t pixels = TPixels;
+
+            Tensor row;
+            Tensor addend;
+            Tensor bias;
+
+            float *rowPtr;
+            float *addendPtr;
+            float *biasPtr;
+
+            const ImageInference::model::VectorKernels *kernels;
+
+            VectorKernelsFixture() {}
+            ~VectorKernelsFixture() {}
+
+            void SetUp(::benchmark::State &state)
+            {
+                // The stride 2 pooling reads 2 x pixels + 1 pixels of the row.
+                row = at::randn({2 * pixels + 1, blockSize});
+                addend = at::randn({pixels, blockSize});
+                bias = at::randn({blockSize});
+
+                rowPtr = row.mutable_data_ptr<float>();
+                addendPtr = addend.mutable_data_ptr<float>();
+                biasPtr = bias.mutable_data_ptr<float>();
+
+                kernels = ImageInference::model::VectorKernels::supported(isa) ? &ImageInference::model::VectorKernels::get(isa) : nullptr;
+            }
+
+            void TearDown(::benchmark::State &state)
+            {
+            }
+        };
+
+        /// @brief Measures a stage of the ResNet50, i.e. the stem or a layer, for an input block size and a block size.
+        /// The times are collected for Autotune_Store, which writes the fastest block sizes into the tuning file.
+        ///
+        /// Args: stage, input block size, block size. The weights are read from the test data in PROJECT_ROOT.
+        class AutotuneFixture : public benchmark::Fixture
+        {
+        public:
+            /// @brief The measured times in seconds, negative if not measured.
+            static ImageInference::model::ResNet50Tuning::StageTimes times;
+
+            size_t stage;
+            size_t inBlockSizeIndex;
+            size_t blockSizeIndex;
+
+            Tensor in;
+            float *inPtr;
+
+            std::shared_ptr<ImageInference::model::LibxsmmRuntime> runtime;
+            std::unique_ptr<ImageInference::model::ResNet50Weights<float>> weights;
+            std::unique_ptr<ImageInference::model::ResNet50Activations<float>> activations;
+
+            static const std::vector<void *> &modelWeights()
+            {
+                static std::unique_ptr<ImageInference::test::utils::Reader> reader;
+                static std::vector<void *> weightPtrs;
+                if (!reader)
+                {
+                    const char *projectDirectory = std::getenv("PROJECT_ROOT");
+                    if (projectDirectory == nullptr)
+                    {
+                        throw std::runtime_error("PROJECT_ROOT environment variable is not set");
+                    }
+
+                    reader = std::make_unique<ImageInference::test::utils::Reader>(std::string(projectDirectory) + "/test_data/resnet50_weights_v2.bin");
+                    while (reader->hasNext())
+                    {
+                        std::vector<int64_t> sizes;
+                        weightPtrs.push_back(reader->getNextTensor(sizes));
+                    }
+                }
+                return weightPtrs;
+            }
+
+            static size_t supportedIndex(const size_t blockSize)
+            {
+                const auto &supported = ImageInference::model::ResNet50BlockSizes::supported;
+                return std::find(supported.begin(), supported.end(), blockSize) - supported.begin();
+            }
+
+            void SetUp(::benchmark::State &state)
+            {
+                stage = state.range(0);
+                const size_t inBlockSize = state.range(1);
+                const size_t blockSize = state.range(2);
+                inBlockSizeIndex = supportedIndex(inBlockSize);
+                blockSizeIndex = supportedIndex(blockSize);
+
+                // The stages in front of the measured one use the input block size, the stages behind it the block size.
+                ImageInference::model::ResNet50BlockSizes blockSizes;
+                size_t *stageBlockSizes[] = {&blockSizes.stem, &blockSizes.layer1, &blockSizes.layer2, &blockSizes.layer3, &blockSizes.layer4};
+                for (size_t iStage = 0; iStage < ImageInference::model::ResNet50Tuning::stages; iStage++)
+                {
+                    *stageBlockSizes[iStage] = iStage < stage ? inBlockSize : blockSize;
+                }
+
+                runtime = ImageInference::model::LibxsmmRuntime::acquire();
+                weights = std::make_unique<ImageInference::model::ResNet50Weights<float>>(modelWeights(), ImageInference::types::KernelLayout::OIHW, blockSizes);
+                activations = std::make_unique<ImageInference::model::ResNet50Activations<float>>();
+
+                // The input of a layer is the output of the previous stage.
+                const size_t inputId = stage == 0   ? 0
+                                       : stage == 1 ? activations->maxPool
+                                       : stage == 2 ? activations->layer1.back().output
+                                       : stage == 3 ? activations->layer2.back().output
+                                                    : activations->layer3.back().output;
+                in = stage == 0 ? at::rand({3, 224, 224}) : at::rand({static_cast<int64_t>(activations->getSize(inputId))});
+                inPtr = in.mutable_data_ptr<float>();
+                if (stage != 0)
+                {
+                    std::copy(inPtr, inPtr + in.numel(), activations->get(inputId));
+                }
+            }
+
+            void TearDown(::benchmark::State &state)
+            {
+                activations.reset();
+                weights.reset();
+                runtime.reset();
+            }
+
+            void runStage()
+            {
+                switch (stage)
+                {
+                case 0:
+                    weights->stem->inference(inPtr, *activations, &weights->gemmKernels);
+                    break;
+                case 1:
+                    weights->layer1->inference(*activations, &weights->gemmKernels);
+                    break;
+                case 2:
+                    weights->layer2->inference(*activations, &weights->gemmKernels);
+                    break;
+                case 3:
+                    weights->layer3->inference(*activations, &weights->gemmKernels);
+                    break;
+                default:
+                    weights->layer4->inference(*activations, &weights->gemmKernels);
+                    break;
+                }
+            }
+        };
+
+        ImageInference::model::ResNet50Tuning::StageTimes AutotuneFixture::times = []()
+        {
+            ImageInference::model::ResNet50Tuning::StageTimes times;
+            for (auto &stageTimes : times)
+            {
+                for (auto &inBlockSizeTimes : stageTimes)
+                {
+                    inBlockSizeTimes.fill(-1.0);
+                }
+            }
+            return times;
+        }();
+
         // Args: TStride, TInPadding, TBlockSize, TOutChannels, TInChannels, THeight, TWidth, TKernelHeight, TKernelWidth
         BENCHMARK_TEMPLATE_F(ConvolutionFixture, Convolution_Custom, 1, 1, 32, 64, 64, 224, 224, 3, 3)
         (benchmark::State &st)
@@ -419,6 +591,22 @@ namespace ImageInference
             }
         };
 
+        // The folded batch norms of the model, where the projection is accumulated into the output.
+        // Args: TStride, TInPadding, TBlockSize, TOutChannels, TInChannels, TShortcutChannels, THeight, TWidth, TKernelHeight, TKernelWidth
+        BENCHMARK_TEMPLATE_F(ConvolutionProjectionFixture, Convolution_Projection_Folded_Custom, 1, 1, 32, 64, 64, 32, 224, 224, 3, 3)
+        (benchmark::State &st)
+        {
+            ImageInference::types::Kernel<float, blockSize, blockSize, outChannels, inChannels, kernelHeight, kernelWidth> inputKernel(weightPtr);
+            ImageInference::types::BatchNorm<float, outChannels, true> batchNorm(batchGammaPtr, batchBetaPtr, batchMeanPtr, batchVarPtr);
+            ImageInference::types::Kernel<float, blockSize, blockSize, outChannels, outChannels / shortcutDimExpand, 1, 1> projectionKernel(projectionWeightPtr);
+            ImageInference::types::BatchNorm<float, outChannels, true> projectionBatchNorm(projectionBatchGammaPtr, projectionBatchBetaPtr, projectionBatchMeanPtr, projectionBatchVarPtr);
+
+            for (auto _ : st)
+            {
+                ImageInference::model::ResNet50::convBlockAddProjection<stride, shortcutDimExpand>(*inputImage, inputKernel, batchNorm, *shortcutImage, projectionKernel, projectionBatchNorm, *outputImage);
+            }
+        };
+
         // Args: TStride, TInPadding, TBlockSize, TOutChannels, TInChannels, TShortcutChannels, THeight, TWidth, TKernelHeight, TKernelWidth
         BENCHMARK_TEMPLATE_F(ConvolutionProjectionFixture, Convolution_Projection_ATen, 1, 1, 32, 64, 64, 32, 224, 224, 3, 3)
         (benchmark::State &st)
@@ -492,5 +680,247 @@ namespace ImageInference
                 Tensor expected = at::linear(in, weight, bias);
             }
         };
+
+        // Args: TIsa, TBlockSize, TPixels
+        BENCHMARK_TEMPLATE_F(VectorKernelsFixture, VectorKernels_BiasAddRelu_Scalar, ImageInference::model::VectorIsa::Scalar, 32, 56)
+        (benchmark::State &st)
+        {
+            if (kernels == nullptr)
+            {
+                st.SkipWithError("The host does not support the instruction set.");
+                return;
+            }
+
+            for (auto _ : st)
+            {
+                kernels->biasAddRelu(rowPtr, biasPtr, addendPtr, pixels, blockSize);
+                benchmark::ClobberMemory();
+            }
+        };
+
+        // Args: TIsa, TBlockSize, TPixels
+        BENCHMARK_TEMPLATE_F(VectorKernelsFixture, VectorKernels_BiasAddRelu_SSE4, ImageInference::model::VectorIsa::SSE4, 32, 56)
+        (benchmark::State &st)
+        {
+            if (kernels == nullptr)
+            {
+                st.SkipWithError("The host does not support the instruction set.");
+                return;
+            }
+
+            for (auto _ : st)
+            {
+                kernels->biasAddRelu(rowPtr, biasPtr, addendPtr, pixels, blockSize);
+                benchmark::ClobberMemory();
+            }
+        };
+
+        // Args: TIsa, TBlockSize, TPixels
+        BENCHMARK_TEMPLATE_F(VectorKernelsFixture, VectorKernels_BiasAddRelu_AVX2, ImageInference::model::VectorIsa::AVX2, 32, 56)
+        (benchmark::State &st)
+        {
+            if (kernels == nullptr)
+            {
+                st.SkipWithError("The host does not support the instruction set.");
+                return;
+            }
+
+            for (auto _ : st)
+            {
+                kernels->biasAddRelu(rowPtr, biasPtr, addendPtr, pixels, blockSize);
+                benchmark::ClobberMemory();
+            }
+        };
+
+        // Args: TIsa, TBlockSize, TPixels
+        BENCHMARK_TEMPLATE_F(VectorKernelsFixture, VectorKernels_BiasAddRelu_AVX512, ImageInference::model::VectorIsa::AVX512, 32, 56)
+        (benchmark::State &st)
+        {
+            if (kernels == nullptr)
+            {
+                st.SkipWithError("The host does not support the instruction set.");
+                return;
+            }
+
+            for (auto _ : st)
+            {
+                kernels->biasAddRelu(rowPtr, biasPtr, addendPtr, pixels, blockSize);
+                benchmark::ClobberMemory();
+            }
+        };
+
+        // Args: TIsa, TBlockSize, TPixels
+        BENCHMARK_TEMPLATE_F(VectorKernelsFixture, VectorKernels_MaxPoolRow_Scalar, ImageInference::model::VectorIsa::Scalar, 32, 56)
+        (benchmark::State &st)
+        {
+            if (kernels == nullptr)
+            {
+                st.SkipWithError("The host does not support the instruction set.");
+                return;
+            }
+
+            for (auto _ : st)
+            {
+                kernels->maxPoolRow(addendPtr, rowPtr, pixels, 2, blockSize);
+                benchmark::ClobberMemory();
+            }
+        };
+
+        // Args: TIsa, TBlockSize, TPixels
+        BENCHMARK_TEMPLATE_F(VectorKernelsFixture, VectorKernels_MaxPoolRow_SSE4, ImageInference::model::VectorIsa::SSE4, 32, 56)
+        (benchmark::State &st)
+        {
+            if (kernels == nullptr)
+            {
+                st.SkipWithError("The host does not support the instruction set.");
+                return;
+            }
+
+            for (auto _ : st)
+            {
+                kernels->maxPoolRow(addendPtr, rowPtr, pixels, 2, blockSize);
+                benchmark::ClobberMemory();
+            }
+        };
+
+        // Args: TIsa, TBlockSize, TPixels
+        BENCHMARK_TEMPLATE_F(VectorKernelsFixture, VectorKernels_MaxPoolRow_AVX2, ImageInference::model::VectorIsa::AVX2, 32, 56)
+        (benchmark::State &st)
+        {
+            if (kernels == nullptr)
+            {
+                st.SkipWithError("The host does not support the instruction set.");
+                return;
+            }
+
+            for (auto _ : st)
+            {
+                kernels->maxPoolRow(addendPtr, rowPtr, pixels, 2, blockSize);
+                benchmark::ClobberMemory();
+            }
+        };
+
+        // Args: TIsa, TBlockSize, TPixels
+        BENCHMARK_TEMPLATE_F(VectorKernelsFixture, VectorKernels_MaxPoolRow_AVX512, ImageInference::model::VectorIsa::AVX512, 32, 56)
+        (benchmark::State &st)
+        {
+            if (kernels == nullptr)
+            {
+                st.SkipWithError("The host does not support the instruction set.");
+                return;
+            }
+
+            for (auto _ : st)
+            {
+                kernels->maxPoolRow(addendPtr, rowPtr, pixels, 2, blockSize);
+                benchmark::ClobberMemory();
+            }
+        };
+
+        // Run with --benchmark_filter=Autotune and IMAGEINFERENCE_TUNING_FILE set to the tuning file that is loaded by the model.
+        // Args: stage, input block size, block size
+        BENCHMARK_DEFINE_F(AutotuneFixture, Autotune_Stage)
+        (benchmark::State &st)
+        {
+            double total = 0.0;
+            for (auto _ : st)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                runStage();
+                const auto end = std::chrono::steady_clock::now();
+                const double elapsed = std::chrono::duration<double>(end - start).count();
+                st.SetIterationTime(elapsed);
+                total += elapsed;
+            }
+            times[stage][inBlockSizeIndex][blockSizeIndex] = total / st.iterations();
+        }
+
+        // The stem reads the planar image, so it has no input block size.
+        BENCHMARK_REGISTER_F(AutotuneFixture, Autotune_Stage)
+            ->ArgsProduct({{0}, {16}, {16, 32, 64}})
+            ->ArgsProduct({{1, 2, 3, 4}, {16, 32, 64}, {16, 32, 64}})
+            ->UseManualTime()
+            ->Unit(benchmark::kMillisecond);
+
+        /// Chooses the block sizes from the times of Autotune_Stage and writes them into the tuning file for the host.
+        static void Autotune_Store(benchmark::State &st)
+        {
+            const char *path = std::getenv(ImageInference::model::ResNet50Tuning::environmentVariable);
+            if (path == nullptr || *path == '\0')
+            {
+                st.SkipWithError("IMAGEINFERENCE_TUNING_FILE environment variable is not set");
+                return;
+            }
+
+            const auto &times = AutotuneFixture::times;
+            for (size_t iStage = 0; iStage < ImageInference::model::ResNet50Tuning::stages; iStage++)
+            {
+                for (size_t iInBlockSize = 0; iInBlockSize < (iStage == 0 ? 1 : times[iStage].size()); iInBlockSize++)
+                {
+                    for (const double time : times[iStage][iInBlockSize])
+                    {
+                        if (time < 0.0)
+                        {
+                            st.SkipWithError("Not all stages are measured, run all Autotune_Stage benchmarks before.");
+                            return;
+                        }
+                    }
+                }
+            }
+
+            ImageInference::model::ResNet50BlockSizes blockSizes;
+            for (auto _ : st)
+            {
+                blockSizes = ImageInference::model::ResNet50Tuning::fastest(times);
+            }
+
+            ImageInference::model::ResNet50Tuning::store(path, ImageInference::model::ResNet50Tuning::cpuModel(), ImageInference::model::ResNet50Tuning::threads(), blockSizes);
+            std::ostringstream label;
+            label << blockSizes;
+            st.SetLabel(label.str());
+        }
+        BENCHMARK(Autotune_Store)->Iterations(1);
+
+        /// Classifies single images on a number of core groups, which share the weights of one model, and reports the images per second.
+        /// Every group gets four images per iteration, so the throughput of the group counts can be compared.
+        ///
+        /// Args: groups. The weights are read from the test data in PROJECT_ROOT.
+        static void Throughput(benchmark::State &st)
+        {
+            const size_t groups = st.range(0);
+            if (groups > ImageInference::model::ResNet50Throughput::availableCores().size())
+            {
+                st.SkipWithError("More groups than cores.");
+                return;
+            }
+
+            ImageInference::model::ResNet50 model(AutotuneFixture::modelWeights(), ImageInference::types::ScalarType::Float);
+            ImageInference::model::ResNet50Throughput throughput(model, groups);
+
+            const size_t images = 4 * groups;
+            Tensor in = at::rand({static_cast<int64_t>(images), 3, 224, 224});
+            Tensor out = at::zeros({static_cast<int64_t>(images), 1000});
+            const float *inPtr = in.mutable_data_ptr<float>();
+            float *outPtr = out.mutable_data_ptr<float>();
+
+            // Every group plans its activations before the measurement.
+            throughput.inference(inPtr, outPtr, images);
+
+            std::vector<std::future<void>> requests(images);
+            for (auto _ : st)
+            {
+                for (size_t i = 0; i < images; i++)
+                {
+                    requests[i] = throughput.submit(inPtr + i * 3 * 224 * 224, outPtr + i * 1000);
+                }
+                for (auto &request : requests)
+                {
+                    request.get();
+                }
+                benchmark::ClobberMemory();
+            }
+            st.counters["images/s"] = benchmark::Counter(static_cast<double>(st.iterations() * images), benchmark::Counter::kIsRate);
+        }
+        BENCHMARK(Throughput)->ArgName("groups")->RangeMultiplier(2)->Range(1, 64)->UseRealTime()->Unit(benchmark::kMillisecond);
     }
 }
\ No newline at end of file
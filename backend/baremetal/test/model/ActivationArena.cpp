@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+#include <stdint.h>
+#include "../../model/ActivationArena.h"
+#include "../../model/ResNet50Activations.h"
+
+namespace ImageInference
+{
+    namespace test
+    {
+        using ImageInference::model::ActivationArena;
+
+        TEST_CASE("test_activation_arena_reuse", "[arena]")
+        {
+            ActivationArena arena;
+            const size_t first = arena.add(8192, 0, 1);
+            const size_t second = arena.add(8192, 1, 2);
+            const size_t third = arena.add(4096, 2, 3); // Overlaps with second only, can reuse first.
+            arena.plan();
+
+            REQUIRE(arena.getTotalSize() == 20480);
+            REQUIRE(arena.getArenaSize() == 16384);
+            REQUIRE(arena.get(first) != arena.get(second));
+            REQUIRE(arena.get(third) == arena.get(first));
+            REQUIRE(reinterpret_cast<uintptr_t>(arena.get(second)) % ActivationArena::alignment == 0);
+            REQUIRE_THROWS(arena.add(64, 0, 0));
+        }
+
+        TEST_CASE("test_activation_arena_resnet50", "[arena]")
+        {
+            auto activations = ImageInference::model::ResNet50Activations<float>();
+            const auto &arena = activations.getArena();
+
+            REQUIRE(arena.getArenaSize() < arena.getTotalSize() / 3);
+
+            // The input and the output of every bottleneck are alive at the same time.
+            REQUIRE(activations.get(activations.maxPool) != activations.get(activations.layer1[0].output));
+            for (size_t i = 1; i < activations.layer3.size(); i++)
+            {
+                REQUIRE(activations.get(activations.layer3[i - 1].output) != activations.get(activations.layer3[i].output));
+                REQUIRE(activations.get(activations.layer3[i - 1].output) != activations.get(activations.layer3[i].reduce));
+            }
+            REQUIRE(activations.layer1[0].winograd == activations.none);
+        }
+
+        TEST_CASE("test_activation_arena_resnet50_winograd", "[arena][winograd]")
+        {
+            auto activations = ImageInference::model::ResNet50Activations<float>(true);
+
+            // Only the 3x3 convolutions with a stride of 1 get a scratch.
+            REQUIRE(activations.layer1[0].winograd != activations.none);
+            REQUIRE(activations.layer2[0].winograd == activations.none);
+            REQUIRE(activations.layer2[1].winograd != activations.none);
+            REQUIRE(activations.getSize(activations.layer4[1].winograd) == ImageInference::model::Winograd::scratchSize<512, 512, 7, 7>());
+
+            // The scratch is only alive during the 3x3 convolution, so it does not overlap its input and output.
+            const auto *scratch = activations.get(activations.layer3[1].winograd);
+            REQUIRE(scratch != activations.get(activations.layer3[1].reduce));
+            REQUIRE(scratch != activations.get(activations.layer3[1].spatial));
+        }
+    } // namespace test
+} // namespace ImageInference
@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+#include <algorithm>
+#include "../../model/GemmKernels.h"
+
+namespace ImageInference
+{
+    namespace test
+    {
+        using ImageInference::model::GemmKernels;
+        using ImageInference::model::GemmShape;
+
+        TEST_CASE("test_gemm_kernels_add_and_find", "[gemm]")
+        {
+            GemmKernels gemmKernels;
+            const GemmShape shape{16, 28, 16, 16, 32, 16, LIBXSMM_DATATYPE(float)};
+            const GemmShape otherShape{16, 28, 16, 16, 16, 16, LIBXSMM_DATATYPE(float)};
+
+            REQUIRE(gemmKernels.add(shape));
+            REQUIRE(gemmKernels.add(shape));
+            REQUIRE(gemmKernels.size() == 1);
+            REQUIRE(gemmKernels.find(shape) != NULL);
+            REQUIRE(gemmKernels.find(otherShape) == NULL);
+            REQUIRE(gemmKernels.getFailures().empty());
+        }
+
+        TEST_CASE("test_gemm_kernels_get", "[gemm]")
+        {
+            constexpr int m = 4;
+            constexpr int n = 3;
+            constexpr int k = 2;
+
+            GemmKernels gemmKernels;
+            const GemmShape shape{m, n, k, m, k, m, LIBXSMM_DATATYPE(float)};
+            gemmKernels.add(shape);
+
+            std::vector<float> a(m * k, 1.0f);
+            std::vector<float> b(k * n, 2.0f);
+
+            // Both the table and a direct dispatch without table accumulate into C.
+            for (const GemmKernels *table : {static_cast<const GemmKernels *>(&gemmKernels), static_cast<const GemmKernels *>(nullptr)})
+            {
+                std::vector<float> c(m * n, 1.0f);
+                libxsmm_gemmfunction gemmFunc = GemmKernels::get(table, shape, "test_gemm_kernels_get");
+
+                libxsmm_gemm_param param;
+                param.a.primary = a.data();
+                param.b.primary = b.data();
+                param.c.primary = c.data();
+                gemmFunc(&param);
+
+                for (float value : c)
+                {
+                    REQUIRE(value == 1.0f + k * 2.0f);
+                }
+            }
+        }
+
+        TEST_CASE("test_gemm_kernels_beta_zero", "[gemm]")
+        {
+            constexpr int m = 4;
+            constexpr int n = 3;
+            constexpr int k = 2;
+
+            GemmKernels gemmKernels;
+            const GemmShape accumulate{m, n, k, m, k, m, LIBXSMM_DATATYPE(float)};
+            const GemmShape overwrite{m, n, k, m, k, m, LIBXSMM_DATATYPE(float), true};
+            gemmKernels.add(accumulate);
+            gemmKernels.add(overwrite);
+            REQUIRE(gemmKernels.size() == 2);
+
+            std::vector<float> a(m * k, 1.0f);
+            std::vector<float> b(k * n, 2.0f);
+            std::vector<float> c(m * n, 1.0f);
+
+            libxsmm_gemm_param param;
+            param.a.primary = a.data();
+            param.b.primary = b.data();
+            param.c.primary = c.data();
+            GemmKernels::get(&gemmKernels, overwrite, "test_gemm_kernels_beta_zero")(&param);
+
+            for (float value : c)
+            {
+                REQUIRE(value == k * 2.0f);
+            }
+        }
+
+        TEST_CASE("test_gemm_kernels_batch_reduce_offset", "[gemm]")
+        {
+            constexpr int m = 4;
+            constexpr int n = 3;
+            constexpr int k = 2;
+            constexpr size_t batch = 3;
+
+            GemmKernels gemmKernels;
+            const GemmShape shape{m, n, k, m, k, m, LIBXSMM_DATATYPE(float), true, LIBXSMM_GEMM_BATCH_REDUCE_OFFSET};
+            REQUIRE(gemmKernels.add(shape));
+            REQUIRE(gemmKernels.find(GemmShape{m, n, k, m, k, m, LIBXSMM_DATATYPE(float), true}) == NULL);
+
+            // Batch i uses A filled with i + 1 and B filled with 2.
+            std::vector<float> a(batch * m * k);
+            std::vector<float> b(batch * k * n, 2.0f);
+            std::vector<unsigned long long> aOffsets(batch);
+            std::vector<unsigned long long> bOffsets(batch);
+            for (size_t i = 0; i < batch; i++)
+            {
+                std::fill(a.begin() + i * m * k, a.begin() + (i + 1) * m * k, static_cast<float>(i + 1));
+                aOffsets[i] = i * m * k * sizeof(float);
+                bOffsets[i] = i * k * n * sizeof(float);
+            }
+            std::vector<float> c(m * n, 1.0f);
+            unsigned long long count = batch;
+
+            libxsmm_gemm_param param;
+            param.a.primary = a.data();
+            param.a.secondary = aOffsets.data();
+            param.b.primary = b.data();
+            param.b.secondary = bOffsets.data();
+            param.c.primary = c.data();
+            param.op.tertiary = &count;
+            GemmKernels::get(&gemmKernels, shape, "test_gemm_kernels_batch_reduce_offset")(&param);
+
+            // C is overwritten with the sum of the batch: (1 + 2 + 3) * k * 2.
+            for (float value : c)
+            {
+                REQUIRE(value == 6.0f * k * 2.0f);
+            }
+        }
+    } // namespace test
+} // namespace ImageInference
@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef USE_ATEN_LIB
+#define USE_ATEN_LIB
+#endif // !USE_ATEN_LIB
+
+#include <ATen/ATen.h>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../model/GemmKernels.h"
+#include "../../model/LibxsmmRuntime.h"
+#include "../../model/ResNet50.h"
+#include "../utils/Reader.h"
+
+namespace ImageInference
+{
+    namespace test
+    {
+        using ImageInference::model::GemmKernels;
+        using ImageInference::model::GemmShape;
+        using ImageInference::model::LibxsmmRuntime;
+        using ImageInference::model::ResNet50;
+
+        TEST_CASE("test_libxsmm_runtime_shared", "[libxsmm]")
+        {
+            auto first = LibxsmmRuntime::acquire();
+            auto second = LibxsmmRuntime::acquire();
+
+            REQUIRE(first == second);
+            REQUIRE(first.use_count() == 2);
+            REQUIRE(first->getTargetArchId() == libxsmm_get_target_archid());
+            REQUIRE(first->getTargetArchName() != nullptr);
+        }
+
+        TEST_CASE("test_libxsmm_runtime_reacquire", "[libxsmm]")
+        {
+            {
+                auto runtime = LibxsmmRuntime::acquire();
+                REQUIRE(runtime.use_count() == 1);
+            }
+
+            // The last reference finalized libxsmm, acquiring again initializes it again.
+            auto runtime = LibxsmmRuntime::acquire();
+            REQUIRE(runtime != nullptr);
+            REQUIRE(runtime.use_count() == 1);
+        }
+
+        TEST_CASE("test_libxsmm_runtime_concurrent", "[libxsmm]")
+        {
+            constexpr int m = 4;
+            constexpr int n = 3;
+            constexpr int k = 2;
+            const GemmShape shape{m, n, k, m, k, m, LIBXSMM_DATATYPE(float)};
+
+            // Both threads release their last reference while the other one acquires, so a runtime is destructed
+            // while the next one is already alive. Every gemm needs an initialized libxsmm.
+            std::atomic<size_t> failures{0};
+            auto run = [&]()
+            {
+                for (size_t i = 0; i < 200; i++)
+                {
+                    auto runtime = LibxsmmRuntime::acquire();
+                    GemmKernels gemmKernels;
+                    gemmKernels.add(shape);
+
+                    std::vector<float> a(m * k, 1.0f);
+                    std::vector<float> b(k * n, 2.0f);
+                    std::vector<float> c(m * n, 1.0f);
+                    libxsmm_gemm_param param;
+                    param.a.primary = a.data();
+                    param.b.primary = b.data();
+                    param.c.primary = c.data();
+                    GemmKernels::get(&gemmKernels, shape, "test_libxsmm_runtime_concurrent")(&param);
+
+                    for (float value : c)
+                    {
+                        failures += value != 1.0f + k * 2.0f;
+                    }
+                }
+            };
+
+            std::thread first(run);
+            std::thread second(run);
+            first.join();
+            second.join();
+
+            REQUIRE(failures == 0);
+        }
+
+        TEST_CASE("test_libxsmm_runtime_concurrent_models", "[libxsmm][resnet50]")
+        {
+            const char *projectDirectory = std::getenv("PROJECT_ROOT");
+            if (projectDirectory == nullptr)
+            {
+                throw std::runtime_error("PROJECT_ROOT environment variable is not set");
+            }
+
+            std::string weightsPath = std::string(projectDirectory) + "/test_data/resnet50_weights_v2.bin";
+            ImageInference::test::utils::Reader reader(weightsPath);
+            std::vector<at::Tensor> weights;
+            std::vector<void *> weightPtrs;
+            while (reader.hasNext())
+            {
+                std::vector<int64_t> sizes;
+                float *readTensorPtr = reader.getNextTensor(sizes);
+                auto tensor = at::from_blob(readTensorPtr, sizes);
+                weights.push_back(tensor);
+                weightPtrs.push_back(tensor.mutable_data_ptr<float>());
+            }
+
+            // Every model holds the only reference of its thread, so the runtime is released and acquired again and again.
+            auto run = [&]()
+            {
+                for (size_t i = 0; i < 4; i++)
+                {
+                    ResNet50 resnet50(weightPtrs, ImageInference::types::ScalarType::Float);
+                }
+            };
+
+            std::thread first(run);
+            std::thread second(run);
+            first.join();
+            second.join();
+
+            auto runtime = LibxsmmRuntime::acquire();
+            REQUIRE(runtime.use_count() == 1);
+            REQUIRE(runtime->getTargetArchId() == libxsmm_get_target_archid());
+        }
+    } // namespace test
+} // namespace ImageInference
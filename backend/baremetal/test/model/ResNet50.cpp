@@ -105,6 +105,23 @@ namespace ImageInference
             REQUIRE(at::allclose(out, expected[0], 1.0e-4, 1.0e-5));
         }
 
+        TEST_CASE("test_resnet50_gemm_rows", "[resnet50][convolution]")
+        {
+            using ImageInference::model::ResNet50;
+
+            // 1x1 convolutions without stride and padding flatten whole rows into one gemm.
+            REQUIRE(ResNet50::gemmRows<1, 0, 0, 1, 1, 56, 56>() == 1);
+            REQUIRE(ResNet50::gemmRows<1, 0, 0, 1, 1, 28, 28>() == 2);
+            REQUIRE(ResNet50::gemmRows<1, 0, 0, 1, 1, 14, 14>() == 2);
+            REQUIRE(ResNet50::gemmRows<1, 0, 0, 1, 1, 7, 7>() == 7);
+            REQUIRE(ResNet50::gemmRows<1, 0, 0, 1, 1, 10, 10>() == 5);
+
+            // All other convolutions compute one row per gemm.
+            REQUIRE(ResNet50::gemmRows<1, 0, 1, 1, 1, 7, 7>() == 1);
+            REQUIRE(ResNet50::gemmRows<2, 0, 0, 1, 1, 7, 7>() == 1);
+            REQUIRE(ResNet50::gemmRows<1, 1, 0, 3, 3, 7, 7>() == 1);
+        }
+
         TEST_CASE("test_resnet50_conv1x1_channels64x32", "[resnet50][convolution]")
         {
             constexpr size_t stride = 1;
@@ -351,6 +368,54 @@ namespace ImageInference
             REQUIRE(at::allclose(out, expected[0], 1.0e-4, 1.0e-5));
         }
 
+        TEST_CASE("test_resnet50_conv3x3_winograd_channels32x32", "[resnet50][convolution][winograd]")
+        {
+            constexpr size_t stride = 1;
+            constexpr size_t inPadding = 1;
+            constexpr size_t blockSize = 16;
+            constexpr size_t outChannels = 32;
+            constexpr size_t inChannels = 32;
+            // Not a multiple of the output tile of 4, so the last tiles are partial.
+            constexpr size_t height = 14;
+            constexpr size_t width = 14;
+            constexpr size_t kernelHeight = 3;
+            constexpr size_t kernelWidth = 3;
+
+            Tensor in = at::rand({1, inChannels, height, width});
+            Tensor weight = at::rand({outChannels, inChannels, kernelHeight, kernelWidth});
+            Tensor batchGamma = at::rand({outChannels});
+            Tensor batchBeta = at::rand({outChannels});
+            Tensor batchMean = at::rand({outChannels});
+            Tensor batchVar = at::rand({outChannels});
+
+            Tensor out = at::zeros({outChannels, height, width});
+            Tensor outDirect = at::zeros({outChannels, height, width});
+
+            float *inPtr = in.mutable_data_ptr<float>();
+            float *weightPtr = weight.mutable_data_ptr<float>();
+            float *batchGammaPtr = batchGamma.mutable_data_ptr<float>();
+            float *batchBetaPtr = batchBeta.mutable_data_ptr<float>();
+            float *batchMeanPtr = batchMean.mutable_data_ptr<float>();
+            float *batchVarPtr = batchVar.mutable_data_ptr<float>();
+            float *outPtr = out.mutable_data_ptr<float>();
+            float *outDirectPtr = outDirect.mutable_data_ptr<float>();
+
+            ImageInference::model::test::ResNet50Test::convBlockWinograd<
+                blockSize, outChannels, inChannels,
+                height, width>(inPtr, weightPtr, batchGammaPtr, batchBetaPtr, batchMeanPtr, batchVarPtr, outPtr);
+            ImageInference::model::test::ResNet50Test::convBlock<
+                stride, inPadding, blockSize, outChannels, inChannels,
+                height, width, kernelHeight, kernelWidth>(inPtr, weightPtr, batchGammaPtr, batchBetaPtr, batchMeanPtr, batchVarPtr, outDirectPtr);
+
+            Tensor expected = at::conv2d(in, weight, {}, stride, inPadding);
+            expected = at::batch_norm(expected, batchGamma, batchBeta, batchMean, batchVar, false, 0.1, 1e-5, false);
+            expected = at::relu(expected);
+
+            // The transforms change the order of the sums, therefore the tolerance is larger than for the direct convolution.
+            REQUIRE(at::allclose(out, outDirect, 1.0e-3, 1.0e-4));
+            REQUIRE(at::allclose(out, expected[0], 1.0e-3, 1.0e-4));
+        }
+
         TEST_CASE("test_resnet50_conv3x3_channels16x32_blockSize1", "[resnet50][convolution]")
         {
             constexpr size_t stride = 1;
@@ -474,6 +539,89 @@ namespace ImageInference
             REQUIRE(at::allclose(out, expected[0], 1.0e-2, 1.0e-3));
         }
 
+        TEST_CASE("test_resnet50_conv7x7_planar_channels3x64_stride2", "[resnet50][convolution][planar]")
+        {
+            constexpr size_t stride = 2;
+            constexpr size_t padding = 3;
+            constexpr size_t blockSize = 16;
+            constexpr size_t outChannels = 64;
+            constexpr size_t inChannels = 3;
+            constexpr size_t height = 224;
+            constexpr size_t width = 224;
+            constexpr size_t kernelHeight = 7;
+            constexpr size_t kernelWidth = 7;
+
+            Tensor in = at::rand({1, inChannels, height, width});
+            Tensor weight = at::rand({outChannels, inChannels, kernelHeight, kernelWidth});
+            Tensor batchGamma = at::rand({outChannels});
+            Tensor batchBeta = at::rand({outChannels});
+            Tensor batchMean = at::rand({outChannels});
+            Tensor batchVar = at::rand({outChannels});
+
+            Tensor out = at::zeros({outChannels, height / stride, width / stride});
+
+            float *inPtr = in.mutable_data_ptr<float>();
+            float *weightPtr = weight.mutable_data_ptr<float>();
+            float *batchGammaPtr = batchGamma.mutable_data_ptr<float>();
+            float *batchBetaPtr = batchBeta.mutable_data_ptr<float>();
+            float *batchMeanPtr = batchMean.mutable_data_ptr<float>();
+            float *batchVarPtr = batchVar.mutable_data_ptr<float>();
+            float *outPtr = out.mutable_data_ptr<float>();
+
+            // The input is read in place without padding.
+            ImageInference::model::test::ResNet50Test::convBlockPlanar<
+                stride, blockSize, outChannels, inChannels,
+                height, width, kernelHeight, kernelWidth>(inPtr, weightPtr, batchGammaPtr, batchBetaPtr, batchMeanPtr, batchVarPtr, outPtr);
+
+            Tensor expected = at::conv2d(in, weight, {}, stride, padding);
+            expected = at::batch_norm(expected, batchGamma, batchBeta, batchMean, batchVar, false, 0.1, 1e-5, false);
+            expected = at::relu(expected);
+
+            REQUIRE(at::allclose(out, expected[0], 1.0e-2, 1.0e-3));
+        }
+
+        TEST_CASE("test_resnet50_conv7x7_planar_max_pool_channels3x64_stride2", "[resnet50][convolution][planar][maxpool]")
+        {
+            constexpr size_t stride = 2;
+            constexpr size_t padding = 3;
+            constexpr size_t blockSize = 16;
+            constexpr size_t outChannels = 64;
+            constexpr size_t inChannels = 3;
+            constexpr size_t height = 224;
+            constexpr size_t width = 224;
+            constexpr size_t kernelHeight = 7;
+            constexpr size_t kernelWidth = 7;
+
+            Tensor in = at::rand({1, inChannels, height, width});
+            Tensor weight = at::rand({outChannels, inChannels, kernelHeight, kernelWidth}) - 0.5;
+            Tensor batchGamma = at::rand({outChannels});
+            Tensor batchBeta = at::rand({outChannels});
+            Tensor batchMean = at::rand({outChannels});
+            Tensor batchVar = at::rand({outChannels});
+
+            Tensor out = at::zeros({outChannels, height / stride / 2, width / stride / 2});
+
+            float *inPtr = in.mutable_data_ptr<float>();
+            float *weightPtr = weight.mutable_data_ptr<float>();
+            float *batchGammaPtr = batchGamma.mutable_data_ptr<float>();
+            float *batchBetaPtr = batchBeta.mutable_data_ptr<float>();
+            float *batchMeanPtr = batchMean.mutable_data_ptr<float>();
+            float *batchVarPtr = batchVar.mutable_data_ptr<float>();
+            float *outPtr = out.mutable_data_ptr<float>();
+
+            // The output of the convolution is only kept row by row for the max pooling.
+            ImageInference::model::test::ResNet50Test::convBlockPlanarMaxPool<
+                stride, blockSize, outChannels, inChannels,
+                height, width, kernelHeight, kernelWidth>(inPtr, weightPtr, batchGammaPtr, batchBetaPtr, batchMeanPtr, batchVarPtr, outPtr);
+
+            Tensor expected = at::conv2d(in, weight, {}, stride, padding);
+            expected = at::batch_norm(expected, batchGamma, batchBeta, batchMean, batchVar, false, 0.1, 1e-5, false);
+            expected = at::relu(expected);
+            expected = at::max_pool2d(expected, {3, 3}, 2, 1);
+
+            REQUIRE(at::allclose(out, expected[0], 1.0e-2, 1.0e-3));
+        }
+
         TEST_CASE("test_resnet50_conv3x3_shortcut_channels16x16", "[resnet50][convolution][shortcut]")
         {
             constexpr size_t inPadding = 1;
@@ -912,6 +1060,35 @@ namespace ImageInference
             REQUIRE(at::allclose(out, expected, 1.0e-3, 1.0e-4));
         }
 
+        TEST_CASE("test_resnet50_global_average_fully_connected_batch2", "[resnet50][globalAverage][fullyConnected]")
+        {
+            constexpr size_t batch = 2;
+            constexpr size_t inPadding = 0;
+            constexpr size_t blockSize = 16;
+            constexpr size_t channels = 2048;
+            constexpr size_t height = 7;
+            constexpr size_t width = 7;
+            constexpr size_t columns = 1000;
+
+            Tensor in = at::randn({batch, channels, height, width});
+            Tensor weight = at::randn({columns, channels});
+            Tensor bias = at::randn({columns});
+
+            Tensor out = at::zeros({batch, columns});
+
+            float *inPtr = in.mutable_data_ptr<float>();
+            float *weightPtr = weight.mutable_data_ptr<float>();
+            float *biasPtr = bias.mutable_data_ptr<float>();
+            float *outPtr = out.mutable_data_ptr<float>();
+
+            ImageInference::model::test::ResNet50Test::globalAveragePoolFullyConnected<
+                batch, inPadding, blockSize, channels, height, width, columns>(inPtr, weightPtr, biasPtr, outPtr);
+
+            Tensor expected = at::linear(at::mean(in, {2, 3}), weight, bias);
+
+            REQUIRE(at::allclose(out, expected, 1.0e-3, 1.0e-4));
+        }
+
         TEST_CASE("test_resnet50_relu", "[resnet50][relu]")
         {
             Tensor in = at::randn({100});
@@ -1064,6 +1241,214 @@ namespace ImageInference
             testWholeResnet50(resnet50, "resnet50_test9.bin");
         }
 
+        TEST_CASE("test_resnet50_whole_model_batch", "[resnet50][inference][batch]")
+        {
+            const char *projectDirectory = std::getenv("PROJECT_ROOT");
+            if (projectDirectory == nullptr)
+            {
+                throw std::runtime_error("PROJECT_ROOT environment variable is not set");
+            }
+
+            std::string weightsPath = std::string(projectDirectory) + "/test_data/resnet50_weights_v2.bin";
+            ImageInference::test::utils::Reader reader(weightsPath);
+            std::vector<at::Tensor> weights;
+            std::vector<void *> weightPtrs;
+            while (reader.hasNext())
+            {
+                std::vector<int64_t> sizes;
+                float *readTensorPtr = reader.getNextTensor(sizes);
+                auto tensor = at::from_blob(readTensorPtr, sizes);
+                weights.push_back(tensor);
+                weightPtrs.push_back(tensor.mutable_data_ptr<float>());
+            }
+
+            ImageInference::model::ResNet50 resnet50(weightPtrs, ImageInference::types::ScalarType::Float);
+
+            // More images than RESNET50_BATCH, so the batch is split into a full and a partial group.
+            std::vector<Tensor> inputs;
+            std::vector<Tensor> outputsExpected;
+            for (size_t i = 0; i < 10; i++)
+            {
+                ImageInference::test::utils::Reader testReader(std::string(projectDirectory) + "/test_data/resnet50_test" + std::to_string(i) + ".bin");
+                std::vector<int64_t> sizes;
+                float *readTensorPtr = testReader.getNextTensor(sizes);
+                inputs.push_back(at::from_blob(readTensorPtr, sizes).clone());
+                readTensorPtr = testReader.getNextTensor(sizes);
+                outputsExpected.push_back(at::from_blob(readTensorPtr, sizes).clone());
+            }
+            Tensor in = at::cat(inputs).contiguous();
+            Tensor outExpected = at::cat(outputsExpected);
+            Tensor out = at::zeros({10, 1000});
+
+            resnet50.inference(in.mutable_data_ptr<float>(), out.mutable_data_ptr<float>(), 10);
+            REQUIRE(at::allclose(out, outExpected, 15.0, 12));
+
+            // Every image of a batch gets the same logits as on its own.
+            Tensor outSingle = at::zeros({1, 1000});
+            resnet50.inference(inputs[9].mutable_data_ptr<float>(), outSingle.mutable_data_ptr<float>());
+            REQUIRE(at::equal(out[9], outSingle[0]));
+        }
+
+        TEST_CASE("test_resnet50_whole_model_bfloat16", "[resnet50][inference][bfloat16]")
+        {
+            const char *projectDirectory = std::getenv("PROJECT_ROOT");
+            if (projectDirectory == nullptr)
+            {
+                throw std::runtime_error("PROJECT_ROOT environment variable is not set");
+            }
+
+            std::string weightsPath = std::string(projectDirectory) + "/test_data/resnet50_weights_v2.bin";
+            ImageInference::test::utils::Reader reader(weightsPath);
+            std::vector<at::Tensor> weights;
+            std::vector<void *> weightPtrs;
+            while (reader.hasNext())
+            {
+                std::vector<int64_t> sizes;
+                float *readTensorPtr = reader.getNextTensor(sizes);
+                auto tensor = at::from_blob(readTensorPtr, sizes);
+                weights.push_back(tensor);
+                weightPtrs.push_back(tensor.mutable_data_ptr<float>());
+            }
+
+            ImageInference::model::ResNet50 resnet50(weightPtrs, ImageInference::types::ScalarType::BFloat16);
+            REQUIRE(resnet50.getType() == ImageInference::types::ScalarType::BFloat16);
+
+            for (size_t i = 0; i < 10; i++)
+            {
+                ImageInference::test::utils::Reader testReader(std::string(projectDirectory) + "/test_data/resnet50_test" + std::to_string(i) + ".bin");
+                std::vector<int64_t> sizes;
+                float *readTensorPtr = testReader.getNextTensor(sizes);
+                Tensor in = at::from_blob(readTensorPtr, sizes);
+                readTensorPtr = testReader.getNextTensor(sizes);
+                Tensor outExpected = at::from_blob(readTensorPtr, sizes);
+                Tensor out = at::zeros({1, 1000});
+
+                resnet50.inference(in.mutable_data_ptr<float>(), out.mutable_data_ptr<float>());
+
+                // The activations only keep 8 bits of mantissa, the prediction has to stay the same.
+                std::cout << "Absolute Error: " << (out - outExpected).abs().max().item<float>() << std::endl;
+                REQUIRE(out.argmax(1).item<int64_t>() == outExpected.argmax(1).item<int64_t>());
+                REQUIRE(at::allclose(out, outExpected, 0.1, 0.5));
+            }
+        }
+
+        TEST_CASE("test_resnet50_whole_model_int8", "[resnet50][inference][int8]")
+        {
+            const char *projectDirectory = std::getenv("PROJECT_ROOT");
+            if (projectDirectory == nullptr)
+            {
+                throw std::runtime_error("PROJECT_ROOT environment variable is not set");
+            }
+
+            std::string weightsPath = std::string(projectDirectory) + "/test_data/resnet50_weights_v2.bin";
+            ImageInference::test::utils::Reader reader(weightsPath);
+            std::vector<at::Tensor> weights;
+            std::vector<void *> weightPtrs;
+            while (reader.hasNext())
+            {
+                std::vector<int64_t> sizes;
+                float *readTensorPtr = reader.getNextTensor(sizes);
+                auto tensor = at::from_blob(readTensorPtr, sizes);
+                weights.push_back(tensor);
+                weightPtrs.push_back(tensor.mutable_data_ptr<float>());
+            }
+
+            // The int8 model can not be prepared without the scales of its activations.
+            REQUIRE_THROWS(ImageInference::model::ResNet50(weightPtrs, ImageInference::types::ScalarType::Int8));
+
+            const auto calibration = ImageInference::model::ResNet50Calibration::load(std::string(projectDirectory) + "/test_data/resnet50_calibration.txt");
+            ImageInference::model::ResNet50 resnet50(weightPtrs, calibration);
+            REQUIRE(resnet50.getType() == ImageInference::types::ScalarType::Int8);
+
+            for (size_t i = 0; i < 10; i++)
+            {
+                ImageInference::test::utils::Reader testReader(std::string(projectDirectory) + "/test_data/resnet50_test" + std::to_string(i) + ".bin");
+                std::vector<int64_t> sizes;
+                float *readTensorPtr = testReader.getNextTensor(sizes);
+                Tensor in = at::from_blob(readTensorPtr, sizes);
+                readTensorPtr = testReader.getNextTensor(sizes);
+                Tensor outExpected = at::from_blob(readTensorPtr, sizes);
+                Tensor out = at::zeros({1, 1000});
+
+                resnet50.inference(in.mutable_data_ptr<float>(), out.mutable_data_ptr<float>());
+
+                // The random test images give flat logits, so the prediction only has to be among the top 5 of the float model.
+                std::cout << "Absolute Error: " << (out - outExpected).abs().max().item<float>() << std::endl;
+                Tensor top5 = std::get<1>(outExpected.topk(5, 1));
+                REQUIRE(top5.eq(out.argmax(1).item<int64_t>()).any().item<bool>());
+            }
+        }
+
+        TEST_CASE("test_resnet50_whole_model_float16_weights", "[resnet50][inference][float16]")
+        {
+            const char *projectDirectory = std::getenv("PROJECT_ROOT");
+            if (projectDirectory == nullptr)
+            {
+                throw std::runtime_error("PROJECT_ROOT environment variable is not set");
+            }
+
+            std::string weightsPath = std::string(projectDirectory) + "/test_data/resnet50_weights_v2.bin";
+            ImageInference::test::utils::Reader reader(weightsPath);
+            std::vector<at::Tensor> weights;
+            std::vector<void *> weightPtrs;
+            while (reader.hasNext())
+            {
+                std::vector<int64_t> sizes;
+                float *readTensorPtr = reader.getNextTensor(sizes);
+                auto tensor = at::from_blob(readTensorPtr, sizes);
+                weights.push_back(tensor);
+                weightPtrs.push_back(tensor.mutable_data_ptr<float>());
+            }
+
+            // The weight bandwidth bound layers i.e. layer3, layer4 and the fully connected layer are stored in Float16.
+            ImageInference::model::ResNet50 resnet50(weightPtrs, ImageInference::types::ScalarType::Float);
+            ImageInference::model::ResNet50 resnet50Float16(weightPtrs, ImageInference::types::ScalarType::Float);
+            const size_t float16Weights[] = {
+                ImageInference::model::ResNet50::layer3_0_conv1_weight, ImageInference::model::ResNet50::layer3_1_conv1_weight,
+                ImageInference::model::ResNet50::layer3_2_conv1_weight, ImageInference::model::ResNet50::layer3_3_conv1_weight,
+                ImageInference::model::ResNet50::layer3_4_conv1_weight, ImageInference::model::ResNet50::layer3_5_conv1_weight,
+                ImageInference::model::ResNet50::layer4_0_conv1_weight, ImageInference::model::ResNet50::layer4_1_conv1_weight,
+                ImageInference::model::ResNet50::layer4_2_conv1_weight, ImageInference::model::ResNet50::fc_weight};
+            for (const size_t weightIndex : float16Weights)
+            {
+                resnet50Float16.setFloat16Weights(weightIndex, true);
+            }
+            REQUIRE_THROWS(resnet50Float16.setFloat16Weights(ImageInference::model::ResNet50::layer3_1_conv2_weight, true));
+
+            for (size_t i = 0; i < 10; i++)
+            {
+                ImageInference::test::utils::Reader testReader(std::string(projectDirectory) + "/test_data/resnet50_test" + std::to_string(i) + ".bin");
+                std::vector<int64_t> sizes;
+                float *readTensorPtr = testReader.getNextTensor(sizes);
+                Tensor in = at::from_blob(readTensorPtr, sizes);
+                Tensor outFloat = at::zeros({1, 1000});
+                Tensor out = at::zeros({1, 1000});
+
+                resnet50.inference(in.mutable_data_ptr<float>(), outFloat.mutable_data_ptr<float>());
+                resnet50Float16.inference(in.mutable_data_ptr<float>(), out.mutable_data_ptr<float>());
+
+                // The weights keep 11 bits of mantissa and the activations stay in float, so the logits stay close to the float model.
+                std::cout << "Float16 weights vs float, Relative Error: " << ((out - outFloat) / (outFloat.abs() + 1e-5)).abs().max().item<float>() << std::endl
+                          << "Float16 weights vs float, Absolute Error: " << (out - outFloat).abs().max().item<float>() << std::endl;
+                REQUIRE(out.argmax(1).item<int64_t>() == outFloat.argmax(1).item<int64_t>());
+                REQUIRE(at::allclose(out, outFloat, 0.01, 0.05));
+            }
+
+            // Widening the weights back keeps their rounding to Float16, the logits stay the same.
+            ImageInference::test::utils::Reader testReader(std::string(projectDirectory) + "/test_data/resnet50_test0.bin");
+            std::vector<int64_t> sizes;
+            Tensor in = at::from_blob(testReader.getNextTensor(sizes), sizes);
+            Tensor outFloat16 = at::zeros({1, 1000});
+            Tensor outWidened = at::zeros({1, 1000});
+            resnet50Float16.inference(in.mutable_data_ptr<float>(), outFloat16.mutable_data_ptr<float>());
+            for (const size_t weightIndex : float16Weights)
+            {
+                resnet50Float16.setFloat16Weights(weightIndex, false);
+            }
+            resnet50Float16.inference(in.mutable_data_ptr<float>(), outWidened.mutable_data_ptr<float>());
+            REQUIRE(at::equal(outWidened, outFloat16));
+        }
+
         void testResnet50Block0(ImageInference::model::ResNet50 &resnet50, const std::string &compareFilepath)
         {
             // Read the input and comparison output
@@ -1148,6 +1533,7 @@ namespace ImageInference
             testResnet50Block0(resnet50, "resnet50_block0_test9.bin");
         }
 
+        template <size_t TInBlockSize = 16UL, size_t TBlockSize = 16UL>
         void testResnet50Block1(ImageInference::model::ResNet50 &resnet50, const std::string &compareFilepath)
         {
             // Read the input and comparison output
@@ -1180,7 +1566,7 @@ namespace ImageInference
             REQUIRE((outExpected.size(2) == 28));
             REQUIRE((outExpected.size(3) == 28));
 
-            ImageInference::model::test::ResNet50Test::block1(resnet50, inPtr, outPtr);
+            ImageInference::model::test::ResNet50Test::block1<TInBlockSize, TBlockSize>(resnet50, inPtr, outPtr);
 
             //printMismatchedValues(at::allclose(out, outExpected, 50.0, 3), out[0], outExpected[0], 1, 512, 28, 28);
             std::cout << "Relative Error: " << (out - outExpected / (outExpected + 1e-5 * (outExpected == 0))).abs().max().item<float>() << std::endl
@@ -1232,6 +1618,79 @@ namespace ImageInference
             testResnet50Block1(resnet50, "resnet50_block1_test9.bin");
         }
 
+        TEST_CASE("test_resnet50_block1_reblocked", "[resnet50][block1]")
+        {
+            const char *projectDirectory = std::getenv("PROJECT_ROOT");
+            if (projectDirectory == nullptr)
+            {
+                throw std::runtime_error("PROJECT_ROOT environment variable is not set");
+            }
+
+            std::string weightsPath = std::string(projectDirectory) + "/test_data/resnet50_weights_v2.bin";
+            ImageInference::test::utils::Reader reader(weightsPath);
+            std::vector<at::Tensor> weights;
+            std::vector<void *> weightPtrs;
+            while (reader.hasNext())
+            {
+                std::vector<int64_t> sizes;
+                float *readTensorPtr = reader.getNextTensor(sizes);
+                auto tensor = at::from_blob(readTensorPtr, sizes);
+                weights.push_back(tensor);
+                weightPtrs.push_back(tensor.mutable_data_ptr<float>());
+            }
+
+            ImageInference::model::ResNet50 resnet50(weightPtrs, ImageInference::types::ScalarType::Float);
+
+            // The layer reads the input in another block size than it writes its output
+            testResnet50Block1<16UL, 32UL>(resnet50, "resnet50_block1_test0.bin");
+            testResnet50Block1<64UL, 16UL>(resnet50, "resnet50_block1_test1.bin");
+            testResnet50Block1<32UL, 64UL>(resnet50, "resnet50_block1_test2.bin");
+        }
+
+        TEST_CASE("test_resnet50_bottleneck_fused", "[resnet50][block0][fused]")
+        {
+            const char *projectDirectory = std::getenv("PROJECT_ROOT");
+            if (projectDirectory == nullptr)
+            {
+                throw std::runtime_error("PROJECT_ROOT environment variable is not set");
+            }
+
+            std::string weightsPath = std::string(projectDirectory) + "/test_data/resnet50_weights_v2.bin";
+            ImageInference::test::utils::Reader reader(weightsPath);
+            std::vector<at::Tensor> weights;
+            std::vector<void *> weightPtrs;
+            while (reader.hasNext())
+            {
+                std::vector<int64_t> sizes;
+                float *readTensorPtr = reader.getNextTensor(sizes);
+                auto tensor = at::from_blob(readTensorPtr, sizes);
+                weights.push_back(tensor);
+                weightPtrs.push_back(tensor.mutable_data_ptr<float>());
+            }
+
+            ImageInference::model::ResNet50 resnet50(weightPtrs, ImageInference::types::ScalarType::Float);
+
+            Tensor in = at::rand({1, 256, 56, 56});
+            Tensor outFused = at::zeros({1, 256, 56, 56});
+            Tensor out = at::zeros({1, 256, 56, 56});
+
+            // With more threads the bands are split between the threads, which compute the halo rows at their borders.
+#ifdef USE_OMP
+            const int threads = omp_get_max_threads();
+            for (int testThreads : {1, 3, 8})
+            {
+                omp_set_num_threads(testThreads);
+#endif // USE_OMP
+                ImageInference::model::test::ResNet50Test::bottleneckFused<16UL>(resnet50, in.mutable_data_ptr<float>(), outFused.mutable_data_ptr<float>(), out.mutable_data_ptr<float>());
+                REQUIRE(at::allclose(outFused, out, 1.0e-5, 1.0e-5));
+                ImageInference::model::test::ResNet50Test::bottleneckFused<64UL>(resnet50, in.mutable_data_ptr<float>(), outFused.mutable_data_ptr<float>(), out.mutable_data_ptr<float>());
+                REQUIRE(at::allclose(outFused, out, 1.0e-5, 1.0e-5));
+#ifdef USE_OMP
+            }
+            omp_set_num_threads(threads);
+#endif // USE_OMP
+        }
+
         void testResnet50Block2(ImageInference::model::ResNet50 &resnet50, const std::string &compareFilepath)
         {
             // Read the input and comparison output
@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "../../model/ResNet50.h"
+#include "../../model/ResNet50Calibration.h"
+
+namespace ImageInference
+{
+    namespace test
+    {
+        using ImageInference::model::ResNet50;
+        using ImageInference::model::ResNet50Calibration;
+
+        namespace
+        {
+            std::array<float, ResNet50Calibration::size> distinctScales()
+            {
+                std::array<float, ResNet50Calibration::size> scales;
+                for (size_t i = 0; i < scales.size(); i++)
+                {
+                    scales[i] = 0.01f * static_cast<float>(i + 1);
+                }
+                return scales;
+            }
+        } // namespace
+
+        TEST_CASE("test_resnet50_calibration_names", "[calibration][int8]")
+        {
+            REQUIRE(ResNet50Calibration::name(0) == "maxpool");
+            REQUIRE(ResNet50Calibration::name(1) == "layer1.0.conv1");
+            REQUIRE(ResNet50Calibration::name(2) == "layer1.0.conv2");
+            REQUIRE(ResNet50Calibration::name(3) == "layer1.0");
+            REQUIRE(ResNet50Calibration::name(10) == "layer2.0.conv1");
+            REQUIRE(ResNet50Calibration::name(ResNet50Calibration::size - 1) == "layer4.2");
+            REQUIRE_THROWS(ResNet50Calibration::name(ResNet50Calibration::size));
+        }
+
+        TEST_CASE("test_resnet50_calibration_bottleneck", "[calibration][int8]")
+        {
+            REQUIRE(ResNet50Calibration().empty());
+
+            const auto scales = distinctScales();
+            ResNet50Calibration calibration(scales.data());
+            REQUIRE_FALSE(calibration.empty());
+            REQUIRE(calibration.stem() == scales[0]);
+
+            // The input of a bottleneck is the output of the stem or the previous bottleneck.
+            const auto first = calibration.bottleneck(ResNet50::layer1_0_conv1_weight);
+            REQUIRE(first.input == scales[0]);
+            REQUIRE(first.reduce == scales[1]);
+            REQUIRE(first.spatial == scales[2]);
+            REQUIRE(first.output == scales[3]);
+
+            const auto layer2 = calibration.bottleneck(ResNet50::layer2_0_conv1_weight);
+            REQUIRE(layer2.input == scales[9]);
+            REQUIRE(layer2.output == scales[12]);
+
+            REQUIRE(calibration.bottleneck(ResNet50::layer4_2_conv1_weight).output == scales[ResNet50Calibration::size - 1]);
+            REQUIRE_THROWS(calibration.bottleneck(ResNet50::layer1_0_conv2_weight));
+
+            auto invalid = scales;
+            invalid[5] = 0.0f;
+            REQUIRE_THROWS(ResNet50Calibration(invalid.data()));
+        }
+
+        TEST_CASE("test_resnet50_calibration_file", "[calibration][int8]")
+        {
+            const std::string path = (std::filesystem::temp_directory_path() / "imageinference_resnet50_calibration_test.txt").string();
+            std::filesystem::remove(path);
+            REQUIRE_THROWS(ResNet50Calibration::load(path));
+
+            const auto scales = distinctScales();
+            ResNet50Calibration(scales.data()).store(path);
+            REQUIRE(ResNet50Calibration::load(path).getScales() == scales);
+
+            // The entries can be in any order, but every activation needs a scale.
+            {
+                std::ofstream file(path, std::ios::trunc);
+                file.precision(9);
+                file << "# activation scale\n\n";
+                for (size_t i = ResNet50Calibration::size; i-- > 1;)
+                {
+                    file << ResNet50Calibration::name(i) << " " << scales[i] << "\n";
+                }
+            }
+            REQUIRE_THROWS(ResNet50Calibration::load(path));
+            {
+                std::ofstream file(path, std::ios::app);
+                file.precision(9);
+                file << "maxpool " << scales[0] << "\n";
+            }
+            REQUIRE(ResNet50Calibration::load(path).getScales() == scales);
+
+            {
+                std::ofstream file(path, std::ios::app);
+                file << "layer5.0 0.5\n";
+            }
+            REQUIRE_THROWS(ResNet50Calibration::load(path));
+
+            std::filesystem::remove(path);
+        }
+    } // namespace test
+} // namespace ImageInference
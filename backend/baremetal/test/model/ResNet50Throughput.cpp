@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef USE_ATEN_LIB
+#define USE_ATEN_LIB
+#endif // !USE_ATEN_LIB
+
+#include <ATen/ATen.h>
+#include <catch2/catch_test_macros.hpp>
+#include <future>
+#include <string>
+#include <vector>
+#include "../../model/ResNet50.h"
+#include "../../model/ResNet50Throughput.h"
+#include "../utils/Reader.h"
+
+namespace ImageInference
+{
+    namespace test
+    {
+        using at::Tensor;
+        using ImageInference::model::ResNet50;
+        using ImageInference::model::ResNet50Throughput;
+
+        TEST_CASE("test_resnet50_throughput_partition", "[resnet50][throughput]")
+        {
+            const std::vector<int> cores = {0, 1, 2, 3, 8, 9, 10, 11};
+
+            // The first groups take the remaining cores, every core is in exactly one group in its order.
+            const auto groups = ResNet50Throughput::partition(cores, 3);
+            REQUIRE(groups == std::vector<std::vector<int>>{{0, 1, 2}, {3, 8, 9}, {10, 11}});
+            REQUIRE(ResNet50Throughput::partition(cores, 1) == std::vector<std::vector<int>>{cores});
+            REQUIRE(ResNet50Throughput::partition(cores, 8).back() == std::vector<int>{11});
+
+            REQUIRE_THROWS(ResNet50Throughput::partition(cores, 0));
+            REQUIRE_THROWS(ResNet50Throughput::partition(cores, 9));
+            REQUIRE_FALSE(ResNet50Throughput::availableCores().empty());
+        }
+
+        TEST_CASE("test_resnet50_throughput_whole_model", "[resnet50][throughput][inference]")
+        {
+            const char *projectDirectory = std::getenv("PROJECT_ROOT");
+            if (projectDirectory == nullptr)
+            {
+                throw std::runtime_error("PROJECT_ROOT environment variable is not set");
+            }
+
+            std::string weightsPath = std::string(projectDirectory) + "/test_data/resnet50_weights_v2.bin";
+            ImageInference::test::utils::Reader reader(weightsPath);
+            std::vector<at::Tensor> weights;
+            std::vector<void *> weightPtrs;
+            while (reader.hasNext())
+            {
+                std::vector<int64_t> sizes;
+                float *readTensorPtr = reader.getNextTensor(sizes);
+                auto tensor = at::from_blob(readTensorPtr, sizes);
+                weights.push_back(tensor);
+                weightPtrs.push_back(tensor.mutable_data_ptr<float>());
+            }
+
+            ResNet50 resnet50(weightPtrs, ImageInference::types::ScalarType::Float);
+
+            std::vector<Tensor> inputs;
+            std::vector<Tensor> outputsExpected;
+            for (size_t i = 0; i < 10; i++)
+            {
+                ImageInference::test::utils::Reader testReader(std::string(projectDirectory) + "/test_data/resnet50_test" + std::to_string(i) + ".bin");
+                std::vector<int64_t> sizes;
+                float *readTensorPtr = testReader.getNextTensor(sizes);
+                inputs.push_back(at::from_blob(readTensorPtr, sizes).clone());
+                readTensorPtr = testReader.getNextTensor(sizes);
+                outputsExpected.push_back(at::from_blob(readTensorPtr, sizes).clone());
+            }
+            Tensor in = at::cat(inputs).contiguous();
+            Tensor outExpected = at::cat(outputsExpected);
+            Tensor outModel = at::zeros({10, 1000});
+            resnet50.inference(in.mutable_data_ptr<float>(), outModel.mutable_data_ptr<float>(), 10);
+
+            // The groups may share cores, so the test also runs on a machine with a single core.
+            // A group runs with fewer threads than the model, which may split the work differently, so the logits are compared closely instead of equally.
+            const std::vector<int> cores = ResNet50Throughput::availableCores();
+            ResNet50Throughput throughput(resnet50, {{cores.front()}, {cores.back()}, {cores.front()}});
+            REQUIRE(throughput.getGroupCount() == 3);
+            REQUIRE(throughput.getCores(1) == std::vector<int>{cores.back()});
+
+            // The batch is split across all groups.
+            Tensor out = at::zeros({10, 1000});
+            throughput.inference(in.mutable_data_ptr<float>(), out.mutable_data_ptr<float>(), 10);
+            REQUIRE(at::allclose(out, outExpected, 15.0, 12));
+            REQUIRE(at::allclose(out, outModel, 1.0e-4, 1.0e-4));
+
+            // Single images are queued on the groups with the fewest pending requests.
+            Tensor outSubmitted = at::zeros({10, 1000});
+            std::vector<std::future<void>> requests;
+            for (size_t i = 0; i < 10; i++)
+            {
+                requests.push_back(throughput.submit(in[i].mutable_data_ptr<float>(), outSubmitted[i].mutable_data_ptr<float>()));
+            }
+            for (auto &request : requests)
+            {
+                request.get();
+            }
+            REQUIRE(at::allclose(outSubmitted, outModel, 1.0e-4, 1.0e-4));
+        }
+    } // namespace test
+} // namespace ImageInference
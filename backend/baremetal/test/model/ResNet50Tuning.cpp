@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "../../model/ResNet50Tuning.h"
+
+namespace ImageInference
+{
+    namespace test
+    {
+        using ImageInference::model::ResNet50BlockSizes;
+        using ImageInference::model::ResNet50Tuning;
+
+        TEST_CASE("test_resnet50_tuning_fastest", "[tuning]")
+        {
+            ResNet50Tuning::StageTimes times;
+            for (auto &stageTimes : times)
+            {
+                for (auto &inBlockSizeTimes : stageTimes)
+                {
+                    inBlockSizeTimes.fill(10.0);
+                }
+            }
+
+            // The stem is fastest with 64, but reading its output with 64 makes layer1 slower than the gain.
+            times[0][0] = {3.0, 2.0, 1.0};
+            times[1][2][2] = 10.0;
+            times[1][0][0] = 5.0;
+            times[2][0][1] = 1.0;
+            times[3][1][1] = 1.0;
+            times[4][1][2] = 1.0;
+
+            REQUIRE(ResNet50Tuning::fastest(times) == ResNet50BlockSizes{16, 16, 32, 32, 64});
+        }
+
+        TEST_CASE("test_resnet50_tuning_file", "[tuning]")
+        {
+            const std::string path = (std::filesystem::temp_directory_path() / "imageinference_resnet50_tuning_test.txt").string();
+            std::filesystem::remove(path);
+
+            ResNet50BlockSizes blockSizes;
+            REQUIRE_FALSE(ResNet50Tuning::load(path, "CPU A", 8, blockSizes));
+
+            ResNet50Tuning::store(path, "CPU A", 8, ResNet50BlockSizes{16, 32, 32, 64, 64});
+            ResNet50Tuning::store(path, "CPU B with spaces", 8, ResNet50BlockSizes::uniform(16));
+            ResNet50Tuning::store(path, "CPU A", 4, ResNet50BlockSizes::uniform(64));
+            ResNet50Tuning::store(path, "CPU A", 8, ResNet50BlockSizes{32, 32, 32, 64, 64}); // Replaces the first entry
+
+            REQUIRE(ResNet50Tuning::load(path, "CPU A", 8, blockSizes));
+            REQUIRE(blockSizes == ResNet50BlockSizes{32, 32, 32, 64, 64});
+            REQUIRE(ResNet50Tuning::load(path, "CPU B with spaces", 8, blockSizes));
+            REQUIRE(blockSizes.isUniform(16));
+            REQUIRE(ResNet50Tuning::load(path, "CPU A", 4, blockSizes));
+            REQUIRE(blockSizes.isUniform(64));
+            REQUIRE_FALSE(ResNet50Tuning::load(path, "CPU B with spaces", 4, blockSizes));
+
+            REQUIRE_THROWS(ResNet50Tuning::store(path, "CPU A", 8, ResNet50BlockSizes::uniform(8)));
+
+            // An entry with a block size the model is not compiled for is rejected.
+            {
+                std::ofstream file(path, std::ios::app);
+                file << "2 16 16 16 16 48 CPU C\n";
+            }
+            REQUIRE_THROWS(ResNet50Tuning::load(path, "CPU C", 2, blockSizes));
+
+            std::filesystem::remove(path);
+        }
+
+        TEST_CASE("test_resnet50_tuning_host", "[tuning]")
+        {
+            REQUIRE_FALSE(ResNet50Tuning::cpuModel().empty());
+            REQUIRE(ResNet50Tuning::threads() > 0);
+            REQUIRE_NOTHROW(ResNet50Tuning::host().check());
+        }
+    } // namespace test
+} // namespace ImageInference
@@ -0,0 +1,276 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include "../../model/VectorKernels.h"
+
+namespace ImageInference
+{
+    namespace test
+    {
+        using ImageInference::model::VectorIsa;
+        using ImageInference::model::VectorKernels;
+
+        namespace
+        {
+            std::vector<float> randomVector(const size_t size, const unsigned int seed)
+            {
+                std::mt19937 generator(seed);
+                std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+                std::vector<float> values(size);
+                std::generate(values.begin(), values.end(), [&]()
+                              { return distribution(generator); });
+                return values;
+            }
+
+            /// The instruction sets of the host, the block size of 20 has a remainder for every vector width.
+            const VectorIsa isas[] = {VectorIsa::Scalar, VectorIsa::SSE4, VectorIsa::AVX2, VectorIsa::AVX512};
+            const size_t blockSizes[] = {16, 20, 32};
+        } // namespace
+
+        TEST_CASE("test_vector_kernels_detect", "[vector]")
+        {
+            const VectorIsa isa = VectorKernels::detect();
+            REQUIRE(VectorKernels::supported(isa));
+            REQUIRE(VectorKernels::supported(VectorIsa::Scalar));
+            REQUIRE(VectorKernels::host().isa == isa);
+        }
+
+        TEST_CASE("test_vector_kernels_bias_relu", "[vector]")
+        {
+            constexpr size_t pixels = 7;
+
+            for (const VectorIsa isa : isas)
+            {
+                if (!VectorKernels::supported(isa))
+                {
+                    continue;
+                }
+
+                for (const size_t blockSize : blockSizes)
+                {
+                    const std::vector<float> input = randomVector(pixels * blockSize, 1);
+                    const std::vector<float> addend = randomVector(pixels * blockSize, 2);
+                    const std::vector<float> bias = randomVector(blockSize, 3);
+
+                    std::vector<float> row = input;
+                    std::vector<float> rowAdd = input;
+                    VectorKernels::get(isa).biasRelu(row.data(), bias.data(), pixels, blockSize);
+                    VectorKernels::get(isa).biasAddRelu(rowAdd.data(), bias.data(), addend.data(), pixels, blockSize);
+
+                    for (size_t i = 0; i < input.size(); i++)
+                    {
+                        REQUIRE(row[i] == std::max(input[i] + bias[i % blockSize], 0.0f));
+                        REQUIRE(rowAdd[i] == std::max(input[i] + addend[i] + bias[i % blockSize], 0.0f));
+                    }
+                }
+            }
+        }
+
+        TEST_CASE("test_vector_kernels_bias_relu_bfloat16", "[vector][bfloat16]")
+        {
+            using ImageInference::types::BFloat16;
+            constexpr size_t pixels = 7;
+
+            for (const VectorIsa isa : isas)
+            {
+                if (!VectorKernels::supported(isa))
+                {
+                    continue;
+                }
+
+                for (const size_t blockSize : blockSizes)
+                {
+                    const std::vector<float> row = randomVector(pixels * blockSize, 1);
+                    const std::vector<float> addendFloat = randomVector(pixels * blockSize, 2);
+                    const std::vector<float> bias = randomVector(blockSize, 3);
+                    const std::vector<BFloat16> addend(addendFloat.begin(), addendFloat.end());
+
+                    std::vector<BFloat16> output(row.size());
+                    std::vector<BFloat16> outputAdd(row.size());
+                    VectorKernels::get(isa).biasReluBFloat16(output.data(), row.data(), bias.data(), pixels, blockSize);
+                    VectorKernels::get(isa).biasAddReluBFloat16(outputAdd.data(), row.data(), bias.data(), addend.data(), pixels, blockSize);
+
+                    // The sums are computed in float and rounded once, so every instruction set matches the scalar rounding bit by bit.
+                    for (size_t i = 0; i < row.size(); i++)
+                    {
+                        REQUIRE(output[i].bits == BFloat16(std::max(row[i] + bias[i % blockSize], 0.0f)).bits);
+                        REQUIRE(outputAdd[i].bits == BFloat16(std::max(row[i] + static_cast<float>(addend[i]) + bias[i % blockSize], 0.0f)).bits);
+                    }
+                }
+            }
+        }
+
+        TEST_CASE("test_vector_kernels_widen_float16", "[vector][float16]")
+        {
+            using ImageInference::types::Float16;
+
+            // Normal, subnormal and special values, the count of 37 has a remainder for every vector width.
+            std::vector<Float16> input;
+            for (const float value : randomVector(30, 7))
+            {
+                input.push_back(Float16(value * 1000.0f));
+            }
+            for (const uint16_t bits : {0x0000, 0x8000, 0x0001, 0x83FF, 0x7BFF, 0x7C00, 0xFC00})
+            {
+                input.push_back(Float16::fromBits(bits));
+            }
+
+            for (const VectorIsa isa : isas)
+            {
+                if (!VectorKernels::supported(isa))
+                {
+                    continue;
+                }
+
+                std::vector<float> output(input.size());
+                VectorKernels::get(isa).widenFloat16(output.data(), input.data(), input.size());
+
+                // Every Float16 is exactly a float, so every instruction set matches the scalar conversion bit by bit.
+                for (size_t i = 0; i < input.size(); i++)
+                {
+                    REQUIRE(std::signbit(output[i]) == std::signbit(static_cast<float>(input[i])));
+                    REQUIRE(output[i] == static_cast<float>(input[i]));
+                }
+
+                Float16 nan = std::numeric_limits<Float16>::quiet_NaN();
+                float widenedNaN;
+                VectorKernels::get(isa).widenFloat16(&widenedNaN, &nan, 1);
+                REQUIRE(std::isnan(widenedNaN));
+            }
+        }
+
+        TEST_CASE("test_vector_kernels_requantize", "[vector][int8]")
+        {
+            constexpr size_t pixels = 7;
+
+            for (const VectorIsa isa : isas)
+            {
+                if (!VectorKernels::supported(isa))
+                {
+                    continue;
+                }
+
+                for (const size_t blockSize : blockSizes)
+                {
+                    // The accumulators cover the range of uint8_t on both sides, so the relu and the saturation are both hit.
+                    std::mt19937 generator(1);
+                    std::uniform_int_distribution<int32_t> accumulators(-4000, 4000);
+                    std::uniform_int_distribution<int> bytes(0, 255);
+                    std::vector<int32_t> row(pixels * blockSize);
+                    std::vector<int32_t> projection(pixels * blockSize);
+                    std::vector<uint8_t> addend(pixels * blockSize);
+                    std::generate(row.begin(), row.end(), [&]()
+                                  { return accumulators(generator); });
+                    std::generate(projection.begin(), projection.end(), [&]()
+                                  { return accumulators(generator); });
+                    std::generate(addend.begin(), addend.end(), [&]()
+                                  { return static_cast<uint8_t>(bytes(generator)); });
+                    std::vector<float> scale = randomVector(blockSize, 2);
+                    std::vector<float> projectionScale = randomVector(blockSize, 3);
+                    const std::vector<float> bias = randomVector(blockSize, 4);
+                    std::transform(scale.begin(), scale.end(), scale.begin(), [](const float value)
+                                   { return std::abs(value) * 0.1f; });
+                    std::transform(projectionScale.begin(), projectionScale.end(), projectionScale.begin(), [](const float value)
+                                   { return std::abs(value) * 0.1f; });
+                    constexpr float addendScale = 0.7f;
+
+                    std::vector<uint8_t> output(row.size());
+                    std::vector<uint8_t> outputAdd(row.size());
+                    std::vector<uint8_t> outputProjection(row.size());
+                    VectorKernels::get(isa).requantizeRelu(output.data(), row.data(), scale.data(), bias.data(), pixels, blockSize);
+                    VectorKernels::get(isa).requantizeAddRelu(outputAdd.data(), row.data(), scale.data(), bias.data(), addend.data(), addendScale, pixels, blockSize);
+                    VectorKernels::get(isa).requantizeProjectionRelu(outputProjection.data(), row.data(), scale.data(), bias.data(),
+                                                                     projection.data(), projectionScale.data(), pixels, blockSize);
+
+                    // A fused multiply add can round a tie to the other side, so the result may differ from the reference by one.
+                    const auto reference = [](const float value)
+                    { return static_cast<int>(ImageInference::types::roundTo<uint8_t>(std::max(value, 0.0f))); };
+                    for (size_t i = 0; i < row.size(); i++)
+                    {
+                        const float value = static_cast<float>(row[i]) * scale[i % blockSize] + bias[i % blockSize];
+                        REQUIRE(std::abs(output[i] - reference(value)) <= 1);
+                        REQUIRE(std::abs(outputAdd[i] - reference(value + static_cast<float>(addend[i]) * addendScale)) <= 1);
+                        REQUIRE(std::abs(outputProjection[i] - reference(value + static_cast<float>(projection[i]) * projectionScale[i % blockSize])) <= 1);
+                    }
+                }
+            }
+        }
+
+        TEST_CASE("test_vector_kernels_max_pool", "[vector]")
+        {
+            constexpr size_t stride = 2;
+            constexpr size_t outputPixels = 5;
+            constexpr size_t rowPixels = outputPixels * stride + 1;
+
+            for (const VectorIsa isa : isas)
+            {
+                if (!VectorKernels::supported(isa))
+                {
+                    continue;
+                }
+
+                for (const size_t blockSize : blockSizes)
+                {
+                    const std::vector<float> input = randomVector(rowPixels * blockSize, 4);
+                    const std::vector<float> other = randomVector(rowPixels * blockSize, 5);
+
+                    std::vector<float> row = input;
+                    VectorKernels::get(isa).maximum(row.data(), other.data(), row.size());
+                    for (size_t i = 0; i < row.size(); i++)
+                    {
+                        REQUIRE(row[i] == std::max(input[i], other[i]));
+                    }
+
+                    std::vector<float> output(outputPixels * blockSize);
+                    VectorKernels::get(isa).maxPoolRow(output.data(), row.data(), outputPixels, stride, blockSize);
+                    for (size_t iPixel = 0; iPixel < outputPixels; iPixel++)
+                    {
+                        for (size_t iBlock = 0; iBlock < blockSize; iBlock++)
+                        {
+                            const size_t offset = iPixel * stride * blockSize + iBlock;
+                            REQUIRE(output[iPixel * blockSize + iBlock] == std::max({row[offset], row[offset + blockSize], row[offset + 2 * blockSize]}));
+                        }
+                    }
+                }
+            }
+        }
+
+        TEST_CASE("test_vector_kernels_sum_pixels", "[vector]")
+        {
+            constexpr size_t pixels = 7;
+
+            for (const VectorIsa isa : isas)
+            {
+                if (!VectorKernels::supported(isa))
+                {
+                    continue;
+                }
+
+                for (const size_t blockSize : blockSizes)
+                {
+                    const std::vector<float> row = randomVector(pixels * blockSize, 6);
+                    std::vector<float> sum(blockSize, 1.0f);
+                    VectorKernels::get(isa).sumPixels(sum.data(), row.data(), pixels, blockSize);
+
+                    for (size_t iBlock = 0; iBlock < blockSize; iBlock++)
+                    {
+                        // Summed in the same order as the kernels, so the result is exact.
+                        float expected = 1.0f;
+                        for (size_t iPixel = 0; iPixel < pixels; iPixel++)
+                        {
+                            expected += row[iPixel * blockSize + iBlock];
+                        }
+                        REQUIRE(sum[iBlock] == expected);
+                    }
+                }
+            }
+        }
+    } // namespace test
+} // namespace ImageInference
@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "../../types/BFloat16.h"
+
+namespace ImageInference
+{
+    namespace test
+    {
+        namespace types
+        {
+            using ImageInference::types::BFloat16;
+
+            TEST_CASE("test_types_bfloat16_exact", "[types][bfloat16]")
+            {
+                // Values with at most 8 significant bits are kept exactly.
+                const float values[] = {0.0f, -0.0f, 1.0f, -2.0f, 0.5f, 255.0f, 1.0f / 128.0f, 65280.0f};
+                for (const float value : values)
+                {
+                    REQUIRE(static_cast<float>(BFloat16(value)) == value);
+                }
+
+                REQUIRE(BFloat16(1.0f).bits == 0x3F80);
+                REQUIRE(BFloat16(-2.0f).bits == 0xC000);
+            }
+
+            TEST_CASE("test_types_bfloat16_round_to_nearest_even", "[types][bfloat16]")
+            {
+                // 1 + 2^-8 lies exactly between 1 and 1 + 2^-7, the tie goes to the even 1.
+                REQUIRE(BFloat16(1.0f + std::ldexp(1.0f, -8)).bits == 0x3F80);
+                // 1 + 3 * 2^-8 lies between 1 + 2^-7 and 1 + 2^-6, the tie goes to the even 1 + 2^-6.
+                REQUIRE(BFloat16(1.0f + 3.0f * std::ldexp(1.0f, -8)).bits == 0x3F82);
+                // Just above the tie rounds up.
+                REQUIRE(BFloat16(1.0f + std::ldexp(1.0f, -8) + std::ldexp(1.0f, -20)).bits == 0x3F81);
+                // Just below the tie rounds down.
+                REQUIRE(BFloat16(1.0f + std::ldexp(1.0f, -8) - std::ldexp(1.0f, -20)).bits == 0x3F80);
+
+                // The largest float rounds to infinity, the largest BFloat16 stays finite.
+                REQUIRE(BFloat16(std::numeric_limits<float>::max()).bits == std::numeric_limits<BFloat16>::infinity().bits);
+                REQUIRE(std::isfinite(static_cast<float>(std::numeric_limits<BFloat16>::max())));
+            }
+
+            TEST_CASE("test_types_bfloat16_special_values", "[types][bfloat16]")
+            {
+                REQUIRE(std::isinf(static_cast<float>(BFloat16(std::numeric_limits<float>::infinity()))));
+                REQUIRE(std::isinf(static_cast<float>(BFloat16(-std::numeric_limits<float>::infinity()))));
+                REQUIRE(std::isnan(static_cast<float>(BFloat16(std::numeric_limits<float>::quiet_NaN()))));
+                REQUIRE(std::isnan(static_cast<float>(std::numeric_limits<BFloat16>::quiet_NaN())));
+
+                // A NaN whose payload is only in the dropped bits must not round to infinity.
+                const uint32_t signalingBits = 0x7F800001u;
+                float signaling;
+                std::memcpy(&signaling, &signalingBits, sizeof(signaling));
+                REQUIRE(std::isnan(static_cast<float>(BFloat16(signaling))));
+            }
+        }
+    }
+}
@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "../../types/Float16.h"
+
+namespace ImageInference
+{
+    namespace test
+    {
+        namespace types
+        {
+            using ImageInference::types::Float16;
+
+            TEST_CASE("test_types_float16_exact", "[types][float16]")
+            {
+                // Values with at most 11 significant bits inside the range are kept exactly.
+                const float values[] = {0.0f, -0.0f, 1.0f, -2.0f, 0.5f, 2047.0f, 1.0f / 1024.0f, 65504.0f, -65504.0f};
+                for (const float value : values)
+                {
+                    REQUIRE(static_cast<float>(Float16(value)) == value);
+                }
+
+                REQUIRE(Float16(1.0f).bits == 0x3C00);
+                REQUIRE(Float16(-2.0f).bits == 0xC000);
+                REQUIRE(Float16(65504.0f).bits == std::numeric_limits<Float16>::max().bits);
+                REQUIRE(std::signbit(static_cast<float>(Float16(-0.0f))));
+            }
+
+            TEST_CASE("test_types_float16_round_to_nearest_even", "[types][float16]")
+            {
+                // 1 + 2^-11 lies exactly between 1 and 1 + 2^-10, the tie goes to the even 1.
+                REQUIRE(Float16(1.0f + std::ldexp(1.0f, -11)).bits == 0x3C00);
+                // 1 + 3 * 2^-11 lies between 1 + 2^-10 and 1 + 2^-9, the tie goes to the even 1 + 2^-9.
+                REQUIRE(Float16(1.0f + 3.0f * std::ldexp(1.0f, -11)).bits == 0x3C02);
+                // Just above the tie rounds up.
+                REQUIRE(Float16(1.0f + std::ldexp(1.0f, -11) + std::ldexp(1.0f, -20)).bits == 0x3C01);
+                // Just below the tie rounds down.
+                REQUIRE(Float16(1.0f + std::ldexp(1.0f, -11) - std::ldexp(1.0f, -20)).bits == 0x3C00);
+                // Rounding up the largest mantissa carries into the exponent.
+                REQUIRE(Float16(2.0f - std::ldexp(1.0f, -12)).bits == 0x4000);
+            }
+
+            TEST_CASE("test_types_float16_range", "[types][float16]")
+            {
+                // 65520 is the tie between the largest Float16 and 65536, which is out of range and goes to infinity.
+                REQUIRE(Float16(65519.0f).bits == std::numeric_limits<Float16>::max().bits);
+                REQUIRE(Float16(65520.0f).bits == std::numeric_limits<Float16>::infinity().bits);
+                REQUIRE(Float16(-1.0e6f).bits == 0xFC00);
+                REQUIRE(Float16(std::numeric_limits<float>::max()).bits == std::numeric_limits<Float16>::infinity().bits);
+
+                // Below the smallest normal the values are rounded to the subnormal steps of 2^-24.
+                REQUIRE(static_cast<float>(std::numeric_limits<Float16>::min()) == std::ldexp(1.0f, -14));
+                REQUIRE(static_cast<float>(std::numeric_limits<Float16>::denorm_min()) == std::ldexp(1.0f, -24));
+                REQUIRE(Float16(std::ldexp(1.0f, -24)).bits == 0x0001);
+                REQUIRE(Float16(3.0f * std::ldexp(1.0f, -24)).bits == 0x0003);
+                REQUIRE(Float16(-std::ldexp(1.0f, -14) + std::ldexp(1.0f, -24)).bits == 0x83FF);
+                // Half of the smallest subnormal is a tie to the even zero, just above it rounds up.
+                REQUIRE(Float16(std::ldexp(1.0f, -25)).bits == 0x0000);
+                REQUIRE(Float16(1.5f * std::ldexp(1.0f, -25)).bits == 0x0001);
+                REQUIRE(Float16(3.0f * std::ldexp(1.0f, -25)).bits == 0x0002);
+                REQUIRE(Float16(-std::ldexp(1.0f, -30)).bits == 0x8000);
+            }
+
+            TEST_CASE("test_types_float16_special_values", "[types][float16]")
+            {
+                REQUIRE(std::isinf(static_cast<float>(Float16(std::numeric_limits<float>::infinity()))));
+                REQUIRE(Float16(-std::numeric_limits<float>::infinity()).bits == 0xFC00);
+                REQUIRE(std::isnan(static_cast<float>(Float16(std::numeric_limits<float>::quiet_NaN()))));
+                REQUIRE(std::isnan(static_cast<float>(std::numeric_limits<Float16>::quiet_NaN())));
+
+                // A NaN whose payload is only in the dropped bits must not become infinity.
+                const uint32_t signalingBits = 0x7F800001u;
+                float signaling;
+                std::memcpy(&signaling, &signalingBits, sizeof(signaling));
+                REQUIRE(std::isnan(static_cast<float>(Float16(signaling))));
+            }
+        }
+    }
+}
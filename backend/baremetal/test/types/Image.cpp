@@ -8,6 +8,10 @@
 #include <ATen/ATen.h>
 #include <torch/library.h>
 #include <catch2/catch_test_macros.hpp>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
 #include "../../types/Image.h"
 
 namespace ImageInference
@@ -179,6 +183,120 @@ namespace ImageInference
 
                 REQUIRE(at::allclose(out, expected));
             }
+
+            TEST_CASE("test_types_image_external_memory", "[types][image][init]")
+            {
+                constexpr size_t padding = 1;
+                constexpr size_t blockSize = 16;
+                constexpr size_t channels = 32;
+                constexpr size_t height = 4;
+                constexpr size_t width = 4;
+                using ImageType = Image<float, padding, blockSize, channels, height, width>;
+
+                std::vector<float> memory(ImageType::size + 1, 1.0f);
+                {
+                    ImageType image(memory.data(), memory.size());
+                    REQUIRE(image.getPointer() == memory.data());
+                }
+
+                // The image is zeroed and does not free the memory, the element behind the image is untouched.
+                REQUIRE(std::all_of(memory.begin(), memory.end() - 1, [](float value) { return value == 0.0f; }));
+                REQUIRE(memory.back() == 1.0f);
+
+                REQUIRE_THROWS(ImageType(memory.data(), ImageType::size - 1));
+            }
+
+            TEST_CASE("test_types_image_move", "[types][image][move]")
+            {
+                constexpr size_t padding = 1;
+                constexpr size_t blockSize = 16;
+                constexpr size_t channels = 32;
+                constexpr size_t height = 4;
+                constexpr size_t width = 4;
+                using ImageType = Image<float, padding, blockSize, channels, height, width>;
+
+                Tensor input = at::randn({channels, height, width});
+                ImageType image(input.const_data_ptr<float>());
+                float *pointer = image.getPointer();
+
+                ImageType moved(std::move(image));
+                REQUIRE(moved.getPointer() == pointer);
+                REQUIRE(image.getPointer() == nullptr);
+
+                ImageType assigned;
+                assigned = std::move(moved);
+                REQUIRE(assigned.getPointer() == pointer);
+
+                auto flatten = assigned.flatten();
+                Tensor out = at::from_blob(flatten.getPointer(), {channels, height, width});
+                REQUIRE(at::allclose(out, input));
+            }
+
+            TEST_CASE("test_types_image_view", "[types][image][view]")
+            {
+                constexpr size_t padding = 1;
+                constexpr size_t blockSize = 16;
+                constexpr size_t channels = 32;
+                constexpr size_t height = 4;
+                constexpr size_t width = 4;
+                using ImageType = Image<float, padding, blockSize, channels, height, width>;
+
+                Tensor input = at::randn({channels, height, width});
+                ImageType image(input.const_data_ptr<float>());
+
+                // The view reads the memory in place and leaves it untouched when it is destroyed.
+                {
+                    auto view = ImageType::view(image.getPointer());
+                    REQUIRE(view.getPointer() == image.getPointer());
+                    REQUIRE(view.getOffset(1, 2, 3, 4) == image.getOffset(1, 2, 3, 4));
+
+                    auto flatten = view.flatten();
+                    Tensor out = at::from_blob(flatten.getPointer(), {channels, height, width});
+                    REQUIRE(at::allclose(out, input));
+                }
+
+                auto flatten = image.flatten();
+                Tensor out = at::from_blob(flatten.getPointer(), {channels, height, width});
+                REQUIRE(at::allclose(out, input));
+            }
+
+            TEST_CASE("test_types_image_padding_initialization", "[types][image][init][padding]")
+            {
+                constexpr size_t padding = 2;
+                constexpr size_t blockSize = 16;
+                constexpr size_t channels = 32;
+                constexpr size_t height = 5;
+                constexpr size_t width = 4;
+                using ImageType = Image<float, padding, blockSize, channels, height, width>;
+
+                ImageType image(ImageInference::types::ImageInitialization::Padding);
+                auto pointer = image.getPointer();
+
+                for (size_t iBChannel = 0; iBChannel < channels / blockSize; iBChannel++)
+                {
+                    for (size_t iHeight = 0; iHeight < height + 2 * padding; iHeight++)
+                    {
+                        for (size_t iWidth = 0; iWidth < width + 2 * padding; iWidth++)
+                        {
+                            const bool isPadding = iHeight < padding || iHeight >= height + padding ||
+                                                   iWidth < padding || iWidth >= width + padding;
+                            for (size_t iChannel = 0; iChannel < blockSize; iChannel++)
+                            {
+                                const float value = pointer[image.getOffset(iBChannel, iHeight, iWidth, iChannel)];
+                                if (isPadding)
+                                {
+                                    REQUIRE(value == 0.0f);
+                                }
+                                else
+                                {
+                                    // The data section is poisoned to catch reads before writes.
+                                    REQUIRE(std::isnan(value));
+                                }
+                            }
+                        }
+                    }
+                }
+            }
         }
     }
 }
\ No newline at end of file
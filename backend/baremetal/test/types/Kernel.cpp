@@ -8,6 +8,8 @@
 #include <ATen/ATen.h>
 #include <torch/library.h>
 #include <catch2/catch_test_macros.hpp>
+#include <utility>
+#include <vector>
 #include "../../types/Kernel.h"
 
 namespace ImageInference
@@ -87,6 +89,133 @@ namespace ImageInference
 
                 REQUIRE(at::allclose(out, expected));
             }
+
+            TEST_CASE("test_types_kernel_initialization_blocked_layout", "[types][kernel]")
+            {
+                constexpr size_t blockSize = 16;
+                constexpr size_t inChannels = 64;
+                constexpr size_t outChannels = 32;
+                constexpr size_t height = 3;
+                constexpr size_t width = 3;
+
+                Tensor input = at::randn({outChannels, inChannels, height, width});
+                Tensor blocked = input.view({outChannels / blockSize, blockSize, inChannels / blockSize, blockSize, height, width})
+                                     .permute({0, 2, 4, 5, 3, 1})
+                                     .contiguous();
+                Kernel<float, blockSize, blockSize, outChannels, inChannels, height, width> kernel = Kernel<float, blockSize, blockSize, outChannels, inChannels, height, width>::view(blocked.mutable_data_ptr<float>());
+                Kernel<float, blockSize, blockSize, outChannels, inChannels, height, width> reference(input.const_data_ptr<float>());
+
+                // The blocked data is used in place
+                REQUIRE(kernel.getPointer() == blocked.const_data_ptr<float>());
+
+                Tensor out = at::from_blob(kernel.getPointer(), {outChannels / blockSize, inChannels / blockSize, height, width, blockSize, blockSize});
+                Tensor expected = at::from_blob(reference.getPointer(), {outChannels / blockSize, inChannels / blockSize, height, width, blockSize, blockSize});
+                REQUIRE(at::equal(out, expected));
+            }
+
+            TEST_CASE("test_types_kernel_scale_count", "[types][kernel]")
+            {
+                constexpr size_t blockSize = 16;
+                constexpr size_t inChannels = 32;
+                constexpr size_t outChannels = 64;
+                constexpr size_t height = 3;
+                constexpr size_t width = 3;
+
+                Tensor input = at::randn({outChannels, inChannels, height, width});
+                Tensor factors = at::randn({outChannels});
+                Kernel<float, blockSize, blockSize, outChannels, inChannels, height, width> kernel(input.const_data_ptr<float>());
+                kernel.scaleCount(factors.const_data_ptr<float>());
+                Tensor out = at::from_blob(kernel.getPointer(), {outChannels / blockSize, inChannels / blockSize, height, width, blockSize, blockSize});
+
+                Tensor expected = (input * factors.view({outChannels, 1, 1, 1}))
+                                      .view({outChannels / blockSize, blockSize, inChannels / blockSize, blockSize, height, width})
+                                      .permute({0, 2, 4, 5, 3, 1})
+                                      .contiguous();
+
+                REQUIRE(at::allclose(out, expected));
+            }
+
+            TEST_CASE("test_types_kernel_convert_bfloat16", "[types][kernel][bfloat16]")
+            {
+                constexpr size_t blockSize = 16;
+                constexpr size_t inChannels = 32;
+                constexpr size_t outChannels = 64;
+                constexpr size_t height = 3;
+                constexpr size_t width = 3;
+                using KernelType = Kernel<float, blockSize, blockSize, outChannels, inChannels, height, width>;
+
+                Tensor input = at::randn({outChannels, inChannels, height, width});
+                KernelType kernel(input.const_data_ptr<float>());
+                KernelType::WithType<ImageInference::types::BFloat16> converted(kernel);
+                Tensor out = at::from_blob(converted.getPointer(), {outChannels / blockSize, inChannels / blockSize, height, width, blockSize / 2, blockSize, 2}, at::kBFloat16);
+
+                // Pairs of channels are interleaved for every count, i.e. the VNNI layout of the BFloat16 gemms.
+                Tensor expected = input.to(at::kBFloat16)
+                                      .view({outChannels / blockSize, blockSize, inChannels / blockSize, blockSize / 2, 2, height, width})
+                                      .permute({0, 2, 5, 6, 3, 1, 4})
+                                      .contiguous();
+
+                REQUIRE((converted.size == kernel.size));
+                REQUIRE(at::equal(out, expected));
+            }
+
+            TEST_CASE("test_types_kernel_convert_int8", "[types][kernel][int8]")
+            {
+                constexpr size_t blockSize = 16;
+                constexpr size_t inChannels = 32;
+                constexpr size_t outChannels = 64;
+                constexpr size_t height = 3;
+                constexpr size_t width = 3;
+                using KernelType = Kernel<float, blockSize, blockSize, outChannels, inChannels, height, width>;
+
+                Tensor input = at::randn({outChannels, inChannels, height, width});
+                KernelType kernel(input.const_data_ptr<float>());
+
+                // The factors quantize every count symmetrically into the range of int8_t.
+                std::vector<float> maxima(outChannels);
+                kernel.absMaxCount(maxima.data());
+                Tensor expectedMaxima = input.abs().amax({1, 2, 3});
+                REQUIRE(at::equal(at::from_blob(maxima.data(), {outChannels}), expectedMaxima));
+
+                Tensor factors = 127 / expectedMaxima;
+                KernelType::WithType<int8_t> converted(kernel, factors.const_data_ptr<float>());
+                Tensor out = at::from_blob(converted.getPointer(), {outChannels / blockSize, inChannels / blockSize, height, width, blockSize / 4, blockSize, 4}, at::kChar);
+
+                // Quadruples of channels are interleaved for every count, i.e. the VNNI layout of the int8 gemms.
+                Tensor expected = (input * factors.view({outChannels, 1, 1, 1}))
+                                      .round()
+                                      .clamp(-128, 127)
+                                      .to(at::kChar)
+                                      .view({outChannels / blockSize, blockSize, inChannels / blockSize, blockSize / 4, 4, height, width})
+                                      .permute({0, 2, 5, 6, 3, 1, 4})
+                                      .contiguous();
+
+                REQUIRE((converted.size == kernel.size));
+                REQUIRE(at::equal(out, expected));
+            }
+
+            TEST_CASE("test_types_kernel_move", "[types][kernel]")
+            {
+                constexpr size_t blockSize = 16;
+                constexpr size_t inChannels = 32;
+                constexpr size_t outChannels = 32;
+                constexpr size_t height = 1;
+                constexpr size_t width = 1;
+                using KernelType = Kernel<float, blockSize, blockSize, outChannels, inChannels, height, width>;
+
+                Tensor input = at::randn({outChannels, inChannels, height, width});
+                KernelType kernel(input.const_data_ptr<float>());
+                float *pointer = kernel.getPointer();
+
+                KernelType moved(std::move(kernel));
+                REQUIRE(moved.getPointer() == pointer);
+                REQUIRE(kernel.getPointer() == nullptr);
+
+                // A view does not own the memory, therefore it can not be scaled in place.
+                auto view = KernelType::view(moved.getPointer());
+                REQUIRE(view.getPointer() == pointer);
+                REQUIRE_THROWS(view.scaleCount(input.const_data_ptr<float>()));
+            }
         }
     }
 }
\ No newline at end of file
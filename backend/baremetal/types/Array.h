@@ -7,6 +7,7 @@
 
 #include "Macros.h"
 #include <stddef.h>
+#include <utility>
 #include <algorithm>
 #include <new>
 #include <execution>
@@ -21,6 +22,14 @@ namespace ImageInference
         {
         private:
             T *data;
+            /// @brief False if the array is a view into memory that is owned by someone else.
+            bool ownsData = true;
+
+            struct ViewTag
+            {
+            };
+
+            Array(T *memory, ViewTag);
 
         public:
             static constexpr const size_t size = TSize;
@@ -29,6 +38,13 @@ namespace ImageInference
             Array(const T *input);
             ~Array();
 
+            Array(const Array &) = delete;
+            Array &operator=(const Array &) = delete;
+            Array(Array &&other) noexcept;
+            Array &operator=(Array &&other) noexcept;
+
+            static Array view(T *memory);
+
             T *getPointer();
             size_t getOffset(size_t iRow);
         };
@@ -76,10 +92,47 @@ namespace ImageInference
             }
         }
 
+        /// Takes over the memory of the other array, which is left without memory.
+        template <typename T, size_t TSize>
+        inline Array<T, TSize>::Array(Array &&other) noexcept
+            : data(other.data), ownsData(other.ownsData)
+        {
+            other.data = nullptr;
+            other.ownsData = false;
+        }
+
+        /// Swaps the memory with the other array, which frees the previous memory of this array when it is destroyed.
+        template <typename T, size_t TSize>
+        inline Array<T, TSize> &Array<T, TSize>::operator=(Array &&other) noexcept
+        {
+            std::swap(data, other.data);
+            std::swap(ownsData, other.ownsData);
+            return *this;
+        }
+
+        /// Creates a array as a view into memory that is already in the format of the array e.g. an ExecuTorch tensor.
+        /// The memory is neither copied nor zeroed, it has to outlive the array and is not freed by it.
+        ///
+        /// @param memory The memory of at least size elements.
+        template <typename T, size_t TSize>
+        inline Array<T, TSize> Array<T, TSize>::view(T *memory)
+        {
+            return Array(memory, ViewTag{});
+        }
+
+        template <typename T, size_t TSize>
+        inline Array<T, TSize>::Array(T *memory, ViewTag)
+            : data(memory), ownsData(false)
+        {
+        }
+
         template <typename T, size_t TSize>
         inline Array<T, TSize>::~Array()
         {
-            operator delete[](data, std::align_val_t(PAGE_CACHE_ALIGN(T, TSize)));
+            if (ownsData)
+            {
+                operator delete[](data, std::align_val_t(PAGE_CACHE_ALIGN(T, TSize)));
+            }
         }
 
         template <typename T, size_t TSize>
@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef IMAGEINFERENCE_BFLOAT16_H
+#define IMAGEINFERENCE_BFLOAT16_H
+
+#include <stdint.h>
+#include <cstring>
+#include <limits>
+
+namespace ImageInference
+{
+    namespace types
+    {
+        /// @brief The brain floating point format: the upper 16 bits of a float, with the exponent of float and 7 bits of mantissa.
+        ///
+        /// It is only a storage type. Every arithmetic converts to float, so expressions of BFloat16 compute in float
+        /// and are rounded once when they are stored.
+        struct BFloat16
+        {
+            uint16_t bits;
+
+            BFloat16() = default;
+
+            /// @brief Rounds to the nearest BFloat16, ties to even. NaN stays a quiet NaN.
+            BFloat16(float value);
+
+            operator float() const;
+
+            static BFloat16 fromBits(uint16_t bits);
+        };
+
+        inline BFloat16::BFloat16(const float value)
+        {
+            uint32_t input;
+            std::memcpy(&input, &value, sizeof(input));
+            if ((input & 0x7FFFFFFFu) > 0x7F800000u)
+            {
+                bits = static_cast<uint16_t>((input >> 16) | 0x0040u);
+                return;
+            }
+
+            // Adding half of the dropped bits rounds up, the lowest kept bit breaks the tie towards even.
+            input += 0x7FFFu + ((input >> 16) & 1u);
+            bits = static_cast<uint16_t>(input >> 16);
+        }
+
+        inline BFloat16::operator float() const
+        {
+            const uint32_t output = static_cast<uint32_t>(bits) << 16;
+            float value;
+            std::memcpy(&value, &output, sizeof(value));
+            return value;
+        }
+
+        inline BFloat16 BFloat16::fromBits(const uint16_t bits)
+        {
+            BFloat16 value;
+            value.bits = bits;
+            return value;
+        }
+    } // namespace types
+} // namespace ImageInference
+
+template <>
+class std::numeric_limits<ImageInference::types::BFloat16>
+{
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr int digits = 8;
+    static constexpr int radix = 2;
+
+    static ImageInference::types::BFloat16 min() { return ImageInference::types::BFloat16::fromBits(0x0080); }
+    static ImageInference::types::BFloat16 max() { return ImageInference::types::BFloat16::fromBits(0x7F7F); }
+    static ImageInference::types::BFloat16 lowest() { return ImageInference::types::BFloat16::fromBits(0xFF7F); }
+    static ImageInference::types::BFloat16 epsilon() { return ImageInference::types::BFloat16::fromBits(0x3C00); }
+    static ImageInference::types::BFloat16 infinity() { return ImageInference::types::BFloat16::fromBits(0x7F80); }
+    static ImageInference::types::BFloat16 quiet_NaN() { return ImageInference::types::BFloat16::fromBits(0x7FC0); }
+};
+
+#endif // IMAGEINFERENCE_BFLOAT16_H
@@ -12,7 +12,15 @@ namespace ImageInference
 {
     namespace types
     {
-        template <typename T, size_t TChannels>
+        /// @brief Batch normalization container.
+        ///
+        /// A folded batch norm expects that gammaVariance is already multiplied into the weights of the preceding convolution.
+        /// Therefore only the bias := beta - mean * gammaVariance is left to apply.
+        ///
+        /// @tparam T The type of the batch norm.
+        /// @tparam TChannels The number of channels.
+        /// @tparam TFolded If the batch norm is folded into the convolution.
+        template <typename T, size_t TChannels, bool TFolded = false>
         class BatchNorm
         {
         private:
@@ -22,7 +30,21 @@ namespace ImageInference
             /// @brief Combination of gamma and variance.
             T *gammaVariance;
 
+            /// @brief Combination of beta, mean and gammaVariance, only used if folded.
+            T *bias = nullptr;
+
+            /// @brief The bias in the quantized domain of the output, only set if requantized.
+            T *quantizedBias = nullptr;
+
+            /// @brief The factor from the quantized accumulator into the quantized output per channel, only set if requantized.
+            T *scale = nullptr;
+
+            /// @brief The factor from the quantized shortcut into the quantized output, only set if requantized.
+            T shortcutScale = 0;
+
         public:
+            static constexpr const bool isFolded = TFolded;
+
             /// @brief Initialize a batch normalization container.
             /// @param gamma The value gamma that is used in batch normalization.
             /// @param beta The value beta that is used in batch normalization.
@@ -32,10 +54,15 @@ namespace ImageInference
             const T *getGammaVariancePointer();
             const T *getBetaPointer();
             const T *getMeanPointer();
+            const T *getBiasPointer();
+            const T *getScalePointer();
+            T getShortcutScale();
+
+            void requantize(const T *weightScales, T inputScale, T outputScale, T shortcutScale = 0);
         };
 
-        template <typename T, size_t TChannels>
-        inline BatchNorm<T, TChannels>::BatchNorm(const void *gamma, const void *beta, const void *mean, const void *variance)
+        template <typename T, size_t TChannels, bool TFolded>
+        inline BatchNorm<T, TChannels, TFolded>::BatchNorm(const void *gamma, const void *beta, const void *mean, const void *variance)
             : beta(static_cast<const T *>(beta)), mean(static_cast<const T *>(mean))
         {
             const T *inVariance = static_cast<const T *>(variance);
@@ -68,31 +95,105 @@ namespace ImageInference
             {
                 gammaVariance[i] = inGamma[i] / std::sqrt(inVariance[i] + 1e-5);
             }
+
+            if constexpr (TFolded)
+            {
+                bias = new (std::align_val_t(PAGE_CACHE_ALIGN(T, TChannels))) T[TChannels];
+
+#ifdef USE_OMP
+#pragma omp simd
+#endif // USE_OMP
+                for (size_t i = 0; i < TChannels; i++)
+                {
+                    bias[i] = this->beta[i] - this->mean[i] * gammaVariance[i];
+                }
+            }
         }
 
-        template <typename T, size_t TChannels>
-        inline BatchNorm<T, TChannels>::~BatchNorm()
+        template <typename T, size_t TChannels, bool TFolded>
+        inline BatchNorm<T, TChannels, TFolded>::~BatchNorm()
         {
             operator delete[](gammaVariance, std::align_val_t(PAGE_CACHE_ALIGN(T, TChannels)));
+            if constexpr (TFolded)
+            {
+                operator delete[](bias, std::align_val_t(PAGE_CACHE_ALIGN(T, TChannels)));
+            }
+            if (scale != nullptr)
+            {
+                operator delete[](scale, std::align_val_t(PAGE_CACHE_ALIGN(T, TChannels)));
+                operator delete[](quantizedBias, std::align_val_t(PAGE_CACHE_ALIGN(T, TChannels)));
+            }
         }
 
-        template <typename T, size_t TChannels>
-        inline const T *BatchNorm<T, TChannels>::getGammaVariancePointer()
+        template <typename T, size_t TChannels, bool TFolded>
+        inline const T *BatchNorm<T, TChannels, TFolded>::getGammaVariancePointer()
         {
             return gammaVariance;
         }
 
-        template <typename T, size_t TChannels>
-        inline const T *BatchNorm<T, TChannels>::getBetaPointer()
+        template <typename T, size_t TChannels, bool TFolded>
+        inline const T *BatchNorm<T, TChannels, TFolded>::getBetaPointer()
         {
             return beta;
         }
 
-        template <typename T, size_t TChannels>
-        inline const T *BatchNorm<T, TChannels>::getMeanPointer()
+        template <typename T, size_t TChannels, bool TFolded>
+        inline const T *BatchNorm<T, TChannels, TFolded>::getMeanPointer()
         {
             return mean;
         }
+
+        /// @brief Get the bias that is left after folding gammaVariance into the convolution.
+        /// A requantized batch norm returns the bias in the quantized domain of the output.
+        template <typename T, size_t TChannels, bool TFolded>
+        inline const T *BatchNorm<T, TChannels, TFolded>::getBiasPointer()
+        {
+            static_assert(TFolded, "BatchNorm: the bias is only available for a folded batch norm.");
+            return quantizedBias != nullptr ? quantizedBias : bias;
+        }
+
+        /// @brief Get the factor per channel from the accumulator of the quantized convolution into the quantized output.
+        template <typename T, size_t TChannels, bool TFolded>
+        inline const T *BatchNorm<T, TChannels, TFolded>::getScalePointer()
+        {
+            return scale;
+        }
+
+        /// @brief Get the factor from the quantized shortcut into the quantized output.
+        template <typename T, size_t TChannels, bool TFolded>
+        inline T BatchNorm<T, TChannels, TFolded>::getShortcutScale()
+        {
+            return shortcutScale;
+        }
+
+        /// @brief Moves the folded batch norm into the quantized domain of the output:
+        /// output / outputScale = accumulator * scale + bias / outputScale + shortcut * shortcutScale
+        /// with scale := inputScale * weightScale / outputScale and shortcutScale := shortcutScale / outputScale,
+        /// where the accumulator is the sum over the quantized input times the quantized weights.
+        /// The quantized bias is computed from the folded bias, which is kept, so requantizing again replaces the previous scales.
+        ///
+        /// @param weightScales The scale of the quantized weights per channel or nullptr if the weights are not quantized.
+        /// @param inputScale The scale of the quantized input of the convolution.
+        /// @param outputScale The scale of the quantized output.
+        /// @param shortcutScale The scale of the quantized shortcut that is added before the relu, 0 without a shortcut.
+        template <typename T, size_t TChannels, bool TFolded>
+        inline void BatchNorm<T, TChannels, TFolded>::requantize(const T *weightScales, const T inputScale, const T outputScale, const T shortcutScale)
+        {
+            static_assert(TFolded, "BatchNorm: Only a folded batch norm can be requantized.");
+
+            if (scale == nullptr)
+            {
+                scale = new (std::align_val_t(PAGE_CACHE_ALIGN(T, TChannels))) T[TChannels];
+                quantizedBias = new (std::align_val_t(PAGE_CACHE_ALIGN(T, TChannels))) T[TChannels];
+            }
+
+            for (size_t i = 0; i < TChannels; i++)
+            {
+                scale[i] = inputScale * (weightScales == nullptr ? T(1) : weightScales[i]) / outputScale;
+                quantizedBias[i] = bias[i] / outputScale;
+            }
+            this->shortcutScale = shortcutScale / outputScale;
+        }
     } // namespace types
 } // namespace ImageInference
 
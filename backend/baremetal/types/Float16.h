@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: © 2024 Vincent Gerlach
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef IMAGEINFERENCE_FLOAT16_H
+#define IMAGEINFERENCE_FLOAT16_H
+
+#include <stdint.h>
+#include <cstring>
+#include <limits>
+
+namespace ImageInference
+{
+    namespace types
+    {
+        /// @brief The IEEE 754 half precision format with 5 bits of exponent and 10 bits of mantissa.
+        ///
+        /// It is only a storage type e.g. of the weights, which are widened to float before they are used.
+        /// Compared to BFloat16 it keeps 3 more bits of mantissa, but only covers magnitudes up to 65504.
+        struct Float16
+        {
+            uint16_t bits;
+
+            Float16() = default;
+
+            /// @brief Rounds to the nearest Float16, ties to even. Magnitudes beyond the range become infinity,
+            /// magnitudes below the smallest normal Float16 become subnormal and NaN stays a quiet NaN.
+            Float16(float value);
+
+            operator float() const;
+
+            static Float16 fromBits(uint16_t bits);
+        };
+
+        inline Float16::Float16(const float value)
+        {
+            uint32_t input;
+            std::memcpy(&input, &value, sizeof(input));
+            const uint16_t sign = static_cast<uint16_t>((input >> 16) & 0x8000u);
+            uint32_t magnitude = input & 0x7FFFFFFFu;
+
+            if (magnitude > 0x7F800000u)
+            {
+                bits = sign | 0x7E00u;
+                return;
+            }
+
+            // 65520 lies between the largest Float16 and the next power of two, the tie goes to the even infinity.
+            if (magnitude >= 0x477FF000u)
+            {
+                bits = sign | 0x7C00u;
+                return;
+            }
+
+            if (magnitude < 0x38800000u)
+            {
+                // Adding 0.5 aligns the value to the step 2^-24 of the subnormal Float16, which the float addition rounds to nearest even.
+                float aligned;
+                std::memcpy(&aligned, &magnitude, sizeof(aligned));
+                aligned += 0.5f;
+                std::memcpy(&magnitude, &aligned, sizeof(magnitude));
+                bits = sign | static_cast<uint16_t>(magnitude - 0x3F000000u);
+                return;
+            }
+
+            // The exponent is rebiased from 127 to 15, then the 13 dropped bits are rounded as for BFloat16.
+            magnitude -= 0x38000000u;
+            magnitude += 0xFFFu + ((magnitude >> 13) & 1u);
+            bits = sign | static_cast<uint16_t>(magnitude >> 13);
+        }
+
+        inline Float16::operator float() const
+        {
+            const uint32_t sign = static_cast<uint32_t>(bits & 0x8000u) << 16;
+            const uint32_t exponent = (bits >> 10) & 0x1Fu;
+            const uint32_t mantissa = bits & 0x3FFu;
+
+            uint32_t output;
+            if (exponent == 0x1Fu)
+            {
+                output = sign | 0x7F800000u | (mantissa << 13);
+            }
+            else if (exponent == 0)
+            {
+                // The subnormals and zero are the mantissa in steps of 2^-24, which every float represents exactly.
+                const float magnitude = static_cast<float>(mantissa) * 5.9604644775390625e-8f;
+                std::memcpy(&output, &magnitude, sizeof(output));
+                output |= sign;
+            }
+            else
+            {
+                output = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+            }
+
+            float value;
+            std::memcpy(&value, &output, sizeof(value));
+            return value;
+        }
+
+        inline Float16 Float16::fromBits(const uint16_t bits)
+        {
+            Float16 value;
+            value.bits = bits;
+            return value;
+        }
+    } // namespace types
+} // namespace ImageInference
+
+template <>
+class std::numeric_limits<ImageInference::types::Float16>
+{
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr int digits = 11;
+    static constexpr int radix = 2;
+
+    static ImageInference::types::Float16 min() { return ImageInference::types::Float16::fromBits(0x0400); }
+    static ImageInference::types::Float16 max() { return ImageInference::types::Float16::fromBits(0x7BFF); }
+    static ImageInference::types::Float16 lowest() { return ImageInference::types::Float16::fromBits(0xFBFF); }
+    static ImageInference::types::Float16 epsilon() { return ImageInference::types::Float16::fromBits(0x1400); }
+    static ImageInference::types::Float16 denorm_min() { return ImageInference::types::Float16::fromBits(0x0001); }
+    static ImageInference::types::Float16 infinity() { return ImageInference::types::Float16::fromBits(0x7C00); }
+    static ImageInference::types::Float16 quiet_NaN() { return ImageInference::types::Float16::fromBits(0x7E00); }
+};
+
+#endif // IMAGEINFERENCE_FLOAT16_H
@@ -7,9 +7,12 @@
 
 #include "Macros.h"
 #include <stddef.h>
+#include <utility>
 #include <cmath>
+#include <limits>
 #include "Array.h"
 #include <new>
+#include <algorithm>
 #include <stdexcept>
 #include <iostream>
 
@@ -17,11 +20,31 @@ namespace ImageInference
 {
     namespace types
     {
+        /// @brief How the memory of a new Image is initialized.
+        enum class ImageInitialization
+        {
+            /// The whole image is zero.
+            Zero,
+            /// Only the padding is zero, the data section is left to be overwritten.
+            /// With IMAGEINFERENCE_TESTING the data section is poisoned with NaN to catch reads before writes.
+            Padding
+        };
+
         template <typename T, size_t TPadding, size_t TBlockSize, size_t TChannels, size_t THeight, size_t TWidth>
         class Image
         {
         private:
             T *data;
+            /// @brief False if the image is a view into memory that is owned by someone else e.g. an arena.
+            bool ownsData = true;
+
+            struct ViewTag
+            {
+            };
+
+            Image(T *memory, ViewTag);
+
+            void initialize(ImageInitialization initialization);
 
         public:
             static constexpr const size_t strideChannelBlock = (THeight + 2 * TPadding) * (TWidth + 2 * TPadding) * TBlockSize;
@@ -31,12 +54,21 @@ namespace ImageInference
             static constexpr const size_t paddingOffset = TPadding * (TWidth + 2 * TPadding) * TBlockSize + TPadding * TBlockSize; // TPadding * strideHeight + TPadding * strideWidth;
             static constexpr const size_t size = TChannels * (THeight + 2 * TPadding) * (TWidth + 2 * TPadding);
 
-            Image();
+            explicit Image(ImageInitialization initialization = ImageInitialization::Zero);
 
             Image(const T *data);
 
+            Image(T *memory, size_t memorySize, ImageInitialization initialization = ImageInitialization::Zero);
+
             ~Image();
 
+            Image(const Image &) = delete;
+            Image &operator=(const Image &) = delete;
+            Image(Image &&other) noexcept;
+            Image &operator=(Image &&other) noexcept;
+
+            static Image view(T *memory);
+
             T *getPointer();
 
             size_t getOffset(size_t iBlockChannel, size_t iHeight, size_t iWidth, size_t iChannel);
@@ -53,9 +85,9 @@ namespace ImageInference
         /// @tparam THeight The dimensions height wise.
         /// @tparam TWidth The dimensions width wise.
         ///
-        /// @param data The pointer to the data.
+        /// @param initialization Which part of the image is zeroed.
         template <typename T, size_t TPadding, size_t TBlockSize, size_t TChannels, size_t THeight, size_t TWidth>
-        inline Image<T, TPadding, TBlockSize, TChannels, THeight, TWidth>::Image()
+        inline Image<T, TPadding, TBlockSize, TChannels, THeight, TWidth>::Image(const ImageInitialization initialization)
         {
             if constexpr (TChannels % TBlockSize != 0)
             {
@@ -64,7 +96,8 @@ namespace ImageInference
                 throw std::runtime_error("Image: The number of channels should be a multiple of the block size!");
             }
 
-            data = new (std::align_val_t(PAGE_CACHE_ALIGN(T, size))) T[size]{0};
+            data = new (std::align_val_t(PAGE_CACHE_ALIGN(T, size))) T[size];
+            initialize(initialization);
         }
 
         /// Converts the input data in format Channel x Height x Width to the blocked format ChannelBlocks x Height x Width x ChannelElements.
@@ -88,7 +121,7 @@ namespace ImageInference
                 throw std::runtime_error("Image: The number of channels should be a multiple of the block size!");
             }
 
-            data = new (std::align_val_t(PAGE_CACHE_ALIGN(T, size))) T[size]{0};
+            data = new (std::align_val_t(PAGE_CACHE_ALIGN(T, size))) T[size];
 
             if (data == nullptr)
             {
@@ -96,6 +129,9 @@ namespace ImageInference
                 throw std::runtime_error("Could not allocate memory for Image on member 'data'");
             }
 
+            // The data section is completely written by the conversion.
+            initialize(ImageInitialization::Padding);
+
             constexpr size_t channelBlocks = TChannels / TBlockSize;
 
             constexpr size_t strideInputChannel = THeight * TWidth;
@@ -124,6 +160,82 @@ namespace ImageInference
             }
         }
 
+        /// Creates an image as a view into memory that is owned by the caller e.g. an activation arena.
+        /// The memory is initialized like a new image and has to outlive the image.
+        ///
+        /// @param memory The memory of at least size elements.
+        /// @param memorySize The number of elements available at memory.
+        /// @param initialization Which part of the memory is zeroed.
+        template <typename T, size_t TPadding, size_t TBlockSize, size_t TChannels, size_t THeight, size_t TWidth>
+        inline Image<T, TPadding, TBlockSize, TChannels, THeight, TWidth>::Image(T *memory, size_t memorySize, const ImageInitialization initialization)
+        {
+            if constexpr (TChannels % TBlockSize != 0)
+            {
+                std::cerr << "Image (" << this << "):The number of channels is not a multiple of the block size. Channels: " << TChannels
+                          << " BlockSize: " << TBlockSize << std::endl;
+                throw std::runtime_error("Image: The number of channels should be a multiple of the block size!");
+            }
+
+            if (memory == nullptr || memorySize < size)
+            {
+                std::cerr << "Image (" << this << "): The memory is too small for the image. Memory: " << memorySize
+                          << " Size: " << size << std::endl;
+                throw std::runtime_error("Image: The memory is too small for the image!");
+            }
+
+            data = memory;
+            ownsData = false;
+            initialize(initialization);
+        }
+
+        /// Zeroes the image or only its padding.
+        /// The padding is a ring of TPadding rows and columns around every channel block.
+        ///
+        /// @param initialization Which part of the image is zeroed.
+        template <typename T, size_t TPadding, size_t TBlockSize, size_t TChannels, size_t THeight, size_t TWidth>
+        inline void Image<T, TPadding, TBlockSize, TChannels, THeight, TWidth>::initialize(const ImageInitialization initialization)
+        {
+            if (initialization == ImageInitialization::Zero)
+            {
+                std::fill(data, data + size, T(0));
+                return;
+            }
+
+#ifdef IMAGEINFERENCE_TESTING
+            if constexpr (std::numeric_limits<T>::has_quiet_NaN)
+            {
+                std::fill(data, data + size, std::numeric_limits<T>::quiet_NaN());
+            }
+            else
+            {
+                std::fill(data, data + size, std::numeric_limits<T>::max());
+            }
+#endif // IMAGEINFERENCE_TESTING
+
+            if constexpr (TPadding > 0)
+            {
+                constexpr size_t channelBlocks = TChannels / TBlockSize;
+                constexpr size_t paddingRows = TPadding * strideHeight;
+                constexpr size_t paddingColumns = TPadding * strideWidth;
+
+                for (size_t iBChannel = 0; iBChannel < channelBlocks; iBChannel++)
+                {
+                    T *channelBlock = data + iBChannel * strideChannelBlock;
+                    // Top and bottom rows
+                    std::fill(channelBlock, channelBlock + paddingRows, T(0));
+                    std::fill(channelBlock + strideChannelBlock - paddingRows, channelBlock + strideChannelBlock, T(0));
+
+                    // Left and right columns of the rows in between
+                    for (size_t iHeight = TPadding; iHeight < THeight + TPadding; iHeight++)
+                    {
+                        T *row = channelBlock + iHeight * strideHeight;
+                        std::fill(row, row + paddingColumns, T(0));
+                        std::fill(row + strideHeight - paddingColumns, row + strideHeight, T(0));
+                    }
+                }
+            }
+        }
+
         /// Get the pointer of the data.
         /// The image is stored in a blocked Format.
         /// ChannelBlocks x Height x Width x ChannelElements
@@ -206,10 +318,47 @@ namespace ImageInference
             return output;
         }
 
+        /// Takes over the memory of the other image, which is left without memory.
+        template <typename T, size_t TPadding, size_t TBlockSize, size_t TChannels, size_t THeight, size_t TWidth>
+        inline Image<T, TPadding, TBlockSize, TChannels, THeight, TWidth>::Image(Image &&other) noexcept
+            : data(other.data), ownsData(other.ownsData)
+        {
+            other.data = nullptr;
+            other.ownsData = false;
+        }
+
+        /// Swaps the memory with the other image, which frees the previous memory of this image when it is destroyed.
+        template <typename T, size_t TPadding, size_t TBlockSize, size_t TChannels, size_t THeight, size_t TWidth>
+        inline Image<T, TPadding, TBlockSize, TChannels, THeight, TWidth> &Image<T, TPadding, TBlockSize, TChannels, THeight, TWidth>::operator=(Image &&other) noexcept
+        {
+            std::swap(data, other.data);
+            std::swap(ownsData, other.ownsData);
+            return *this;
+        }
+
+        /// Creates a image as a view into memory that is already in the format of the image e.g. an ExecuTorch tensor.
+        /// The memory is neither copied nor zeroed, it has to outlive the image and is not freed by it.
+        ///
+        /// @param memory The memory of at least size elements.
+        template <typename T, size_t TPadding, size_t TBlockSize, size_t TChannels, size_t THeight, size_t TWidth>
+        inline Image<T, TPadding, TBlockSize, TChannels, THeight, TWidth> Image<T, TPadding, TBlockSize, TChannels, THeight, TWidth>::view(T *memory)
+        {
+            return Image(memory, ViewTag{});
+        }
+
+        template <typename T, size_t TPadding, size_t TBlockSize, size_t TChannels, size_t THeight, size_t TWidth>
+        inline Image<T, TPadding, TBlockSize, TChannels, THeight, TWidth>::Image(T *memory, ViewTag)
+            : data(memory), ownsData(false)
+        {
+        }
+
         template <typename T, size_t TPadding, size_t TBlockSize, size_t TChannels, size_t THeight, size_t TWidth>
         inline Image<T, TPadding, TBlockSize, TChannels, THeight, TWidth>::~Image()
         {
-            operator delete[](data, std::align_val_t(PAGE_CACHE_ALIGN(T, size)));
+            if (ownsData)
+            {
+                operator delete[](data, std::align_val_t(PAGE_CACHE_ALIGN(T, size)));
+            }
         }
     } // namespace types
 } // namespace ImageInference
@@ -6,19 +6,40 @@
 #define IMAGEINFERENCE_KERNEL_H
 
 #include "Macros.h"
+#include "ScalarTypes.h"
 #include <stddef.h>
+#include <type_traits>
+#include <utility>
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 
 namespace ImageInference
 {
     namespace types
     {
+        /// @brief The memory layout of the data a Kernel is created from.
+        enum class KernelLayout
+        {
+            /// Count x Channel x Height x Width, the data is converted into the blocked format.
+            OIHW,
+            /// Already in the blocked format, the data is used in place by a view, see Kernel::view.
+            Blocked
+        };
+
         template <typename T, size_t TBlockSizeCount, size_t TBlockSizeChannel, size_t TCount, size_t TChannels, size_t THeight, size_t TWidth>
         class Kernel
         {
         private:
              T* data;
+             bool ownsData = true;
+
+             struct ViewTag
+             {
+             };
+
+             Kernel(T *memory, ViewTag);
 
         public:
             static constexpr const size_t strideCountBlock = TChannels * THeight * TWidth * TBlockSizeCount;
@@ -28,11 +49,29 @@ namespace ImageInference
             static constexpr const size_t strideChannel = TBlockSizeCount;
             static constexpr const size_t strideCount = 1;
             static constexpr const size_t size = TCount * TChannels * THeight * TWidth;
+            /// @brief The number of consecutive channels that are interleaved for every count inside a block.
+            /// BFloat16 and int8_t are stored in the VNNI layout of their gemms, then only offsets of whole blocks are meaningful.
+            static constexpr const size_t vnni = std::is_same<T, BFloat16>::value ? 2 : (std::is_same<T, int8_t>::value ? 4 : 1);
+
+            /// @brief The kernel with the same dimensions and blocking stored in another type.
+            template <typename TOther>
+            using WithType = Kernel<TOther, TBlockSizeCount, TBlockSizeChannel, TCount, TChannels, THeight, TWidth>;
 
             Kernel(const T *input);
+            template <typename TSource>
+            explicit Kernel(Kernel<TSource, TBlockSizeCount, TBlockSizeChannel, TCount, TChannels, THeight, TWidth> &source, const TSource *factors = nullptr);
             ~Kernel();
 
+            Kernel(const Kernel &) = delete;
+            Kernel &operator=(const Kernel &) = delete;
+            Kernel(Kernel &&other) noexcept;
+            Kernel &operator=(Kernel &&other) noexcept;
+
+            static Kernel view(T *memory);
+
             T *getPointer();
+            void scaleCount(const T *factors);
+            void absMaxCount(T *maxima);
             size_t getOffset(size_t iBlockCount, size_t iBlockChannel, size_t iHeight, size_t iWidth, size_t iChannel, size_t iCount);
         };
 
@@ -115,10 +154,94 @@ namespace ImageInference
             }
         }
 
+        /// Converts a blocked kernel of another type e.g. the prepared float kernel into BFloat16 or a Float16 kernel back into float.
+        /// Every element is rounded once and the channels of a block are interleaved into the layout given by vnni.
+        /// The source can also be of the same type, then the kernel is an owned copy e.g. of a kernel that uses the data in place.
+        ///
+        /// @param source The kernel to convert, which is not changed.
+        /// @param factors Multiplied with every kernel i.e. output channel before it is rounded e.g. the inverse of its quantization scale,
+        /// TCount elements or nullptr.
+        template <typename T, size_t TBlockSizeCount, size_t TBlockSizeChannel, size_t TCount, size_t TChannels, size_t THeight, size_t TWidth>
+        template <typename TSource>
+        inline Kernel<T, TBlockSizeCount, TBlockSizeChannel, TCount, TChannels, THeight, TWidth>::Kernel(
+            Kernel<TSource, TBlockSizeCount, TBlockSizeChannel, TCount, TChannels, THeight, TWidth> &source, const TSource *factors)
+        {
+            static_assert(TBlockSizeChannel % vnni == 0, "Kernel: The channel block size needs to be a multiple of vnni.");
+            static_assert(Kernel<TSource, TBlockSizeCount, TBlockSizeChannel, TCount, TChannels, THeight, TWidth>::vnni == 1,
+                          "Kernel: The source needs to be in the plain blocked layout.");
+
+            data = new (std::align_val_t(PAGE_CACHE_ALIGN(T, size))) T[size];
+
+            constexpr size_t blockSize = TBlockSizeChannel * TBlockSizeCount;
+            constexpr size_t blocks = size / blockSize;
+            const TSource *sourcePtr = source.getPointer();
+
+#ifdef USE_OMP
+#pragma omp parallel for
+#endif
+            for (size_t iBlock = 0; iBlock < blocks; iBlock++)
+            {
+                // The blocks of a count block are consecutive, see strideCountBlock.
+                const TSource *blockFactors = factors == nullptr ? nullptr : factors + iBlock / (strideCountBlock / blockSize) * TBlockSizeCount;
+                const TSource *sourceBlock = sourcePtr + iBlock * blockSize;
+                T *block = data + iBlock * blockSize;
+                for (size_t iChannel = 0; iChannel < TBlockSizeChannel; iChannel++)
+                {
+                    for (size_t iCount = 0; iCount < TBlockSizeCount; iCount++)
+                    {
+                        float value = sourceBlock[iChannel * strideChannel + iCount * strideCount];
+                        if (blockFactors != nullptr)
+                        {
+                            value *= blockFactors[iCount];
+                        }
+                        block[(iChannel / vnni) * vnni * TBlockSizeCount + iCount * vnni + iChannel % vnni] = roundTo<T>(value);
+                    }
+                }
+            }
+        }
+
+        /// Takes over the memory of the other kernel, which is left without memory.
+        template <typename T, size_t TBlockSizeCount, size_t TBlockSizeChannel, size_t TCount, size_t TChannels, size_t THeight, size_t TWidth>
+        inline Kernel<T, TBlockSizeCount, TBlockSizeChannel, TCount, TChannels, THeight, TWidth>::Kernel(Kernel &&other) noexcept
+            : data(other.data), ownsData(other.ownsData)
+        {
+            other.data = nullptr;
+            other.ownsData = false;
+        }
+
+        /// Swaps the memory with the other kernel, which frees the previous memory of this kernel when it is destroyed.
+        template <typename T, size_t TBlockSizeCount, size_t TBlockSizeChannel, size_t TCount, size_t TChannels, size_t THeight, size_t TWidth>
+        inline Kernel<T, TBlockSizeCount, TBlockSizeChannel, TCount, TChannels, THeight, TWidth> &Kernel<T, TBlockSizeCount, TBlockSizeChannel, TCount, TChannels, THeight, TWidth>::operator=(Kernel &&other) noexcept
+        {
+            std::swap(data, other.data);
+            std::swap(ownsData, other.ownsData);
+            return *this;
+        }
+
+        /// Creates a kernel as a view into memory that is already in the format of the kernel e.g. an ExecuTorch tensor.
+        /// The memory is neither copied nor zeroed, it has to outlive the kernel and is not freed by it.
+        /// The kernel aliases the memory, so writes through the kernel e.g. scaleCount change the memory of the caller.
+        ///
+        /// @param memory The memory of at least size elements.
+        template <typename T, size_t TBlockSizeCount, size_t TBlockSizeChannel, size_t TCount, size_t TChannels, size_t THeight, size_t TWidth>
+        inline Kernel<T, TBlockSizeCount, TBlockSizeChannel, TCount, TChannels, THeight, TWidth> Kernel<T, TBlockSizeCount, TBlockSizeChannel, TCount, TChannels, THeight, TWidth>::view(T *memory)
+        {
+            return Kernel(memory, ViewTag{});
+        }
+
+        template <typename T, size_t TBlockSizeCount, size_t TBlockSizeChannel, size_t TCount, size_t TChannels, size_t THeight, size_t TWidth>
+        inline Kernel<T, TBlockSizeCount, TBlockSizeChannel, TCount, TChannels, THeight, TWidth>::Kernel(T *memory, ViewTag)
+            : data(memory), ownsData(false)
+        {
+        }
+
         template <typename T, size_t TBlockSizeCount, size_t TBlockSizeChannel, size_t TCount, size_t TChannels, size_t THeight, size_t TWidth>
         inline Kernel<T, TBlockSizeCount, TBlockSizeChannel, TCount, TChannels, THeight, TWidth>::~Kernel()
         {
-            operator delete[](data, std::align_val_t(PAGE_CACHE_ALIGN(T, size)));
+            if (ownsData)
+            {
+                operator delete[](data, std::align_val_t(PAGE_CACHE_ALIGN(T, size)));
+            }
         }
 
         /// Get the pointer of the data.
@@ -137,6 +260,72 @@ namespace ImageInference
             return data;
         }
 
+        /// Multiplies every kernel i.e. output channel with its factor.
+        /// This is used to fold the scale of a batch norm into the kernel.
+        ///
+        /// @param factors The factors with TCount elements.
+        template <typename T, size_t TBlockSizeCount, size_t TBlockSizeChannel, size_t TCount, size_t TChannels, size_t THeight, size_t TWidth>
+        inline void Kernel<T, TBlockSizeCount, TBlockSizeChannel, TCount, TChannels, THeight, TWidth>::scaleCount(const T *factors)
+        {
+            if (!ownsData)
+            {
+                std::cerr << "Kernel (" << this << "):Can not scale a kernel that uses the data in place." << std::endl;
+                throw std::runtime_error("Kernel: Can not scale a kernel that uses the data in place!");
+            }
+
+            constexpr size_t countBlocks = TCount / TBlockSizeCount;
+            constexpr size_t innerSize = TChannels * THeight * TWidth; // ChannelBlocks x Height x Width x ChannelElements
+
+#ifdef USE_OMP
+#pragma omp parallel for collapse(2)
+#endif
+            for (size_t iBCount = 0; iBCount < countBlocks; iBCount++)
+            {
+                for (size_t iInner = 0; iInner < innerSize; iInner++)
+                {
+                    T *countPtr = data + iBCount * strideCountBlock + iInner * TBlockSizeCount;
+                    const T *factorPtr = factors + iBCount * TBlockSizeCount;
+#ifdef USE_OMP
+#pragma omp simd
+#endif
+                    for (size_t iCount = 0; iCount < TBlockSizeCount; iCount++)
+                    {
+                        countPtr[iCount] *= factorPtr[iCount];
+                    }
+                }
+            }
+        }
+
+        /// Computes the maximum of the absolute values of every kernel i.e. output channel,
+        /// which is the range of a symmetric quantization per output channel.
+        ///
+        /// @param maxima The maxima with TCount elements.
+        template <typename T, size_t TBlockSizeCount, size_t TBlockSizeChannel, size_t TCount, size_t TChannels, size_t THeight, size_t TWidth>
+        inline void Kernel<T, TBlockSizeCount, TBlockSizeChannel, TCount, TChannels, THeight, TWidth>::absMaxCount(T *maxima)
+        {
+            static_assert(vnni == 1, "Kernel: The maxima need the plain blocked layout.");
+
+            constexpr size_t countBlocks = TCount / TBlockSizeCount;
+            constexpr size_t innerSize = TChannels * THeight * TWidth; // ChannelBlocks x Height x Width x ChannelElements
+
+#ifdef USE_OMP
+#pragma omp parallel for
+#endif
+            for (size_t iBCount = 0; iBCount < countBlocks; iBCount++)
+            {
+                T *maximaPtr = maxima + iBCount * TBlockSizeCount;
+                std::fill(maximaPtr, maximaPtr + TBlockSizeCount, T(0));
+                for (size_t iInner = 0; iInner < innerSize; iInner++)
+                {
+                    const T *countPtr = data + iBCount * strideCountBlock + iInner * TBlockSizeCount;
+                    for (size_t iCount = 0; iCount < TBlockSizeCount; iCount++)
+                    {
+                        maximaPtr[iCount] = std::max(maximaPtr[iCount], static_cast<T>(std::abs(countPtr[iCount])));
+                    }
+                }
+            }
+        }
+
         template <typename T, size_t TBlockSizeCount, size_t TBlockSizeChannel, size_t TCount, size_t TChannels, size_t THeight, size_t TWidth>
         inline size_t Kernel<T, TBlockSizeCount, TBlockSizeChannel, TCount, TChannels, THeight, TWidth>::getOffset(
             size_t iBlockCount, size_t iBlockChannel, size_t iHeight, size_t iWidth, size_t iChannel, size_t iCount)
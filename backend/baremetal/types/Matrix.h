@@ -7,6 +7,7 @@
 
 #include "Macros.h"
 #include <stddef.h>
+#include <utility>
 #include <algorithm>
 #include <stdexcept>
 #include <iostream>
@@ -24,6 +25,14 @@ namespace ImageInference
         {
         private:
             T *data;
+            /// @brief False if the matrix is a view into memory that is owned by someone else.
+            bool ownsData = true;
+
+            struct ViewTag
+            {
+            };
+
+            Matrix(T *memory, ViewTag);
 
         public:
             static constexpr const size_t strideColumn = TRows;
@@ -32,8 +41,18 @@ namespace ImageInference
 
             Matrix();
             Matrix(const T *input);
+            template <typename TSource>
+            explicit Matrix(Matrix<TSource, TColumns, TRows> &source);
             ~Matrix();
 
+            Matrix(const Matrix &) = delete;
+            Matrix &operator=(const Matrix &) = delete;
+            Matrix(Matrix &&other) noexcept;
+            Matrix &operator=(Matrix &&other) noexcept;
+
+            static Matrix view(T *memory);
+            static Matrix transposed(const T *input);
+
             T *getPointer();
             size_t getOffset(size_t iColumn, size_t iRow);
         };
@@ -80,10 +99,87 @@ namespace ImageInference
             }
         }
 
+        /// Converts a matrix of another type e.g. the float weight of a fully connected layer into Float16.
+        /// Every element is rounded once, the layout stays the same.
+        ///
+        /// @param source The matrix to convert, which is not changed.
+        template <typename T, size_t TColumns, size_t TRows>
+        template <typename TSource>
+        inline Matrix<T, TColumns, TRows>::Matrix(Matrix<TSource, TColumns, TRows> &source)
+        {
+            data = new (std::align_val_t(PAGE_CACHE_ALIGN(T, size))) T[size];
+            const TSource *sourcePtr = source.getPointer();
+#ifdef USE_OMP
+#pragma omp parallel for
+#endif // USE_OMP
+            for (size_t i = 0; i < size; i++)
+            {
+                data[i] = T(static_cast<float>(sourcePtr[i]));
+            }
+        }
+
+        /// Takes over the memory of the other matrix, which is left without memory.
+        template <typename T, size_t TColumns, size_t TRows>
+        inline Matrix<T, TColumns, TRows>::Matrix(Matrix &&other) noexcept
+            : data(other.data), ownsData(other.ownsData)
+        {
+            other.data = nullptr;
+            other.ownsData = false;
+        }
+
+        /// Swaps the memory with the other matrix, which frees the previous memory of this matrix when it is destroyed.
+        template <typename T, size_t TColumns, size_t TRows>
+        inline Matrix<T, TColumns, TRows> &Matrix<T, TColumns, TRows>::operator=(Matrix &&other) noexcept
+        {
+            std::swap(data, other.data);
+            std::swap(ownsData, other.ownsData);
+            return *this;
+        }
+
+        /// Creates a matrix as a view into memory that is already in the format of the matrix e.g. an ExecuTorch tensor.
+        /// The memory is neither copied nor zeroed, it has to outlive the matrix and is not freed by it.
+        ///
+        /// @param memory The memory of at least size elements.
+        template <typename T, size_t TColumns, size_t TRows>
+        inline Matrix<T, TColumns, TRows> Matrix<T, TColumns, TRows>::view(T *memory)
+        {
+            return Matrix(memory, ViewTag{});
+        }
+
+        /// Creates a matrix from memory in the transposed format Rows x Columns e.g. the weight of a fully connected layer,
+        /// which is used as the A matrix of a gemm with the columns in the fast dimension.
+        ///
+        /// @param input The memory of size elements, which is copied.
+        template <typename T, size_t TColumns, size_t TRows>
+        inline Matrix<T, TColumns, TRows> Matrix<T, TColumns, TRows>::transposed(const T *input)
+        {
+            Matrix matrix;
+#ifdef USE_OMP
+#pragma omp parallel for
+#endif // USE_OMP
+            for (size_t iColumn = 0; iColumn < TColumns; iColumn++)
+            {
+                for (size_t iRow = 0; iRow < TRows; iRow++)
+                {
+                    matrix.data[iColumn * strideColumn + iRow * strideRow] = input[iRow * TColumns + iColumn];
+                }
+            }
+            return matrix;
+        }
+
+        template <typename T, size_t TColumns, size_t TRows>
+        inline Matrix<T, TColumns, TRows>::Matrix(T *memory, ViewTag)
+            : data(memory), ownsData(false)
+        {
+        }
+
         template <typename T, size_t TColumns, size_t TRows>
         inline Matrix<T, TColumns, TRows>::~Matrix()
         {
-            operator delete[](data, std::align_val_t(PAGE_CACHE_ALIGN(T, size)));
+            if (ownsData)
+            {
+                operator delete[](data, std::align_val_t(PAGE_CACHE_ALIGN(T, size)));
+            }
         }
 
         template <typename T, size_t TColumns, size_t TRows>
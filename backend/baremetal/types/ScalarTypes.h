@@ -5,6 +5,11 @@
 #ifndef IMAGEINFERENCE_SCALARTYPES_H
 #define IMAGEINFERENCE_SCALARTYPES_H
 
+#include "BFloat16.h"
+#include "Float16.h"
+#include <stdint.h>
+#include <cmath>
+
 namespace ImageInference
 {
     namespace types
@@ -12,9 +17,87 @@ namespace ImageInference
         enum class ScalarType
         {
             Undefined,
-            Float
+            Float,
+            /// The weights are given as float and converted while they are prepared, the activations are stored as BFloat16
+            /// and the gemms accumulate in float, see ImageInference::types::BFloat16.
+            BFloat16,
+            /// The weights are given as float and quantized while they are prepared into int8_t with a symmetric scale per output channel.
+            /// The activations are stored as uint8_t with a scale per tensor from a calibration, the gemms accumulate in int32_t.
+            Int8
+        };
+
+        /// @brief The type the gemms accumulate in for activations of type T.
+        template <typename T>
+        struct Accumulator
+        {
+            using type = T;
+        };
+
+        template <>
+        struct Accumulator<BFloat16>
+        {
+            using type = float;
+        };
+
+        template <>
+        struct Accumulator<uint8_t>
+        {
+            using type = int32_t;
+        };
+
+        /// @brief The type of the convolution weights for activations of type T.
+        /// The quantized activations are unsigned as they follow a relu, the weights are signed.
+        template <typename T>
+        struct Weight
+        {
+            using type = T;
+        };
+
+        template <>
+        struct Weight<uint8_t>
+        {
+            using type = int8_t;
         };
-    }
-}
 
-#endif // IMAGEINFERENCE_SCALARTYPES_H
\ No newline at end of file
+        /// @brief The type the epilogues compute in for activations of type T, which is also the type of the weights
+        /// that are not stored in T e.g. the batch norms, the stem and the fully connected layer.
+        template <typename T>
+        struct Parameter
+        {
+            using type = T;
+        };
+
+        template <>
+        struct Parameter<BFloat16>
+        {
+            using type = float;
+        };
+
+        template <>
+        struct Parameter<uint8_t>
+        {
+            using type = float;
+        };
+
+        /// @brief Rounds a value to the nearest T, ties to even. Integers are saturated to their range.
+        template <typename T>
+        inline T roundTo(const float value)
+        {
+            return T(value);
+        }
+
+        template <>
+        inline uint8_t roundTo<uint8_t>(const float value)
+        {
+            return static_cast<uint8_t>(std::nearbyint(std::fmin(std::fmax(value, 0.0f), 255.0f)));
+        }
+
+        template <>
+        inline int8_t roundTo<int8_t>(const float value)
+        {
+            return static_cast<int8_t>(std::nearbyint(std::fmin(std::fmax(value, -128.0f), 127.0f)));
+        }
+    } // namespace types
+} // namespace ImageInference
+
+#endif // IMAGEINFERENCE_SCALARTYPES_H
@@ -11,7 +11,7 @@ import io
 import sys
 
 sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
-from backend.baremetal.export_utils import getResnet50Weights
+from backend.baremetal.export_utils import getResnet50Weights, calibrateActivations, writeCalibration
 
 
 def writeTensor(file: io.BufferedWriter, tensor: torch.Tensor):
@@ -142,3 +142,8 @@ if __name__ == "__main__":
     with open(filePath, "wb") as f:
         writeTensor(f, testBatchNorm)
         writeTensor(f, output)
+
+    # The scales of the activations for the int8 model, calibrated on other images than the test images.
+    calibrationImages = [torch.rand(1, 3, 224, 224) for _ in range(8)]
+    filePath = os.path.join(base_directory, directory, "resnet50_calibration.txt")
+    writeCalibration(filePath, calibrateActivations(resnet50, calibrationImages))